@@ -42,6 +42,7 @@ SOURCES += $${VAULT_BASE}/source/vtypes/_mac/vtypes_platform.cpp
 OBJECTIVE_SOURCES += $${VAULT_BASE}/source/vtypes/_mac/vtypes_platform_objc.mm
 SOURCES += $${VAULT_BASE}/source/containers/_unix/vinstant_platform.cpp
 SOURCES += $${VAULT_BASE}/source/files/_unix/vfsnode_platform.cpp
+SOURCES += $${VAULT_BASE}/source/files/_unix/vmemorymappedfile_platform.cpp
 HEADERS += $${VAULT_BASE}/source/threads/_unix/vthread_platform.h
 SOURCES += $${VAULT_BASE}/source/threads/_unix/vthread_platform.cpp
 HEADERS += $${VAULT_BASE}/source/sockets/_unix/vsocket.h
@@ -65,6 +66,7 @@ HEADERS += $${VAULT_BASE}/source/vtypes/_unix/vtypes_platform.h
 SOURCES += $${VAULT_BASE}/source/vtypes/_unix/vtypes_platform.cpp
 SOURCES += $${VAULT_BASE}/source/containers/_unix/vinstant_platform.cpp
 SOURCES += $${VAULT_BASE}/source/files/_unix/vfsnode_platform.cpp
+SOURCES += $${VAULT_BASE}/source/files/_unix/vmemorymappedfile_platform.cpp
 HEADERS += $${VAULT_BASE}/source/threads/_unix/vthread_platform.h
 SOURCES += $${VAULT_BASE}/source/threads/_unix/vthread_platform.cpp
 HEADERS += $${VAULT_BASE}/source/sockets/_unix/vsocket.h
@@ -88,6 +90,7 @@ HEADERS += $${VAULT_BASE}/source/vtypes/_win/vtypes_platform.h
 SOURCES += $${VAULT_BASE}/source/vtypes/_win/vtypes_platform.cpp
 SOURCES += $${VAULT_BASE}/source/containers/_win/vinstant_platform.cpp
 SOURCES += $${VAULT_BASE}/source/files/_win/vfsnode_platform.cpp
+SOURCES += $${VAULT_BASE}/source/files/_win/vmemorymappedfile_platform.cpp
 HEADERS += $${VAULT_BASE}/source/threads/_win/vthread_platform.h
 SOURCES += $${VAULT_BASE}/source/threads/_win/vthread_platform.cpp
 SOURCES += $${VAULT_BASE}/source/sockets/_win/vcommsessioneventproducerfactory.cpp
@@ -145,8 +148,14 @@ HEADERS += $${VAULT_BASE}/source/containers/vgeometry.h
 SOURCES += $${VAULT_BASE}/source/containers/vgeometry.cpp
 HEADERS += $${VAULT_BASE}/source/containers/vinstant.h
 SOURCES += $${VAULT_BASE}/source/containers/vinstant.cpp
+HEADERS += $${VAULT_BASE}/source/containers/vnumberformat.h
+SOURCES += $${VAULT_BASE}/source/containers/vnumberformat.cpp
 HEADERS += $${VAULT_BASE}/source/containers/vstring.h
 SOURCES += $${VAULT_BASE}/source/containers/vstring.cpp
+HEADERS += $${VAULT_BASE}/source/containers/vstringatom.h
+SOURCES += $${VAULT_BASE}/source/containers/vstringatom.cpp
+HEADERS += $${VAULT_BASE}/source/containers/vstringbuilder.h
+SOURCES += $${VAULT_BASE}/source/containers/vstringbuilder.cpp
 HEADERS += $${VAULT_BASE}/source/files/vabstractfilestream.h
 SOURCES += $${VAULT_BASE}/source/files/vabstractfilestream.cpp
 HEADERS += $${VAULT_BASE}/source/files/vbufferedfilestream.h
@@ -155,6 +164,8 @@ HEADERS += $${VAULT_BASE}/source/files/vdirectiofilestream.h
 SOURCES += $${VAULT_BASE}/source/files/vdirectiofilestream.cpp
 HEADERS += $${VAULT_BASE}/source/files/vfsnode.h
 SOURCES += $${VAULT_BASE}/source/files/vfsnode.cpp
+HEADERS += $${VAULT_BASE}/source/files/vmemorymappedfile.h
+SOURCES += $${VAULT_BASE}/source/files/vmemorymappedfile.cpp
 HEADERS += $${VAULT_BASE}/source/server/vclientsession.h
 SOURCES += $${VAULT_BASE}/source/server/vclientsession.cpp
 HEADERS += $${VAULT_BASE}/source/server/vlistenersocket.h
@@ -239,6 +250,8 @@ HEADERS += $${VAULT_BASE}/source/threads/vthread.h
 SOURCES += $${VAULT_BASE}/source/threads/vthread.cpp
 HEADERS += $${VAULT_BASE}/source/toolbox/vassert.h
 SOURCES += $${VAULT_BASE}/source/toolbox/vassert.cpp
+HEADERS += $${VAULT_BASE}/source/toolbox/vbinarylog.h
+SOURCES += $${VAULT_BASE}/source/toolbox/vbinarylog.cpp
 HEADERS += $${VAULT_BASE}/source/toolbox/vblockingqueue.h
 HEADERS += $${VAULT_BASE}/source/toolbox/vcancellationtoken.h
 SOURCES += $${VAULT_BASE}/source/toolbox/vcancellationtoken.cpp
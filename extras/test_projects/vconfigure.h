@@ -43,6 +43,11 @@ clear by reading which ones you are not using.
 /* It requires you to create a stack crawl header file that contains certain items (see VThread.cpp). */
 //#define VAULT_USER_STACKCRAWL_SUPPORT
 
+/* This value is the most detailed log level compiled into the VLOGGER macros; calls at more detailed (higher) levels */
+/* compile to nothing, including evaluation of their messages. For example, 60 (INFO) removes DEBUG and TRACE calls */
+/* from a release build. All levels are compiled in if not defined. */
+//#define VAULT_LOG_MIN_LEVEL 60
+
 /* This flag enables VMutex checking and logging of lock delays. */
 #define VAULT_MUTEX_LOCK_DELAY_CHECK
 
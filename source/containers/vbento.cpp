@@ -11,6 +11,7 @@ License: MIT. See LICENSE.md in the Vault top level directory.
 #include "vtypes_internal.h"
 
 #include "vexception.h"
+#include "vstringbuilder.h"
 #include "vbufferedfilestream.h"
 
 // VBentoTextParser ----------------------------------------------------------
@@ -18,6 +19,14 @@ License: MIT. See LICENSE.md in the Vault top level directory.
 /**
 This class performs parsing of Bento Text Format data to create a Bento
 data hierarchy from the text.
+
+When the entire input is available in one contiguous buffer (a VString, or a
+VTextIOStream whose raw stream is a VMemoryStream), the parser tokenizes the
+buffer in bulk: delimiters and quotes are located with memchr and each token
+is copied into its target string in one step, rather than being appended one
+code point at a time. Other streams are parsed one code point at a time as
+they are read. Both paths accept exactly the same syntax, and both report
+the line and column of a formatting error.
 */
 class VBentoTextNodeParser {
     public:
@@ -27,6 +36,7 @@ class VBentoTextNodeParser {
 
         void parse(VTextIOStream& stream, VBentoNode& buildNode);
         void parse(const VString& s, VBentoNode& buildNode);
+        void parse(const char* buffer, int bufferLength, VBentoNode& buildNode);
 
     private:
 
@@ -45,7 +55,20 @@ class VBentoTextNodeParser {
 
         } TokenState;
 
+        // Per-code-point parsing, used for non-contiguous streams.
         void _parseCharacter(const VCodePoint& c);
+        void _updatePosition(const VCodePoint& c);
+
+        // Bulk parsing, used for contiguous buffers.
+        void _parseBuffer(const char* buffer, const char* bufferEnd);
+        void _parseBufferTokens(const char*& p, const char* bufferEnd);
+        void _setPositionFromBuffer(const char* buffer, const char* p);
+
+        // Shared by both paths.
+        void _beginChildNode();
+        void _endNode();
+        void _beginAttribute();
+        void _endAttribute();
 
         TokenState mTokenState;
         VString mPendingToken;
@@ -57,6 +80,8 @@ class VBentoTextNodeParser {
         VString mPendingAttributeType;
         VString mPendingAttributeQualifier;
         VString mPendingAttributeValue;
+        int mLineNumber;    ///< Line of the code point being parsed (1-based), for error messages.
+        int mColumnNumber;  ///< Column of the code point being parsed (1-based), for error messages.
 
         VBentoTextNodeParser(const VBentoTextNodeParser&); // not copyable
         VBentoTextNodeParser& operator=(const VBentoTextNodeParser&); // not assignable
@@ -72,33 +97,52 @@ VBentoTextNodeParser::VBentoTextNodeParser()
     , mPendingAttributeName()
     , mPendingAttributeType()
     , mPendingAttributeValue()
+    , mLineNumber(1)
+    , mColumnNumber(0)
     {
 }
 
 void VBentoTextNodeParser::parse(VTextIOStream& stream, VBentoNode& node) {
+    // If the text is sitting in a memory buffer, we can tokenize it in place.
+    // (A pending character means the text stream has already consumed bytes
+    // beyond the raw stream's point of view, so we must let it feed us.)
+    VMemoryStream* memoryStream = dynamic_cast<VMemoryStream*>(&stream.getRawStream());
+    if ((memoryStream != NULL) && !stream.hasPendingCharacter()) {
+        Vs64 offset = memoryStream->getIOOffset();
+        Vs64 numBytes = memoryStream->getEOFOffset() - offset;
+        if ((numBytes >= 0) && (numBytes <= V_MAX_S32)) {
+            this->parse(reinterpret_cast<const char*>(memoryStream->getBuffer() + offset), static_cast<int>(numBytes), node);
+            (void) memoryStream->seek(0, SEEK_END); // same end state as reading to EOF
+            return;
+        }
+    }
+
     mRootNode = &node;
 
     try {
         for (;;) {
             VCodePoint c = stream.readUTF8CodePoint();
+            this->_updatePosition(c);
             this->_parseCharacter(c);
         }
     } catch (const VEOFException& /*ex*/) { // normal EOF on input stream simply ends parsing
     } catch (const VException& ex) {
-        throw VException(VSTRING_FORMAT("The Bento text stream was incorrectly formatted: %s", ex.what()));
+        throw VException(VSTRING_FORMAT("The Bento text stream was incorrectly formatted at line %d, column %d: %s", mLineNumber, mColumnNumber, ex.what()));
     }
 }
 
 void VBentoTextNodeParser::parse(const VString& s, VBentoNode& node) {
+    this->parse(s.chars(), s.length(), node);
+}
+
+void VBentoTextNodeParser::parse(const char* buffer, int bufferLength, VBentoNode& node) {
     mRootNode = &node;
 
     try {
-        for (VString::const_iterator i = s.begin(); i != s.end(); ++i) {
-            this->_parseCharacter(*i);
-        }
+        this->_parseBuffer(buffer, buffer + bufferLength);
     } catch (const VEOFException& /*ex*/) { // normal EOF on input stream simply ends parsing
     } catch (const VException& ex) {
-        throw VException(VSTRING_FORMAT("The Bento text stream was incorrectly formatted: %s", ex.what()));
+        throw VException(VSTRING_FORMAT("The Bento text stream was incorrectly formatted at line %d, column %d: %s", mLineNumber, mColumnNumber, ex.what()));
     }
 }
 
@@ -106,6 +150,78 @@ static bool _isSkippable(const VCodePoint& c) {
     return (c.intValue() <= 0x20) || (c.intValue() == 0x7F);
 }
 
+static bool _isSkippableByte(char c) {
+    return (static_cast<Vu8>(c) <= 0x20) || (c == 0x7F);
+}
+
+/**
+Appends the bytes in the range [rangeStart, rangeEnd) to a string, growing the
+string's buffer at most once.
+*/
+static void _appendBytes(VString& s, const char* rangeStart, const char* rangeEnd) {
+    int numBytes = static_cast<int>(rangeEnd - rangeStart);
+    if (numBytes == 0) {
+        return;
+    }
+
+    int oldLength = s.length();
+    s.preflight(oldLength + numBytes);
+    ::memcpy(s.buffer() + oldLength, rangeStart, static_cast<VSizeType>(numBytes));
+    s.postflight(oldLength + numBytes);
+}
+
+void VBentoTextNodeParser::_updatePosition(const VCodePoint& c) {
+    if (c == '\n') {
+        ++mLineNumber;
+        mColumnNumber = 0;
+    } else {
+        ++mColumnNumber;
+    }
+}
+
+void VBentoTextNodeParser::_beginChildNode() {
+    if (mPendingNode == NULL) {
+        throw VException("Parser found a { after the top level node was closed.");
+    }
+
+    VBentoNode* child = new VBentoNode();
+    mPendingNode->addChildNode(child);
+    mPendingNode = child;
+    mParseNodeStack.push_back(child);
+}
+
+void VBentoTextNodeParser::_endNode() {
+    if (mParseNodeStack.empty()) {
+        throw VException("Parser found a } after the top level node was closed.");
+    }
+
+    mParseNodeStack.pop_back(); // pop the last node
+    if (mParseNodeStack.size() == 0)
+        mPendingNode = NULL; // we're back at top level outside all nodes
+    else
+        mPendingNode = mParseNodeStack.back(); // the new last node is now pending
+}
+
+void VBentoTextNodeParser::_beginAttribute() {
+    if (mPendingNode == NULL) {
+        throw VException("Parser found a [ after the top level node was closed.");
+    }
+
+    mPendingAttributeName = VString::EMPTY();
+    mPendingAttributeType = VString::EMPTY();
+    mPendingAttributeQualifier = VString::EMPTY();
+    mPendingAttributeValue = VString::EMPTY();
+}
+
+void VBentoTextNodeParser::_endAttribute() {
+    mPendingNode->_addAttribute(VBentoAttribute::newObjectFromBentoTextValues(mPendingAttributeName, mPendingAttributeType, mPendingAttributeValue, mPendingAttributeQualifier));
+
+    mPendingAttributeName = VString::EMPTY();
+    mPendingAttributeType = VString::EMPTY();
+    mPendingAttributeQualifier = VString::EMPTY();
+    mPendingAttributeValue = VString::EMPTY();
+}
+
 void VBentoTextNodeParser::_parseCharacter(const VCodePoint& c) {
     switch (mTokenState) {
         case START:
@@ -125,24 +241,14 @@ void VBentoTextNodeParser::_parseCharacter(const VCodePoint& c) {
             } else if (c == '\"') {
                 mTokenState = IN_NODE_NAME;
             } else if (c == '[') {
+                this->_beginAttribute();
                 mTokenState = IN_ATTRIBUTE;
-                mPendingAttributeName = VString::EMPTY();
-                mPendingAttributeType = VString::EMPTY();
-                mPendingAttributeQualifier = VString::EMPTY();
-                mPendingAttributeValue = VString::EMPTY();
             } else if (c == '{') {
+                this->_beginChildNode();
                 mTokenState = IN_NODE;
-                VBentoNode* child = new VBentoNode();
-                mPendingNode->addChildNode(child);
-                mPendingNode = child;
-                mParseNodeStack.push_back(child);
             } else if (c == '}') {
+                this->_endNode();
                 mTokenState = IN_NODE;
-                mParseNodeStack.pop_back(); // pop the last node
-                if (mParseNodeStack.size() == 0)
-                    mPendingNode = NULL; // we're back at top level outside all nodes
-                else
-                    mPendingNode = mParseNodeStack.back(); // the new last node is now pending
             } else {
                 throw VException(VSTRING_FORMAT("Parser expected whitespace, node name, [, {, or } but got '%s'.", c.toString().chars()));
             }
@@ -180,13 +286,7 @@ void VBentoTextNodeParser::_parseCharacter(const VCodePoint& c) {
                 mTokenState = IN_ATTRIBUTE_PRE_VALUE;
             } else if (c == ']') {
                 mTokenState = IN_NODE;
-
-                mPendingNode->_addAttribute(VBentoAttribute::newObjectFromBentoTextValues(mPendingAttributeName, mPendingAttributeType, mPendingAttributeValue, mPendingAttributeQualifier));
-
-                mPendingAttributeName = VString::EMPTY();
-                mPendingAttributeType = VString::EMPTY();
-                mPendingAttributeQualifier = VString::EMPTY();
-                mPendingAttributeValue = VString::EMPTY();
+                this->_endAttribute();
             } else {
                 throw VException(VSTRING_FORMAT("Parser expected whitespace, attr name/type/value, or ] but got '%s'.", c.toString().chars()));
             }
@@ -309,13 +409,7 @@ void VBentoTextNodeParser::_parseCharacter(const VCodePoint& c) {
                     mPendingAttributeValue = mPendingToken;
                     mPendingToken = VString::EMPTY();
                     mTokenState = IN_NODE;
-
-                    mPendingNode->_addAttribute(VBentoAttribute::newObjectFromBentoTextValues(mPendingAttributeName, mPendingAttributeType, mPendingAttributeValue, mPendingAttributeQualifier));
-
-                    mPendingAttributeName = VString::EMPTY();
-                    mPendingAttributeType = VString::EMPTY();
-                    mPendingAttributeQualifier = VString::EMPTY();
-                    mPendingAttributeValue = VString::EMPTY();
+                    this->_endAttribute();
                 }
             } else {
                 mPendingToken += c;
@@ -327,11 +421,255 @@ void VBentoTextNodeParser::_parseCharacter(const VCodePoint& c) {
     }
 }
 
+/**
+Scans a token that ends at an unescaped terminator byte, and in which a
+backslash causes the byte that follows it to be taken literally. The
+unescaped token bytes are appended to the supplied string. Returns a pointer
+to the terminator, or bufferEnd if the input ran out first.
+*/
+static const char* _scanEscapedToken(const char* p, const char* bufferEnd, char terminator, VString& token) {
+    const char* terminatorPtr = static_cast<const char*>(::memchr(p, terminator, static_cast<VSizeType>(bufferEnd - p)));
+    for (;;) {
+        const char* searchEnd = (terminatorPtr == NULL) ? bufferEnd : terminatorPtr;
+        const char* escapePtr = static_cast<const char*>(::memchr(p, '\\', static_cast<VSizeType>(searchEnd - p)));
+
+        if (escapePtr == NULL) {
+            _appendBytes(token, p, searchEnd);
+            return searchEnd;
+        }
+
+        _appendBytes(token, p, escapePtr);
+        p = escapePtr + 1;
+        if (p == bufferEnd) {
+            return bufferEnd;
+        }
+
+        _appendBytes(token, p, p + 1); // the escaped byte is literal, even if it is the terminator
+        if (p == terminatorPtr) {
+            terminatorPtr = static_cast<const char*>(::memchr(p + 1, terminator, static_cast<VSizeType>(bufferEnd - (p + 1))));
+        }
+
+        ++p;
+    }
+}
+
+/**
+Scans an unquoted value, which ends at unescaped whitespace or an unescaped ].
+The value bytes are appended to the supplied string. Returns a pointer to the
+terminating byte, or bufferEnd if the input ran out first.
+*/
+static const char* _scanUnquotedValue(const char* p, const char* bufferEnd, VString& token) {
+    const char* runStart = p;
+    while (p < bufferEnd) {
+        const char c = *p;
+        if (c == '\\') {
+            _appendBytes(token, runStart, p);
+            ++p;
+            if (p == bufferEnd) {
+                return bufferEnd;
+            }
+
+            runStart = p; // the escaped byte starts the next run
+            ++p;
+        } else if (_isSkippableByte(c) || (c == ']')) {
+            break;
+        } else {
+            ++p;
+        }
+    }
+
+    _appendBytes(token, runStart, p);
+    return p;
+}
+
+/*
+The bulk parser walks the same state machine as _parseCharacter(), but only the
+states between tokens (START, IN_NODE, IN_ATTRIBUTE, and IN_ATTRIBUTE_PRE_VALUE)
+are visited byte by byte. Each token -- a quoted name, a parenthesized type or
+qualifier, or a value -- is scanned to its end in one step and copied directly
+into its target string. All delimiters are ASCII, so byte-wise scanning of UTF-8
+is safe: the bytes of multi-byte sequences are always >= 0x80. Running out of
+input in the middle of a token simply ends parsing, just as EOF does for the
+per-code-point path.
+*/
+void VBentoTextNodeParser::_parseBuffer(const char* buffer, const char* bufferEnd) {
+    const char* p = buffer;
+    try {
+        this->_parseBufferTokens(p, bufferEnd);
+    } catch (const VEOFException& /*ex*/) {
+        throw;
+    } catch (const VException& /*ex*/) {
+        this->_setPositionFromBuffer(buffer, p);
+        throw;
+    }
+}
+
+void VBentoTextNodeParser::_parseBufferTokens(const char*& p, const char* bufferEnd) {
+    while (p < bufferEnd) {
+        const char c = *p;
+        switch (mTokenState) {
+            case START:
+                if (_isSkippableByte(c)) {
+                    // nothing
+                } else if (c == '{') {
+                    mTokenState = IN_NODE;
+                    mPendingNode = mRootNode;
+                    mParseNodeStack.push_back(mPendingNode);
+                } else {
+                    throw VException(VSTRING_FORMAT("Parser expected whitespace or { but got '%s'.", VCodePoint(reinterpret_cast<const Vu8*>(p), 0).toString().chars()));
+                }
+                ++p;
+                break;
+
+            case IN_NODE:
+                if (_isSkippableByte(c)) {
+                    // nothing
+                } else if (c == '\"') {
+                    if (mPendingNode == NULL) {
+                        throw VException("Parser found a node name after the top level node was closed.");
+                    }
+
+                    const char* nameEnd = _scanEscapedToken(p + 1, bufferEnd, '\"', mPendingToken);
+                    if (nameEnd == bufferEnd) {
+                        p = bufferEnd;
+                        return;
+                    }
+
+                    mPendingNode->setName(mPendingToken);
+                    mPendingToken = VString::EMPTY();
+                    p = nameEnd; // closing quote
+                } else if (c == '[') {
+                    this->_beginAttribute();
+                    mTokenState = IN_ATTRIBUTE;
+                } else if (c == '{') {
+                    this->_beginChildNode();
+                } else if (c == '}') {
+                    this->_endNode();
+                } else {
+                    throw VException(VSTRING_FORMAT("Parser expected whitespace, node name, [, {, or } but got '%s'.", VCodePoint(reinterpret_cast<const Vu8*>(p), 0).toString().chars()));
+                }
+                ++p;
+                break;
+
+            case IN_ATTRIBUTE:
+                if (_isSkippableByte(c)) {
+                    // nothing
+                } else if (c == '\"') {
+                    mPendingAttributeName = VString::EMPTY();
+                    p = _scanEscapedToken(p + 1, bufferEnd, '\"', mPendingAttributeName);
+                    if (p == bufferEnd) {
+                        return;
+                    }
+                } else if (c == '(') {
+                    const char* typeEnd = static_cast<const char*>(::memchr(p + 1, ')', static_cast<VSizeType>(bufferEnd - (p + 1))));
+                    if (typeEnd == NULL) {
+                        p = bufferEnd;
+                        return;
+                    }
+
+                    mPendingAttributeType.copyFromBuffer(p + 1, 0, static_cast<int>(typeEnd - (p + 1)));
+                    p = typeEnd;
+                } else if (c == '=') {
+                    mTokenState = IN_ATTRIBUTE_PRE_VALUE;
+                } else if (c == ']') {
+                    mTokenState = IN_NODE;
+                    this->_endAttribute();
+                } else {
+                    throw VException(VSTRING_FORMAT("Parser expected whitespace, attr name/type/value, or ] but got '%s'.", VCodePoint(reinterpret_cast<const Vu8*>(p), 0).toString().chars()));
+                }
+                ++p;
+                break;
+
+            case IN_ATTRIBUTE_PRE_VALUE:
+                if (c == '(') {
+                    const char* qualifierEnd = static_cast<const char*>(::memchr(p + 1, ')', static_cast<VSizeType>(bufferEnd - (p + 1))));
+                    if (qualifierEnd == NULL) {
+                        p = bufferEnd;
+                        return;
+                    }
+
+                    mPendingAttributeQualifier.copyFromBuffer(p + 1, 0, static_cast<int>(qualifierEnd - (p + 1)));
+                    p = qualifierEnd + 1;
+                } else if ((c == '\"') || (c == '\'')) {
+                    // Quoted values retain their quotes; newObjectFromBentoTextValues() relies on them.
+                    mPendingAttributeValue.copyFromBuffer(p, 0, 1);
+                    p = _scanEscapedToken(p + 1, bufferEnd, c, mPendingAttributeValue);
+                    if (p == bufferEnd) {
+                        return;
+                    }
+
+                    _appendBytes(mPendingAttributeValue, p, p + 1); // closing quote
+                    mTokenState = IN_ATTRIBUTE;
+                    ++p;
+                } else {
+                    // Any other byte starts an unquoted value, and is taken literally even if it is
+                    // whitespace or ]. A leading backslash makes the byte after it literal instead.
+                    mPendingAttributeValue = VString::EMPTY();
+                    const char* valueStart = p + 1;
+                    if (c == '\\') {
+                        if (valueStart == bufferEnd) {
+                            p = bufferEnd;
+                            return;
+                        }
+
+                        ++valueStart;
+                    }
+
+                    _appendBytes(mPendingAttributeValue, valueStart - 1, valueStart);
+                    p = _scanUnquotedValue(valueStart, bufferEnd, mPendingAttributeValue);
+                    if (p == bufferEnd) {
+                        return;
+                    }
+
+                    if (*p == ']') {
+                        mTokenState = IN_NODE;
+                        this->_endAttribute();
+                    } else {
+                        mTokenState = IN_ATTRIBUTE;
+                    }
+
+                    ++p; // terminating whitespace or ]
+                }
+                break;
+
+            default:
+                // The token states are consumed entirely by the scanning helpers above.
+                p = bufferEnd;
+                return;
+        }
+    }
+}
+
+void VBentoTextNodeParser::_setPositionFromBuffer(const char* buffer, const char* p) {
+    mLineNumber = 1;
+    const char* lineStart = buffer;
+    const char* newline;
+    while ((newline = static_cast<const char*>(::memchr(lineStart, '\n', static_cast<VSizeType>(p - lineStart)))) != NULL) {
+        ++mLineNumber;
+        lineStart = newline + 1;
+    }
+
+    mColumnNumber = 1 + VCodePoint::countUTF8CodePoints(reinterpret_cast<const Vu8*>(lineStart), static_cast<int>(p - lineStart));
+}
+
 // VBentoAttribute -----------------------------------------------------------
 
 VBentoAttribute::VBentoAttribute()
     : mName("uninitialized")
-    , mDataType(VString::EMPTY())
+    , mDataType()
+    {
+}
+
+VBentoAttribute::VBentoAttribute(VBinaryIOStream& stream, const VStringAtom& dataType)
+    : mName(VString::EMPTY())
+    , mDataType(dataType)
+    {
+    stream.readString(mName);
+}
+
+VBentoAttribute::VBentoAttribute(const VString& name, const VStringAtom& dataType)
+    : mName(name)
+    , mDataType(dataType)
     {
 }
 
@@ -355,10 +693,6 @@ const VString& VBentoAttribute::getName() const {
     return mName;
 }
 
-const VString& VBentoAttribute::getDataType() const {
-    return mDataType;
-}
-
 Vs64 VBentoAttribute::calculateContentSize() const {
     Vs64 lengthOfType = 4;
     Vs64 lengthOfName = VBentoNode::_getBinaryStringLength(mName);
@@ -378,27 +712,12 @@ void VBentoAttribute::writeToStream(VBinaryIOStream& stream) const {
     Vs64 contentSize = this->calculateContentSize();
 
     VBentoNode::_writeLengthToStream(stream, contentSize);
-    VBentoNode::_writeFourCharCodeToStream(stream, mDataType);
+    VBentoNode::_writeFourCharCodeToStream(stream, this->getDataType());
     stream.writeString(mName);
 
     this->writeDataToBinaryStream(stream);
 }
 
-static void _escapeString(VString& s) {
-    // Insert a backslash in front of any special character.
-    for (int i = 0; i < s.length(); ++i) {
-        char c = s[i];
-        if ((c == '\\') ||
-            (c == '{') ||
-            (c == '}') ||
-            (c == '"') ||
-            (c == '\'')) {
-            s.insert('\\', i);
-            ++i;
-        }
-    }
-}
-
 static void _unescapeString(VString& s) {
     // Remove any backslash that precedes a special character.
     s.replace("\\'", "\'");
@@ -408,12 +727,120 @@ static void _unescapeString(VString& s) {
     s.replace("\\\\", "\\");
 }
 
-void VBentoAttribute::writeToBentoTextStream(VTextIOStream& stream) const {
-    VString name(mName);
-    _escapeString(name);
-    VString valueString;
-    this->getValueAsBentoTextString(valueString);
+// VBentoTextRenderer --------------------------------------------------------
+
+/**
+This class renders Bento data as Bento Text Format or as XML. It composes the
+text in a VStringBuilder, so a large rendering never recopies what it has already
+written. When rendering to a string, the text is appended to the caller's string
+in one step by finish(); when rendering to a stream, the pending text is written
+each time it reaches kStreamFlushSize, so that a whole hierarchy is never held in
+memory. Integer and bool values are formatted and special characters are escaped
+directly into the builder, without a temporary string per attribute.
+
+The caller may limit the node depth and the number of bytes rendered. Children
+below the depth limit are elided, and once the byte budget is spent rendering
+stops and the output ends with "...". The budget is checked after each attribute
+and node, and the item that crossed it is clipped, so truncated output is exactly
+the budget plus the three-byte marker (less, to avoid splitting a UTF-8 sequence).
+Either way, the part of the hierarchy that is not shown is never rendered.
+*/
+class VBentoTextRenderer {
+    public:
 
+        VBentoTextRenderer(VString& output, bool lineWrap, int maxDepth, int maxLength);
+        VBentoTextRenderer(VTextIOStream& stream, bool lineWrap, int maxDepth, int maxLength);
+        ~VBentoTextRenderer() {}
+
+        void reserve(Vs64 numBytes);
+        void renderBentoText(const VBentoNode& node, int indentDepth);
+        void renderBentoText(const VBentoAttribute& attribute);
+        void renderXML(const VBentoNode& node, int indentDepth);
+        void appendLineEndIfRequested();
+        void finish();
+
+    private:
+
+        static const int kStreamFlushSize = 65536; ///< Pending stream output is written once it reaches this size.
+
+        bool _renderBentoTextNode(const VBentoNode& node, int indentDepth, int depth);
+        bool _renderXMLNode(const VBentoNode& node, int indentDepth, int depth);
+        void _renderXMLArrayAttribute(const VBentoAttribute& attribute, int indentDepth);
+        bool _appendIntegerOrBoolValue(const VBentoAttribute& attribute);
+        void _append(const char* text, int length) { mOutput.append(text, length); }
+        void _append(const char* text) { mOutput.append(text); }
+        void _append(const VString& text) { mOutput.append(text); }
+        void _appendEscaped(const VString& text);
+        void _appendIndentIfRequested(int depth);
+        bool _isOverBudget();
+        void _flushIfFull();
+
+        VStringBuilder  mOutput;            ///< The text rendered and not yet handed to the caller's string or stream.
+        VString*        mOutputString;      ///< The string being rendered to, or NULL.
+        VTextIOStream*  mStream;            ///< The stream being rendered to, or NULL.
+        int             mLineEndingsKind;   ///< The VTextIOStream line endings write kind we are using.
+        const Vu8*      mLineEnding;        ///< The line ending chars to use if mLineWrap is true.
+        int             mLineEndingLength;  ///< The number of mLineEnding chars.
+        bool            mLineWrap;          ///< True if each node should start on its own indented line.
+        int             mMaxDepth;          ///< The deepest node level to render, or -1 for no limit.
+        int             mMaxLength;         ///< The number of bytes to render, or -1 for no limit.
+        Vs64            mNumBytesFlushed;   ///< The number of bytes already written to mStream.
+        bool            mTruncated;         ///< True once the byte budget has been spent.
+        VString         mValueText;         ///< Reused to hold attribute values that are not formatted directly.
+};
+
+VBentoTextRenderer::VBentoTextRenderer(VString& output, bool lineWrap, int maxDepth, int maxLength)
+    : mOutput()
+    , mOutputString(&output)
+    , mStream(NULL)
+    , mLineEndingsKind(VTextIOStream::kUseNativeLineEndings)
+    , mLineEnding(NULL)
+    , mLineEndingLength(0)
+    , mLineWrap(lineWrap)
+    , mMaxDepth(maxDepth)
+    , mMaxLength(maxLength)
+    , mNumBytesFlushed(0)
+    , mTruncated(false)
+    , mValueText()
+    {
+    mLineEnding = vault::VgetNativeLineEnding(mLineEndingLength);
+}
+
+VBentoTextRenderer::VBentoTextRenderer(VTextIOStream& stream, bool lineWrap, int maxDepth, int maxLength)
+    : mOutput()
+    , mOutputString(NULL)
+    , mStream(&stream)
+    , mLineEndingsKind(stream.getLineEndingsWriteKind())
+    , mLineEnding(NULL)
+    , mLineEndingLength(0)
+    , mLineWrap(lineWrap)
+    , mMaxDepth(maxDepth)
+    , mMaxLength(maxLength)
+    , mNumBytesFlushed(0)
+    , mTruncated(false)
+    , mValueText()
+    {
+    mLineEnding = stream.getLineEndingChars(mLineEndingLength);
+}
+
+void VBentoTextRenderer::reserve(Vs64 numBytes) {
+    if (mStream != NULL) {
+        numBytes = V_MIN(numBytes, static_cast<Vs64>(kStreamFlushSize * 2));
+    }
+
+    if (mMaxLength >= 0) {
+        numBytes = V_MIN(numBytes, static_cast<Vs64>(mMaxLength + 16)); // Leave room for the "..." that marks truncation.
+    }
+
+    numBytes = V_MIN(numBytes, static_cast<Vs64>(VStringBuilder::kMaxChunkSize));
+    mOutput.reserve(static_cast<int>(numBytes));
+}
+
+void VBentoTextRenderer::renderBentoText(const VBentoNode& node, int indentDepth) {
+    (void) this->_renderBentoTextNode(node, indentDepth, 0);
+}
+
+void VBentoTextRenderer::renderBentoText(const VBentoAttribute& attribute) {
     // The less-used types must self-describe their type in text form.
     // But String, bool, and vs32 are most common and we can infer them
     // from how we format them, so we can have a cleaner format for them.
@@ -438,31 +865,289 @@ void VBentoAttribute::writeToBentoTextStream(VTextIOStream& stream) const {
     // - A VIPolygon:        "outline(poli)"="(24,30)(40,42)(56,30)"
     // - A VColor:           "shading(rgba)"="127,64,200,255"
     // - Binary data:        "thing(bina)"="0x165231FCE64546DE45AD" (0x is optional)
-    if (mDataType == VBentoString::DATA_TYPE_ID()) {
-        _escapeString(valueString);
-        const VBentoString* thisString = static_cast<const VBentoString*>(this); // already type-checked above, no need to dynamic cast
-        const VString& encoding = thisString->getEncoding();
-        if (encoding.isEmpty()) {
-            stream.writeString(VSTRING_FORMAT("[\"%s\"=\"%s\"]", name.chars(), valueString.chars()));
-        } else {
-            stream.writeString(VSTRING_FORMAT("[\"%s\"=(%s)\"%s\"]", name.chars(), encoding.chars(), valueString.chars()));
+    const VStringAtom& dataType = attribute.getDataTypeAtom();
+
+    this->_append("[\"", 2);
+    this->_appendEscaped(attribute.getName());
+
+    if ((dataType == VBentoS32::DATA_TYPE_ATOM()) || (dataType == VBentoBool::DATA_TYPE_ATOM())) {
+        this->_append("\"=", 2);
+        (void) this->_appendIntegerOrBoolValue(attribute);
+    } else if (dataType == VBentoString::DATA_TYPE_ATOM()) {
+        const VBentoString& stringAttribute = static_cast<const VBentoString&>(attribute); // already type-checked above, no need to dynamic cast
+        this->_append("\"=", 2);
+        if (stringAttribute.getEncoding().isNotEmpty()) {
+            this->_append("(", 1);
+            this->_append(stringAttribute.getEncoding());
+            this->_append(")", 1);
         }
-    } else if (mDataType == VBentoChar::DATA_TYPE_ID()) {
-        _escapeString(valueString);
-        stream.writeString(VSTRING_FORMAT("[\"%s\"='%s']", name.chars(), valueString.chars()));
-    } else if ((mDataType == VBentoS32::DATA_TYPE_ID()) || (mDataType == VBentoBool::DATA_TYPE_ID())) {
-        stream.writeString(VSTRING_FORMAT("[\"%s\"=%s]", name.chars(), valueString.chars()));
-    } else if (mDataType == VBentoStringArray::DATA_TYPE_ID()) {
-        VString dataType(mDataType);
-        _escapeString(dataType);
+        this->_append("\"", 1);
+        this->_appendEscaped(stringAttribute.getValue());
+        this->_append("\"", 1);
+    } else if (dataType == VBentoChar::DATA_TYPE_ATOM()) {
+        mValueText.truncateLength(0); // Some attribute types append to the string.
+        attribute.getValueAsBentoTextString(mValueText);
+        mValueText.truncateLength(static_cast<int>(::strlen(mValueText.chars()))); // A null char is written as ''.
+        this->_append("\"='", 3);
+        this->_appendEscaped(mValueText);
+        this->_append("'", 1);
+    } else if (dataType == VBentoStringArray::DATA_TYPE_ATOM()) {
         // Single-quote but do not escape the value string. It contains double-quoted, escaped elements.
-        stream.writeString(VSTRING_FORMAT("[\"%s\"(%s)='%s']", name.chars(), dataType.chars(), valueString.chars()));
+        mValueText.truncateLength(0);
+        attribute.getValueAsBentoTextString(mValueText);
+        this->_append("\"(", 2);
+        this->_appendEscaped(attribute.getDataType());
+        this->_append(")='", 3);
+        this->_append(mValueText);
+        this->_append("'", 1);
+    } else {
+        this->_append("\"(", 2);
+        this->_appendEscaped(attribute.getDataType());
+        this->_append(")=\"", 3);
+        if (!this->_appendIntegerOrBoolValue(attribute)) {
+            mValueText.truncateLength(0);
+            attribute.getValueAsBentoTextString(mValueText);
+            this->_appendEscaped(mValueText);
+        }
+        this->_append("\"", 1);
+    }
+
+    this->_append("]", 1);
+}
+
+void VBentoTextRenderer::renderXML(const VBentoNode& node, int indentDepth) {
+    (void) this->_renderXMLNode(node, indentDepth, 0);
+}
+
+void VBentoTextRenderer::appendLineEndIfRequested() {
+    if (mLineWrap) {
+        this->_append(reinterpret_cast<const char*>(mLineEnding), mLineEndingLength);
+    }
+}
+
+void VBentoTextRenderer::finish() {
+    if (mStream != NULL) {
+        mOutput.writeToStream(*mStream);
+    } else {
+        mOutput.appendToString(*mOutputString);
+    }
+
+    mNumBytesFlushed += mOutput.length();
+    mOutput.truncateLength(0); // Keeps the builder's chunks for the next batch of stream output.
+}
+
+bool VBentoTextRenderer::_renderBentoTextNode(const VBentoNode& node, int indentDepth, int depth) {
+    this->appendLineEndIfRequested();
+    this->_appendIndentIfRequested(indentDepth);
+
+    this->_append("{ \"", 3);
+    this->_appendEscaped(node.getName());
+    this->_append("\" ", 2);
+
+    const VBentoAttributePtrVector& attributes = node.getAttributes();
+    for (VBentoAttributePtrVector::const_iterator i = attributes.begin(); i != attributes.end(); ++i) {
+        this->renderBentoText(**i);
+        this->_append(" ", 1);
+
+        if (this->_isOverBudget()) {
+            return false;
+        }
+    }
+
+    const VBentoNodePtrVector& children = node.getNodes();
+    if ((mMaxDepth >= 0) && (depth >= mMaxDepth) && !children.empty()) {
+        this->_append("... ", 4); // Children below the depth limit are elided.
+    } else {
+        for (VBentoNodePtrVector::const_iterator i = children.begin(); i != children.end(); ++i) {
+            if (!this->_renderBentoTextNode(**i, indentDepth + 1, depth + 1)) {
+                return false;
+            }
+
+            this->_append(" ", 1);
+        }
+    }
+
+    if (!children.empty()) {
+        this->appendLineEndIfRequested();
+        this->_appendIndentIfRequested(indentDepth);
+    }
+
+    this->_append("}", 1);
+
+    return !this->_isOverBudget();
+}
+
+bool VBentoTextRenderer::_renderXMLNode(const VBentoNode& node, int indentDepth, int depth) {
+    this->_appendIndentIfRequested(indentDepth);
+    this->_append("<", 1);
+    this->_append(node.getName());
+
+    const VBentoAttributePtrVector& attributes = node.getAttributes();
+    bool hasArrayAttributes = false;
+    for (VBentoAttributePtrVector::const_iterator i = attributes.begin(); i != attributes.end(); ++i) {
+        if ((*i)->xmlAppearsAsArray()) {
+            hasArrayAttributes = true;
+        } else {
+            // Simple attributes do not use line wrap nor indent. They appear inline in the node's tag.
+            this->_append(" ", 1);
+            this->_append((*i)->getName());
+            this->_append("=\"", 2);
+            if (!this->_appendIntegerOrBoolValue(**i)) {
+                mValueText.truncateLength(0);
+                (*i)->getValueAsXMLText(mValueText);
+                this->_append(mValueText);
+            }
+            this->_append("\"", 1);
+
+            if (this->_isOverBudget()) {
+                return false;
+            }
+        }
+    }
+
+    const VBentoNodePtrVector& children = node.getNodes();
+    bool hasContent = hasArrayAttributes || !children.empty();
+    this->_append(hasContent ? ">" : "/>"); // Leave tag open for array/child elements, or close it.
+    this->appendLineEndIfRequested();
+
+    if (this->_isOverBudget()) {
+        return false;
+    }
+
+    // Write any array attributes as child xml nodes.
+    for (VBentoAttributePtrVector::const_iterator i = attributes.begin(); i != attributes.end(); ++i) {
+        if ((*i)->xmlAppearsAsArray()) {
+            this->_renderXMLArrayAttribute(**i, indentDepth + 1);
+
+            if (this->_isOverBudget()) {
+                return false;
+            }
+        }
+    }
+
+    // Write child nodes as child xml nodes, unless they are below the depth limit.
+    if ((mMaxDepth >= 0) && (depth >= mMaxDepth) && !children.empty()) {
+        this->_appendIndentIfRequested(indentDepth + 1);
+        this->_append("<!-- ... -->");
+        this->appendLineEndIfRequested();
+    } else {
+        for (VBentoNodePtrVector::const_iterator i = children.begin(); i != children.end(); ++i) {
+            if (!this->_renderXMLNode(**i, indentDepth + 1, depth + 1)) {
+                return false;
+            }
+        }
+    }
+
+    // Close the tag if we left it open for child xml nodes.
+    if (hasContent) {
+        this->_appendIndentIfRequested(indentDepth);
+        this->_append("</", 2);
+        this->_append(node.getName());
+        this->_append(">", 1);
+        this->appendLineEndIfRequested();
+    }
+
+    return !this->_isOverBudget();
+}
+
+void VBentoTextRenderer::_renderXMLArrayAttribute(const VBentoAttribute& attribute, int indentDepth) {
+    // Array and geometry attributes render themselves to a text stream; they are rare enough
+    // in practice to give each its own small scratch stream, using our kind of line endings.
+    VMemoryStream buffer(1024);
+    VTextIOStream stream(buffer, mLineEndingsKind);
+    attribute.writeToXMLTextStream(stream, mLineWrap, indentDepth);
+    this->_append(reinterpret_cast<const char*>(buffer.getBuffer()), static_cast<int>(buffer.getEOFOffset()));
+}
+
+bool VBentoTextRenderer::_appendIntegerOrBoolValue(const VBentoAttribute& attribute) {
+    const VStringAtom& dataType = attribute.getDataTypeAtom();
+
+    if (dataType == VBentoS32::DATA_TYPE_ATOM()) {
+        mOutput.appendS64(static_cast<const VBentoS32&>(attribute).getValue());
+    } else if (dataType == VBentoBool::DATA_TYPE_ATOM()) {
+        this->_append(static_cast<const VBentoBool&>(attribute).getValue() ? "true" : "false");
+    } else if (dataType == VBentoS64::DATA_TYPE_ATOM()) {
+        mOutput.appendS64(static_cast<const VBentoS64&>(attribute).getValue());
+    } else if (dataType == VBentoU64::DATA_TYPE_ATOM()) {
+        mOutput.appendU64(static_cast<const VBentoU64&>(attribute).getValue());
+    } else if (dataType == VBentoU32::DATA_TYPE_ATOM()) {
+        mOutput.appendU64(static_cast<const VBentoU32&>(attribute).getValue());
+    } else if (dataType == VBentoS16::DATA_TYPE_ATOM()) {
+        mOutput.appendS64(static_cast<const VBentoS16&>(attribute).getValue());
+    } else if (dataType == VBentoU16::DATA_TYPE_ATOM()) {
+        mOutput.appendU64(static_cast<const VBentoU16&>(attribute).getValue());
+    } else if (dataType == VBentoS8::DATA_TYPE_ATOM()) {
+        mOutput.appendS64(static_cast<const VBentoS8&>(attribute).getValue());
+    } else if (dataType == VBentoU8::DATA_TYPE_ATOM()) {
+        mOutput.appendU64(static_cast<const VBentoU8&>(attribute).getValue());
     } else {
-        VString dataType(mDataType);
-        _escapeString(dataType);
-        _escapeString(valueString);
-        stream.writeString(VSTRING_FORMAT("[\"%s\"(%s)=\"%s\"]", name.chars(), dataType.chars(), valueString.chars()));
+        return false;
+    }
+
+    return true;
+}
+
+void VBentoTextRenderer::_appendEscaped(const VString& text) {
+    // Insert a backslash in front of any special character, copying the runs between them in one step.
+    const char* runStart = text.chars();
+    const char* end = runStart + text.length();
+    for (const char* p = runStart; p != end; ++p) {
+        char c = *p;
+        if ((c == '\\') || (c == '{') || (c == '}') || (c == '"') || (c == '\'')) {
+            this->_append(runStart, static_cast<int>(p - runStart));
+            this->_append("\\", 1);
+            runStart = p; // The special character itself starts the next run.
+        }
+    }
+
+    this->_append(runStart, static_cast<int>(end - runStart));
+}
+
+void VBentoTextRenderer::_appendIndentIfRequested(int depth) {
+    if (mLineWrap) {
+        mOutput.appendRepeated(' ', depth);
+    }
+}
+
+bool VBentoTextRenderer::_isOverBudget() {
+    if (mTruncated) {
+        return true;
     }
+
+    if (mMaxLength < 0) {
+        this->_flushIfFull();
+        return false;
+    }
+
+    Vs64 numBytesRendered = mNumBytesFlushed + mOutput.length();
+    if (numBytesRendered <= mMaxLength) {
+        this->_flushIfFull();
+        return false;
+    }
+
+    // Clip the overshoot from the last item rendered, without splitting a UTF-8 sequence, and mark the truncation.
+    Vs64 clippedLength = V_MAX(mOutput.length() - (numBytesRendered - mMaxLength), static_cast<Vs64>(0));
+    while ((clippedLength > 0) && ((static_cast<Vu8>(mOutput.charAt(clippedLength)) & 0xC0) == 0x80)) {
+        --clippedLength;
+    }
+
+    mOutput.truncateLength(clippedLength);
+    this->_append("...", 3);
+    mTruncated = true;
+
+    return true;
+}
+
+void VBentoTextRenderer::_flushIfFull() {
+    if ((mStream != NULL) && (mOutput.length() >= kStreamFlushSize)) {
+        this->finish();
+    }
+}
+
+void VBentoAttribute::writeToBentoTextStream(VTextIOStream& stream) const {
+    VBentoTextRenderer renderer(stream, false, -1, -1);
+    renderer.renderBentoText(*this);
+    renderer.finish();
 }
 
 static const VString XML_NAME_VALUE_SEPARATOR("=\"");
@@ -632,13 +1317,9 @@ VBentoAttribute* VBentoAttribute::newObjectFromBentoTextValues(const VString& at
         else if (attributeType == VBentoChar::LEGACY_DATA_TYPE_ID())
             result = new VBentoChar(attributeName, actualValue.length() == 0 ? VCodePoint(0) : VCodePoint((int) actualValue[0]));
         else if (attributeType == VBentoFloat::DATA_TYPE_ID()) {
-            VDouble d;
-            (void) ::sscanf(actualValue, VSTRING_FORMATTER_DOUBLE, &d);
-            result = new VBentoFloat(attributeName, static_cast<VFloat>(d));
+            result = new VBentoFloat(attributeName, static_cast<VFloat>(actualValue.parseDouble()));
         } else if (attributeType == VBentoDouble::DATA_TYPE_ID()) {
-            VDouble d;
-            (void) ::sscanf(actualValue, VSTRING_FORMATTER_DOUBLE, &d);
-            result = new VBentoDouble(attributeName, d);
+            result = new VBentoDouble(attributeName, actualValue.parseDouble());
         } else if (attributeType == VBentoDuration::DATA_TYPE_ID()) {
             // Although we always generate with a "ms" suffix, allow any valid
             // VDuration magnitude suffix, by letting VDuration parse it.
@@ -1176,6 +1857,21 @@ void VBentoS64Array::writeToXMLTextStream(VTextIOStream& stream, bool lineWrap,
 
 // VBentoBoolArray --------------------------------------------------------------
 
+VBentoBoolArray::VBentoBoolArray(VBinaryIOStream& stream)
+    : VBentoArray(stream, DATA_TYPE_ATOM())
+    , mValue()
+    {
+    // VBoolArray is a packed vector<bool>, so read the one-byte elements in bulk and then unpack them.
+    Vs8Array bytes;
+    _readElementsFromStream(stream, bytes, &VBinaryIOStream::readS8Array);
+    if (!bytes.empty()) {
+        mValue.reserve(bytes.size());
+        for (Vs8Array::const_iterator i = bytes.begin(); i != bytes.end(); ++i) {
+            mValue.push_back(*i != 0);
+        }
+    }
+}
+
 // static
 VBentoBoolArray* VBentoBoolArray::newFromBentoTextString(const VString& name, const VString& s) {
     VBentoBoolArray* result = new VBentoBoolArray(name);
@@ -1205,6 +1901,18 @@ void VBentoBoolArray::writeToXMLTextStream(VTextIOStream& stream, bool lineWrap,
     _writeLineItemToStream(stream, lineWrap, indentDepth, VSTRING_FORMAT("</%s>", this->getName().chars()));
 }
 
+void VBentoBoolArray::writeDataToBinaryStream(VBinaryIOStream& stream) const {
+    int numElements = static_cast<int>(mValue.size());
+    stream.writeS32(numElements);
+    if (numElements > 0) {
+        Vs8Array bytes(numElements);
+        for (int i = 0; i < numElements; ++i) {
+            bytes[i] = mValue[i] ? 1 : 0;
+        }
+        stream.writeS8Array(&bytes[0], numElements);
+    }
+}
+
 // VBentoStringArray --------------------------------------------------------------
 
 /** Internal string array data parser state. */
@@ -1310,9 +2018,7 @@ VBentoDoubleArray* VBentoDoubleArray::newFromBentoTextString(const VString& name
     int nextSeparatorIndex = s.indexOf(',');
     do {
         s.getSubstring(nextElementText, previousSeparatorIndex + 1, nextSeparatorIndex);
-        VDouble value;
-        (void) ::sscanf(nextElementText, VSTRING_FORMATTER_DOUBLE, &value);
-        result->appendValue(value);
+        result->appendValue(nextElementText.parseDouble());
 
         previousSeparatorIndex = nextSeparatorIndex;
         nextSeparatorIndex = s.indexOf(',', previousSeparatorIndex + 1);
@@ -1333,10 +2039,25 @@ void VBentoDoubleArray::writeToXMLTextStream(VTextIOStream& stream, bool lineWra
 
 // VBentoDurationArray --------------------------------------------------------------
 
-// static
-VBentoDurationArray* VBentoDurationArray::newFromBentoTextString(const VString& name, const VString& s) {
-    VBentoDurationArray* result = new VBentoDurationArray(name);
-
+VBentoDurationArray::VBentoDurationArray(VBinaryIOStream& stream)
+    : VBentoArray(stream, DATA_TYPE_ATOM())
+    , mValue()
+    {
+    // Durations are streamed as Vs64 milliseconds; read them all at once and then convert.
+    Vs64Array milliseconds;
+    _readElementsFromStream(stream, milliseconds, &VBinaryIOStream::readS64Array);
+    if (!milliseconds.empty()) {
+        mValue.reserve(milliseconds.size());
+        for (Vs64Array::const_iterator i = milliseconds.begin(); i != milliseconds.end(); ++i) {
+            mValue.push_back(VDuration::MILLISECOND() * (*i));
+        }
+    }
+}
+
+// static
+VBentoDurationArray* VBentoDurationArray::newFromBentoTextString(const VString& name, const VString& s) {
+    VBentoDurationArray* result = new VBentoDurationArray(name);
+
     // example: "0ms,1111ms,2723847ms"
     VString nextElementText;
     int previousSeparatorIndex = -1;
@@ -1364,8 +2085,35 @@ void VBentoDurationArray::writeToXMLTextStream(VTextIOStream& stream, bool lineW
     _writeLineItemToStream(stream, lineWrap, indentDepth, VSTRING_FORMAT("</%s>", this->getName().chars()));
 }
 
+void VBentoDurationArray::writeDataToBinaryStream(VBinaryIOStream& stream) const {
+    int numElements = static_cast<int>(mValue.size());
+    stream.writeS32(numElements);
+    if (numElements > 0) {
+        Vs64Array milliseconds(numElements);
+        for (int i = 0; i < numElements; ++i) {
+            milliseconds[i] = mValue[i].getDurationMilliseconds();
+        }
+        stream.writeS64Array(&milliseconds[0], numElements);
+    }
+}
+
 // VBentoInstantArray --------------------------------------------------------------
 
+VBentoInstantArray::VBentoInstantArray(VBinaryIOStream& stream)
+    : VBentoArray(stream, DATA_TYPE_ATOM())
+    , mValue()
+    {
+    // Instants are streamed as Vs64 raw values; read them all at once and then convert.
+    Vs64Array rawValues;
+    _readElementsFromStream(stream, rawValues, &VBinaryIOStream::readS64Array);
+    if (!rawValues.empty()) {
+        mValue.reserve(rawValues.size());
+        for (Vs64Array::const_iterator i = rawValues.begin(); i != rawValues.end(); ++i) {
+            mValue.push_back(VInstant::instantFromRawValue(*i));
+        }
+    }
+}
+
 // static
 VBentoInstantArray* VBentoInstantArray::newFromBentoTextString(const VString& name, const VString& s) {
     VBentoInstantArray* result = new VBentoInstantArray(name);
@@ -1402,6 +2150,249 @@ void VBentoInstantArray::writeToXMLTextStream(VTextIOStream& stream, bool lineWr
     _writeLineItemToStream(stream, lineWrap, indentDepth, VSTRING_FORMAT("</%s>", this->getName().chars()));
 }
 
+void VBentoInstantArray::writeDataToBinaryStream(VBinaryIOStream& stream) const {
+    int numElements = static_cast<int>(mValue.size());
+    stream.writeS32(numElements);
+    if (numElements > 0) {
+        Vs64Array rawValues(numElements);
+        for (int i = 0; i < numElements; ++i) {
+            rawValues[i] = mValue[i].getValue();
+        }
+        stream.writeS64Array(&rawValues[0], numElements);
+    }
+}
+
+// VBentoPatchBuilder --------------------------------------------------------
+
+/*
+A patch produced by VBentoNode::diff() has the name of the new node, no
+attributes of its own, and up to six child nodes:
+- "rename": present if the node's name changed; its string attribute "name" is the new name, which may be empty
+- "set": copies of attributes to add, or to replace the attribute with the same name and type
+- "unset": one string attribute per attribute to remove; its name is the attribute name and its value is the data type
+- "add": copies of child nodes to append
+- "remove": one empty node per child node to remove, named for the child
+- "patch": one nested patch per child node that changed, named for the child
+Entries in "remove" and "patch" carry an S32 "index" attribute when they refer
+to other than the first child of that name.
+*/
+static const VString PATCH_SET_ATTRIBUTES("set");
+static const VString PATCH_UNSET_ATTRIBUTES("unset");
+static const VString PATCH_ADD_NODES("add");
+static const VString PATCH_REMOVE_NODES("remove");
+static const VString PATCH_PATCH_NODES("patch");
+static const VString PATCH_OCCURRENCE("index");
+static const VString PATCH_RENAME("rename");
+static const VString PATCH_RENAME_NAME("name");
+
+typedef std::pair<VString, VString> VBentoAttributeKey;         ///< An attribute's name and data type.
+typedef std::map<VBentoAttributeKey, int> VBentoAttributeIndexMap;
+typedef std::pair<VString, int> VBentoNodeKey;                  ///< A child node's name and occurrence among its siblings of that name.
+typedef std::map<VBentoNodeKey, int> VBentoNodeIndexMap;
+
+/**
+This class computes the patch for VBentoNode::diff(). It keeps one pair of
+scratch buffers for comparing attribute values, and reuses them for every
+attribute in the hierarchy so that a diff does not allocate per attribute.
+*/
+class VBentoPatchBuilder {
+    public:
+
+        VBentoPatchBuilder();
+        ~VBentoPatchBuilder() {}
+
+        bool diff(const VBentoNode& oldNode, const VBentoNode& newNode, VBentoNode& patch);
+
+    private:
+
+        bool _diffAttributes(const VBentoNode& oldNode, const VBentoNode& newNode, VBentoNode& patch);
+        bool _diffNodes(const VBentoNode& oldNode, const VBentoNode& newNode, VBentoNode& patch);
+        void _addNodePatch(const VBentoNodePtrVector& oldChildren, int oldChildIndex, const VBentoNode& newChild, VBentoNode& patch, VBentoNode*& patchNodes);
+        bool _attributesEqual(const VBentoAttribute& oldAttribute, const VBentoAttribute& newAttribute);
+
+        static int _findAttributeIndex(const VBentoAttributePtrVector& attributes, const VBentoAttribute& attribute, int hintIndex, VBentoAttributeIndexMap& index);
+        static int _getOccurrence(const VBentoNodePtrVector& nodes, int nodeIndex);
+        static VBentoNode* _getContainer(VBentoNode& patch, const VString& name, VBentoNode*& container);
+
+        VMemoryStream   mOldBuffer; ///< Scratch buffer holding the old attribute being compared.
+        VBinaryIOStream mOldStream; ///< Stream for writing to mOldBuffer.
+        VMemoryStream   mNewBuffer; ///< Scratch buffer holding the new attribute being compared.
+        VBinaryIOStream mNewStream; ///< Stream for writing to mNewBuffer.
+};
+
+VBentoPatchBuilder::VBentoPatchBuilder()
+    : mOldBuffer()
+    , mOldStream(mOldBuffer)
+    , mNewBuffer()
+    , mNewStream(mNewBuffer)
+    {
+}
+
+bool VBentoPatchBuilder::diff(const VBentoNode& oldNode, const VBentoNode& newNode, VBentoNode& patch) {
+    bool differs = (oldNode.getName() != newNode.getName());
+    patch.setName(newNode.getName());
+    if (differs) {
+        patch.addNewChildNode(PATCH_RENAME)->addString(PATCH_RENAME_NAME, newNode.getName());
+    }
+
+    differs = this->_diffAttributes(oldNode, newNode, patch) || differs;
+    differs = this->_diffNodes(oldNode, newNode, patch) || differs;
+
+    return differs;
+}
+
+bool VBentoPatchBuilder::_diffAttributes(const VBentoNode& oldNode, const VBentoNode& newNode, VBentoNode& patch) {
+    const VBentoAttributePtrVector& oldAttributes = oldNode.getAttributes();
+    const VBentoAttributePtrVector& newAttributes = newNode.getAttributes();
+    VBentoAttributeIndexMap oldIndex; // Built only if the attribute order differs.
+    VBentoAttributeIndexMap newIndex;
+    VBentoNode* setAttributes = NULL;
+    VBentoNode* unsetAttributes = NULL;
+
+    for (int i = 0; i < static_cast<int>(newAttributes.size()); ++i) {
+        const VBentoAttribute* newAttribute = newAttributes[i];
+        int oldAttributeIndex = _findAttributeIndex(oldAttributes, *newAttribute, i, oldIndex);
+        if ((oldAttributeIndex == -1) || !this->_attributesEqual(*oldAttributes[oldAttributeIndex], *newAttribute)) {
+            _getContainer(patch, PATCH_SET_ATTRIBUTES, setAttributes)->_addAttribute(newAttribute->clone());
+        }
+    }
+
+    for (int i = 0; i < static_cast<int>(oldAttributes.size()); ++i) {
+        const VBentoAttribute* oldAttribute = oldAttributes[i];
+        if (_findAttributeIndex(newAttributes, *oldAttribute, i, newIndex) == -1) {
+            _getContainer(patch, PATCH_UNSET_ATTRIBUTES, unsetAttributes)->addString(oldAttribute->getName(), oldAttribute->getDataType());
+        }
+    }
+
+    return (setAttributes != NULL) || (unsetAttributes != NULL);
+}
+
+bool VBentoPatchBuilder::_diffNodes(const VBentoNode& oldNode, const VBentoNode& newNode, VBentoNode& patch) {
+    const VBentoNodePtrVector& oldChildren = oldNode.getNodes();
+    const VBentoNodePtrVector& newChildren = newNode.getNodes();
+    VBentoNode* patchNodes = NULL;
+
+    // Usual case: the same children in the same order, so each child is matched by position.
+    bool sameLayout = (oldChildren.size() == newChildren.size());
+    for (VSizeType i = 0; sameLayout && (i < newChildren.size()); ++i) {
+        sameLayout = (oldChildren[i]->getName() == newChildren[i]->getName());
+    }
+
+    if (sameLayout) {
+        for (int i = 0; i < static_cast<int>(newChildren.size()); ++i) {
+            this->_addNodePatch(oldChildren, i, *newChildren[i], patch, patchNodes);
+        }
+
+        return (patchNodes != NULL);
+    }
+
+    // Otherwise, match children by name and occurrence.
+    VBentoNodeIndexMap oldIndex;
+    std::map<VString, int> occurrences;
+    for (int i = 0; i < static_cast<int>(oldChildren.size()); ++i) {
+        const VString& name = oldChildren[i]->getName();
+        oldIndex[VBentoNodeKey(name, occurrences[name]++)] = i;
+    }
+
+    std::vector<bool> oldChildMatched(oldChildren.size(), false);
+    VBentoNode* addNodes = NULL;
+    occurrences.clear();
+    for (int i = 0; i < static_cast<int>(newChildren.size()); ++i) {
+        const VString& name = newChildren[i]->getName();
+        int occurrence = occurrences[name]++;
+        VBentoNodeIndexMap::const_iterator position = oldIndex.find(VBentoNodeKey(name, occurrence));
+        if (position == oldIndex.end()) {
+            _getContainer(patch, PATCH_ADD_NODES, addNodes)->addChildNode(new VBentoNode(*newChildren[i]));
+        } else {
+            oldChildMatched[position->second] = true;
+            this->_addNodePatch(oldChildren, position->second, *newChildren[i], patch, patchNodes);
+        }
+    }
+
+    VBentoNode* removeNodes = NULL;
+    for (int i = 0; i < static_cast<int>(oldChildren.size()); ++i) {
+        if (!oldChildMatched[i]) {
+            VBentoNode* entry = _getContainer(patch, PATCH_REMOVE_NODES, removeNodes)->addNewChildNode(oldChildren[i]->getName());
+            int occurrence = _getOccurrence(oldChildren, i);
+            if (occurrence != 0) {
+                entry->addS32(PATCH_OCCURRENCE, occurrence);
+            }
+        }
+    }
+
+    return (patchNodes != NULL) || (addNodes != NULL) || (removeNodes != NULL);
+}
+
+void VBentoPatchBuilder::_addNodePatch(const VBentoNodePtrVector& oldChildren, int oldChildIndex, const VBentoNode& newChild, VBentoNode& patch, VBentoNode*& patchNodes) {
+    VBentoNode* childPatch = new VBentoNode();
+    if (!this->diff(*oldChildren[oldChildIndex], newChild, *childPatch)) {
+        delete childPatch;
+        return;
+    }
+
+    int occurrence = _getOccurrence(oldChildren, oldChildIndex);
+    if (occurrence != 0) {
+        childPatch->addS32(PATCH_OCCURRENCE, occurrence);
+    }
+
+    _getContainer(patch, PATCH_PATCH_NODES, patchNodes)->addChildNode(childPatch);
+}
+
+bool VBentoPatchBuilder::_attributesEqual(const VBentoAttribute& oldAttribute, const VBentoAttribute& newAttribute) {
+    // Name and type already match. Compare the streamed form, which is what the receiver would see.
+    Vs64 contentSize = newAttribute.calculateContentSize();
+    if (oldAttribute.calculateContentSize() != contentSize) {
+        return false;
+    }
+
+    (void) mOldStream.seek0();
+    (void) mNewStream.seek0();
+    oldAttribute.writeToStream(mOldStream);
+    newAttribute.writeToStream(mNewStream);
+
+    Vs64 streamedSize = mNewStream.getIOOffset();
+    return (mOldStream.getIOOffset() == streamedSize) && (::memcmp(mOldBuffer.getBuffer(), mNewBuffer.getBuffer(), static_cast<size_t>(streamedSize)) == 0);
+}
+
+// static
+int VBentoPatchBuilder::_findAttributeIndex(const VBentoAttributePtrVector& attributes, const VBentoAttribute& attribute, int hintIndex, VBentoAttributeIndexMap& index) {
+    if ((hintIndex < static_cast<int>(attributes.size())) &&
+            (attributes[hintIndex]->getName() == attribute.getName()) &&
+            (attributes[hintIndex]->getDataType() == attribute.getDataType())) {
+        return hintIndex;
+    }
+
+    if (index.empty()) {
+        for (int i = 0; i < static_cast<int>(attributes.size()); ++i) {
+            (void) index.insert(VBentoAttributeIndexMap::value_type(VBentoAttributeKey(attributes[i]->getName(), attributes[i]->getDataType()), i)); // Keeps the first of any duplicates.
+        }
+    }
+
+    VBentoAttributeIndexMap::const_iterator position = index.find(VBentoAttributeKey(attribute.getName(), attribute.getDataType()));
+    return (position == index.end()) ? -1 : position->second;
+}
+
+// static
+int VBentoPatchBuilder::_getOccurrence(const VBentoNodePtrVector& nodes, int nodeIndex) {
+    int occurrence = 0;
+    for (int i = 0; i < nodeIndex; ++i) {
+        if (nodes[i]->getName() == nodes[nodeIndex]->getName()) {
+            ++occurrence;
+        }
+    }
+
+    return occurrence;
+}
+
+// static
+VBentoNode* VBentoPatchBuilder::_getContainer(VBentoNode& patch, const VString& name, VBentoNode*& container) {
+    if (container == NULL) {
+        container = patch.addNewChildNode(name);
+    }
+
+    return container;
+}
+
 // VBentoNode ----------------------------------------------------------------
 
 VBentoNode::VBentoNode()
@@ -1534,7 +2525,7 @@ void VBentoNode::updateFrom(const VBentoNode& source) {
     // Copy (adding as necessary) the attributes.
     const VBentoAttributePtrVector& sourceAttributes = source.getAttributes();
     for (VBentoAttributePtrVector::const_iterator i = sourceAttributes.begin(); i != sourceAttributes.end(); ++i) {
-        VBentoAttribute* targetAttribute = this->_findMutableAttribute((*i)->getName(), (*i)->getDataType());
+        VBentoAttribute* targetAttribute = this->_findMutableAttribute((*i)->getName(), (*i)->getDataTypeAtom());
         if (targetAttribute == NULL) {
             // Clone the source attribute and add it.
             VBentoAttribute* clonedAttribute = (*i)->clone();
@@ -1560,6 +2551,16 @@ void VBentoNode::updateFrom(const VBentoNode& source) {
     }
 }
 
+// static
+bool VBentoNode::diff(const VBentoNode& oldNode, const VBentoNode& newNode, VBentoNode& patch) {
+    VBentoPatchBuilder builder;
+    return builder.diff(oldNode, newNode, patch);
+}
+
+void VBentoNode::applyPatch(const VBentoNode& patch) {
+    this->_applyPatch(patch);
+}
+
 void VBentoNode::addChildNode(VBentoNode* node) {
     node->mParentNode = this;
     mChildNodes.push_back(node);
@@ -1644,43 +2645,24 @@ void VBentoNode::writeToStream(VBinaryIOStream& stream) const {
     }
 }
 
-void VBentoNode::writeToBentoTextStream(VTextIOStream& stream, bool lineWrap, int indentDepth) const {
-    _lineEndIfRequested(stream, lineWrap);
-    _indentIfRequested(stream, lineWrap, indentDepth);
-
-    VString name(mName);
-    _escapeString(name);
-    stream.writeString(VSTRING_FORMAT("{ \"%s\" ", name.chars()));
-
-    VSizeType numAttributes = mAttributes.size();
-    for (VSizeType i = 0; i < numAttributes; ++i) {
-        mAttributes[i]->writeToBentoTextStream(stream);
-        stream.writeString(" ");
-    }
-
-    VSizeType numChildNodes = mChildNodes.size();
-    for (VSizeType i = 0; i < numChildNodes; ++i) {
-        mChildNodes[i]->writeToBentoTextStream(stream, lineWrap, indentDepth + 1);
-        stream.writeString(" ");
-    }
-
-    if (numChildNodes != 0) {
-        _lineEndIfRequested(stream, lineWrap);
-        _indentIfRequested(stream, lineWrap, indentDepth);
-    }
-
-    stream.writeString("}");
+void VBentoNode::writeToBentoTextStream(VTextIOStream& stream, bool lineWrap, int indentDepth, int maxDepth, int maxLength) const {
+    VBentoTextRenderer renderer(stream, lineWrap, maxDepth, maxLength);
+    renderer.reserve(this->_calculateContentSize());
+    renderer.renderBentoText(*this, indentDepth);
+    renderer.finish();
 }
 
 void VBentoNode::writeToBentoTextString(VString& s, bool lineWrap) const {
-    VMemoryStream buffer;
-    VTextIOStream stream(buffer);
-    this->writeToBentoTextStream(stream, lineWrap);
-    stream.writeLineEnd();
-    stream.seek0();
-
     s = VString::EMPTY();
-    stream.readAll(s, lineWrap);
+    this->appendToBentoTextString(s, lineWrap);
+}
+
+void VBentoNode::appendToBentoTextString(VString& s, bool lineWrap, int maxDepth, int maxLength) const {
+    VBentoTextRenderer renderer(s, lineWrap, maxDepth, maxLength);
+    renderer.reserve(this->_calculateContentSize()); // The binary size is a good estimate of the text size.
+    renderer.renderBentoText(*this, 0);
+    renderer.appendLineEndIfRequested();
+    renderer.finish();
 }
 
 void VBentoNode::readFromStream(VBinaryIOStream& stream) {
@@ -1730,7 +2712,7 @@ const VBentoNode* VBentoNode::findNode(const VString& nodeName) const {
 const VBentoNode* VBentoNode::findNode(const VString& nodeName, const VString& attributeName, const VString& dataType) const {
     for (VBentoNodePtrVector::const_iterator i = mChildNodes.begin(); i != mChildNodes.end(); ++i) {
         if (nodeName.equalsIgnoreCase((*i)->getName())) {
-            if ((*i)->_findAttribute(attributeName, dataType) != NULL) {
+            if ((*i)->findAttribute(attributeName, dataType) != NULL) {
                 return (*i);
             }
         }
@@ -1748,12 +2730,12 @@ int VBentoNode::getInt(const VString& name) const {
 }
 
 bool VBentoNode::getBool(const VString& name, bool defaultValue) const {
-    const VBentoBool* attribute = dynamic_cast<const VBentoBool*>(this->_findAttribute(name, VBentoBool::DATA_TYPE_ID()));
+    const VBentoBool* attribute = dynamic_cast<const VBentoBool*>(this->_findAttribute(name, VBentoBool::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 bool VBentoNode::getBool(const VString& name) const {
-    const VBentoBool* attribute = dynamic_cast<const VBentoBool*>(this->_findAttribute(name, VBentoBool::DATA_TYPE_ID()));
+    const VBentoBool* attribute = dynamic_cast<const VBentoBool*>(this->_findAttribute(name, VBentoBool::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoBool::DATA_TYPE_ID(), name);
@@ -1762,12 +2744,12 @@ bool VBentoNode::getBool(const VString& name) const {
 }
 
 const VString& VBentoNode::getString(const VString& name, const VString& defaultValue) const {
-    const VBentoString* attribute = dynamic_cast<const VBentoString*>(this->_findAttribute(name, VBentoString::DATA_TYPE_ID()));
+    const VBentoString* attribute = dynamic_cast<const VBentoString*>(this->_findAttribute(name, VBentoString::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VString& VBentoNode::getString(const VString& name) const {
-    const VBentoString* attribute = dynamic_cast<const VBentoString*>(this->_findAttribute(name, VBentoString::DATA_TYPE_ID()));
+    const VBentoString* attribute = dynamic_cast<const VBentoString*>(this->_findAttribute(name, VBentoString::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoString::DATA_TYPE_ID(), name);
@@ -1776,12 +2758,12 @@ const VString& VBentoNode::getString(const VString& name) const {
 }
 
 const VCodePoint& VBentoNode::getChar(const VString& name, const VCodePoint& defaultValue) const {
-    const VBentoChar* attribute = dynamic_cast<const VBentoChar*>(this->_findAttribute(name, VBentoChar::DATA_TYPE_ID()));
+    const VBentoChar* attribute = dynamic_cast<const VBentoChar*>(this->_findAttribute(name, VBentoChar::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VCodePoint& VBentoNode::getChar(const VString& name) const {
-    const VBentoChar* attribute = dynamic_cast<const VBentoChar*>(this->_findAttribute(name, VBentoChar::DATA_TYPE_ID()));
+    const VBentoChar* attribute = dynamic_cast<const VBentoChar*>(this->_findAttribute(name, VBentoChar::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoChar::DATA_TYPE_ID(), name);
@@ -1790,12 +2772,12 @@ const VCodePoint& VBentoNode::getChar(const VString& name) const {
 }
 
 VDouble VBentoNode::getDouble(const VString& name, VDouble defaultValue) const {
-    const VBentoDouble* attribute = dynamic_cast<const VBentoDouble*>(this->_findAttribute(name, VBentoDouble::DATA_TYPE_ID()));
+    const VBentoDouble* attribute = dynamic_cast<const VBentoDouble*>(this->_findAttribute(name, VBentoDouble::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 VDouble VBentoNode::getDouble(const VString& name) const {
-    const VBentoDouble* attribute = dynamic_cast<const VBentoDouble*>(this->_findAttribute(name, VBentoDouble::DATA_TYPE_ID()));
+    const VBentoDouble* attribute = dynamic_cast<const VBentoDouble*>(this->_findAttribute(name, VBentoDouble::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoDouble::DATA_TYPE_ID(), name);
@@ -1804,12 +2786,12 @@ VDouble VBentoNode::getDouble(const VString& name) const {
 }
 
 const VDuration& VBentoNode::getDuration(const VString& name, const VDuration& defaultValue) const {
-    const VBentoDuration* attribute = dynamic_cast<const VBentoDuration*>(this->_findAttribute(name, VBentoDuration::DATA_TYPE_ID()));
+    const VBentoDuration* attribute = dynamic_cast<const VBentoDuration*>(this->_findAttribute(name, VBentoDuration::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VDuration& VBentoNode::getDuration(const VString& name) const {
-    const VBentoDuration* attribute = dynamic_cast<const VBentoDuration*>(this->_findAttribute(name, VBentoDuration::DATA_TYPE_ID()));
+    const VBentoDuration* attribute = dynamic_cast<const VBentoDuration*>(this->_findAttribute(name, VBentoDuration::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoDuration::DATA_TYPE_ID(), name);
@@ -1818,12 +2800,12 @@ const VDuration& VBentoNode::getDuration(const VString& name) const {
 }
 
 const VInstant& VBentoNode::getInstant(const VString& name, const VInstant& defaultValue) const {
-    const VBentoInstant* attribute = dynamic_cast<const VBentoInstant*>(this->_findAttribute(name, VBentoInstant::DATA_TYPE_ID()));
+    const VBentoInstant* attribute = dynamic_cast<const VBentoInstant*>(this->_findAttribute(name, VBentoInstant::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VInstant& VBentoNode::getInstant(const VString& name) const {
-    const VBentoInstant* attribute = dynamic_cast<const VBentoInstant*>(this->_findAttribute(name, VBentoInstant::DATA_TYPE_ID()));
+    const VBentoInstant* attribute = dynamic_cast<const VBentoInstant*>(this->_findAttribute(name, VBentoInstant::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoInstant::DATA_TYPE_ID(), name);
@@ -1832,12 +2814,12 @@ const VInstant& VBentoNode::getInstant(const VString& name) const {
 }
 
 const VSize& VBentoNode::getSize(const VString& name, const VSize& defaultValue) const {
-    const VBentoSize* attribute = dynamic_cast<const VBentoSize*>(this->_findAttribute(name, VBentoSize::DATA_TYPE_ID()));
+    const VBentoSize* attribute = dynamic_cast<const VBentoSize*>(this->_findAttribute(name, VBentoSize::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VSize& VBentoNode::getSize(const VString& name) const {
-    const VBentoSize* attribute = dynamic_cast<const VBentoSize*>(this->_findAttribute(name, VBentoSize::DATA_TYPE_ID()));
+    const VBentoSize* attribute = dynamic_cast<const VBentoSize*>(this->_findAttribute(name, VBentoSize::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoSize::DATA_TYPE_ID(), name);
@@ -1846,12 +2828,12 @@ const VSize& VBentoNode::getSize(const VString& name) const {
 }
 
 const VISize& VBentoNode::getISize(const VString& name, const VISize& defaultValue) const {
-    const VBentoISize* attribute = dynamic_cast<const VBentoISize*>(this->_findAttribute(name, VBentoISize::DATA_TYPE_ID()));
+    const VBentoISize* attribute = dynamic_cast<const VBentoISize*>(this->_findAttribute(name, VBentoISize::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VISize& VBentoNode::getISize(const VString& name) const {
-    const VBentoISize* attribute = dynamic_cast<const VBentoISize*>(this->_findAttribute(name, VBentoISize::DATA_TYPE_ID()));
+    const VBentoISize* attribute = dynamic_cast<const VBentoISize*>(this->_findAttribute(name, VBentoISize::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoISize::DATA_TYPE_ID(), name);
@@ -1860,12 +2842,12 @@ const VISize& VBentoNode::getISize(const VString& name) const {
 }
 
 const VPoint& VBentoNode::getPoint(const VString& name, const VPoint& defaultValue) const {
-    const VBentoPoint* attribute = dynamic_cast<const VBentoPoint*>(this->_findAttribute(name, VBentoPoint::DATA_TYPE_ID()));
+    const VBentoPoint* attribute = dynamic_cast<const VBentoPoint*>(this->_findAttribute(name, VBentoPoint::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VPoint& VBentoNode::getPoint(const VString& name) const {
-    const VBentoPoint* attribute = dynamic_cast<const VBentoPoint*>(this->_findAttribute(name, VBentoPoint::DATA_TYPE_ID()));
+    const VBentoPoint* attribute = dynamic_cast<const VBentoPoint*>(this->_findAttribute(name, VBentoPoint::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoPoint::DATA_TYPE_ID(), name);
@@ -1874,12 +2856,12 @@ const VPoint& VBentoNode::getPoint(const VString& name) const {
 }
 
 const VIPoint& VBentoNode::getIPoint(const VString& name, const VIPoint& defaultValue) const {
-    const VBentoIPoint* attribute = dynamic_cast<const VBentoIPoint*>(this->_findAttribute(name, VBentoIPoint::DATA_TYPE_ID()));
+    const VBentoIPoint* attribute = dynamic_cast<const VBentoIPoint*>(this->_findAttribute(name, VBentoIPoint::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VIPoint& VBentoNode::getIPoint(const VString& name) const {
-    const VBentoIPoint* attribute = dynamic_cast<const VBentoIPoint*>(this->_findAttribute(name, VBentoIPoint::DATA_TYPE_ID()));
+    const VBentoIPoint* attribute = dynamic_cast<const VBentoIPoint*>(this->_findAttribute(name, VBentoIPoint::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoIPoint::DATA_TYPE_ID(), name);
@@ -1888,12 +2870,12 @@ const VIPoint& VBentoNode::getIPoint(const VString& name) const {
 }
 
 const VPoint3D& VBentoNode::getPoint3D(const VString& name, const VPoint3D& defaultValue) const {
-    const VBentoPoint3D* attribute = dynamic_cast<const VBentoPoint3D*>(this->_findAttribute(name, VBentoPoint3D::DATA_TYPE_ID()));
+    const VBentoPoint3D* attribute = dynamic_cast<const VBentoPoint3D*>(this->_findAttribute(name, VBentoPoint3D::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VPoint3D& VBentoNode::getPoint3D(const VString& name) const {
-    const VBentoPoint3D* attribute = dynamic_cast<const VBentoPoint3D*>(this->_findAttribute(name, VBentoPoint3D::DATA_TYPE_ID()));
+    const VBentoPoint3D* attribute = dynamic_cast<const VBentoPoint3D*>(this->_findAttribute(name, VBentoPoint3D::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoPoint3D::DATA_TYPE_ID(), name);
@@ -1902,12 +2884,12 @@ const VPoint3D& VBentoNode::getPoint3D(const VString& name) const {
 }
 
 const VIPoint3D& VBentoNode::getIPoint3D(const VString& name, const VIPoint3D& defaultValue) const {
-    const VBentoIPoint3D* attribute = dynamic_cast<const VBentoIPoint3D*>(this->_findAttribute(name, VBentoIPoint3D::DATA_TYPE_ID()));
+    const VBentoIPoint3D* attribute = dynamic_cast<const VBentoIPoint3D*>(this->_findAttribute(name, VBentoIPoint3D::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VIPoint3D& VBentoNode::getIPoint3D(const VString& name) const {
-    const VBentoIPoint3D* attribute = dynamic_cast<const VBentoIPoint3D*>(this->_findAttribute(name, VBentoIPoint3D::DATA_TYPE_ID()));
+    const VBentoIPoint3D* attribute = dynamic_cast<const VBentoIPoint3D*>(this->_findAttribute(name, VBentoIPoint3D::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoIPoint3D::DATA_TYPE_ID(), name);
@@ -1916,12 +2898,12 @@ const VIPoint3D& VBentoNode::getIPoint3D(const VString& name) const {
 }
 
 const VLine& VBentoNode::getLine(const VString& name, const VLine& defaultValue) const {
-    const VBentoLine* attribute = dynamic_cast<const VBentoLine*>(this->_findAttribute(name, VBentoLine::DATA_TYPE_ID()));
+    const VBentoLine* attribute = dynamic_cast<const VBentoLine*>(this->_findAttribute(name, VBentoLine::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VLine& VBentoNode::getLine(const VString& name) const {
-    const VBentoLine* attribute = dynamic_cast<const VBentoLine*>(this->_findAttribute(name, VBentoLine::DATA_TYPE_ID()));
+    const VBentoLine* attribute = dynamic_cast<const VBentoLine*>(this->_findAttribute(name, VBentoLine::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoLine::DATA_TYPE_ID(), name);
@@ -1930,12 +2912,12 @@ const VLine& VBentoNode::getLine(const VString& name) const {
 }
 
 const VILine& VBentoNode::getILine(const VString& name, const VILine& defaultValue) const {
-    const VBentoILine* attribute = dynamic_cast<const VBentoILine*>(this->_findAttribute(name, VBentoILine::DATA_TYPE_ID()));
+    const VBentoILine* attribute = dynamic_cast<const VBentoILine*>(this->_findAttribute(name, VBentoILine::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VILine& VBentoNode::getILine(const VString& name) const {
-    const VBentoILine* attribute = dynamic_cast<const VBentoILine*>(this->_findAttribute(name, VBentoILine::DATA_TYPE_ID()));
+    const VBentoILine* attribute = dynamic_cast<const VBentoILine*>(this->_findAttribute(name, VBentoILine::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoILine::DATA_TYPE_ID(), name);
@@ -1944,12 +2926,12 @@ const VILine& VBentoNode::getILine(const VString& name) const {
 }
 
 const VRect& VBentoNode::getRect(const VString& name, const VRect& defaultValue) const {
-    const VBentoRect* attribute = dynamic_cast<const VBentoRect*>(this->_findAttribute(name, VBentoRect::DATA_TYPE_ID()));
+    const VBentoRect* attribute = dynamic_cast<const VBentoRect*>(this->_findAttribute(name, VBentoRect::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VRect& VBentoNode::getRect(const VString& name) const {
-    const VBentoRect* attribute = dynamic_cast<const VBentoRect*>(this->_findAttribute(name, VBentoRect::DATA_TYPE_ID()));
+    const VBentoRect* attribute = dynamic_cast<const VBentoRect*>(this->_findAttribute(name, VBentoRect::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoRect::DATA_TYPE_ID(), name);
@@ -1958,12 +2940,12 @@ const VRect& VBentoNode::getRect(const VString& name) const {
 }
 
 const VIRect& VBentoNode::getIRect(const VString& name, const VIRect& defaultValue) const {
-    const VBentoIRect* attribute = dynamic_cast<const VBentoIRect*>(this->_findAttribute(name, VBentoIRect::DATA_TYPE_ID()));
+    const VBentoIRect* attribute = dynamic_cast<const VBentoIRect*>(this->_findAttribute(name, VBentoIRect::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VIRect& VBentoNode::getIRect(const VString& name) const {
-    const VBentoIRect* attribute = dynamic_cast<const VBentoIRect*>(this->_findAttribute(name, VBentoIRect::DATA_TYPE_ID()));
+    const VBentoIRect* attribute = dynamic_cast<const VBentoIRect*>(this->_findAttribute(name, VBentoIRect::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoIRect::DATA_TYPE_ID(), name);
@@ -1972,12 +2954,12 @@ const VIRect& VBentoNode::getIRect(const VString& name) const {
 }
 
 const VPolygon& VBentoNode::getPolygon(const VString& name, const VPolygon& defaultValue) const {
-    const VBentoPolygon* attribute = dynamic_cast<const VBentoPolygon*>(this->_findAttribute(name, VBentoPolygon::DATA_TYPE_ID()));
+    const VBentoPolygon* attribute = dynamic_cast<const VBentoPolygon*>(this->_findAttribute(name, VBentoPolygon::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VPolygon& VBentoNode::getPolygon(const VString& name) const {
-    const VBentoPolygon* attribute = dynamic_cast<const VBentoPolygon*>(this->_findAttribute(name, VBentoPolygon::DATA_TYPE_ID()));
+    const VBentoPolygon* attribute = dynamic_cast<const VBentoPolygon*>(this->_findAttribute(name, VBentoPolygon::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoPolygon::DATA_TYPE_ID(), name);
@@ -1986,12 +2968,12 @@ const VPolygon& VBentoNode::getPolygon(const VString& name) const {
 }
 
 const VIPolygon& VBentoNode::getIPolygon(const VString& name, const VIPolygon& defaultValue) const {
-    const VBentoIPolygon* attribute = dynamic_cast<const VBentoIPolygon*>(this->_findAttribute(name, VBentoIPolygon::DATA_TYPE_ID()));
+    const VBentoIPolygon* attribute = dynamic_cast<const VBentoIPolygon*>(this->_findAttribute(name, VBentoIPolygon::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VIPolygon& VBentoNode::getIPolygon(const VString& name) const {
-    const VBentoIPolygon* attribute = dynamic_cast<const VBentoIPolygon*>(this->_findAttribute(name, VBentoIPolygon::DATA_TYPE_ID()));
+    const VBentoIPolygon* attribute = dynamic_cast<const VBentoIPolygon*>(this->_findAttribute(name, VBentoIPolygon::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoIPolygon::DATA_TYPE_ID(), name);
@@ -2000,12 +2982,12 @@ const VIPolygon& VBentoNode::getIPolygon(const VString& name) const {
 }
 
 const VColor& VBentoNode::getColor(const VString& name, const VColor& defaultValue) const {
-    const VBentoColor* attribute = dynamic_cast<const VBentoColor*>(this->_findAttribute(name, VBentoColor::DATA_TYPE_ID()));
+    const VBentoColor* attribute = dynamic_cast<const VBentoColor*>(this->_findAttribute(name, VBentoColor::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VColor& VBentoNode::getColor(const VString& name) const {
-    const VBentoColor* attribute = dynamic_cast<const VBentoColor*>(this->_findAttribute(name, VBentoColor::DATA_TYPE_ID()));
+    const VBentoColor* attribute = dynamic_cast<const VBentoColor*>(this->_findAttribute(name, VBentoColor::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoColor::DATA_TYPE_ID(), name);
@@ -2014,12 +2996,12 @@ const VColor& VBentoNode::getColor(const VString& name) const {
 }
 
 Vs8 VBentoNode::getS8(const VString& name, Vs8 defaultValue) const {
-    const VBentoS8* attribute = dynamic_cast<const VBentoS8*>(this->_findAttribute(name, VBentoS8::DATA_TYPE_ID()));
+    const VBentoS8* attribute = dynamic_cast<const VBentoS8*>(this->_findAttribute(name, VBentoS8::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 Vs8 VBentoNode::getS8(const VString& name) const {
-    const VBentoS8* attribute = dynamic_cast<const VBentoS8*>(this->_findAttribute(name, VBentoS8::DATA_TYPE_ID()));
+    const VBentoS8* attribute = dynamic_cast<const VBentoS8*>(this->_findAttribute(name, VBentoS8::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoS8::DATA_TYPE_ID(), name);
@@ -2028,12 +3010,12 @@ Vs8 VBentoNode::getS8(const VString& name) const {
 }
 
 Vu8 VBentoNode::getU8(const VString& name, Vu8 defaultValue) const {
-    const VBentoU8* attribute = dynamic_cast<const VBentoU8*>(this->_findAttribute(name, VBentoU8::DATA_TYPE_ID()));
+    const VBentoU8* attribute = dynamic_cast<const VBentoU8*>(this->_findAttribute(name, VBentoU8::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 Vu8 VBentoNode::getU8(const VString& name) const {
-    const VBentoU8* attribute = dynamic_cast<const VBentoU8*>(this->_findAttribute(name, VBentoU8::DATA_TYPE_ID()));
+    const VBentoU8* attribute = dynamic_cast<const VBentoU8*>(this->_findAttribute(name, VBentoU8::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoU8::DATA_TYPE_ID(), name);
@@ -2042,12 +3024,12 @@ Vu8 VBentoNode::getU8(const VString& name) const {
 }
 
 Vs16 VBentoNode::getS16(const VString& name, Vs16 defaultValue) const {
-    const VBentoS16* attribute = dynamic_cast<const VBentoS16*>(this->_findAttribute(name, VBentoS16::DATA_TYPE_ID()));
+    const VBentoS16* attribute = dynamic_cast<const VBentoS16*>(this->_findAttribute(name, VBentoS16::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 Vs16 VBentoNode::getS16(const VString& name) const {
-    const VBentoS16* attribute = dynamic_cast<const VBentoS16*>(this->_findAttribute(name, VBentoS16::DATA_TYPE_ID()));
+    const VBentoS16* attribute = dynamic_cast<const VBentoS16*>(this->_findAttribute(name, VBentoS16::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoS16::DATA_TYPE_ID(), name);
@@ -2056,12 +3038,12 @@ Vs16 VBentoNode::getS16(const VString& name) const {
 }
 
 Vu16 VBentoNode::getU16(const VString& name, Vu16 defaultValue) const {
-    const VBentoU16* attribute = dynamic_cast<const VBentoU16*>(this->_findAttribute(name, VBentoU16::DATA_TYPE_ID()));
+    const VBentoU16* attribute = dynamic_cast<const VBentoU16*>(this->_findAttribute(name, VBentoU16::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 Vu16 VBentoNode::getU16(const VString& name) const {
-    const VBentoU16* attribute = dynamic_cast<const VBentoU16*>(this->_findAttribute(name, VBentoU16::DATA_TYPE_ID()));
+    const VBentoU16* attribute = dynamic_cast<const VBentoU16*>(this->_findAttribute(name, VBentoU16::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoU16::DATA_TYPE_ID(), name);
@@ -2070,12 +3052,12 @@ Vu16 VBentoNode::getU16(const VString& name) const {
 }
 
 Vs32 VBentoNode::getS32(const VString& name, Vs32 defaultValue) const {
-    const VBentoS32* attribute = dynamic_cast<const VBentoS32*>(this->_findAttribute(name, VBentoS32::DATA_TYPE_ID()));
+    const VBentoS32* attribute = dynamic_cast<const VBentoS32*>(this->_findAttribute(name, VBentoS32::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 Vs32 VBentoNode::getS32(const VString& name) const {
-    const VBentoS32* attribute = dynamic_cast<const VBentoS32*>(this->_findAttribute(name, VBentoS32::DATA_TYPE_ID()));
+    const VBentoS32* attribute = dynamic_cast<const VBentoS32*>(this->_findAttribute(name, VBentoS32::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoS32::DATA_TYPE_ID(), name);
@@ -2084,12 +3066,12 @@ Vs32 VBentoNode::getS32(const VString& name) const {
 }
 
 Vu32 VBentoNode::getU32(const VString& name, Vu32 defaultValue) const {
-    const VBentoU32* attribute = dynamic_cast<const VBentoU32*>(this->_findAttribute(name, VBentoU32::DATA_TYPE_ID()));
+    const VBentoU32* attribute = dynamic_cast<const VBentoU32*>(this->_findAttribute(name, VBentoU32::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 Vu32 VBentoNode::getU32(const VString& name) const {
-    const VBentoU32* attribute = dynamic_cast<const VBentoU32*>(this->_findAttribute(name, VBentoU32::DATA_TYPE_ID()));
+    const VBentoU32* attribute = dynamic_cast<const VBentoU32*>(this->_findAttribute(name, VBentoU32::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoU32::DATA_TYPE_ID(), name);
@@ -2098,12 +3080,12 @@ Vu32 VBentoNode::getU32(const VString& name) const {
 }
 
 Vs64 VBentoNode::getS64(const VString& name, Vs64 defaultValue) const {
-    const VBentoS64* attribute = dynamic_cast<const VBentoS64*>(this->_findAttribute(name, VBentoS64::DATA_TYPE_ID()));
+    const VBentoS64* attribute = dynamic_cast<const VBentoS64*>(this->_findAttribute(name, VBentoS64::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 Vs64 VBentoNode::getS64(const VString& name) const {
-    const VBentoS64* attribute = dynamic_cast<const VBentoS64*>(this->_findAttribute(name, VBentoS64::DATA_TYPE_ID()));
+    const VBentoS64* attribute = dynamic_cast<const VBentoS64*>(this->_findAttribute(name, VBentoS64::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoS64::DATA_TYPE_ID(), name);
@@ -2112,12 +3094,12 @@ Vs64 VBentoNode::getS64(const VString& name) const {
 }
 
 Vu64 VBentoNode::getU64(const VString& name, Vu64 defaultValue) const {
-    const VBentoU64* attribute = dynamic_cast<const VBentoU64*>(this->_findAttribute(name, VBentoU64::DATA_TYPE_ID()));
+    const VBentoU64* attribute = dynamic_cast<const VBentoU64*>(this->_findAttribute(name, VBentoU64::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 Vu64 VBentoNode::getU64(const VString& name) const {
-    const VBentoU64* attribute = dynamic_cast<const VBentoU64*>(this->_findAttribute(name, VBentoU64::DATA_TYPE_ID()));
+    const VBentoU64* attribute = dynamic_cast<const VBentoU64*>(this->_findAttribute(name, VBentoU64::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoU64::DATA_TYPE_ID(), name);
@@ -2126,12 +3108,12 @@ Vu64 VBentoNode::getU64(const VString& name) const {
 }
 
 VFloat VBentoNode::getFloat(const VString& name, VFloat defaultValue) const {
-    const VBentoFloat* attribute = dynamic_cast<const VBentoFloat*>(this->_findAttribute(name, VBentoFloat::DATA_TYPE_ID()));
+    const VBentoFloat* attribute = dynamic_cast<const VBentoFloat*>(this->_findAttribute(name, VBentoFloat::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 VFloat VBentoNode::getFloat(const VString& name) const {
-    const VBentoFloat* attribute = dynamic_cast<const VBentoFloat*>(this->_findAttribute(name, VBentoFloat::DATA_TYPE_ID()));
+    const VBentoFloat* attribute = dynamic_cast<const VBentoFloat*>(this->_findAttribute(name, VBentoFloat::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoFloat::DATA_TYPE_ID(), name);
@@ -2140,7 +3122,7 @@ VFloat VBentoNode::getFloat(const VString& name) const {
 }
 
 bool VBentoNode::getBinary(const VString& name, VReadOnlyMemoryStream& returnedReader) const {
-    const VBentoBinary* attribute = dynamic_cast<const VBentoBinary*>(this->_findAttribute(name, VBentoBinary::DATA_TYPE_ID()));
+    const VBentoBinary* attribute = dynamic_cast<const VBentoBinary*>(this->_findAttribute(name, VBentoBinary::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         return false;
@@ -2150,7 +3132,7 @@ bool VBentoNode::getBinary(const VString& name, VReadOnlyMemoryStream& returnedR
 }
 
 VReadOnlyMemoryStream VBentoNode::getBinary(const VString& name) const {
-    const VBentoBinary* attribute = dynamic_cast<const VBentoBinary*>(this->_findAttribute(name, VBentoBinary::DATA_TYPE_ID()));
+    const VBentoBinary* attribute = dynamic_cast<const VBentoBinary*>(this->_findAttribute(name, VBentoBinary::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoBinary::DATA_TYPE_ID(), name);
@@ -2159,12 +3141,12 @@ VReadOnlyMemoryStream VBentoNode::getBinary(const VString& name) const {
 }
 
 const Vs8Array& VBentoNode::getS8Array(const VString& name, const Vs8Array& defaultValue) const {
-    const VBentoS8Array* attribute = dynamic_cast<const VBentoS8Array*>(this->_findAttribute(name, VBentoS8Array::DATA_TYPE_ID()));
+    const VBentoS8Array* attribute = dynamic_cast<const VBentoS8Array*>(this->_findAttribute(name, VBentoS8Array::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const Vs8Array& VBentoNode::getS8Array(const VString& name) const {
-    const VBentoS8Array* attribute = dynamic_cast<const VBentoS8Array*>(this->_findAttribute(name, VBentoS8Array::DATA_TYPE_ID()));
+    const VBentoS8Array* attribute = dynamic_cast<const VBentoS8Array*>(this->_findAttribute(name, VBentoS8Array::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoS8Array::DATA_TYPE_ID(), name);
@@ -2173,12 +3155,12 @@ const Vs8Array& VBentoNode::getS8Array(const VString& name) const {
 }
 
 const Vs16Array& VBentoNode::getS16Array(const VString& name, const Vs16Array& defaultValue) const {
-    const VBentoS16Array* attribute = dynamic_cast<const VBentoS16Array*>(this->_findAttribute(name, VBentoS16Array::DATA_TYPE_ID()));
+    const VBentoS16Array* attribute = dynamic_cast<const VBentoS16Array*>(this->_findAttribute(name, VBentoS16Array::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const Vs16Array& VBentoNode::getS16Array(const VString& name) const {
-    const VBentoS16Array* attribute = dynamic_cast<const VBentoS16Array*>(this->_findAttribute(name, VBentoS16Array::DATA_TYPE_ID()));
+    const VBentoS16Array* attribute = dynamic_cast<const VBentoS16Array*>(this->_findAttribute(name, VBentoS16Array::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoS16Array::DATA_TYPE_ID(), name);
@@ -2187,12 +3169,12 @@ const Vs16Array& VBentoNode::getS16Array(const VString& name) const {
 }
 
 const Vs32Array& VBentoNode::getS32Array(const VString& name, const Vs32Array& defaultValue) const {
-    const VBentoS32Array* attribute = dynamic_cast<const VBentoS32Array*>(this->_findAttribute(name, VBentoS32Array::DATA_TYPE_ID()));
+    const VBentoS32Array* attribute = dynamic_cast<const VBentoS32Array*>(this->_findAttribute(name, VBentoS32Array::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const Vs32Array& VBentoNode::getS32Array(const VString& name) const {
-    const VBentoS32Array* attribute = dynamic_cast<const VBentoS32Array*>(this->_findAttribute(name, VBentoS32Array::DATA_TYPE_ID()));
+    const VBentoS32Array* attribute = dynamic_cast<const VBentoS32Array*>(this->_findAttribute(name, VBentoS32Array::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoS32Array::DATA_TYPE_ID(), name);
@@ -2201,12 +3183,12 @@ const Vs32Array& VBentoNode::getS32Array(const VString& name) const {
 }
 
 const Vs64Array& VBentoNode::getS64Array(const VString& name, const Vs64Array& defaultValue) const {
-    const VBentoS64Array* attribute = dynamic_cast<const VBentoS64Array*>(this->_findAttribute(name, VBentoS64Array::DATA_TYPE_ID()));
+    const VBentoS64Array* attribute = dynamic_cast<const VBentoS64Array*>(this->_findAttribute(name, VBentoS64Array::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const Vs64Array& VBentoNode::getS64Array(const VString& name) const {
-    const VBentoS64Array* attribute = dynamic_cast<const VBentoS64Array*>(this->_findAttribute(name, VBentoS64Array::DATA_TYPE_ID()));
+    const VBentoS64Array* attribute = dynamic_cast<const VBentoS64Array*>(this->_findAttribute(name, VBentoS64Array::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoS64Array::DATA_TYPE_ID(), name);
@@ -2215,7 +3197,7 @@ const Vs64Array& VBentoNode::getS64Array(const VString& name) const {
 }
 
 const VStringVector& VBentoNode::getStringArray(const VString& name, const VStringVector& defaultValue) const {
-    const VBentoStringArray* attribute = dynamic_cast<const VBentoStringArray*>(this->_findAttribute(name, VBentoStringArray::DATA_TYPE_ID()));
+    const VBentoStringArray* attribute = dynamic_cast<const VBentoStringArray*>(this->_findAttribute(name, VBentoStringArray::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         return defaultValue;
@@ -2224,7 +3206,7 @@ const VStringVector& VBentoNode::getStringArray(const VString& name, const VStri
 }
 
 const VStringVector& VBentoNode::getStringArray(const VString& name) const {
-    const VBentoStringArray* attribute = dynamic_cast<const VBentoStringArray*>(this->_findAttribute(name, VBentoStringArray::DATA_TYPE_ID()));
+    const VBentoStringArray* attribute = dynamic_cast<const VBentoStringArray*>(this->_findAttribute(name, VBentoStringArray::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoStringArray::DATA_TYPE_ID(), name);
@@ -2233,12 +3215,12 @@ const VStringVector& VBentoNode::getStringArray(const VString& name) const {
 }
 
 const VBoolArray& VBentoNode::getBoolArray(const VString& name, const VBoolArray& defaultValue) const {
-    const VBentoBoolArray* attribute = dynamic_cast<const VBentoBoolArray*>(this->_findAttribute(name, VBentoBoolArray::DATA_TYPE_ID()));
+    const VBentoBoolArray* attribute = dynamic_cast<const VBentoBoolArray*>(this->_findAttribute(name, VBentoBoolArray::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VBoolArray& VBentoNode::getBoolArray(const VString& name) const {
-    const VBentoBoolArray* attribute = dynamic_cast<const VBentoBoolArray*>(this->_findAttribute(name, VBentoBoolArray::DATA_TYPE_ID()));
+    const VBentoBoolArray* attribute = dynamic_cast<const VBentoBoolArray*>(this->_findAttribute(name, VBentoBoolArray::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoBoolArray::DATA_TYPE_ID(), name);
@@ -2247,12 +3229,12 @@ const VBoolArray& VBentoNode::getBoolArray(const VString& name) const {
 }
 
 const VDoubleArray& VBentoNode::getDoubleArray(const VString& name, const VDoubleArray& defaultValue) const {
-    const VBentoDoubleArray* attribute = dynamic_cast<const VBentoDoubleArray*>(this->_findAttribute(name, VBentoDoubleArray::DATA_TYPE_ID()));
+    const VBentoDoubleArray* attribute = dynamic_cast<const VBentoDoubleArray*>(this->_findAttribute(name, VBentoDoubleArray::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VDoubleArray& VBentoNode::getDoubleArray(const VString& name) const {
-    const VBentoDoubleArray* attribute = dynamic_cast<const VBentoDoubleArray*>(this->_findAttribute(name, VBentoDoubleArray::DATA_TYPE_ID()));
+    const VBentoDoubleArray* attribute = dynamic_cast<const VBentoDoubleArray*>(this->_findAttribute(name, VBentoDoubleArray::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoDoubleArray::DATA_TYPE_ID(), name);
@@ -2261,12 +3243,12 @@ const VDoubleArray& VBentoNode::getDoubleArray(const VString& name) const {
 }
 
 const VDurationVector& VBentoNode::getDurationArray(const VString& name, const VDurationVector& defaultValue) const {
-    const VBentoDurationArray* attribute = dynamic_cast<const VBentoDurationArray*>(this->_findAttribute(name, VBentoDurationArray::DATA_TYPE_ID()));
+    const VBentoDurationArray* attribute = dynamic_cast<const VBentoDurationArray*>(this->_findAttribute(name, VBentoDurationArray::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VDurationVector& VBentoNode::getDurationArray(const VString& name) const {
-    const VBentoDurationArray* attribute = dynamic_cast<const VBentoDurationArray*>(this->_findAttribute(name, VBentoDurationArray::DATA_TYPE_ID()));
+    const VBentoDurationArray* attribute = dynamic_cast<const VBentoDurationArray*>(this->_findAttribute(name, VBentoDurationArray::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoDurationArray::DATA_TYPE_ID(), name);
@@ -2275,12 +3257,12 @@ const VDurationVector& VBentoNode::getDurationArray(const VString& name) const {
 }
 
 const VInstantVector& VBentoNode::getInstantArray(const VString& name, const VInstantVector& defaultValue) const {
-    const VBentoInstantArray* attribute = dynamic_cast<const VBentoInstantArray*>(this->_findAttribute(name, VBentoInstantArray::DATA_TYPE_ID()));
+    const VBentoInstantArray* attribute = dynamic_cast<const VBentoInstantArray*>(this->_findAttribute(name, VBentoInstantArray::DATA_TYPE_ATOM()));
     return (attribute == NULL) ? defaultValue : attribute->getValue();
 }
 
 const VInstantVector& VBentoNode::getInstantArray(const VString& name) const {
-    const VBentoInstantArray* attribute = dynamic_cast<const VBentoInstantArray*>(this->_findAttribute(name, VBentoInstantArray::DATA_TYPE_ID()));
+    const VBentoInstantArray* attribute = dynamic_cast<const VBentoInstantArray*>(this->_findAttribute(name, VBentoInstantArray::DATA_TYPE_ATOM()));
 
     if (attribute == NULL)
         throw VBentoNotFoundException(VBentoInstantArray::DATA_TYPE_ID(), name);
@@ -2289,7 +3271,7 @@ const VInstantVector& VBentoNode::getInstantArray(const VString& name) const {
 }
 
 void VBentoNode::setInt(const VString& name, int value) {
-    VBentoS32* attribute = dynamic_cast<VBentoS32*>(this->_findMutableAttribute(name, VBentoS32::DATA_TYPE_ID()));
+    VBentoS32* attribute = dynamic_cast<VBentoS32*>(this->_findMutableAttribute(name, VBentoS32::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addInt(name, value);
     else
@@ -2297,7 +3279,7 @@ void VBentoNode::setInt(const VString& name, int value) {
 }
 
 void VBentoNode::setBool(const VString& name, bool value) {
-    VBentoBool* attribute = dynamic_cast<VBentoBool*>(this->_findMutableAttribute(name, VBentoBool::DATA_TYPE_ID()));
+    VBentoBool* attribute = dynamic_cast<VBentoBool*>(this->_findMutableAttribute(name, VBentoBool::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addBool(name, value);
     else
@@ -2305,7 +3287,7 @@ void VBentoNode::setBool(const VString& name, bool value) {
 }
 
 void VBentoNode::setString(const VString& name, const VString& value, const VString& encoding) {
-    VBentoString* attribute = dynamic_cast<VBentoString*>(this->_findMutableAttribute(name, VBentoString::DATA_TYPE_ID()));
+    VBentoString* attribute = dynamic_cast<VBentoString*>(this->_findMutableAttribute(name, VBentoString::DATA_TYPE_ATOM()));
     if (attribute == NULL) {
         this->addString(name, value, encoding);
     } else {
@@ -2315,7 +3297,7 @@ void VBentoNode::setString(const VString& name, const VString& value, const VStr
 }
 
 void VBentoNode::setChar(const VString& name, const VCodePoint& value) {
-    VBentoChar* attribute = dynamic_cast<VBentoChar*>(this->_findMutableAttribute(name, VBentoChar::DATA_TYPE_ID()));
+    VBentoChar* attribute = dynamic_cast<VBentoChar*>(this->_findMutableAttribute(name, VBentoChar::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addChar(name, value);
     else
@@ -2323,7 +3305,7 @@ void VBentoNode::setChar(const VString& name, const VCodePoint& value) {
 }
 
 void VBentoNode::setDouble(const VString& name, VDouble value) {
-    VBentoDouble* attribute = dynamic_cast<VBentoDouble*>(this->_findMutableAttribute(name, VBentoDouble::DATA_TYPE_ID()));
+    VBentoDouble* attribute = dynamic_cast<VBentoDouble*>(this->_findMutableAttribute(name, VBentoDouble::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addDouble(name, value);
     else
@@ -2331,7 +3313,7 @@ void VBentoNode::setDouble(const VString& name, VDouble value) {
 }
 
 void VBentoNode::setDuration(const VString& name, const VDuration& value) {
-    VBentoDuration* attribute = dynamic_cast<VBentoDuration*>(this->_findMutableAttribute(name, VBentoDuration::DATA_TYPE_ID()));
+    VBentoDuration* attribute = dynamic_cast<VBentoDuration*>(this->_findMutableAttribute(name, VBentoDuration::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addDuration(name, value);
     else
@@ -2339,7 +3321,7 @@ void VBentoNode::setDuration(const VString& name, const VDuration& value) {
 }
 
 void VBentoNode::setInstant(const VString& name, const VInstant& value) {
-    VBentoInstant* attribute = dynamic_cast<VBentoInstant*>(this->_findMutableAttribute(name, VBentoInstant::DATA_TYPE_ID()));
+    VBentoInstant* attribute = dynamic_cast<VBentoInstant*>(this->_findMutableAttribute(name, VBentoInstant::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addInstant(name, value);
     else
@@ -2347,7 +3329,7 @@ void VBentoNode::setInstant(const VString& name, const VInstant& value) {
 }
 
 void VBentoNode::setSize(const VString& name, const VSize& value) {
-    VBentoSize* attribute = dynamic_cast<VBentoSize*>(this->_findMutableAttribute(name, VBentoSize::DATA_TYPE_ID()));
+    VBentoSize* attribute = dynamic_cast<VBentoSize*>(this->_findMutableAttribute(name, VBentoSize::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addSize(name, value);
     else
@@ -2355,7 +3337,7 @@ void VBentoNode::setSize(const VString& name, const VSize& value) {
 }
 
 void VBentoNode::setISize(const VString& name, const VISize& value) {
-    VBentoISize* attribute = dynamic_cast<VBentoISize*>(this->_findMutableAttribute(name, VBentoISize::DATA_TYPE_ID()));
+    VBentoISize* attribute = dynamic_cast<VBentoISize*>(this->_findMutableAttribute(name, VBentoISize::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addISize(name, value);
     else
@@ -2363,7 +3345,7 @@ void VBentoNode::setISize(const VString& name, const VISize& value) {
 }
 
 void VBentoNode::setPoint(const VString& name, const VPoint& value) {
-    VBentoPoint* attribute = dynamic_cast<VBentoPoint*>(this->_findMutableAttribute(name, VBentoPoint::DATA_TYPE_ID()));
+    VBentoPoint* attribute = dynamic_cast<VBentoPoint*>(this->_findMutableAttribute(name, VBentoPoint::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addPoint(name, value);
     else
@@ -2371,7 +3353,7 @@ void VBentoNode::setPoint(const VString& name, const VPoint& value) {
 }
 
 void VBentoNode::setIPoint(const VString& name, const VIPoint& value) {
-    VBentoIPoint* attribute = dynamic_cast<VBentoIPoint*>(this->_findMutableAttribute(name, VBentoIPoint::DATA_TYPE_ID()));
+    VBentoIPoint* attribute = dynamic_cast<VBentoIPoint*>(this->_findMutableAttribute(name, VBentoIPoint::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addIPoint(name, value);
     else
@@ -2379,7 +3361,7 @@ void VBentoNode::setIPoint(const VString& name, const VIPoint& value) {
 }
 
 void VBentoNode::setPoint3D(const VString& name, const VPoint3D& value) {
-    VBentoPoint3D* attribute = dynamic_cast<VBentoPoint3D*>(this->_findMutableAttribute(name, VBentoPoint3D::DATA_TYPE_ID()));
+    VBentoPoint3D* attribute = dynamic_cast<VBentoPoint3D*>(this->_findMutableAttribute(name, VBentoPoint3D::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addPoint3D(name, value);
     else
@@ -2387,7 +3369,7 @@ void VBentoNode::setPoint3D(const VString& name, const VPoint3D& value) {
 }
 
 void VBentoNode::setIPoint3D(const VString& name, const VIPoint3D& value) {
-    VBentoIPoint3D* attribute = dynamic_cast<VBentoIPoint3D*>(this->_findMutableAttribute(name, VBentoIPoint3D::DATA_TYPE_ID()));
+    VBentoIPoint3D* attribute = dynamic_cast<VBentoIPoint3D*>(this->_findMutableAttribute(name, VBentoIPoint3D::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addIPoint3D(name, value);
     else
@@ -2395,7 +3377,7 @@ void VBentoNode::setIPoint3D(const VString& name, const VIPoint3D& value) {
 }
 
 void VBentoNode::setLine(const VString& name, const VLine& value) {
-    VBentoLine* attribute = dynamic_cast<VBentoLine*>(this->_findMutableAttribute(name, VBentoLine::DATA_TYPE_ID()));
+    VBentoLine* attribute = dynamic_cast<VBentoLine*>(this->_findMutableAttribute(name, VBentoLine::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addLine(name, value);
     else
@@ -2403,7 +3385,7 @@ void VBentoNode::setLine(const VString& name, const VLine& value) {
 }
 
 void VBentoNode::setILine(const VString& name, const VILine& value) {
-    VBentoILine* attribute = dynamic_cast<VBentoILine*>(this->_findMutableAttribute(name, VBentoILine::DATA_TYPE_ID()));
+    VBentoILine* attribute = dynamic_cast<VBentoILine*>(this->_findMutableAttribute(name, VBentoILine::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addILine(name, value);
     else
@@ -2411,7 +3393,7 @@ void VBentoNode::setILine(const VString& name, const VILine& value) {
 }
 
 void VBentoNode::setRect(const VString& name, const VRect& value) {
-    VBentoRect* attribute = dynamic_cast<VBentoRect*>(this->_findMutableAttribute(name, VBentoRect::DATA_TYPE_ID()));
+    VBentoRect* attribute = dynamic_cast<VBentoRect*>(this->_findMutableAttribute(name, VBentoRect::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addRect(name, value);
     else
@@ -2419,7 +3401,7 @@ void VBentoNode::setRect(const VString& name, const VRect& value) {
 }
 
 void VBentoNode::setIRect(const VString& name, const VIRect& value) {
-    VBentoIRect* attribute = dynamic_cast<VBentoIRect*>(this->_findMutableAttribute(name, VBentoIRect::DATA_TYPE_ID()));
+    VBentoIRect* attribute = dynamic_cast<VBentoIRect*>(this->_findMutableAttribute(name, VBentoIRect::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addIRect(name, value);
     else
@@ -2427,7 +3409,7 @@ void VBentoNode::setIRect(const VString& name, const VIRect& value) {
 }
 
 void VBentoNode::setPolygon(const VString& name, const VPolygon& value) {
-    VBentoPolygon* attribute = dynamic_cast<VBentoPolygon*>(this->_findMutableAttribute(name, VBentoPolygon::DATA_TYPE_ID()));
+    VBentoPolygon* attribute = dynamic_cast<VBentoPolygon*>(this->_findMutableAttribute(name, VBentoPolygon::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addPolygon(name, value);
     else
@@ -2435,7 +3417,7 @@ void VBentoNode::setPolygon(const VString& name, const VPolygon& value) {
 }
 
 void VBentoNode::setIPolygon(const VString& name, const VIPolygon& value) {
-    VBentoIPolygon* attribute = dynamic_cast<VBentoIPolygon*>(this->_findMutableAttribute(name, VBentoIPolygon::DATA_TYPE_ID()));
+    VBentoIPolygon* attribute = dynamic_cast<VBentoIPolygon*>(this->_findMutableAttribute(name, VBentoIPolygon::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addIPolygon(name, value);
     else
@@ -2443,7 +3425,7 @@ void VBentoNode::setIPolygon(const VString& name, const VIPolygon& value) {
 }
 
 void VBentoNode::setColor(const VString& name, const VColor& value) {
-    VBentoColor* attribute = dynamic_cast<VBentoColor*>(this->_findMutableAttribute(name, VBentoColor::DATA_TYPE_ID()));
+    VBentoColor* attribute = dynamic_cast<VBentoColor*>(this->_findMutableAttribute(name, VBentoColor::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addColor(name, value);
     else
@@ -2451,7 +3433,7 @@ void VBentoNode::setColor(const VString& name, const VColor& value) {
 }
 
 void VBentoNode::setS64(const VString& name, Vs64 value) {
-    VBentoS64* attribute = dynamic_cast<VBentoS64*>(this->_findMutableAttribute(name, VBentoS64::DATA_TYPE_ID()));
+    VBentoS64* attribute = dynamic_cast<VBentoS64*>(this->_findMutableAttribute(name, VBentoS64::DATA_TYPE_ATOM()));
     if (attribute == NULL)
         this->addS64(name, value);
     else
@@ -2470,53 +3452,26 @@ void VBentoNode::setName(const VString& name) {
     mName = name;
 }
 
-void VBentoNode::writeToXMLTextStream(VTextIOStream& stream, bool lineWrap, int indentDepth) const {
-    _indentIfRequested(stream, lineWrap, indentDepth);
-    stream.writeString("<");
-    stream.writeString(mName);
-
-    bool hasArrayAttributes = false;
-    for (VBentoAttributePtrVector::const_iterator i = mAttributes.begin(); i != mAttributes.end(); ++i) {
-        if ((*i)->xmlAppearsAsArray()) {
-            hasArrayAttributes = true;
-        } else {
-            stream.writeString(" ");
-            (*i)->writeToXMLTextStream(stream, lineWrap, indentDepth + 1);
-        }
-    }
-
-    if (hasArrayAttributes || (mChildNodes.size() != 0)) {
-        stream.writeString(">"); // leave tag open for array/child elements
-    } else {
-        stream.writeString("/>"); // close tag, we're all done
-    }
-
-    _lineEndIfRequested(stream, lineWrap);
-
-    // Write any array attributes as child xml nodes.
-    for (VBentoAttributePtrVector::const_iterator i = mAttributes.begin(); i != mAttributes.end(); ++i) {
-        if ((*i)->xmlAppearsAsArray()) {
-            (*i)->writeToXMLTextStream(stream, lineWrap, indentDepth + 1);
-        }
-    }
-
-    // Write child nodes as child xml nodes.
-    for (VBentoNodePtrVector::const_iterator i = mChildNodes.begin(); i != mChildNodes.end(); ++i) {
-        (*i)->writeToXMLTextStream(stream, lineWrap, indentDepth + 1);
-    }
+void VBentoNode::writeToXMLTextStream(VTextIOStream& stream, bool lineWrap, int indentDepth, int maxDepth, int maxLength) const {
+    VBentoTextRenderer renderer(stream, lineWrap, maxDepth, maxLength);
+    renderer.reserve(this->_calculateContentSize());
+    renderer.renderXML(*this, indentDepth);
+    renderer.finish();
+}
 
-    // Close the tag if we left it open for child xml nodes.
-    if (hasArrayAttributes || (mChildNodes.size() != 0)) {
-        _writeLineItemToStream(stream, lineWrap, indentDepth, VSTRING_FORMAT("</%s>", mName.chars()));
-    }
+void VBentoNode::appendToXMLTextString(VString& s, bool lineWrap, int maxDepth, int maxLength) const {
+    VBentoTextRenderer renderer(s, lineWrap, maxDepth, maxLength);
+    renderer.reserve(this->_calculateContentSize() * 2); // XML repeats each closing tag name.
+    renderer.renderXML(*this, 0);
+    renderer.finish();
 }
 
-void VBentoNode::printXML() const {
+void VBentoNode::printXML(int maxDepth, int maxLength) const {
     try {
         VBufferedFileStream    stdoutStream(stdout, false/*don't close on destruct*/);
         VTextIOStream        printStream(stdoutStream, VTextIOStream::kUseUnixLineEndings);
 
-        this->writeToXMLTextStream(printStream);
+        this->writeToXMLTextStream(printStream, false, 0, maxDepth, maxLength);
 
         stdoutStream.flush();
     } catch (const VException& ex) {
@@ -2524,26 +3479,13 @@ void VBentoNode::printXML() const {
     }
 }
 
-void VBentoNode::printHexDump(VHex& hexDump) const {
+void VBentoNode::printHexDump(VHex& hexDump, Vs64 maxLength) const {
+    // One scratch buffer serves the whole hierarchy; each part is printed as a separate hex row group as before.
     VMemoryStream   buffer;
     VBinaryIOStream stream(buffer);
+    Vs64            numBytesRemaining = (maxLength < 0) ? V_MAX_S64 : maxLength;
 
-    VSizeType   numAttributes = mAttributes.size();
-    VSizeType   numChildNodes = mChildNodes.size();
-    Vs64        totalSize = this->_calculateContentSize();
-
-    VBentoNode::_writeLengthToStream(stream, totalSize);
-    stream.writeSize32(numAttributes);
-    stream.writeSize32(numChildNodes);
-    stream.writeString(mName);
-
-    hexDump.printHex(buffer.getBuffer(), buffer.getEOFOffset());
-
-    for (VSizeType i = 0; i < numAttributes; ++i)
-        mAttributes[i]->printHexDump(hexDump);
-
-    for (VSizeType i = 0; i < numChildNodes; ++i)
-        mChildNodes[i]->printHexDump(hexDump);
+    this->_printHexDump(hexDump, stream, buffer, numBytesRemaining);
 }
 
 Vs64 VBentoNode::_calculateContentSize() const {
@@ -2570,19 +3512,76 @@ Vs64 VBentoNode::_calculateTotalSize() const {
     return lengthOfLength + contentSize;
 }
 
+bool VBentoNode::_printHexDump(VHex& hexDump, VBinaryIOStream& stream, VMemoryStream& buffer, Vs64& numBytesRemaining) const {
+    VSizeType   numAttributes = mAttributes.size();
+    VSizeType   numChildNodes = mChildNodes.size();
+    Vs64        totalSize = this->_calculateContentSize();
+
+    buffer.seek0();
+    buffer.setEOF(0);
+    VBentoNode::_writeLengthToStream(stream, totalSize);
+    stream.writeSize32(numAttributes);
+    stream.writeSize32(numChildNodes);
+    stream.writeString(mName);
+
+    if (!VBentoNode::_printHexDumpPart(hexDump, buffer, numBytesRemaining)) {
+        return false;
+    }
+
+    for (VSizeType i = 0; i < numAttributes; ++i) {
+        buffer.seek0();
+        buffer.setEOF(0);
+        mAttributes[i]->writeToStream(stream);
+
+        if (!VBentoNode::_printHexDumpPart(hexDump, buffer, numBytesRemaining)) {
+            return false;
+        }
+    }
+
+    for (VSizeType i = 0; i < numChildNodes; ++i) {
+        if (!mChildNodes[i]->_printHexDump(hexDump, stream, buffer, numBytesRemaining)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// static
+bool VBentoNode::_printHexDumpPart(VHex& hexDump, const VMemoryStream& buffer, Vs64& numBytesRemaining) {
+    Vs64 numBytesToPrint = V_MIN(buffer.getEOFOffset(), numBytesRemaining);
+    hexDump.printHex(buffer.getBuffer(), numBytesToPrint);
+    numBytesRemaining -= numBytesToPrint;
+
+    return numBytesRemaining > 0;
+}
+
 void VBentoNode::_addAttribute(VBentoAttribute* attribute) {
     mAttributes.push_back(attribute);
 }
 
-const VBentoAttribute* VBentoNode::_findAttribute(const VString& name, const VString& dataType) const {
+const VBentoAttribute* VBentoNode::findAttribute(const VString& name, const VString& dataType) const {
+    // Compares type names rather than atoms, so that a VBentoUnknownValue is found by its original type.
+    for (VBentoAttributePtrVector::const_iterator i = mAttributes.begin(); i != mAttributes.end(); ++i) {
+        if (name.equalsIgnoreCase((*i)->getName()) &&
+                ((*i)->getDataType() == dataType)) {
+            return (*i);
+        }
+    }
+
+    return NULL;
+}
+
+const VBentoAttribute* VBentoNode::_findAttribute(const VString& name, const VStringAtom& dataType) const {
     // Just return from the mutable find, with appropriate cast.
     return const_cast<VBentoNode*>(this)->_findMutableAttribute(name, dataType); // const_cast: NON-CONST WRAPPER
 }
 
-VBentoAttribute* VBentoNode::_findMutableAttribute(const VString& name, const VString& dataType) {
+VBentoAttribute* VBentoNode::_findMutableAttribute(const VString& name, const VStringAtom& dataType) {
     for (VBentoAttributePtrVector::const_iterator i = mAttributes.begin(); i != mAttributes.end(); ++i) {
-        if (name.equalsIgnoreCase((*i)->getName()) &&
-                ((*i)->getDataType() == dataType)) {
+        // Test the type first; it is a pointer compare.
+        if (((*i)->getDataTypeAtom() == dataType) &&
+                name.equalsIgnoreCase((*i)->getName())) {
             return (*i);
         }
     }
@@ -2590,6 +3589,107 @@ VBentoAttribute* VBentoNode::_findMutableAttribute(const VString& name, const VS
     return NULL;
 }
 
+VBentoNode* VBentoNode::_findMutableNodeOccurrence(const VString& name, int occurrence) {
+    for (VBentoNodePtrVector::const_iterator i = mChildNodes.begin(); i != mChildNodes.end(); ++i) {
+        if (((*i)->getName() == name) && (occurrence-- == 0)) {
+            return (*i);
+        }
+    }
+
+    return NULL;
+}
+
+void VBentoNode::_applyPatch(const VBentoNode& patch) {
+    const VBentoNode* rename = patch.findNode(PATCH_RENAME);
+    if (rename != NULL) {
+        mName = rename->getString(PATCH_RENAME_NAME);
+    }
+
+    // Attributes are matched exactly by name and type, as diff() matched them. All unknown values
+    // share one data type atom, so they are told apart by the data type they were read with.
+    const VBentoNode* unsetAttributes = patch.findNode(PATCH_UNSET_ATTRIBUTES);
+    if (unsetAttributes != NULL) {
+        for (VBentoAttributePtrVector::const_iterator i = unsetAttributes->mAttributes.begin(); i != unsetAttributes->mAttributes.end(); ++i) {
+            if ((*i)->getDataType() != VBentoString::DATA_TYPE_ID()) {
+                continue;
+            }
+
+            const VString& dataType = static_cast<const VBentoString*>(*i)->getValue();
+            for (VBentoAttributePtrVector::iterator j = mAttributes.begin(); j != mAttributes.end(); ++j) {
+                if (((*j)->getName() == (*i)->getName()) && ((*j)->getDataType() == dataType)) {
+                    delete (*j);
+                    (void) mAttributes.erase(j);
+                    break;
+                }
+            }
+        }
+    }
+
+    const VBentoNode* setAttributes = patch.findNode(PATCH_SET_ATTRIBUTES);
+    if (setAttributes != NULL) {
+        for (VBentoAttributePtrVector::const_iterator i = setAttributes->mAttributes.begin(); i != setAttributes->mAttributes.end(); ++i) {
+            VBentoAttributePtrVector::iterator j = mAttributes.begin();
+            const bool isUnknownValue = ((*i)->getDataTypeAtom() == VBentoUnknownValue::DATA_TYPE_ATOM());
+            while ((j != mAttributes.end()) && !(((*j)->getDataTypeAtom() == (*i)->getDataTypeAtom()) && ((*j)->getName() == (*i)->getName()) && (!isUnknownValue || ((*j)->getDataType() == (*i)->getDataType())))) {
+                ++j;
+            }
+
+            if (j == mAttributes.end()) {
+                this->_addAttribute((*i)->clone());
+            } else {
+                delete (*j);
+                (*j) = (*i)->clone();
+            }
+        }
+    }
+
+    // Locate every child that is patched or removed before changing the child list, because
+    // the occurrence numbers refer to the children as they were when the patch was made.
+    std::vector<VBentoNode*> patchTargets;
+    const VBentoNode* patchNodes = patch.findNode(PATCH_PATCH_NODES);
+    if (patchNodes != NULL) {
+        for (VBentoNodePtrVector::const_iterator i = patchNodes->mChildNodes.begin(); i != patchNodes->mChildNodes.end(); ++i) {
+            VBentoNode* target = this->_findMutableNodeOccurrence((*i)->getName(), (*i)->getS32(PATCH_OCCURRENCE, 0));
+            if (target == NULL) {
+                throw VException(VSTRING_FORMAT("Bento patch for node '%s' refers to child node '%s' (index %d) that does not exist.",
+                    mName.chars(), (*i)->getName().chars(), (*i)->getS32(PATCH_OCCURRENCE, 0)));
+            }
+
+            patchTargets.push_back(target);
+        }
+    }
+
+    std::vector<VBentoNode*> removeTargets;
+    const VBentoNode* removeNodes = patch.findNode(PATCH_REMOVE_NODES);
+    if (removeNodes != NULL) {
+        for (VBentoNodePtrVector::const_iterator i = removeNodes->mChildNodes.begin(); i != removeNodes->mChildNodes.end(); ++i) {
+            VBentoNode* target = this->_findMutableNodeOccurrence((*i)->getName(), (*i)->getS32(PATCH_OCCURRENCE, 0));
+            if (target == NULL) {
+                throw VException(VSTRING_FORMAT("Bento patch for node '%s' removes child node '%s' (index %d) that does not exist.",
+                    mName.chars(), (*i)->getName().chars(), (*i)->getS32(PATCH_OCCURRENCE, 0)));
+            }
+
+            removeTargets.push_back(target);
+        }
+    }
+
+    for (VSizeType i = 0; i < patchTargets.size(); ++i) {
+        patchTargets[i]->_applyPatch(*patchNodes->mChildNodes[i]);
+    }
+
+    for (std::vector<VBentoNode*>::const_iterator i = removeTargets.begin(); i != removeTargets.end(); ++i) {
+        this->orphanNode(*i);
+        delete (*i);
+    }
+
+    const VBentoNode* addNodes = patch.findNode(PATCH_ADD_NODES);
+    if (addNodes != NULL) {
+        for (VBentoNodePtrVector::const_iterator i = addNodes->mChildNodes.begin(); i != addNodes->mChildNodes.end(); ++i) {
+            this->addChildNode(new VBentoNode(**i));
+        }
+    }
+}
+
 // static
 Vs64 VBentoNode::_readLengthFromStream(VBinaryIOStream& stream) {
     return stream.readDynamicCount();
@@ -2635,7 +3735,8 @@ Vs64 VBentoNode::_getBinaryStringLength(const VString& s) {
 // VBentoUnknownValue --------------------------------------------------------
 
 VBentoUnknownValue::VBentoUnknownValue(VBinaryIOStream& stream, Vs64 dataLength, const VString& dataType)
-    : VBentoAttribute(stream, dataType)
+    : VBentoAttribute(stream, DATA_TYPE_ATOM()) // not dataType: type codes from a stream are not a bounded set, so we don't intern them
+    , mOriginalDataType(dataType)
     , mValue(dataLength)
     {
     VBinaryIOStream memoryIOStream(mValue);
@@ -2717,6 +3818,150 @@ void VBentoCallbackParser::readAttributeData(int /*depth*/, VBinaryIOStream& str
     stream.skip(static_cast<Vu64>(dataLength));
 }
 
+// VBentoStreamWriter --------------------------------------------------------
+
+VBentoStreamWriter::VBentoStreamWriter(VBinaryIOStream& stream, bool streamIsReadWriteSeekable)
+    : mStream(stream)
+    , mMemoryStream(dynamic_cast<VMemoryStream*>(&stream.getRawStream()))
+    , mSpoolTopLevelNodes((mMemoryStream == NULL) && !streamIsReadWriteSeekable)
+    , mSpoolBuffer(0)
+    , mSpoolStream(mSpoolBuffer)
+    , mOpenNodes()
+    {
+    if (mSpoolTopLevelNodes) {
+        mMemoryStream = &mSpoolBuffer;
+    }
+}
+
+void VBentoStreamWriter::beginNode(const VString& name) {
+    if (!mOpenNodes.empty()) {
+        ++(mOpenNodes.back().mNumChildNodes);
+    }
+
+    VBinaryIOStream& stream = this->_getWorkingStream();
+
+    OpenNode node;
+    node.mHeaderOffset = stream.getIOOffset();
+    node.mNumAttributes = 0;
+    node.mNumChildNodes = 0;
+    mOpenNodes.push_back(node);
+
+    // The length and counts are placeholders until endNode(). We assume the
+    // shortest length indicator, and make room for a longer one if needed.
+    VBentoNode::_writeLengthToStream(stream, 0);
+    stream.writeSize32(0);
+    stream.writeSize32(0);
+    stream.writeString(name);
+}
+
+void VBentoStreamWriter::endNode() {
+    if (mOpenNodes.empty()) {
+        throw VException("VBentoStreamWriter::endNode called with no open node.");
+    }
+
+    OpenNode node = mOpenNodes.back();
+    mOpenNodes.pop_back();
+
+    VBinaryIOStream& stream = this->_getWorkingStream();
+    const Vs64 placeholderLengthOfLength = VBentoNode::_getLengthOfLength(0);
+    const Vs64 contentOffset = node.mHeaderOffset + placeholderLengthOfLength;
+    Vs64 endOffset = stream.getIOOffset();
+    const Vs64 contentSize = endOffset - contentOffset;
+    const Vs64 extraLengthOfLength = VBentoNode::_getLengthOfLength(contentSize) - placeholderLengthOfLength;
+
+    if (extraLengthOfLength != 0) {
+        this->_moveTailForward(contentOffset, endOffset, extraLengthOfLength);
+        endOffset += extraLengthOfLength;
+    }
+
+    (void) stream.seek(node.mHeaderOffset, SEEK_SET);
+    VBentoNode::_writeLengthToStream(stream, contentSize);
+    stream.writeSize32(node.mNumAttributes);
+    stream.writeSize32(node.mNumChildNodes);
+    (void) stream.seek(endOffset, SEEK_SET);
+
+    if (mSpoolTopLevelNodes && mOpenNodes.empty()) {
+        (void) mSpoolStream.seek0();
+        (void) VStream::streamCopy(mSpoolStream, mStream, endOffset);
+        (void) mSpoolStream.seek0();
+        mSpoolBuffer.setEOF(0);
+    }
+}
+
+void VBentoStreamWriter::addNode(const VBentoNode& node) {
+    if (!mOpenNodes.empty()) {
+        ++(mOpenNodes.back().mNumChildNodes);
+    }
+
+    // A complete node knows its own length, so it can go straight to the caller's stream if it is top level.
+    node.writeToStream(mOpenNodes.empty() ? mStream : this->_getWorkingStream());
+}
+
+void VBentoStreamWriter::addAttribute(const VBentoAttribute& attribute) {
+    if (mOpenNodes.empty()) {
+        throw VException(VSTRING_FORMAT("VBentoStreamWriter::addAttribute '%s' called with no open node.", attribute.getName().chars()));
+    }
+
+    OpenNode& node = mOpenNodes.back();
+    if (node.mNumChildNodes != 0) {
+        throw VException(VSTRING_FORMAT("VBentoStreamWriter::addAttribute '%s' called after the node's first child node.", attribute.getName().chars()));
+    }
+
+    ++node.mNumAttributes;
+    attribute.writeToStream(this->_getWorkingStream());
+}
+
+void VBentoStreamWriter::addInt(const VString& name, int value) { this->addAttribute(VBentoS32(name, value)); }
+void VBentoStreamWriter::addBool(const VString& name, bool value) { this->addAttribute(VBentoBool(name, value)); }
+void VBentoStreamWriter::addString(const VString& name, const VString& value, const VString& encoding) { this->addAttribute(VBentoString(name, value, encoding)); }
+void VBentoStreamWriter::addChar(const VString& name, const VCodePoint& value) { this->addAttribute(VBentoChar(name, value)); }
+void VBentoStreamWriter::addDouble(const VString& name, VDouble value) { this->addAttribute(VBentoDouble(name, value)); }
+void VBentoStreamWriter::addDuration(const VString& name, const VDuration& value) { this->addAttribute(VBentoDuration(name, value)); }
+void VBentoStreamWriter::addInstant(const VString& name, const VInstant& value) { this->addAttribute(VBentoInstant(name, value)); }
+void VBentoStreamWriter::addS8(const VString& name, Vs8 value) { this->addAttribute(VBentoS8(name, value)); }
+void VBentoStreamWriter::addU8(const VString& name, Vu8 value) { this->addAttribute(VBentoU8(name, value)); }
+void VBentoStreamWriter::addS16(const VString& name, Vs16 value) { this->addAttribute(VBentoS16(name, value)); }
+void VBentoStreamWriter::addU16(const VString& name, Vu16 value) { this->addAttribute(VBentoU16(name, value)); }
+void VBentoStreamWriter::addS32(const VString& name, Vs32 value) { this->addAttribute(VBentoS32(name, value)); }
+void VBentoStreamWriter::addU32(const VString& name, Vu32 value) { this->addAttribute(VBentoU32(name, value)); }
+void VBentoStreamWriter::addS64(const VString& name, Vs64 value) { this->addAttribute(VBentoS64(name, value)); }
+void VBentoStreamWriter::addU64(const VString& name, Vu64 value) { this->addAttribute(VBentoU64(name, value)); }
+void VBentoStreamWriter::addFloat(const VString& name, VFloat value) { this->addAttribute(VBentoFloat(name, value)); }
+void VBentoStreamWriter::addBinary(const VString& name, const Vu8* data, Vs64 length) { this->addAttribute(VBentoBinary(name, const_cast<Vu8*>(data), VMemoryStream::kAllocatedUnknown, false, length, length)); } // const_cast: buffer is only read
+
+VBinaryIOStream& VBentoStreamWriter::_getWorkingStream() {
+    return mSpoolTopLevelNodes ? mSpoolStream : mStream;
+}
+
+void VBentoStreamWriter::_moveTailForward(Vs64 fromOffset, Vs64 toOffset, Vs64 distance) {
+    VBinaryIOStream& stream = this->_getWorkingStream();
+
+    if (mMemoryStream != NULL) {
+        // Extend the stream, then slide the bytes up within the buffer (which may have been reallocated by the write).
+        static const Vu8 kPadding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        (void) stream.write(kPadding, distance);
+        Vu8* buffer = mMemoryStream->getBuffer();
+        ::memmove(buffer + fromOffset + distance, buffer + fromOffset, static_cast<VSizeType>(toOffset - fromOffset));
+        return;
+    }
+
+    // Copy back to front in chunks so that no byte is overwritten before it has been moved.
+    const Vs64 kChunkSize = 16384;
+    Vu8 chunk[kChunkSize];
+    Vs64 chunkEnd = toOffset;
+    while (chunkEnd > fromOffset) {
+        Vs64 chunkLength = V_MIN(kChunkSize, chunkEnd - fromOffset);
+        Vs64 chunkStart = chunkEnd - chunkLength;
+        (void) stream.seek(chunkStart, SEEK_SET);
+        stream.readGuaranteed(chunk, chunkLength);
+        (void) stream.seek(chunkStart + distance, SEEK_SET);
+        (void) stream.write(chunk, chunkLength);
+        chunkEnd = chunkStart;
+    }
+
+    (void) stream.seek(toOffset + distance, SEEK_SET);
+}
+
 // VBentoArray ----------------------------------------------------------------------
 
 void VBentoArray::_getValueAsBentoTextString(VString& s) const {
@@ -16,6 +16,7 @@ License: MIT. See LICENSE.md in the Vault top level directory.
 #include "vexception.h"
 #include "vgeometry.h"
 #include "vcolor.h"
+#include "vstringatom.h"
 
 class VBinaryIOStream;
 class VTextIOStream;
@@ -133,11 +134,10 @@ value : the text representation of the attribute's value
     The type must be specified.
     Double-quotes are optional.
 
-'flot' and 'doub' values when written to Bento Text Format use 6 decimal places of
-accuracy. This may place practical limits on using the text format for these data
-types, if exact equality of values with many decimal places is needed. If this
-becomes a problem, the method VBentoDouble::getValueAsBentoTextString() could be
-changed to use a string format with more decimal places than the IEEE default of 6.
+'doub' values (and 'doub' array elements) are written to Bento Text Format as the
+shortest text that reads back as exactly the same value, so they survive a round trip
+through text. 'flot' values use 6 decimal places of accuracy. Both are read without
+regard to the C locale's decimal point.
 */
 
 class VBentoAttribute;
@@ -311,8 +311,12 @@ class VBentoNode {
         @param    stream    the stream to write to
         @param    lineWrap  true if each bento node should start on its own indented line
         @param    indentDepth if lineWrap is true, the indent level depth of this node
+        @param    maxDepth  the number of levels of child nodes to write, or -1 for no limit;
+                            deeper children are elided as "..."
+        @param    maxLength the number of bytes of text to write, or -1 for no limit; if the
+                            limit is reached, the text is truncated and ends with "..."
         */
-        void writeToBentoTextStream(VTextIOStream& stream, bool lineWrap = false, int indentDepth = 0) const;
+        void writeToBentoTextStream(VTextIOStream& stream, bool lineWrap = false, int indentDepth = 0, int maxDepth = -1, int maxLength = -1) const;
         /**
         Writes the object, including its attributes and contained child
         objects, to a text stream in Bento Text Format. Use some caution in calling this vs.
@@ -322,6 +326,20 @@ class VBentoNode {
         @param    lineWrap  true if each bento node should start on its own indented line
         */
         void writeToBentoTextString(VString& s, bool lineWrap = false) const;
+        /**
+        Like writeToBentoTextString(), but appends to the string rather than replacing it,
+        and can limit how much of the hierarchy is rendered. Because it appends, a caller
+        can render a prefix and several nodes into one string, which grows geometrically
+        rather than being re-allocated per node. Limits are cheap: the part of the
+        hierarchy beyond them is never rendered.
+        @param    s         the string to append to
+        @param    lineWrap  true if each bento node should start on its own indented line
+        @param    maxDepth  the number of levels of child nodes to write, or -1 for no limit;
+                            deeper children are elided as "..."
+        @param    maxLength the number of bytes to append, or -1 for no limit; if the
+                            limit is reached, the text is truncated and ends with "..."
+        */
+        void appendToBentoTextString(VString& s, bool lineWrap = false, int maxDepth = -1, int maxLength = -1) const;
 
         // Methods for de-serializing and reading a data hierarchy -----------
 
@@ -513,7 +531,7 @@ class VBentoNode {
         */
         const VBentoAttributePtrVector& getAttributes() const;
 
-        const VBentoAttribute* findAttribute(const VString& name, const VString& dataType) const { return this->_findAttribute(name, dataType); }
+        const VBentoAttribute* findAttribute(const VString& name, const VString& dataType) const;
 
         /**
         Returns the node's name.
@@ -534,16 +552,33 @@ class VBentoNode {
         @param    stream    the stream to write to
         @param    lineWrap  true if each bento node should start on its own indented line
         @param    indentDepth if lineWrap is true, the indent level depth of this node
+        @param    maxDepth  the number of levels of child nodes to write, or -1 for no limit;
+                            deeper children are elided as an XML comment
+        @param    maxLength the number of bytes of text to write, or -1 for no limit; if the
+                            limit is reached, the text is truncated and ends with "..."
+        */
+        void writeToXMLTextStream(VTextIOStream& stream, bool lineWrap = false, int indentDepth = 0, int maxDepth = -1, int maxLength = -1) const;
+        /**
+        Appends the node's XML text rendering to a string. See appendToBentoTextString()
+        regarding appending and the limits.
+        @param    s         the string to append to
+        @param    lineWrap  true if each bento node should start on its own indented line
+        @param    maxDepth  the number of levels of child nodes to write, or -1 for no limit
+        @param    maxLength the number of bytes to append, or -1 for no limit
         */
-        void writeToXMLTextStream(VTextIOStream& stream, bool lineWrap = false, int indentDepth = 0) const;
+        void appendToXMLTextString(VString& s, bool lineWrap = false, int maxDepth = -1, int maxLength = -1) const;
         /**
         Prints the node's XML text rendering to stdout for debugging purposes.
+        @param    maxDepth  the number of levels of child nodes to print, or -1 for no limit
+        @param    maxLength the number of bytes to print, or -1 for no limit
         */
-        void printXML() const;
+        void printXML(int maxDepth = -1, int maxLength = -1) const;
         /**
         Prints the node's binary stream layout to stdout for debugging purposes.
+        @param    hexDump   the hex dump formatter object
+        @param    maxLength the number of bytes to print, or -1 for no limit
         */
-        void printHexDump(VHex& hexDump) const;
+        void printHexDump(VHex& hexDump, Vs64 maxLength = -1) const;
 
         /**
         Deletes all attributes and children (recursive) from this node. This node
@@ -591,6 +626,39 @@ class VBentoNode {
         @param node the node from which to copy attributes and children
         */
         void updateFrom(const VBentoNode& node);
+        /**
+        Compares two versions of a node hierarchy and describes how to turn the
+        old one into the new one, as a patch that is itself a bento node. Because
+        the patch is an ordinary node, it is sent over a VMessage (or any binary
+        stream) with writeToStream() and received by constructing a VBentoNode
+        from the stream, and it can be logged as bento text like any other node.
+        Only what differs is recorded:
+        - Attributes are matched by name and data type. Added or changed
+          attributes are copied into the patch; removed ones are listed by name
+          and type.
+        - Child nodes are matched by name and by occurrence among siblings of the
+          same name. Added children are copied into the patch whole; removed
+          ones are listed; and matched children that differ get a nested patch.
+        Attributes and children are usually in the same order in both versions,
+        so they are matched by position first and only looked up by key when
+        the positions disagree; this keeps a diff of a large, mostly unchanged
+        tree close to a single linear pass.
+        @param  oldNode the node hierarchy the receiver already has
+        @param  newNode the node hierarchy the receiver should end up with
+        @param  patch   a node to fill in with the patch; it should be empty
+        @return true if the two hierarchies differ, false if the patch is empty
+        */
+        static bool diff(const VBentoNode& oldNode, const VBentoNode& newNode, VBentoNode& patch);
+        /**
+        Applies a patch produced by diff(), turning this node hierarchy (which
+        should equal the diff's old node) into the diff's new node. Added child
+        nodes are appended after the existing children. Throws a VException if
+        the patch refers to a child node that does not exist, which means this
+        hierarchy has diverged from the one the patch was made against; the
+        caller should then fall back to sending the whole hierarchy.
+        @param  patch   the patch to apply
+        */
+        void applyPatch(const VBentoNode& patch);
 
     private:
 
@@ -603,6 +671,17 @@ class VBentoNode {
         */
         Vs64 _calculateContentSize() const;
         /**
+        Prints this node's binary stream layout, one part at a time, until the byte
+        budget is spent. The stream and its buffer are scratch space re-used for each part.
+        @return false if the byte budget has been spent
+        */
+        bool _printHexDump(VHex& hexDump, VBinaryIOStream& stream, VMemoryStream& buffer, Vs64& numBytesRemaining) const;
+        /**
+        Prints the bytes in the buffer, up to the remaining byte budget, and reduces the budget.
+        @return false if the byte budget has been spent
+        */
+        static bool _printHexDumpPart(VHex& hexDump, const VMemoryStream& buffer, Vs64& numBytesRemaining);
+        /**
         Returns the total length of the object, including its attributes
         and contained child objects, as it would exist as written to a binary
         data stream (via the writeToStream() method), including the dynamic length
@@ -623,23 +702,37 @@ class VBentoNode {
         attached to this object. This method does NOT search the object's
         contained child objects.
         @param    name        the attribute name to match
-        @param    dataType    the data type name to match; typically you should
-                            supply the static DATA_TYPE_ID() method of the desired
-                            VBentoAttribute class, for example VBentoS8::DATA_TYPE_ID()
+        @param    dataType    the data type to match; typically you should
+                            supply the static DATA_TYPE_ATOM() method of the desired
+                            VBentoAttribute class, for example VBentoS8::DATA_TYPE_ATOM()
         @return    a pointer to the found attribute object, or NULL if not found
         */
-        const VBentoAttribute* _findAttribute(const VString& name, const VString& dataType) const;
+        const VBentoAttribute* _findAttribute(const VString& name, const VStringAtom& dataType) const;
         /**
         This is the same as _findAttribute, but it returns a non-const pointer, and is
         itself non-const, for use in non-const code that needs to update an existing
         attribute.
         @param    name        the attribute name to match
-        @param    dataType    the data type name to match; typically you should
-                            supply the static DATA_TYPE_ID() method of the desired
-                            VBentoAttribute class, for example VBentoS8::DATA_TYPE_ID()
+        @param    dataType    the data type to match; typically you should
+                            supply the static DATA_TYPE_ATOM() method of the desired
+                            VBentoAttribute class, for example VBentoS8::DATA_TYPE_ATOM()
         @return    a pointer to the found attribute object, or NULL if not found
         */
-        VBentoAttribute* _findMutableAttribute(const VString& name, const VString& dataType);
+        VBentoAttribute* _findMutableAttribute(const VString& name, const VStringAtom& dataType);
+        /**
+        Returns the child node with the specified name and occurrence among
+        children of that name, which is how diff() and applyPatch() identify
+        children.
+        @param  name        the child node name to match
+        @param  occurrence  0 for the first child with that name, 1 for the second, etc.
+        @return a pointer to the found child node, or NULL if not found
+        */
+        VBentoNode* _findMutableNodeOccurrence(const VString& name, int occurrence);
+        /**
+        Applies one level of a patch to this node, recursing for nested patches.
+        @param  patch   the patch to apply
+        */
+        void _applyPatch(const VBentoNode& patch);
 
         /**
         Reads a dynamically-sized length indicator from the stream.
@@ -698,6 +791,8 @@ class VBentoNode {
         // These related classes use some of our private static utility functions.
         friend class VBentoAttribute;
         friend class VBentoCallbackParser;
+        friend class VBentoPatchBuilder;
+        friend class VBentoStreamWriter;
         friend class VBentoString;
         friend class VBentoBinary;
         friend class VBentoUnit;
@@ -807,6 +902,124 @@ class VBentoCallbackParser {
         virtual void readAttributeData(int depth, VBinaryIOStream& stream, Vu64 dataLength);
 };
 
+/**
+VBentoStreamWriter is the writing counterpart of VBentoCallbackParser: it lets you
+write a bento hierarchy to a binary stream "manually", one node and attribute at a
+time, without first building the whole VBentoNode tree in memory. The bytes written
+are identical to what VBentoNode::writeToStream() would write for the equivalent tree.
+
+Usage mirrors the tree structure:
+<pre>
+    VBentoStreamWriter writer(stream);
+    writer.beginNode("results");
+    writer.addS32("count", n);
+    for (each row) {
+        writer.beginNode("row");
+        writer.addString("name", row.name);
+        writer.endNode();
+    }
+    writer.endNode();
+</pre>
+
+A node's attributes must all be added before its first child node is begun, because
+that is the order in which they appear in the binary format.
+
+The binary format puts each node's length and attribute/child counts ahead of its
+content, so those values are back-patched when the node ends. When the target stream
+is a VMemoryStream this is done in place. If you pass a stream that can seek and can
+read back what was written (for example a file stream opened with openReadWrite())
+and set streamIsReadWriteSeekable, it is also done in place on that stream. Otherwise
+(for example a socket stream), each top level node is spooled to an internal memory
+buffer and copied to the target stream when the top level node ends. Apart from that
+spool buffer, the writer only keeps a small record for each open node, so its memory
+use is bounded by the nesting depth rather than by the size of the hierarchy.
+*/
+class VBentoStreamWriter {
+    public:
+
+        /**
+        Constructs a writer that writes to the specified stream.
+        @param  stream                      the output stream to write to
+        @param  streamIsReadWriteSeekable   true if the stream supports seek() and read() of
+                                                previously written data; not needed for a
+                                                VMemoryStream, which is detected automatically
+        */
+        VBentoStreamWriter(VBinaryIOStream& stream, bool streamIsReadWriteSeekable = false);
+        /**
+        Destructor. If any nodes are still open, the partially written data is left as is.
+        */
+        ~VBentoStreamWriter() {}
+
+        /**
+        Begins a new node. If another node is open, the new node is its child.
+        @param  name    the node name
+        */
+        void beginNode(const VString& name);
+        /**
+        Ends the most recently begun node, back-patching its length and counts.
+        Throws a VException if no node is open.
+        */
+        void endNode();
+        /**
+        Writes a complete, already-built node (and its children) as a child of
+        the open node, or as a top level node if no node is open.
+        @param  node    the node to write
+        */
+        void addNode(const VBentoNode& node);
+        /**
+        Writes an attribute to the open node. Throws a VException if no node is open,
+        or if the open node already has a child node.
+        @param  attribute   the attribute to write
+        */
+        void addAttribute(const VBentoAttribute& attribute);
+
+        void addInt(const VString& name, int value);                  ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addBool(const VString& name, bool value);                ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addString(const VString& name, const VString& value, const VString& encoding = VString::EMPTY());  ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value @param encoding the text encoding of the value string (UTF-8 assumed if not specified)
+        void addChar(const VString& name, const VCodePoint& value);   ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addDouble(const VString& name, VDouble value);           ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addDuration(const VString& name, const VDuration& value);///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addInstant(const VString& name, const VInstant& value);  ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addS8(const VString& name, Vs8 value);                   ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addU8(const VString& name, Vu8 value);                   ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addS16(const VString& name, Vs16 value);                 ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addU16(const VString& name, Vu16 value);                 ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addS32(const VString& name, Vs32 value);                 ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addU32(const VString& name, Vu32 value);                 ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addS64(const VString& name, Vs64 value);                 ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addU64(const VString& name, Vu64 value);                 ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addFloat(const VString& name, VFloat value);             ///< Writes the specified attribute to the open node. @param name the attribute name @param value the attribute value
+        void addBinary(const VString& name, const Vu8* data, Vs64 length);///< Writes the specified attribute to the open node; the data is not copied. @param name the attribute name @param data the data buffer to write @param length the length of data to write
+
+        /**
+        Returns the number of nodes currently open.
+        @return the nesting depth, 0 when no node is open
+        */
+        int getDepth() const { return static_cast<int>(mOpenNodes.size()); }
+
+    private:
+
+        /** Bookkeeping for a node that has been begun but not yet ended. */
+        struct OpenNode {
+            Vs64        mHeaderOffset;  ///< Offset of the node's length indicator in the working stream.
+            VSizeType   mNumAttributes; ///< Number of attributes written so far.
+            VSizeType   mNumChildNodes; ///< Number of child nodes begun so far.
+        };
+
+        VBinaryIOStream& _getWorkingStream();
+        void _moveTailForward(Vs64 fromOffset, Vs64 toOffset, Vs64 distance);
+
+        VBinaryIOStream&        mStream;            ///< The caller's output stream.
+        VMemoryStream*          mMemoryStream;      ///< The working stream's raw stream, if it is a memory stream we can edit in place.
+        bool                    mSpoolTopLevelNodes;///< True if we must spool each top level node before copying it to mStream.
+        VMemoryStream           mSpoolBuffer;       ///< Raw spool stream, used only if mSpoolTopLevelNodes is true.
+        VBinaryIOStream         mSpoolStream;       ///< Binary i/o on mSpoolBuffer.
+        std::vector<OpenNode>   mOpenNodes;         ///< Stack of open nodes; back() is the innermost.
+
+        VBentoStreamWriter(const VBentoStreamWriter&); // not copyable
+        VBentoStreamWriter& operator=(const VBentoStreamWriter&); // not assignable
+};
+
 /**
 VBentoAttribute is an abstract base class for all of the concrete VBento
 attribute classes. Each VBentoNode object in the object hierarchy can
@@ -819,15 +1032,18 @@ class VBentoAttribute {
     public:
 
         VBentoAttribute(); ///< Constructs with uninitialized name.
-        VBentoAttribute(VBinaryIOStream& stream, const VString& dataType); ///< Constructs by reading from stream.
-        VBentoAttribute(const VString& name, const VString& dataType); ///< Constructs with name and type. @param name the attribute name @param dataType the data type
+        VBentoAttribute(VBinaryIOStream& stream, const VStringAtom& dataType); ///< Constructs by reading from stream.
+        VBentoAttribute(const VString& name, const VStringAtom& dataType); ///< Constructs with name and type. @param name the attribute name @param dataType the data type
+        VBentoAttribute(VBinaryIOStream& stream, const VString& dataType); ///< Constructs by reading from stream. Interns dataType; subclasses should pass their DATA_TYPE_ATOM() instead.
+        VBentoAttribute(const VString& name, const VString& dataType); ///< Constructs with name and type. Interns dataType; subclasses should pass their DATA_TYPE_ATOM() instead. @param name the attribute name @param dataType the data type
         virtual ~VBentoAttribute(); ///< Destructor.
 
         virtual VBentoAttribute* clone() const = 0;
         VBentoAttribute& operator=(const VBentoAttribute& rhs) { mName = rhs.mName; mDataType = rhs.mDataType; return *this; }
 
         const VString& getName() const; ///< Returns the attribute name. @return a reference to the attribute name string.
-        const VString& getDataType() const; ///< Returns the data type name. @return a reference to the data type name string.
+        virtual const VString& getDataType() const { return mDataType.getString(); } ///< Returns the data type name. @return a reference to the data type name string.
+        const VStringAtom& getDataTypeAtom() const { return mDataType; } ///< Returns the data type name as an atom; compare it with a class's DATA_TYPE_ATOM() to test the type with a single pointer compare. @return the data type atom
 
         virtual bool xmlAppearsAsArray() const { return false; } ///< True if XML output requires this attribute to use a separate child tag for its array elements; implies override of writeToXMLTextStream
         virtual void getValueAsXMLText(VString& s) const = 0; ///< Returns a string suitable for an XML attribute value, including escaping via _escapeXMLValue() if needed.
@@ -857,7 +1073,7 @@ class VBentoAttribute {
     private:
 
         VString mName;      ///< The attribute name.
-        VString mDataType;  ///< The data type name.
+        VStringAtom mDataType;  ///< The data type name.
 };
 
 /**
@@ -868,9 +1084,11 @@ class VBentoS8 : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("vs_8"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoS8() : mValue(0) {} ///< Constructs with uninitialized name and value.
-        VBentoS8(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream.readS8()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoS8(const VString& name, Vs8 i) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(i) {} ///< Constructs from supplied name and value.
+        VBentoS8(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream.readS8()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoS8(const VString& name, Vs8 i) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(i) {} ///< Constructs from supplied name and value.
         virtual ~VBentoS8() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoS8(this->getName(), mValue); }
@@ -901,9 +1119,11 @@ class VBentoU8 : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("vu_8"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoU8() : mValue(0) {} ///< Constructs with uninitialized name and value.
-        VBentoU8(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream.readU8()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoU8(const VString& name, Vu8 i) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(i) {} ///< Constructs from supplied name and value.
+        VBentoU8(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream.readU8()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoU8(const VString& name, Vu8 i) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(i) {} ///< Constructs from supplied name and value.
         virtual ~VBentoU8() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoU8(this->getName(), mValue); }
@@ -934,9 +1154,11 @@ class VBentoS16 : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("vs16"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoS16() : mValue(0) {} ///< Constructs with uninitialized name and value.
-        VBentoS16(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream.readS16()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoS16(const VString& name, Vs16 i) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(i) {} ///< Constructs from supplied name and value.
+        VBentoS16(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream.readS16()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoS16(const VString& name, Vs16 i) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(i) {} ///< Constructs from supplied name and value.
         virtual ~VBentoS16() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoS16(this->getName(), mValue); }
@@ -967,9 +1189,11 @@ class VBentoU16 : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("vu16"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoU16() : mValue(0) {} ///< Constructs with uninitialized name and value.
-        VBentoU16(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream.readU16()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoU16(const VString& name, Vu16 i) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(i) {} ///< Constructs from supplied name and value.
+        VBentoU16(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream.readU16()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoU16(const VString& name, Vu16 i) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(i) {} ///< Constructs from supplied name and value.
         virtual ~VBentoU16() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoU16(this->getName(), mValue); }
@@ -1000,9 +1224,11 @@ class VBentoS32 : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("vs32"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoS32() : mValue(0) {} ///< Constructs with uninitialized name and value.
-        VBentoS32(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream.readS32()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoS32(const VString& name, Vs32 i) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(i) {} ///< Constructs from supplied name and value.
+        VBentoS32(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream.readS32()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoS32(const VString& name, Vs32 i) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(i) {} ///< Constructs from supplied name and value.
         virtual ~VBentoS32() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoS32(this->getName(), mValue); }
@@ -1033,9 +1259,11 @@ class VBentoU32 : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("vu32"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoU32() : mValue(0) {} ///< Constructs with uninitialized name and value.
-        VBentoU32(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream.readU32()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoU32(const VString& name, Vu32 i) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(i) {} ///< Constructs from supplied name and value.
+        VBentoU32(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream.readU32()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoU32(const VString& name, Vu32 i) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(i) {} ///< Constructs from supplied name and value.
         virtual ~VBentoU32() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoU32(this->getName(), mValue); }
@@ -1066,9 +1294,11 @@ class VBentoS64 : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("vs64"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoS64() : mValue(0) {} ///< Constructs with uninitialized name and value.
-        VBentoS64(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream.readS64()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoS64(const VString& name, Vs64 i) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(i) {} ///< Constructs from supplied name and value.
+        VBentoS64(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream.readS64()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoS64(const VString& name, Vs64 i) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(i) {} ///< Constructs from supplied name and value.
         virtual ~VBentoS64() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoS64(this->getName(), mValue); }
@@ -1099,9 +1329,11 @@ class VBentoU64 : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("vu64"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoU64() : mValue(0) {} ///< Constructs with uninitialized name and value.
-        VBentoU64(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream.readU64()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoU64(const VString& name, Vu64 i) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(i) {} ///< Constructs from supplied name and value.
+        VBentoU64(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream.readU64()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoU64(const VString& name, Vu64 i) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(i) {} ///< Constructs from supplied name and value.
         virtual ~VBentoU64() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoU64(this->getName(), mValue); }
@@ -1132,9 +1364,11 @@ class VBentoBool : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("bool"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoBool() : mValue(false) {} ///< Constructs with uninitialized name and value.
-        VBentoBool(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream.readBool()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoBool(const VString& name, bool b) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(b) {} ///< Constructs from supplied name and value.
+        VBentoBool(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream.readBool()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoBool(const VString& name, bool b) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(b) {} ///< Constructs from supplied name and value.
         virtual ~VBentoBool() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoBool(this->getName(), mValue); }
@@ -1165,9 +1399,11 @@ class VBentoString : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("vstr"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoString() : mValue() {} ///< Constructs with uninitialized name and empty string.
-        VBentoString(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mEncoding(stream.readString()), mValue(stream.readString()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoString(const VString& name, const VString& s, const VString& encoding) : VBentoAttribute(name, DATA_TYPE_ID()), mEncoding(encoding), mValue(s) {} ///< Constructs from supplied name and value.
+        VBentoString(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mEncoding(stream.readString()), mValue(stream.readString()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoString(const VString& name, const VString& s, const VString& encoding) : VBentoAttribute(name, DATA_TYPE_ATOM()), mEncoding(encoding), mValue(s) {} ///< Constructs from supplied name and value.
         virtual ~VBentoString() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoString(this->getName(), mValue, mEncoding); }
@@ -1218,12 +1454,13 @@ class VBentoChar : public VBentoAttribute {
 
         static const VString& LEGACY_DATA_TYPE_ID() { static const VString kID("char"); return kID; } ///< The data type name / class ID string.
         static const VString& DATA_TYPE_ID() { static const VString kID("u8ch"); return kID; } ///< The data type name / class ID string.
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
         
         static VBentoChar* newFromLegacyCharStream(VBinaryIOStream& stream); ///< Constructs by reading 1 byte and using it as a Unicode code point value.
 
         VBentoChar() : mValue(' ') {} ///< Constructs with uninitialized name and a space char.
-        VBentoChar(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoChar(const VString& name, const VCodePoint& c) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(c) {} ///< Constructs from supplied name and value.
+        VBentoChar(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoChar(const VString& name, const VCodePoint& c) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(c) {} ///< Constructs from supplied name and value.
         virtual ~VBentoChar() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoChar(this->getName(), mValue); }
@@ -1254,9 +1491,11 @@ class VBentoFloat : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("flot"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoFloat() : mValue(0.0f) {} ///< Constructs with uninitialized name and a 0 value.
-        VBentoFloat(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream.readFloat()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoFloat(const VString& name, VFloat f) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(f) {} ///< Constructs from supplied name and value.
+        VBentoFloat(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream.readFloat()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoFloat(const VString& name, VFloat f) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(f) {} ///< Constructs from supplied name and value.
         virtual ~VBentoFloat() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoFloat(this->getName(), mValue); }
@@ -1287,9 +1526,11 @@ class VBentoDouble : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("doub"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoDouble() : mValue(0.0) {} ///< Constructs with uninitialized name and a 0 value.
-        VBentoDouble(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream.readDouble()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoDouble(const VString& name, VDouble d) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(d) {} ///< Constructs from supplied name and value.
+        VBentoDouble(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream.readDouble()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoDouble(const VString& name, VDouble d) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(d) {} ///< Constructs from supplied name and value.
         virtual ~VBentoDouble() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoDouble(this->getName(), mValue); }
@@ -1297,7 +1538,7 @@ class VBentoDouble : public VBentoAttribute {
 
         virtual void getValueAsXMLText(VString& s) const { s = VSTRING_DOUBLE(mValue); }
         virtual void getValueAsString(VString& s) const { s = VSTRING_DOUBLE(mValue); }
-        virtual void getValueAsBentoTextString(VString& s) const { s = VSTRING_DOUBLE(mValue); } // Note: %lf uses 6 decimal places by default; this limits output resolution.
+        virtual void getValueAsBentoTextString(VString& s) const { s.formatRoundTrip(mValue); } // Shortest text that parses back to exactly mValue.
 
         inline VDouble getValue() const { return mValue; } ///< Returns the attribute's value. @return a reference to the value object
         inline void setValue(VDouble d) { mValue = d; } ///< Sets the attribute's value. @param d the attribute value
@@ -1320,9 +1561,11 @@ class VBentoDuration : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("dura"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoDuration() : mValue() {} ///< Constructs with uninitialized name and a 0 value.
-        VBentoDuration(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(VDuration::MILLISECOND() * stream.readS64()) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoDuration(const VString& name, const VDuration& d) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(d) {} ///< Constructs from supplied name and value.
+        VBentoDuration(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(VDuration::MILLISECOND() * stream.readS64()) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoDuration(const VString& name, const VDuration& d) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(d) {} ///< Constructs from supplied name and value.
         virtual ~VBentoDuration() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoDuration(this->getName(), mValue); }
@@ -1353,9 +1596,11 @@ class VBentoInstant : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("inst"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoInstant() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoInstant(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(VInstant::instantFromRawValue(stream.readS64())) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoInstant(const VString& name, const VInstant& i) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(i) {} ///< Constructs from supplied name and value.
+        VBentoInstant(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(VInstant::instantFromRawValue(stream.readS64())) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoInstant(const VString& name, const VInstant& i) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(i) {} ///< Constructs from supplied name and value.
         virtual ~VBentoInstant() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoInstant(this->getName(), mValue); }
@@ -1386,9 +1631,11 @@ class VBentoSize : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("sizd"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoSize() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoSize(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoSize(const VString& name, const VSize& s) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(s) {} ///< Constructs from supplied name and value.
+        VBentoSize(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoSize(const VString& name, const VSize& s) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(s) {} ///< Constructs from supplied name and value.
         virtual ~VBentoSize() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoSize(this->getName(), mValue); }
@@ -1422,9 +1669,11 @@ class VBentoISize : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("sizi"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoISize() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoISize(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoISize(const VString& name, const VISize& s) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(s) {} ///< Constructs from supplied name and value.
+        VBentoISize(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoISize(const VString& name, const VISize& s) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(s) {} ///< Constructs from supplied name and value.
         virtual ~VBentoISize() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoISize(this->getName(), mValue); }
@@ -1458,9 +1707,11 @@ class VBentoPoint : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("pt_d"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoPoint() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoPoint(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoPoint(const VString& name, const VPoint& p) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(p) {} ///< Constructs from supplied name and value.
+        VBentoPoint(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoPoint(const VString& name, const VPoint& p) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(p) {} ///< Constructs from supplied name and value.
         virtual ~VBentoPoint() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoPoint(this->getName(), mValue); }
@@ -1494,9 +1745,11 @@ class VBentoIPoint : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("pt_i"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoIPoint() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoIPoint(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoIPoint(const VString& name, const VIPoint& s) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(s) {} ///< Constructs from supplied name and value.
+        VBentoIPoint(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoIPoint(const VString& name, const VIPoint& s) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(s) {} ///< Constructs from supplied name and value.
         virtual ~VBentoIPoint() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoIPoint(this->getName(), mValue); }
@@ -1530,9 +1783,11 @@ class VBentoPoint3D : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("pt3d"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoPoint3D() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoPoint3D(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoPoint3D(const VString& name, const VPoint3D& p) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(p) {} ///< Constructs from supplied name and value.
+        VBentoPoint3D(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoPoint3D(const VString& name, const VPoint3D& p) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(p) {} ///< Constructs from supplied name and value.
         virtual ~VBentoPoint3D() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoPoint3D(this->getName(), mValue); }
@@ -1566,9 +1821,11 @@ class VBentoIPoint3D : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("pt3i"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoIPoint3D() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoIPoint3D(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoIPoint3D(const VString& name, const VIPoint3D& s) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(s) {} ///< Constructs from supplied name and value.
+        VBentoIPoint3D(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoIPoint3D(const VString& name, const VIPoint3D& s) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(s) {} ///< Constructs from supplied name and value.
         virtual ~VBentoIPoint3D() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoIPoint3D(this->getName(), mValue); }
@@ -1602,9 +1859,11 @@ class VBentoLine : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("line"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoLine() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoLine(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoLine(const VString& name, const VLine& v) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(v) {} ///< Constructs from supplied name and value.
+        VBentoLine(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoLine(const VString& name, const VLine& v) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(v) {} ///< Constructs from supplied name and value.
         virtual ~VBentoLine() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoLine(this->getName(), mValue); }
@@ -1638,9 +1897,11 @@ class VBentoILine : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("lini"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoILine() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoILine(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoILine(const VString& name, const VILine& v) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(v) {} ///< Constructs from supplied name and value.
+        VBentoILine(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoILine(const VString& name, const VILine& v) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(v) {} ///< Constructs from supplied name and value.
         virtual ~VBentoILine() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoILine(this->getName(), mValue); }
@@ -1674,9 +1935,11 @@ class VBentoRect : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("recd"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoRect() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoRect(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoRect(const VString& name, const VRect& p) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(p) {} ///< Constructs from supplied name and value.
+        VBentoRect(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoRect(const VString& name, const VRect& p) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(p) {} ///< Constructs from supplied name and value.
         virtual ~VBentoRect() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoRect(this->getName(), mValue); }
@@ -1710,9 +1973,11 @@ class VBentoIRect : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("reci"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoIRect() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoIRect(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoIRect(const VString& name, const VIRect& s) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(s) {} ///< Constructs from supplied name and value.
+        VBentoIRect(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoIRect(const VString& name, const VIRect& s) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(s) {} ///< Constructs from supplied name and value.
         virtual ~VBentoIRect() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoIRect(this->getName(), mValue); }
@@ -1746,9 +2011,11 @@ class VBentoPolygon : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("pold"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoPolygon() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoPolygon(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoPolygon(const VString& name, const VPolygon& p) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(p) {} ///< Constructs from supplied name and value.
+        VBentoPolygon(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoPolygon(const VString& name, const VPolygon& p) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(p) {} ///< Constructs from supplied name and value.
         virtual ~VBentoPolygon() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoPolygon(this->getName(), mValue); }
@@ -1786,9 +2053,11 @@ class VBentoIPolygon : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("poli"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoIPolygon() : mValue() {} ///< Constructs with uninitialized name and the current time as value.
-        VBentoIPolygon(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoIPolygon(const VString& name, const VIPolygon& s) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(s) {} ///< Constructs from supplied name and value.
+        VBentoIPolygon(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoIPolygon(const VString& name, const VIPolygon& s) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(s) {} ///< Constructs from supplied name and value.
         virtual ~VBentoIPolygon() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoIPolygon(this->getName(), mValue); }
@@ -1826,9 +2095,11 @@ class VBentoColor : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("rgba"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoColor() : mValue() {} ///< Constructs with uninitialized name and the default value.
-        VBentoColor(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoColor(const VString& name, const VColor& c) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(c) {} ///< Constructs from supplied name and value.
+        VBentoColor(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(stream) {} ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoColor(const VString& name, const VColor& c) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(c) {} ///< Constructs from supplied name and value.
         virtual ~VBentoColor() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoColor(this->getName(), mValue); }
@@ -1861,10 +2132,12 @@ class VBentoBinary : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("bina"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoBinary() : mValue(0) {} ///< Constructs with uninitialized name and a zero-length buffer.
-        VBentoBinary(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ID()), mValue(0) { Vs64 length = VBentoNode::_readLengthFromStream(stream); (void) VStream::streamCopy(stream, mValue, length); } ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoBinary(const VString& name, const Vu8* data, Vs64 length) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(0) { (void) mValue.write(data, length); } ///< Constructs from supplied name and data that is copied.
-        VBentoBinary(const VString& name, Vu8* data, VMemoryStream::BufferAllocationType allocationType, bool adoptBuffer, Vs64 suppliedBufferSize, Vs64 suppliedEOFOffset) : VBentoAttribute(name, DATA_TYPE_ID()), mValue(data, allocationType, adoptBuffer, suppliedBufferSize, suppliedEOFOffset) {} ///< Constructs from supplied name and information.
+        VBentoBinary(VBinaryIOStream& stream) : VBentoAttribute(stream, DATA_TYPE_ATOM()), mValue(0) { Vs64 length = VBentoNode::_readLengthFromStream(stream); (void) VStream::streamCopy(stream, mValue, length); } ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoBinary(const VString& name, const Vu8* data, Vs64 length) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(0) { (void) mValue.write(data, length); } ///< Constructs from supplied name and data that is copied.
+        VBentoBinary(const VString& name, Vu8* data, VMemoryStream::BufferAllocationType allocationType, bool adoptBuffer, Vs64 suppliedBufferSize, Vs64 suppliedEOFOffset) : VBentoAttribute(name, DATA_TYPE_ATOM()), mValue(data, allocationType, adoptBuffer, suppliedBufferSize, suppliedEOFOffset) {} ///< Constructs from supplied name and information.
         virtual ~VBentoBinary() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoBinary(this->getName(), mValue.getBuffer(), mValue.getEOFOffset()); }
@@ -1901,7 +2174,9 @@ class VBentoUnknownValue : public VBentoAttribute {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("unkn"); return kID; } ///< The data type name / class ID string.
 
-        VBentoUnknownValue() : mValue() {} ///< Constructs with uninitialized name and empty stream.
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
+        VBentoUnknownValue() : mOriginalDataType(), mValue() {} ///< Constructs with uninitialized name and empty stream.
         VBentoUnknownValue(VBinaryIOStream& stream, Vs64 dataLength, const VString& dataType); ///< Constructs by reading from stream. @param stream the stream to read @param dataLength the length of stream data to read @param dataType the original data type value
         virtual ~VBentoUnknownValue() {} ///< Destructor.
 
@@ -1913,6 +2188,7 @@ class VBentoUnknownValue : public VBentoAttribute {
         virtual void getValueAsBentoTextString(VString& s) const { VHex::bufferToHexString(mValue.getBuffer(), mValue.getEOFOffset(), s, true/* want leading "0x" */); }
 
         inline const VMemoryStream& getValue() const { return mValue; } ///< Returns the attribute's value. @return a reference to the unknown-typed data stream
+        virtual const VString& getDataType() const { return mOriginalDataType; } ///< Returns the original data type name, which is written back out; getDataTypeAtom() is DATA_TYPE_ATOM(). @return a reference to the data type name string
 
     protected:
 
@@ -1921,7 +2197,8 @@ class VBentoUnknownValue : public VBentoAttribute {
 
     private:
 
-        VMemoryStream mValue; ///< The attribute value.
+        VString       mOriginalDataType;    ///< The data type name as read from the stream.
+        VMemoryStream mValue;               ///< The attribute value.
 };
 
 /**
@@ -1932,8 +2209,8 @@ class VBentoArray : public VBentoAttribute {
     public:
 
         VBentoArray() : VBentoAttribute() {} ///< Constructs with uninitialized name and value.
-        VBentoArray(VBinaryIOStream& stream, const VString& dataType) : VBentoAttribute(stream, dataType) {} ///< Constructs by reading from stream. @param stream the stream to read @param dataType the data type of the concrete subclass
-        VBentoArray(const VString& name, const VString& dataType) : VBentoAttribute(name, dataType) {} ///< Constructs from supplied name and value.
+        VBentoArray(VBinaryIOStream& stream, const VStringAtom& dataType) : VBentoAttribute(stream, dataType) {} ///< Constructs by reading from stream. @param stream the stream to read @param dataType the data type of the concrete subclass
+        VBentoArray(const VString& name, const VStringAtom& dataType) : VBentoAttribute(name, dataType) {} ///< Constructs from supplied name and value.
         virtual ~VBentoArray() {} ///< Destructor.
 
         VBentoArray& operator=(const VBentoArray& rhs) { VBentoAttribute::operator=(rhs); return *this; }
@@ -1950,6 +2227,26 @@ class VBentoArray : public VBentoAttribute {
         virtual int _getNumElements() const = 0;
         virtual void _appendElementBentoText(int elementIndex, VString& s) const = 0;
 
+        /**
+        Reads an element count and then the elements from the stream. The count comes straight off the
+        wire, so the vector grows a bounded chunk at a time; a corrupt or hostile count cannot force a
+        huge allocation before the stream runs out of data.
+        @param  stream          the stream to read
+        @param  values          the vector to append the elements to
+        @param  readElements    the VBinaryIOStream function that reads an array of elements
+        */
+        template <typename T> static void _readElementsFromStream(VBinaryIOStream& stream, std::vector<T>& values, void (VBinaryIOStream::*readElements)(T*, int)) {
+            const int kMaxElementsPerRead = 65536;
+            int numElements = stream.readInt32();
+            while (numElements > 0) {
+                const int numToRead = V_MIN(numElements, kMaxElementsPerRead);
+                const size_t start = values.size();
+                values.resize(start + static_cast<size_t>(numToRead));
+                (stream.*readElements)(&values[start], numToRead);
+                numElements -= numToRead;
+            }
+        }
+
     private:
 
         void _getValueAsBentoTextString(VString& s) const;
@@ -1965,10 +2262,13 @@ class VBentoS8Array : public VBentoArray {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("s8_a"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoS8Array() : VBentoArray(), mValue() {} ///< Constructs with uninitialized name and an initially empty array.
-        VBentoS8Array(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ID()), mValue() { int numElements = static_cast<int>(stream.readS32()); for (int i = 0; i < numElements; ++i) mValue.push_back(stream.readS8()); } ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoS8Array(const VString& name) : VBentoArray(name, DATA_TYPE_ID()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
-        VBentoS8Array(const VString& name, const Vs8Array& elements) : VBentoArray(name, DATA_TYPE_ID()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoS8Array(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ATOM()), mValue() { _readElementsFromStream(stream, mValue, &VBinaryIOStream::readS8Array); } ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoS8Array(const VString& name) : VBentoArray(name, DATA_TYPE_ATOM()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
+        VBentoS8Array(const VString& name, const Vs8Array& elements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoS8Array(const VString& name, const Vs8* elements, int numElements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements, elements + numElements) {} ///< Constructs from supplied name and a caller's buffer of elements, copied in one pass. @param name the attribute name @param elements the elements to copy @param numElements the number of elements
         virtual ~VBentoS8Array() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoS8Array(this->getName(), mValue); }
@@ -1978,13 +2278,14 @@ class VBentoS8Array : public VBentoArray {
         inline void setValue(const Vs8Array& elements) { mValue = elements; } ///< Sets the attribute's value. @param elements the vector of elements
         inline void appendValue(Vs8 element) { mValue.push_back(element); } ///< Appends to the attribute's value. @param element the element to append
         inline void appendValues(const Vs8Array& elements) { mValue.insert(mValue.end(), elements.begin(), elements.end()); } ///< Appends to the attribute's value. @param elements the vector of elements
+        inline void adoptValue(Vs8Array& elements) { mValue.swap(elements); } ///< Takes the supplied vector's storage as the attribute's value without copying; the supplied vector receives the previous value. @param elements the vector of elements to adopt
 
         virtual void writeToXMLTextStream(VTextIOStream& stream, bool lineWrap, int depth) const; ///< Override to form this complex attribute as a child tag with its own attributes.
 
     protected:
 
         virtual Vs64 getDataLength() const { return 4 + (1 * mValue.size()); } ///< Returns the length of this object's raw data only. @return the length of the object's raw data
-        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); for (Vs8Array::const_iterator i = mValue.begin(); i != mValue.end(); ++i) stream.writeS8(*i); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
+        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); if (numElements > 0) stream.writeS8Array(&mValue[0], numElements); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
 
         virtual int _getNumElements() const { return static_cast<int>(mValue.size()); }
         virtual void _appendElementBentoText(int elementIndex, VString& s) const { s += mValue[elementIndex]; }
@@ -2004,10 +2305,13 @@ class VBentoS16Array : public VBentoArray {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("s16a"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoS16Array() : VBentoArray(), mValue() {} ///< Constructs with uninitialized name and an initially empty array.
-        VBentoS16Array(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ID()), mValue() { int numElements = static_cast<int>(stream.readS32()); for (int i = 0; i < numElements; ++i) mValue.push_back(stream.readS16()); } ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoS16Array(const VString& name) : VBentoArray(name, DATA_TYPE_ID()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
-        VBentoS16Array(const VString& name, const Vs16Array& elements) : VBentoArray(name, DATA_TYPE_ID()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoS16Array(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ATOM()), mValue() { _readElementsFromStream(stream, mValue, &VBinaryIOStream::readS16Array); } ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoS16Array(const VString& name) : VBentoArray(name, DATA_TYPE_ATOM()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
+        VBentoS16Array(const VString& name, const Vs16Array& elements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoS16Array(const VString& name, const Vs16* elements, int numElements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements, elements + numElements) {} ///< Constructs from supplied name and a caller's buffer of elements, copied in one pass. @param name the attribute name @param elements the elements to copy @param numElements the number of elements
         virtual ~VBentoS16Array() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoS16Array(this->getName(), mValue); }
@@ -2017,13 +2321,14 @@ class VBentoS16Array : public VBentoArray {
         inline void setValue(const Vs16Array& elements) { mValue = elements; } ///< Sets the attribute's value. @param elements the vector of elements
         inline void appendValue(Vs16 element) { mValue.push_back(element); } ///< Appends to the attribute's value. @param element the element to append
         inline void appendValues(const Vs16Array& elements) { mValue.insert(mValue.end(), elements.begin(), elements.end()); } ///< Appends to the attribute's value. @param elements the vector of elements
+        inline void adoptValue(Vs16Array& elements) { mValue.swap(elements); } ///< Takes the supplied vector's storage as the attribute's value without copying; the supplied vector receives the previous value. @param elements the vector of elements to adopt
 
         virtual void writeToXMLTextStream(VTextIOStream& stream, bool lineWrap, int depth) const; ///< Override to form this complex attribute as a child tag with its own attributes.
 
     protected:
 
         virtual Vs64 getDataLength() const { return 4 + (2 * mValue.size()); } ///< Returns the length of this object's raw data only. @return the length of the object's raw data
-        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); for (Vs16Array::const_iterator i = mValue.begin(); i != mValue.end(); ++i) stream.writeS16(*i); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
+        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); if (numElements > 0) stream.writeS16Array(&mValue[0], numElements); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
 
         virtual int _getNumElements() const { return static_cast<int>(mValue.size()); }
         virtual void _appendElementBentoText(int elementIndex, VString& s) const { s += mValue[elementIndex]; }
@@ -2043,10 +2348,13 @@ class VBentoS32Array : public VBentoArray {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("s32a"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoS32Array() : VBentoArray(), mValue() {} ///< Constructs with uninitialized name and an initially empty array.
-        VBentoS32Array(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ID()), mValue() { int numElements = static_cast<int>(stream.readS32()); for (int i = 0; i < numElements; ++i) mValue.push_back(stream.readS32()); } ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoS32Array(const VString& name) : VBentoArray(name, DATA_TYPE_ID()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
-        VBentoS32Array(const VString& name, const Vs32Array& elements) : VBentoArray(name, DATA_TYPE_ID()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoS32Array(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ATOM()), mValue() { _readElementsFromStream(stream, mValue, &VBinaryIOStream::readS32Array); } ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoS32Array(const VString& name) : VBentoArray(name, DATA_TYPE_ATOM()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
+        VBentoS32Array(const VString& name, const Vs32Array& elements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoS32Array(const VString& name, const Vs32* elements, int numElements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements, elements + numElements) {} ///< Constructs from supplied name and a caller's buffer of elements, copied in one pass. @param name the attribute name @param elements the elements to copy @param numElements the number of elements
         virtual ~VBentoS32Array() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoS32Array(this->getName(), mValue); }
@@ -2056,13 +2364,14 @@ class VBentoS32Array : public VBentoArray {
         inline void setValue(const Vs32Array& elements) { mValue = elements; } ///< Sets the attribute's value. @param elements the vector of elements
         inline void appendValue(Vs32 element) { mValue.push_back(element); } ///< Appends to the attribute's value. @param element the element to append
         inline void appendValues(const Vs32Array& elements) { mValue.insert(mValue.end(), elements.begin(), elements.end()); } ///< Appends to the attribute's value. @param elements the vector of elements
+        inline void adoptValue(Vs32Array& elements) { mValue.swap(elements); } ///< Takes the supplied vector's storage as the attribute's value without copying; the supplied vector receives the previous value. @param elements the vector of elements to adopt
 
         virtual void writeToXMLTextStream(VTextIOStream& stream, bool lineWrap, int depth) const; ///< Override to form this complex attribute as a child tag with its own attributes.
 
     protected:
 
         virtual Vs64 getDataLength() const { return 4 + (4 * mValue.size()); } ///< Returns the length of this object's raw data only. @return the length of the object's raw data
-        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); for (Vs32Array::const_iterator i = mValue.begin(); i != mValue.end(); ++i) stream.writeS32(*i); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
+        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); if (numElements > 0) stream.writeS32Array(&mValue[0], numElements); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
 
         virtual int _getNumElements() const { return static_cast<int>(mValue.size()); }
         virtual void _appendElementBentoText(int elementIndex, VString& s) const { s += mValue[elementIndex]; }
@@ -2082,10 +2391,13 @@ class VBentoS64Array : public VBentoArray {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("s64a"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoS64Array() : VBentoArray(), mValue() {} ///< Constructs with uninitialized name and an initially empty array.
-        VBentoS64Array(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ID()), mValue() { int numElements = static_cast<int>(stream.readS32()); for (int i = 0; i < numElements; ++i) mValue.push_back(stream.readS64()); } ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoS64Array(const VString& name) : VBentoArray(name, DATA_TYPE_ID()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
-        VBentoS64Array(const VString& name, const Vs64Array& elements) : VBentoArray(name, DATA_TYPE_ID()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoS64Array(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ATOM()), mValue() { _readElementsFromStream(stream, mValue, &VBinaryIOStream::readS64Array); } ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoS64Array(const VString& name) : VBentoArray(name, DATA_TYPE_ATOM()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
+        VBentoS64Array(const VString& name, const Vs64Array& elements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoS64Array(const VString& name, const Vs64* elements, int numElements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements, elements + numElements) {} ///< Constructs from supplied name and a caller's buffer of elements, copied in one pass. @param name the attribute name @param elements the elements to copy @param numElements the number of elements
         virtual ~VBentoS64Array() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoS64Array(this->getName(), mValue); }
@@ -2095,13 +2407,14 @@ class VBentoS64Array : public VBentoArray {
         inline void setValue(const Vs64Array& elements) { mValue = elements; } ///< Sets the attribute's value. @param elements the vector of elements
         inline void appendValue(Vs64 element) { mValue.push_back(element); } ///< Appends to the attribute's value. @param element the element to append
         inline void appendValues(const Vs64Array& elements) { mValue.insert(mValue.end(), elements.begin(), elements.end()); } ///< Appends to the attribute's value. @param elements the vector of elements
+        inline void adoptValue(Vs64Array& elements) { mValue.swap(elements); } ///< Takes the supplied vector's storage as the attribute's value without copying; the supplied vector receives the previous value. @param elements the vector of elements to adopt
 
         virtual void writeToXMLTextStream(VTextIOStream& stream, bool lineWrap, int depth) const; ///< Override to form this complex attribute as a child tag with its own attributes.
 
     protected:
 
         virtual Vs64 getDataLength() const { return 4 + (8 * mValue.size()); } ///< Returns the length of this object's raw data only. @return the length of the object's raw data
-        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); for (Vs64Array::const_iterator i = mValue.begin(); i != mValue.end(); ++i) stream.writeS64(*i); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
+        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); if (numElements > 0) stream.writeS64Array(&mValue[0], numElements); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
 
         virtual int _getNumElements() const { return static_cast<int>(mValue.size()); }
         virtual void _appendElementBentoText(int elementIndex, VString& s) const { s += mValue[elementIndex]; }
@@ -2121,10 +2434,12 @@ class VBentoStringArray : public VBentoArray {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("vsta"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoStringArray() : VBentoArray(), mValue() {} ///< Constructs with uninitialized name and an initially empty array.
-        VBentoStringArray(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ID()), mValue() { int numElements = static_cast<int>(stream.readS32()); for (int i = 0; i < numElements; ++i) mValue.push_back(stream.readString()); } ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoStringArray(const VString& name) : VBentoArray(name, DATA_TYPE_ID()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
-        VBentoStringArray(const VString& name, const VStringVector& elements) : VBentoArray(name, DATA_TYPE_ID()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoStringArray(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ATOM()), mValue() { int numElements = static_cast<int>(stream.readS32()); for (int i = 0; i < numElements; ++i) mValue.push_back(stream.readString()); } ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoStringArray(const VString& name) : VBentoArray(name, DATA_TYPE_ATOM()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
+        VBentoStringArray(const VString& name, const VStringVector& elements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
         virtual ~VBentoStringArray() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoStringArray(this->getName(), mValue); }
@@ -2160,10 +2475,12 @@ class VBentoBoolArray : public VBentoArray {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("booa"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoBoolArray() : VBentoArray(), mValue() {} ///< Constructs with uninitialized name and an initially empty array.
-        VBentoBoolArray(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ID()), mValue() { int numElements = static_cast<int>(stream.readS32()); for (int i = 0; i < numElements; ++i) mValue.push_back(stream.readBool()); } ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoBoolArray(const VString& name) : VBentoArray(name, DATA_TYPE_ID()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
-        VBentoBoolArray(const VString& name, const VBoolArray& elements) : VBentoArray(name, DATA_TYPE_ID()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoBoolArray(VBinaryIOStream& stream); ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoBoolArray(const VString& name) : VBentoArray(name, DATA_TYPE_ATOM()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
+        VBentoBoolArray(const VString& name, const VBoolArray& elements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
         virtual ~VBentoBoolArray() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoBoolArray(this->getName(), mValue); }
@@ -2179,7 +2496,7 @@ class VBentoBoolArray : public VBentoArray {
     protected:
 
         virtual Vs64 getDataLength() const { return 4 + (1 * mValue.size()); } ///< Returns the length of this object's raw data only. @return the length of the object's raw data
-        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); for (VBoolArray::const_iterator i = mValue.begin(); i != mValue.end(); ++i) stream.writeBool(*i); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
+        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const; ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
 
         virtual int _getNumElements() const { return static_cast<int>(mValue.size()); }
         virtual void _appendElementBentoText(int elementIndex, VString& s) const { s += (mValue[elementIndex] ? "true" : "false"); }
@@ -2199,10 +2516,13 @@ class VBentoDoubleArray : public VBentoArray {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("duba"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoDoubleArray() : VBentoArray(), mValue() {} ///< Constructs with uninitialized name and an initially empty array.
-        VBentoDoubleArray(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ID()), mValue() { int numElements = static_cast<int>(stream.readS32()); for (int i = 0; i < numElements; ++i) mValue.push_back(stream.readDouble()); } ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoDoubleArray(const VString& name) : VBentoArray(name, DATA_TYPE_ID()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
-        VBentoDoubleArray(const VString& name, const VDoubleArray& elements) : VBentoArray(name, DATA_TYPE_ID()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoDoubleArray(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ATOM()), mValue() { _readElementsFromStream(stream, mValue, &VBinaryIOStream::readDoubleArray); } ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoDoubleArray(const VString& name) : VBentoArray(name, DATA_TYPE_ATOM()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
+        VBentoDoubleArray(const VString& name, const VDoubleArray& elements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoDoubleArray(const VString& name, const VDouble* elements, int numElements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements, elements + numElements) {} ///< Constructs from supplied name and a caller's buffer of elements, copied in one pass. @param name the attribute name @param elements the elements to copy @param numElements the number of elements
         virtual ~VBentoDoubleArray() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoDoubleArray(this->getName(), mValue); }
@@ -2212,16 +2532,17 @@ class VBentoDoubleArray : public VBentoArray {
         inline void setValue(const VDoubleArray& elements) { mValue = elements; } ///< Sets the attribute's value. @param elements the vector of elements
         inline void appendValue(VDouble element) { mValue.push_back(element); } ///< Appends to the attribute's value. @param element the element to append
         inline void appendValues(const VDoubleArray& elements) { mValue.insert(mValue.end(), elements.begin(), elements.end()); } ///< Appends to the attribute's value. @param elements the vector of elements
+        inline void adoptValue(VDoubleArray& elements) { mValue.swap(elements); } ///< Takes the supplied vector's storage as the attribute's value without copying; the supplied vector receives the previous value. @param elements the vector of elements to adopt
 
         virtual void writeToXMLTextStream(VTextIOStream& stream, bool lineWrap, int depth) const; ///< Override to form this complex attribute as a child tag with its own attributes.
 
     protected:
 
         virtual Vs64 getDataLength() const { return 4 + (8 * mValue.size()); } ///< Returns the length of this object's raw data only. @return the length of the object's raw data
-        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); for (VDoubleArray::const_iterator i = mValue.begin(); i != mValue.end(); ++i) stream.writeDouble(*i); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
+        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); if (numElements > 0) stream.writeDoubleArray(&mValue[0], numElements); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
 
         virtual int _getNumElements() const { return static_cast<int>(mValue.size()); }
-        virtual void _appendElementBentoText(int elementIndex, VString& s) const { s += mValue[elementIndex]; }
+        virtual void _appendElementBentoText(int elementIndex, VString& s) const { s.appendRoundTrip(mValue[elementIndex]); }
 
     private:
 
@@ -2238,10 +2559,12 @@ class VBentoDurationArray : public VBentoArray {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("draa"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoDurationArray() : VBentoArray(), mValue() {} ///< Constructs with uninitialized name and an initially empty array.
-        VBentoDurationArray(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ID()), mValue() { int numElements = static_cast<int>(stream.readS32()); for (int i = 0; i < numElements; ++i) mValue.push_back(stream.readDuration()); } ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoDurationArray(const VString& name) : VBentoArray(name, DATA_TYPE_ID()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
-        VBentoDurationArray(const VString& name, const VDurationVector& elements) : VBentoArray(name, DATA_TYPE_ID()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoDurationArray(VBinaryIOStream& stream); ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoDurationArray(const VString& name) : VBentoArray(name, DATA_TYPE_ATOM()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
+        VBentoDurationArray(const VString& name, const VDurationVector& elements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
         virtual ~VBentoDurationArray() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoDurationArray(this->getName(), mValue); }
@@ -2257,7 +2580,7 @@ class VBentoDurationArray : public VBentoArray {
     protected:
 
         virtual Vs64 getDataLength() const { return 4 + (8 * mValue.size()); } ///< Returns the length of this object's raw data only. @return the length of the object's raw data
-        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); for (VDurationVector::const_iterator i = mValue.begin(); i != mValue.end(); ++i) stream.writeDuration(*i); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
+        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const; ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
 
         virtual int _getNumElements() const { return static_cast<int>(mValue.size()); }
         virtual void _appendElementBentoText(int elementIndex, VString& s) const { s += mValue[elementIndex].getDurationMilliseconds(); s += "ms"; }
@@ -2277,10 +2600,12 @@ class VBentoInstantArray : public VBentoArray {
 
         static const VString& DATA_TYPE_ID() { static const VString kID("insa"); return kID; } ///< The data type name / class ID string.
 
+        static const VStringAtom& DATA_TYPE_ATOM() { static const VStringAtom kAtom(DATA_TYPE_ID()); return kAtom; } ///< The data type name as an atom, for fast type comparison.
+
         VBentoInstantArray() : VBentoArray(), mValue() {} ///< Constructs with uninitialized name and an initially empty array.
-        VBentoInstantArray(VBinaryIOStream& stream) : VBentoArray(stream, DATA_TYPE_ID()), mValue() { int numElements = static_cast<int>(stream.readS32()); for (int i = 0; i < numElements; ++i) mValue.push_back(stream.readInstant()); } ///< Constructs by reading from stream. @param stream the stream to read
-        VBentoInstantArray(const VString& name) : VBentoArray(name, DATA_TYPE_ID()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
-        VBentoInstantArray(const VString& name, const VInstantVector& elements) : VBentoArray(name, DATA_TYPE_ID()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
+        VBentoInstantArray(VBinaryIOStream& stream); ///< Constructs by reading from stream. @param stream the stream to read
+        VBentoInstantArray(const VString& name) : VBentoArray(name, DATA_TYPE_ATOM()), mValue() {} ///< Constructs from supplied name, with an initially empty array.
+        VBentoInstantArray(const VString& name, const VInstantVector& elements) : VBentoArray(name, DATA_TYPE_ATOM()), mValue(elements) {} ///< Constructs from supplied name and array to be copied.
         virtual ~VBentoInstantArray() {} ///< Destructor.
 
         virtual VBentoAttribute* clone() const { return new VBentoInstantArray(this->getName(), mValue); }
@@ -2296,7 +2621,7 @@ class VBentoInstantArray : public VBentoArray {
     protected:
 
         virtual Vs64 getDataLength() const { return 4 + (8 * mValue.size()); } ///< Returns the length of this object's raw data only. @return the length of the object's raw data
-        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const { int numElements = static_cast<int>(mValue.size()); stream.writeS32(numElements); for (VInstantVector::const_iterator i = mValue.begin(); i != mValue.end(); ++i) stream.writeInstant(*i); } ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
+        virtual void writeDataToBinaryStream(VBinaryIOStream& stream) const; ///< Writes the object's raw data only to a binary stream. @param stream the stream to write to
 
         virtual int _getNumElements() const { return static_cast<int>(mValue.size()); }
         virtual void _appendElementBentoText(int elementIndex, VString& s) const { s += mValue[elementIndex].getUTCString(); }
@@ -295,24 +295,13 @@ void VCodePoint::writeToBinaryStream(VBinaryIOStream& stream) const {
     }
 }
 
+// In UTF-8 the number of leading 1 bits on the first byte tells us how many bytes make up the code point,
+// so the high nibble alone determines the length. Stray continuation bytes (10xxxxxx) count as 1 byte.
+static const int kUTF8LengthFromHighNibble[16] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 3, 4 };
+
 // static
 int VCodePoint::getUTF8LengthFromUTF8StartByte(Vu8 startByte) {
-    // In UTF-8 the number of leading 1 bits on the first byte tells us how many "extra" bytes make up the code point in the buffer.
-    int utf8Length = 1;
-
-    if (((startByte & 0x80) != 0x00) && ((startByte & 0x40) != 0x00)) { // test for binary 11?????? (2 bits found so far)
-        ++utf8Length;
-        
-        if ((startByte & 0x20) != 0x00) { // test for binary ??1????? (3 bits found so far)
-            ++utf8Length;
-        
-            if ((startByte & 0x10) != 0x00) { // test for binary ???1???? (4 bits found total)
-                ++utf8Length;
-            }
-        }
-    }
-    
-    return utf8Length;
+    return kUTF8LengthFromHighNibble[startByte >> 4];
 }
 
 // static
@@ -338,17 +327,104 @@ bool VCodePoint::isUTF8ContinuationByte(Vu8 byteValue) {
 
 // static
 int VCodePoint::countUTF8CodePoints(const Vu8* buffer, int numBytes) {
+    // Each ASCII run counts one code point per byte; only the non-ASCII code points between runs need stepping over.
     int numCodePoints = 0;
     int offset = 0;
     while (offset < numBytes) {
-        VCodePoint cp(buffer, offset);
-        ++numCodePoints;
-        offset += cp.getUTF8Length();
+        int asciiLength = VCodePoint::getASCIIPrefixLength(buffer + offset, numBytes - offset);
+        numCodePoints += asciiLength;
+        offset += asciiLength;
+
+        while ((offset < numBytes) && (buffer[offset] >= 0x80)) {
+            ++numCodePoints;
+            offset += VCodePoint::getUTF8LengthFromUTF8StartByte(buffer[offset]);
+        }
     }
 
     return numCodePoints;
 }
 
+static const Vu64 kEachByteHighBit = CONST_U64(0x8080808080808080);
+
+// static
+int VCodePoint::getASCIIPrefixLength(const Vu8* buffer, int numBytes) {
+    int offset = 0;
+
+    // A word with no high bit set in any lane is 8 ASCII bytes.
+    while ((numBytes - offset) >= 8) {
+        Vu64 word;
+        ::memcpy(&word, buffer + offset, sizeof(word)); // memcpy because the buffer need not be aligned; compiles to a single load
+        if ((word & kEachByteHighBit) != 0) {
+            break;
+        }
+
+        offset += 8;
+    }
+
+    while ((offset < numBytes) && (buffer[offset] < 0x80)) {
+        ++offset;
+    }
+
+    return offset;
+}
+
+// static
+bool VCodePoint::isValidUTF8(const Vu8* buffer, int numBytes) {
+    int offset = 0;
+    while (offset < numBytes) {
+        offset += VCodePoint::getASCIIPrefixLength(buffer + offset, numBytes - offset);
+        if (offset == numBytes) {
+            break;
+        }
+
+        // Validate one multi-byte sequence. The allowed range of the second byte depends on the first,
+        // which is how overlong forms, surrogates, and values above U+10FFFF are excluded.
+        Vu8 byte0 = buffer[offset];
+        Vu8 minByte1 = 0x80;
+        Vu8 maxByte1 = 0xBF;
+        int sequenceLength;
+        if (byte0 < 0xC2) { // stray continuation byte, or overlong 2-byte form of an ASCII value
+            return false;
+        } else if (byte0 < 0xE0) {
+            sequenceLength = 2;
+        } else if (byte0 < 0xF0) {
+            sequenceLength = 3;
+            if (byte0 == 0xE0) {
+                minByte1 = 0xA0; // below U+0800 is overlong
+            } else if (byte0 == 0xED) {
+                maxByte1 = 0x9F; // U+D800 to U+DFFF are UTF-16 surrogates
+            }
+        } else if (byte0 < 0xF5) {
+            sequenceLength = 4;
+            if (byte0 == 0xF0) {
+                minByte1 = 0x90; // below U+10000 is overlong
+            } else if (byte0 == 0xF4) {
+                maxByte1 = 0x8F; // above U+10FFFF
+            }
+        } else {
+            return false;
+        }
+
+        if ((numBytes - offset) < sequenceLength) {
+            return false;
+        }
+
+        if ((buffer[offset + 1] < minByte1) || (buffer[offset + 1] > maxByte1)) {
+            return false;
+        }
+
+        for (int i = 2; i < sequenceLength; ++i) {
+            if (!VCodePoint::isUTF8ContinuationByte(buffer[offset + i])) {
+                return false;
+            }
+        }
+
+        offset += sequenceLength;
+    }
+
+    return true;
+}
+
 // static
 int VCodePoint::getPreviousUTF8CodePointOffset(const Vu8* buffer, int offset) {
     int previousOffset = offset - 1;
@@ -205,6 +205,24 @@ class VCodePoint {
         */
         static int countUTF8CodePoints(const Vu8* buffer, int numBytes);
         /**
+        Returns the number of leading ASCII bytes (0x00 to 0x7F) in the specified buffer.
+        The buffer is scanned 8 bytes at a time, so this is the fast way to skip the
+        pure-ASCII runs that make up most text.
+        @param  buffer      the UTF-8 byte buffer to examine
+        @param  numBytes    the number of bytes in the buffer to examine
+        @return the number of bytes before the first non-ASCII byte; numBytes if all are ASCII
+        */
+        static int getASCIIPrefixLength(const Vu8* buffer, int numBytes);
+        /**
+        Returns true if the specified buffer is well-formed UTF-8: no stray continuation
+        bytes, no truncated sequences, no overlong forms, no UTF-16 surrogate values, and
+        nothing above U+10FFFF. ASCII runs are skipped 8 bytes at a time.
+        @param  buffer      the UTF-8 byte buffer to examine
+        @param  numBytes    the number of bytes in the buffer to examine
+        @return true if the buffer is valid UTF-8
+        */
+        static bool isValidUTF8(const Vu8* buffer, int numBytes);
+        /**
         Returns the offset of the previous UTF-8 code point start, given the offset of a given
         code point. The answer should be 1 to 4 bytes less than the specified offset, since
         UTF-8 uses 1 to 4 bytes per code point. You must not call this function with offset 0
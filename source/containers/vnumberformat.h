@@ -0,0 +1,100 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+#ifndef vnumberformat_h
+#define vnumberformat_h
+
+/** @file */
+
+#include "vtypes.h"
+
+/**
+    @ingroup vstring
+*/
+
+/**
+VNumberFormat converts numbers to and from text without allocating memory and without
+consulting the C locale: the decimal point is always '.', and there is no grouping.
+It works on caller-supplied char buffers, so VString can format straight into its
+own buffer and parse straight out of it; most code should use the VString APIs
+(operator=, operator+=, parseS64(), parseDouble(), VString::formatRoundTrip() and so on)
+rather than calling this class directly.
+
+Doubles are formatted as the shortest decimal string that parses back to exactly the
+same value (the Ryu algorithm), so text is both compact and lossless. Doubles are parsed
+with correct rounding: the common short forms are computed exactly in double arithmetic,
+and the rest (more than 15 significant digits, or large exponents) are handed to strtod()
+in a form that has no decimal point, so the locale cannot affect the result.
+*/
+class VNumberFormat {
+
+    public:
+
+        static const int kMaxIntegerLength = 20;    ///< The longest formatted Vs64 or Vu64: "-9223372036854775808" and "18446744073709551615".
+        static const int kMaxDoubleLength = 24;     ///< The longest formatted double, such as "-2.2250738585072014e-308".
+
+        /**
+        Formats a signed integer in decimal.
+        @param  value   the value to format
+        @param  buffer  the buffer to write to, at least kMaxIntegerLength chars; it is not null-terminated
+        @return the number of chars written
+        */
+        static int formatS64(Vs64 value, char* buffer);
+        /**
+        Formats an unsigned integer in decimal.
+        @param  value   the value to format
+        @param  buffer  the buffer to write to, at least kMaxIntegerLength chars; it is not null-terminated
+        @return the number of chars written
+        */
+        static int formatU64(Vu64 value, char* buffer);
+        /**
+        Formats a double as the shortest decimal string that parses back to the same value.
+        Values with a decimal exponent from -5 to 16 are written in fixed notation ("0.001",
+        "3.14", "1500"); others in scientific notation with at least two exponent digits
+        ("1e-07", "6.02214076e+23"). Infinities are "inf" and "-inf", NaN is "nan", and
+        negative zero is "-0".
+        @param  value   the value to format
+        @param  buffer  the buffer to write to, at least kMaxDoubleLength chars; it is not null-terminated
+        @return the number of chars written
+        */
+        static int formatDouble(VDouble value, char* buffer);
+
+        /**
+        Parses a signed decimal integer of the form [+|-]digits.
+        @param  chars   the text to parse; need not be null-terminated
+        @param  length  the number of chars of text; all of them must be part of the number
+        @param  value   set to the parsed value if successful; unchanged if not
+        @return true if the text is a valid integer within the Vs64 range
+        */
+        static bool parseS64(const char* chars, int length, Vs64& value);
+        /**
+        Parses an unsigned decimal integer of the form [+]digits.
+        @param  chars   the text to parse; need not be null-terminated
+        @param  length  the number of chars of text; all of them must be part of the number
+        @param  value   set to the parsed value if successful; unchanged if not
+        @return true if the text is a valid integer within the Vu64 range
+        */
+        static bool parseU64(const char* chars, int length, Vu64& value);
+        /**
+        Parses a double from the start of the text, accepting the decimal forms strtod()
+        accepts ([+|-]digits[.digits][e[+|-]digits], with either part of the mantissa
+        optional but not both) as well as "inf", "infinity" and "nan" in any case. The
+        result is correctly rounded. Parsing stops at the first char that cannot continue
+        the number, so the caller decides whether trailing text is an error.
+        @param  chars   the text to parse; need not be null-terminated
+        @param  length  the number of chars of text
+        @param  value   set to the parsed value if successful; unchanged if not
+        @return the number of chars parsed; 0 if the text does not start with a number
+        */
+        static int parseDouble(const char* chars, int length, VDouble& value);
+
+    private:
+
+        VNumberFormat(); // not instantiable; static methods only
+};
+
+#endif /* vnumberformat_h */
@@ -14,6 +14,7 @@ License: MIT. See LICENSE.md in the Vault top level directory.
 #include "vcodepoint.h"
 #include "vexception.h"
 #include "vlogger.h"
+#include "vnumberformat.h"
 
 #ifndef V_EFFICIENT_SPRINTF
 #include "vmutex.h"
@@ -99,7 +100,9 @@ VString::VString(const VString& s)
     this->_construct();
 
     int theLength = s.length();
-    if (theLength > 0) {
+    if (!s.mU.mI.mUsingInternalBuffer) {
+        this->_shareHeapBuffer(s);
+    } else if (theLength > 0) {
         this->preflight(theLength);
         s.copyToBuffer(_set(), theLength + 1);
         this->_setLength(theLength);
@@ -108,6 +111,12 @@ VString::VString(const VString& s)
     ASSERT_INVARIANT();
 }
 
+VString::VString(VString&& s) noexcept
+    {
+    this->_construct();
+    this->_takeBuffer(s);
+}
+
 VString::VString(char c)
     {
     this->_construct();
@@ -255,14 +264,16 @@ VString::VString(const VCodePoint& cp)
 
 VString::~VString() {
     if (!mU.mI.mUsingInternalBuffer) {
-        delete [] mU.mX.mHeapBufferPtr;
+        this->_releaseHeapBuffer();
     }
 }
 
 VString& VString::operator=(const VString& s) {
     ASSERT_INVARIANT();
 
-    if (this != &s) {
+    if (!s.mU.mI.mUsingInternalBuffer) {
+        this->_shareHeapBuffer(s); // Also correct when s is this string.
+    } else if (this != &s) {
         int theLength = s.length();
 
         if (theLength != 0) {
@@ -278,6 +289,18 @@ VString& VString::operator=(const VString& s) {
     return *this;
 }
 
+VString& VString::operator=(VString&& s) noexcept {
+    if (this != &s) {
+        if (!mU.mI.mUsingInternalBuffer) {
+            this->_releaseHeapBuffer();
+        }
+
+        this->_takeBuffer(s);
+    }
+
+    return *this;
+}
+
 VString& VString::operator=(const VString* s) {
     ASSERT_INVARIANT();
 
@@ -403,7 +426,7 @@ VString& VString::operator=(const std::wstring& ws) {
 VString& VString::operator=(int i) {
     ASSERT_INVARIANT();
 
-    this->format(VSTRING_FORMATTER_INT, i);
+    this->_assignS64(i);
 
     ASSERT_INVARIANT();
 
@@ -413,7 +436,7 @@ VString& VString::operator=(int i) {
 VString& VString::operator=(Vu8 i) {
     ASSERT_INVARIANT();
 
-    this->format(VSTRING_FORMATTER_U8, (int) i);
+    this->_assignU64(i);
 
     ASSERT_INVARIANT();
 
@@ -423,7 +446,7 @@ VString& VString::operator=(Vu8 i) {
 VString& VString::operator=(Vs8 i) {
     ASSERT_INVARIANT();
 
-    this->format(VSTRING_FORMATTER_S8, (int) i);
+    this->_assignS64(i);
 
     ASSERT_INVARIANT();
 
@@ -433,7 +456,7 @@ VString& VString::operator=(Vs8 i) {
 VString& VString::operator=(Vu16 i) {
     ASSERT_INVARIANT();
 
-    this->format(VSTRING_FORMATTER_U16, i);
+    this->_assignU64(i);
 
     ASSERT_INVARIANT();
 
@@ -443,7 +466,7 @@ VString& VString::operator=(Vu16 i) {
 VString& VString::operator=(Vs16 i) {
     ASSERT_INVARIANT();
 
-    this->format(VSTRING_FORMATTER_S16, i);
+    this->_assignS64(i);
 
     ASSERT_INVARIANT();
 
@@ -453,7 +476,7 @@ VString& VString::operator=(Vs16 i) {
 VString& VString::operator=(Vu32 i) {
     ASSERT_INVARIANT();
 
-    this->format(VSTRING_FORMATTER_U32, i);
+    this->_assignU64(i);
 
     ASSERT_INVARIANT();
 
@@ -464,7 +487,7 @@ VString& VString::operator=(Vu32 i) {
 VString& VString::operator=(Vs32 i) {
     ASSERT_INVARIANT();
 
-    this->format(VSTRING_FORMATTER_S32, i);
+    this->_assignS64(i);
 
     ASSERT_INVARIANT();
 
@@ -475,7 +498,7 @@ VString& VString::operator=(Vs32 i) {
 VString& VString::operator=(Vu64 i) {
     ASSERT_INVARIANT();
 
-    this->format(VSTRING_FORMATTER_U64, i);
+    this->_assignU64(i);
 
     ASSERT_INVARIANT();
 
@@ -486,7 +509,7 @@ VString& VString::operator=(Vu64 i) {
 VString& VString::operator=(Vs64 i) {
     ASSERT_INVARIANT();
 
-    this->format(VSTRING_FORMATTER_S64, i);
+    this->_assignS64(i);
 
     ASSERT_INVARIANT();
 
@@ -631,7 +654,7 @@ VString& VString::operator+=(const VCodePoint& cp) {
 VString& VString::operator+=(int i) {
     ASSERT_INVARIANT();
 
-    *this += VSTRING_INT(i);
+    this->_appendS64(i);
 
     ASSERT_INVARIANT();
 
@@ -641,7 +664,7 @@ VString& VString::operator+=(int i) {
 VString& VString::operator+=(Vu8 i) {
     ASSERT_INVARIANT();
 
-    *this += VSTRING_U8((int) i); // int case req'd for some compilers
+    this->_appendU64(i);
 
     ASSERT_INVARIANT();
 
@@ -651,7 +674,7 @@ VString& VString::operator+=(Vu8 i) {
 VString& VString::operator+=(Vs8 i) {
     ASSERT_INVARIANT();
 
-    *this += VSTRING_S8((int) i); // int case req'd for some compilers
+    this->_appendS64(i);
 
     ASSERT_INVARIANT();
 
@@ -661,7 +684,7 @@ VString& VString::operator+=(Vs8 i) {
 VString& VString::operator+=(Vu16 i) {
     ASSERT_INVARIANT();
 
-    *this += VSTRING_U16(i);
+    this->_appendU64(i);
 
     ASSERT_INVARIANT();
 
@@ -671,7 +694,7 @@ VString& VString::operator+=(Vu16 i) {
 VString& VString::operator+=(Vs16 i) {
     ASSERT_INVARIANT();
 
-    *this += VSTRING_S16(i);
+    this->_appendS64(i);
 
     ASSERT_INVARIANT();
 
@@ -681,7 +704,7 @@ VString& VString::operator+=(Vs16 i) {
 VString& VString::operator+=(Vu32 i) {
     ASSERT_INVARIANT();
 
-    *this += VSTRING_U32(i);
+    this->_appendU64(i);
 
     ASSERT_INVARIANT();
 
@@ -692,7 +715,7 @@ VString& VString::operator+=(Vu32 i) {
 VString& VString::operator+=(Vs32 i) {
     ASSERT_INVARIANT();
 
-    *this += VSTRING_S32(i);
+    this->_appendS64(i);
 
     ASSERT_INVARIANT();
 
@@ -703,7 +726,7 @@ VString& VString::operator+=(Vs32 i) {
 VString& VString::operator+=(Vu64 i) {
     ASSERT_INVARIANT();
 
-    *this += VSTRING_U64(i);
+    this->_appendU64(i);
 
     ASSERT_INVARIANT();
 
@@ -714,7 +737,7 @@ VString& VString::operator+=(Vu64 i) {
 VString& VString::operator+=(Vs64 i) {
     ASSERT_INVARIANT();
 
-    *this += VSTRING_S64(i);
+    this->_appendS64(i);
 
     ASSERT_INVARIANT();
 
@@ -925,7 +948,23 @@ int VString::getNumCodePoints() const {
         this->_determineNumCodePoints();
     }
     
-    return mU.mI.mNumCodePoints;
+    return (mU.mI.mNumCodePoints == -2) ? mU.mI.mStringLength : mU.mI.mNumCodePoints;
+}
+
+bool VString::isASCII() const {
+    ASSERT_INVARIANT();
+
+    if (mU.mI.mNumCodePoints == -1) {
+        this->_determineNumCodePoints();
+    }
+
+    return mU.mI.mNumCodePoints == mU.mI.mStringLength;
+}
+
+bool VString::isValidUTF8() const {
+    ASSERT_INVARIANT();
+
+    return this->isASCII() || VCodePoint::isValidUTF8(this->getDataBufferConst(), this->length());
 }
 
 int VString::length() const {
@@ -1060,10 +1099,82 @@ VString::operator CFStringRef() const {
 }
 #endif /* VAULT_CORE_FOUNDATION_SUPPORT */
 
+/*
+Case-insensitive comparison and hashing. Names compared this way (bento attributes,
+settings paths, logger names) are almost always ASCII, so we compare 8 bytes per step
+as a Vu64, folding 'A'-'Z' to 'a'-'z' in all 8 lanes at once with a couple of adds and
+masks. Non-ASCII lanes are left as is, so identical UTF-8 bytes still match. As soon as
+the folded words differ, or a word contains a null byte, we hand the rest of the
+comparison to strncasecmp, so the ordering is exactly what it always was.
+*/
+
+static const Vu64 kEachByte = CONST_U64(0x0101010101010101);
+static const Vu64 kEachByteHighBit = CONST_U64(0x8080808080808080);
+
+static inline char _foldASCIICase(char c) {
+    return ((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+static inline Vu64 _loadWord(const char* bytes) {
+    Vu64 word;
+    ::memcpy(&word, bytes, sizeof(word)); // memcpy because bytes need not be aligned; compiles to a single load
+    return word;
+}
+
+static inline bool _wordHasNullByte(Vu64 word) {
+    return ((word - kEachByte) & ~word & kEachByteHighBit) != 0;
+}
+
+// Folds the upper case ASCII letters in each byte lane of the word to lower case.
+static inline Vu64 _foldASCIICaseWord(Vu64 word) {
+    // Test the low 7 bits of each lane so that no add can carry into the next lane, then drop the non-ASCII lanes.
+    const Vu64 lowBits = word & ~kEachByteHighBit;
+    const Vu64 atLeastA = lowBits + (kEachByte * static_cast<Vu64>(0x80 - 'A'));
+    const Vu64 aboveZ = lowBits + (kEachByte * static_cast<Vu64>(0x7F - 'Z'));
+    const Vu64 upperCaseHighBits = atLeastA & ~aboveZ & ~word & kEachByteHighBit;
+    return word | (upperCaseHighBits >> 2); // 0x80 >> 2 is 0x20, the ASCII case bit
+}
+
+static int _compareIgnoreCase(const char* a, int aLength, const char* b, int bLength) {
+    const int commonLength = V_MIN(aLength, bLength);
+    int offset = 0;
+    for (; offset + 8 <= commonLength; offset += 8) {
+        const Vu64 aWord = _loadWord(a + offset);
+        const Vu64 bWord = _loadWord(b + offset);
+        if (((aWord != bWord) && (_foldASCIICaseWord(aWord) != _foldASCIICaseWord(bWord))) || _wordHasNullByte(aWord)) {
+            break;
+        }
+    }
+
+    if ((offset == commonLength) && (aLength == bLength)) {
+        return 0;
+    }
+
+    return vault::strcasecmp(a + offset, b + offset);
+}
+
+static VSizeType _hashBytes(const char* bytes, int length, bool foldCase) {
+    // FNV-1a over 8-byte words rather than single bytes, with a final mix so the high bits affect the low bits.
+    Vu64 hash = CONST_U64(0xcbf29ce484222325) ^ static_cast<Vu64>(length);
+    int offset = 0;
+    for (; offset + 8 <= length; offset += 8) {
+        const Vu64 word = _loadWord(bytes + offset);
+        hash = (hash ^ (foldCase ? _foldASCIICaseWord(word) : word)) * CONST_U64(0x100000001b3);
+    }
+
+    // The leftover bytes go into the low lanes of a zeroed word, the same lanes _loadWord would have used.
+    Vu64 tail = 0;
+    ::memcpy(&tail, bytes + offset, static_cast<VSizeType>(length - offset));
+    hash = (hash ^ (foldCase ? _foldASCIICaseWord(tail) : tail)) * CONST_U64(0x100000001b3);
+    hash ^= hash >> 32;
+    return static_cast<VSizeType>(hash);
+}
+
 bool VString::equalsIgnoreCase(const VString& s) const {
     ASSERT_INVARIANT();
 
-    return this->equalsIgnoreCase(s.chars());
+    // Case folding never changes the length, so different lengths means not equal.
+    return (mU.mI.mStringLength == s.length()) && (_compareIgnoreCase(_get(), mU.mI.mStringLength, s.chars(), s.length()) == 0);
 }
 
 bool VString::equalsIgnoreCase(const char* s) const {
@@ -1087,13 +1198,25 @@ int VString::compare(const char* s) const {
 int VString::compareIgnoreCase(const VString& s) const {
     ASSERT_INVARIANT();
 
-    return this->compareIgnoreCase(s.chars());
+    return _compareIgnoreCase(_get(), mU.mI.mStringLength, s.chars(), s.length());
 }
 
 int VString::compareIgnoreCase(const char* s) const {
     ASSERT_INVARIANT();
 
-    return vault::strcasecmp(_get(), s);
+    return _compareIgnoreCase(_get(), mU.mI.mStringLength, s, static_cast<int>(::strlen(s)));
+}
+
+VSizeType VString::hashValue() const {
+    ASSERT_INVARIANT();
+
+    return _hashBytes(_get(), mU.mI.mStringLength, false);
+}
+
+VSizeType VString::hashValueIgnoreCase() const {
+    ASSERT_INVARIANT();
+
+    return _hashBytes(_get(), mU.mI.mStringLength, true);
 }
 
 bool VString::startsWith(const VString& s) const {
@@ -1201,15 +1324,93 @@ VString::iterator VString::find(const VCodePoint& cp, const VString::iterator& s
     return this->end();
 }
 
+/*
+Substring search. Searching is done on the UTF-8 bytes; because no UTF-8 code point's
+encoding appears inside another's, a match of a whole search string always starts and
+ends on code point boundaries, so the byte offsets we return are valid iterator offsets.
+For a multi-byte search string, memchr (which the C library vectorizes) skips ahead to
+each occurrence of the first byte, and we compare the last byte before comparing the
+rest; in typical text this rejects almost every candidate without a memcmp.
+*/
+
+static const char* _findBytes(const char* buffer, int bufferLength, const char* searchBytes, int searchLength) {
+    if ((searchLength <= 0) || (searchLength > bufferLength)) {
+        return NULL;
+    }
+
+    const char firstByte = searchBytes[0];
+    if (searchLength == 1) {
+        return static_cast<const char*>(::memchr(buffer, firstByte, static_cast<VSizeType>(bufferLength)));
+    }
+
+    const char lastByte = searchBytes[searchLength - 1];
+    const char* candidate = buffer;
+    const char* candidatesEnd = buffer + (bufferLength - searchLength + 1); // a match cannot start at or after here
+    while (candidate < candidatesEnd) {
+        candidate = static_cast<const char*>(::memchr(candidate, firstByte, static_cast<VSizeType>(candidatesEnd - candidate)));
+        if (candidate == NULL) {
+            return NULL;
+        }
+
+        if ((candidate[searchLength - 1] == lastByte) && (::memcmp(candidate + 1, searchBytes + 1, static_cast<VSizeType>(searchLength - 2)) == 0)) {
+            return candidate;
+        }
+
+        ++candidate;
+    }
+
+    return NULL;
+}
+
+static const char* _findBytesIgnoreCase(const char* buffer, int bufferLength, const char* searchBytes, int searchLength) {
+    if ((searchLength <= 0) || (searchLength > bufferLength)) {
+        return NULL;
+    }
+
+    const char firstByte = _foldASCIICase(searchBytes[0]);
+    const char lastByte = _foldASCIICase(searchBytes[searchLength - 1]);
+    const char* candidatesEnd = buffer + (bufferLength - searchLength + 1);
+    for (const char* candidate = buffer; candidate < candidatesEnd; ++candidate) {
+        if ((_foldASCIICase(candidate[0]) == firstByte) &&
+                (_foldASCIICase(candidate[searchLength - 1]) == lastByte) &&
+                (vault::strncasecmp(candidate, searchBytes, static_cast<VSizeType>(searchLength)) == 0)) {
+            return candidate;
+        }
+    }
+
+    return NULL;
+}
+
+static const char* _findLastBytes(const char* buffer, int lastCandidateOffset, const char* searchBytes, int searchLength, bool caseSensitive) {
+    if (searchLength <= 0) {
+        return NULL;
+    }
+
+    const char firstByte = caseSensitive ? searchBytes[0] : _foldASCIICase(searchBytes[0]);
+    const char lastByte = caseSensitive ? searchBytes[searchLength - 1] : _foldASCIICase(searchBytes[searchLength - 1]);
+    for (const char* candidate = buffer + lastCandidateOffset; candidate >= buffer; --candidate) {
+        if (caseSensitive) {
+            if ((candidate[0] == firstByte) && (candidate[searchLength - 1] == lastByte) &&
+                    (::memcmp(candidate, searchBytes, static_cast<VSizeType>(searchLength)) == 0)) {
+                return candidate;
+            }
+        } else if ((_foldASCIICase(candidate[0]) == firstByte) && (_foldASCIICase(candidate[searchLength - 1]) == lastByte) &&
+                (vault::strncasecmp(candidate, searchBytes, static_cast<VSizeType>(searchLength)) == 0)) {
+            return candidate;
+        }
+    }
+
+    return NULL;
+}
+
 int VString::indexOf(char c, int fromIndex) const {
     ASSERT_INVARIANT();
 
     if ((fromIndex >= 0) && (fromIndex < mU.mI.mStringLength)) {
         const char* buf = _get();
-        for (int i = fromIndex; i < mU.mI.mStringLength; ++i) {
-            if (buf[i] == c) {
-                return i;
-            }
+        const char* found = static_cast<const char*>(::memchr(buf + fromIndex, c, static_cast<VSizeType>(mU.mI.mStringLength - fromIndex)));
+        if (found != NULL) {
+            return static_cast<int>(found - buf);
         }
     }
 
@@ -1234,42 +1435,33 @@ int VString::indexOfIgnoreCase(char c, int fromIndex) const {
 int VString::indexOf(const VString& s, int fromIndex) const {
     ASSERT_INVARIANT();
 
-    if (fromIndex < 0)
+    if ((fromIndex < 0) || (fromIndex >= mU.mI.mStringLength)) {
         return -1;
-
-    int otherLength = s.length();
-
-    for (int i = fromIndex; i < mU.mI.mStringLength; ++i) {
-        if (this->regionMatches(i, s, 0, otherLength)) {
-            return i;
-        }
     }
 
-    return -1;
+    const char* buf = _get();
+    const char* found = _findBytes(buf + fromIndex, mU.mI.mStringLength - fromIndex, s.chars(), s.length());
+
+    return (found == NULL) ? -1 : static_cast<int>(found - buf);
 }
 
 int VString::indexOfIgnoreCase(const VString& s, int fromIndex) const {
     ASSERT_INVARIANT();
 
-    if (fromIndex < 0) {
+    if ((fromIndex < 0) || (fromIndex >= mU.mI.mStringLength)) {
         return -1;
     }
 
-    int otherLength = s.length();
-
-    for (int i = fromIndex; i < mU.mI.mStringLength; ++i) {
-        if (this->regionMatches(i, s, 0, otherLength, /* caseSensitive = */ false)) {
-            return i;
-        }
-    }
+    const char* buf = _get();
+    const char* found = _findBytesIgnoreCase(buf + fromIndex, mU.mI.mStringLength - fromIndex, s.chars(), s.length());
 
-    return -1;
+    return (found == NULL) ? -1 : static_cast<int>(found - buf);
 }
 
 int VString::lastIndexOf(char c, int fromIndex) const {
     ASSERT_INVARIANT();
 
-    if (fromIndex == -1) {
+    if ((fromIndex == -1) || (fromIndex >= mU.mI.mStringLength)) {
         fromIndex = mU.mI.mStringLength - 1;
     }
 
@@ -1286,7 +1478,7 @@ int VString::lastIndexOf(char c, int fromIndex) const {
 int VString::lastIndexOfIgnoreCase(char c, int fromIndex) const {
     ASSERT_INVARIANT();
 
-    if (fromIndex == -1) {
+    if ((fromIndex == -1) || (fromIndex >= mU.mI.mStringLength)) {
         fromIndex = mU.mI.mStringLength - 1;
     }
 
@@ -1309,13 +1501,15 @@ int VString::lastIndexOf(const VString& s, int fromIndex) const {
         fromIndex = mU.mI.mStringLength;
     }
 
-    for (int i = fromIndex; i >= 0; --i) {
-        if (this->regionMatches(i, s, 0, otherLength)) {
-            return i;
-        }
+    int lastCandidateOffset = V_MIN(fromIndex, mU.mI.mStringLength - otherLength); // a match must fit
+    if ((lastCandidateOffset < 0) || (otherLength == 0)) {
+        return -1;
     }
 
-    return -1;
+    const char* buf = _get();
+    const char* found = _findLastBytes(buf, lastCandidateOffset, s.chars(), otherLength, true);
+
+    return (found == NULL) ? -1 : static_cast<int>(found - buf);
 }
 
 int VString::lastIndexOfIgnoreCase(const VString& s, int fromIndex) const {
@@ -1327,13 +1521,15 @@ int VString::lastIndexOfIgnoreCase(const VString& s, int fromIndex) const {
         fromIndex = mU.mI.mStringLength;
     }
 
-    for (int i = fromIndex; i >= 0; --i) {
-        if (this->regionMatches(i, s, 0, otherLength, /* caseSensitive = */ false)) {
-            return i;
-        }
+    int lastCandidateOffset = V_MIN(fromIndex, mU.mI.mStringLength - otherLength); // a match must fit
+    if ((lastCandidateOffset < 0) || (otherLength == 0)) {
+        return -1;
     }
 
-    return -1;
+    const char* buf = _get();
+    const char* found = _findLastBytes(buf, lastCandidateOffset, s.chars(), otherLength, false);
+
+    return (found == NULL) ? -1 : static_cast<int>(found - buf);
 }
 
 bool VString::regionMatches(int thisOffset, const VString& otherString, int otherOffset, int regionLength, bool caseSensitive) const {
@@ -1390,60 +1586,52 @@ int VString::replace(const VString& searchString, const VString& replacementStri
 
     int searchLength = searchString.length();
 
-    if (searchLength == 0) {
+    if ((searchLength == 0) || (searchLength > mU.mI.mStringLength)) {
         return 0;
     }
 
-    int replacementLength = replacementString.length();
-    int numReplacements = 0;
-    int currentOffset = caseSensitiveSearch ? this->indexOf(searchString) : this->indexOfIgnoreCase(searchString);
-
-    while ((currentOffset != -1) && (mU.mI.mStringLength != 0)) {
-        /*
-        The optimization trick here is that we can place a zero byte to artificially
-        terminate the C string buffer at the found index, creating the BEFORE part
-        as a C string. The AFTER part remains intact. And we've been supplied the
-        MIDDLE part. We simply format these 3 pieces together to form the new
-        string, and then reassign it back to ourself. This relieves us of having
-        to create multiple temporary buffers; we only create 1 temporary buffer as
-        a result of using a VString to format into.
-
-        We could further optimize by
-        combining ourself with 3 memcpy calls instead of letting vsnprintf calculate
-        the buffer length:
-        char* buffer = new char[this->length() + replacementLength - searchLength + 1];
-        1. memcpy from mBuffer[0] to buffer[0] length=currentOffset
-        2. memcpy from mBuffer[currentOffset + searchLength] to buffer[currentOffset + replacementLength] length=(this->length() - currentOffset + searchLength)
-        3. memcpy from replacementString.mBuffer to buffer[currentOffset] length=replacementLength
-        4. null terminate the buffer: buffer[length of buffer] = 0
-        (order of 1, 2, 3 is important for correct copying w/o incorrect overwriting)
-        (something like that off the top of my head)
-
-        And, if replacementLength <= searchLength we could just update in place.
-
-        FIXME: On second thought, this in-place replacement is dangerous IF we run out of memory
-        because we've broken the invariants. The problem is that we irrevocably alter our data
-        before we're guaranteed we'll succeed. This is very unlikely to actually happen, but it's possible.
-        */
-
-        char* buf = _set();
-        buf[currentOffset] = 0;    // terminate the C string buffer to create the BEFORE part
-        char*   beforePart = buf;
-        char*   afterPart = &buf[currentOffset + searchLength];
-        VString alteredString(VSTRING_ARGS("%s%s%s", beforePart, replacementString.chars(), afterPart));
-
-        // Assign the new string to ourself -- copies its buffer into ours correctly.
-        // (Could be optimized to just swap buffers if we defined a new friend function or two.)
-        *this = alteredString;
+    // Find all the matches first, so that we know the resulting length. Matches do not overlap; the
+    // search resumes after each one, exactly as if we had replaced it before looking for the next.
+    const char* buf = _get();
+    const char* bufEnd = buf + mU.mI.mStringLength;
+    const char* searchChars = searchString.chars();
+    std::vector<int> matchOffsets;
+    const char* found = buf;
+    while ((found = (caseSensitiveSearch ? _findBytes(found, static_cast<int>(bufEnd - found), searchChars, searchLength) :
+                                           _findBytesIgnoreCase(found, static_cast<int>(bufEnd - found), searchChars, searchLength))) != NULL) {
+        matchOffsets.push_back(static_cast<int>(found - buf));
+        found += searchLength;
+    }
+
+    int numReplacements = static_cast<int>(matchOffsets.size());
+    if (numReplacements == 0) {
+        return 0;
+    }
 
-        // Finally we have to move currentOffset forward past the replacement part.
-        currentOffset += replacementLength;
+    // Build the result in one pass: the text before each match, then the replacement, and finally the tail.
+    // We build it in a separate string (and then take its buffer) rather than shifting our own text for each
+    // match; this leaves us intact if the allocation fails, and lets the replacement refer to our own text.
+    int replacementLength = replacementString.length();
+    int resultLength = mU.mI.mStringLength + (numReplacements * (replacementLength - searchLength));
+    VString result;
+    result.preflight(resultLength);
+    char* resultBuf = result._set();
+    const char* replacementChars = replacementString.chars();
+    int sourceOffset = 0;
+    for (std::vector<int>::const_iterator i = matchOffsets.begin(); i != matchOffsets.end(); ++i) {
+        int unchangedLength = (*i) - sourceOffset;
+        ::memcpy(resultBuf, buf + sourceOffset, static_cast<VSizeType>(unchangedLength));
+        resultBuf += unchangedLength;
+        ::memcpy(resultBuf, replacementChars, static_cast<VSizeType>(replacementLength));
+        resultBuf += replacementLength;
+        sourceOffset = (*i) + searchLength;
+    }
 
-        ++numReplacements;
+    ::memcpy(resultBuf, buf + sourceOffset, static_cast<VSizeType>(mU.mI.mStringLength - sourceOffset));
+    result._setLength(resultLength);
 
-        // See if there is another occurrence to replace.
-        currentOffset = caseSensitiveSearch ? this->indexOf(searchString, currentOffset) : this->indexOfIgnoreCase(searchString, currentOffset);
-    }
+    // Take the result's buffer rather than copying it. Both union views are plain data, so this is a simple exchange.
+    std::swap(mU, result.mU);
 
     ASSERT_INVARIANT();
 
@@ -1485,7 +1673,7 @@ void VString::toUpperCase() {
 int VString::parseInt() const {
     ASSERT_INVARIANT();
 
-    Vs64 result = this->_parseSignedInteger();
+    Vs64 result = this->parseS64();
     Vs64 maxValue = V_MAX_S32;
     Vs64 minValue = V_MIN_S32;
 
@@ -1510,7 +1698,10 @@ int VString::parseInt() const {
 Vs64 VString::parseS64() const {
     ASSERT_INVARIANT();
 
-    Vs64 result = this->_parseSignedInteger();
+    Vs64 result = CONST_S64(0);
+    if ((mU.mI.mStringLength != 0) && !VNumberFormat::parseS64(_get(), mU.mI.mStringLength, result)) {
+        throw VRangeException(VSTRING_FORMAT("VString::parseS64 '%s' is invalid format or out of range.", _get()));
+    }
 
     return result;
 }
@@ -1518,7 +1709,10 @@ Vs64 VString::parseS64() const {
 Vu64 VString::parseU64() const {
     ASSERT_INVARIANT();
 
-    Vu64 result = this->_parseUnsignedInteger();
+    Vu64 result = CONST_U64(0);
+    if ((mU.mI.mStringLength != 0) && !VNumberFormat::parseU64(_get(), mU.mI.mStringLength, result)) {
+        throw VRangeException(VSTRING_FORMAT("VString::parseU64 '%s' is invalid format or out of range.", _get()));
+    }
 
     return result;
 }
@@ -1530,15 +1724,39 @@ VDouble VString::parseDouble() const {
         return 0.0;
     }
 
-    VDouble result;
-    int n = ::sscanf(_get(), VSTRING_FORMATTER_DOUBLE, &result);
-    if (n == 0) {
+    // Like sscanf("%lf"), skip leading whitespace and ignore any text after the number.
+    const char* buf = _get();
+    int start = 0;
+    while ((start < mU.mI.mStringLength) && VChar(buf[start]).isWhitespace()) {
+        ++start;
+    }
+
+    VDouble result = 0.0;
+    if (VNumberFormat::parseDouble(buf + start, mU.mI.mStringLength - start, result) == 0) {
         throw VRangeException(VSTRING_FORMAT("VString::parseDouble '%s' is invalid format.", _get()));
     }
 
     return result;
 }
 
+void VString::formatRoundTrip(VDouble d) {
+    ASSERT_INVARIANT();
+
+    char text[VNumberFormat::kMaxDoubleLength];
+    this->copyFromBuffer(text, 0, VNumberFormat::formatDouble(d, text));
+
+    ASSERT_INVARIANT();
+}
+
+void VString::appendRoundTrip(VDouble d) {
+    ASSERT_INVARIANT();
+
+    char text[VNumberFormat::kMaxDoubleLength];
+    this->_appendChars(text, VNumberFormat::formatDouble(d, text));
+
+    ASSERT_INVARIANT();
+}
+
 void VString::set(int i, const VChar& c) {
     ASSERT_INVARIANT();
 
@@ -1604,33 +1822,36 @@ void VString::split(VStringVector& result, const VCodePoint& delimiter, int limi
     ASSERT_INVARIANT();
 
     result.clear();
-    VString nextItem;
-    
-    for (VString::const_iterator i = this->begin(); i != this->end(); ++i) {
-        VCodePoint cp = (*i);
-        if (cp == delimiter) {
-            result.push_back(nextItem);
-            nextItem = VString::EMPTY();
-
-            if ((limit != 0) && (((int) result.size()) == limit - 1)) {
-                // We are 1 less than the limit, so the rest of the string is the remaining item.
-                this->getSubstring(nextItem, i + 1, this->end());
-                result.push_back(nextItem);
-                nextItem = VString::EMPTY();
-                break;
-            }
-        } else {
-            nextItem += cp;
+
+    // Search for the delimiter's UTF-8 bytes and copy each item directly, rather than appending code points one at a time.
+    const VString delimiterString = delimiter.toString();
+    const int delimiterLength = delimiterString.length();
+    const char* buf = _get();
+    int itemStart = 0;
+    const char* found;
+    while ((found = _findBytes(buf + itemStart, mU.mI.mStringLength - itemStart, delimiterString.chars(), delimiterLength)) != NULL) {
+        int itemEnd = static_cast<int>(found - buf);
+        result.push_back(VString::EMPTY());
+        result.back().copyFromBuffer(buf, itemStart, itemEnd);
+        itemStart = itemEnd + delimiterLength;
+
+        if ((limit != 0) && (((int) result.size()) == limit - 1)) {
+            // We are 1 less than the limit, so the rest of the string is the remaining item.
+            result.push_back(VString::EMPTY());
+            result.back().copyFromBuffer(buf, itemStart, mU.mI.mStringLength);
+            itemStart = mU.mI.mStringLength;
+            break;
         }
     }
-    
-    if (nextItem.isNotEmpty()) {
-        result.push_back(nextItem);
+
+    if (itemStart < mU.mI.mStringLength) {
+        result.push_back(VString::EMPTY());
+        result.back().copyFromBuffer(buf, itemStart, mU.mI.mStringLength);
     }
 
     // Strip trailing empty strings if specified.
     if (stripTrailingEmpties) {
-        while (result[result.size() - 1].isEmpty()) {
+        while (!result.empty() && result[result.size() - 1].isEmpty()) {
             result.erase(result.end() - 1);
         }
     }
@@ -1822,20 +2043,21 @@ void VString::preflight(int stringLength) {
         return; // Our internal buffer is in use and it's big enough.
     }
     
-    if ((!mU.mI.mUsingInternalBuffer) && (stringLength < mU.mX.mHeapBufferLength)) {
-        return; // Our external buffer is in use and it's big enough.
+    if ((!mU.mI.mUsingInternalBuffer) && (stringLength < mU.mX.mHeapBufferLength) && !this->_isSharedHeapBuffer()) {
+        return; // Our external buffer is in use, it's big enough, and it's ours alone to modify.
     }
     
     // At this point, either we need to switch from internal to external, or the
-    // external buffer is present but not big enough. So we need to allocate a new
-    // buffer, copy the old buffer (internal or external) to it, and swap it in
-    // or switch modes.
+    // external buffer is present but not big enough or shared with another string.
+    // So we need to allocate a new buffer, copy the old buffer (internal or external)
+    // to it, and swap it in or switch modes.
     
     try {
         // Allocate the buffer in reasonable sized chunks rather than using the exact size
         // requested; this easily yields an order of magnitude improvement when a string is
         // created with multiple appends.
-        int newBufferLength = stringLength + 1;
+        // When we are only unsharing a buffer, stringLength may be less than the current length.
+        int newBufferLength = V_MAX(stringLength, mU.mI.mStringLength) + 1;
         if (HEAP_BUFFER_EXPANSION_CHUNK_SIZE != 1) { // If static analyzer complains about constant comparison, disable it in the tool.
             int remainder = newBufferLength % HEAP_BUFFER_EXPANSION_CHUNK_SIZE;
             int extra = HEAP_BUFFER_EXPANSION_CHUNK_SIZE - remainder;
@@ -1843,7 +2065,7 @@ void VString::preflight(int stringLength) {
         }
 
         // This allocation will throw an exception if we run out of memory. Catch below.
-        char* newBuffer = new char[newBufferLength];
+        char* newBuffer = VString::_newHeapBuffer(newBufferLength);
 
         // Copy our old string, including the null terminator, to the new buffer.
         if (mU.mI.mStringLength == 0) {
@@ -1852,19 +2074,18 @@ void VString::preflight(int stringLength) {
             newBuffer[0] = '\0';
         } else {
             // Copy our old buffer, up to and including the null terminator byte, to the new buffer.
-            // We know that stringLength is greater than mU.mI.mStringLength, or we wouldn't be growing
-            // the buffer in the first place.
+            // We made the new buffer at least long enough for the old string above.
             ::memcpy(newBuffer, _get(), static_cast<VSizeType>(mU.mI.mStringLength + 1));
         }
 
         // Bookkeeping to switch to the new buffer.
         // If previously using the internal buffer, this means switching modes.
-        // If previously using a heap buffer, this means deleting the old one and swapping pointers.
+        // If previously using a heap buffer, this means releasing the old one and swapping pointers.
         // We haven't changed the mU.mI.mStringLength; we've merely copied data to a larger buffer.
         if (mU.mI.mUsingInternalBuffer) {
             mU.mI.mUsingInternalBuffer = false;
         } else {
-            delete [] mU.mX.mHeapBufferPtr;
+            this->_releaseHeapBuffer();
         }
 
         mU.mX.mHeapBufferPtr = newBuffer;
@@ -1933,8 +2154,15 @@ char* VString::orphanDataBuffer() {
         mU.mI.mNumCodePoints = 0;
 
     } else {
-        // hand back our heap buffer, and then switch to our internal buffer as empty
-        orphanedBuffer = mU.mX.mHeapBufferPtr;
+        // hand back our heap buffer, or a copy if it is shared, and then switch to our internal buffer as empty
+        if (this->_isSharedHeapBuffer()) {
+            orphanedBuffer = new char[1 + mU.mI.mStringLength];
+            ::memcpy(orphanedBuffer, _get(), static_cast<VSizeType>(1 + mU.mI.mStringLength));
+            this->_releaseHeapBuffer();
+        } else {
+            orphanedBuffer = mU.mX.mHeapBufferPtr; // The reference count after the chars is simply part of what the caller deletes.
+        }
+
         mU.mX.mHeapBufferPtr = NULL;
         mU.mX.mHeapBufferLength = 0;
 
@@ -1962,35 +2190,128 @@ void VString::postflight(int stringLength) {
 }
 
 #ifdef VAULT_VARARG_STRING_FORMATTING_SUPPORT
+static const int STACK_FORMATTING_BUFFER_SIZE = 512; ///< Size of the stack buffer vaFormat() tries first; most formatted strings fit.
+
 void VString::vaFormat(const char* formatText, va_list args) {
     ASSERT_INVARIANT();
 
     if (formatText == NULL) {
         this->_setLength(0);
     } else {
+        // Most formatted strings are short, so we first format into a stack buffer. Only if the
+        // result does not fit do we preflight to the reported length and format a second time.
+        // Both paths format into a separate buffer before touching ours, so an argument may safely
+        // point into our own buffer even though preflight() may reallocate it.
         va_list argsCopy;
         va_copy(argsCopy, args);
-        int newStringLength = VString::_determineSprintfLength(formatText, args);
-
-        if (newStringLength == -1) {
-            // We were unable to determine the buffer length needed. Log an error and make the preflight
-            // use as big a buffer as we dare: how about the size of the temporary formatting buffer.
-            const int kTruncatedStringLength = 32768;
-            VLOGGER_ERROR(VSTRING_FORMAT("VString: formatted string will be truncated to %d characaters.", kTruncatedStringLength));
-            newStringLength = kTruncatedStringLength;
-        }
+        char stackBuffer[STACK_FORMATTING_BUFFER_SIZE];
+        int newStringLength = vault::vsnprintf(stackBuffer, sizeof(stackBuffer), formatText, args);
 
-        this->preflight(newStringLength);
+        if ((newStringLength >= 0) && (newStringLength < STACK_FORMATTING_BUFFER_SIZE)) {
+            this->preflight(newStringLength);
+            ::memcpy(_set(), stackBuffer, static_cast<VSizeType>(newStringLength));
+            this->_setLength(newStringLength); // could call postflight, but would do extra assertion check
+        } else {
+            if (newStringLength < 0) {
+                // Some libraries only tell us the result did not fit, so measure it the hard way.
+                va_list lengthArgs;
+                va_copy(lengthArgs, argsCopy);
+                newStringLength = VString::_determineSprintfLength(formatText, lengthArgs);
+                va_end(lengthArgs);
+            }
 
-        (void) vault::vsnprintf(_set(), static_cast<VSizeType>(this->_getBufferLength()), formatText, argsCopy);
+            if (newStringLength == -1) {
+                // We were unable to determine the buffer length needed. Log an error and make the preflight
+                // use as big a buffer as we dare: how about the size of the temporary formatting buffer.
+                const int kTruncatedStringLength = 32768;
+                VLOGGER_ERROR(VSTRING_FORMAT("VString: formatted string will be truncated to %d characaters.", kTruncatedStringLength));
+                newStringLength = kTruncatedStringLength;
+            }
+
+            VString formatted;
+            formatted.preflight(newStringLength);
+            (void) vault::vsnprintf(formatted._set(), static_cast<VSizeType>(formatted._getBufferLength()), formatText, argsCopy);
+            formatted._setLength(newStringLength); // could call postflight, but would do extra assertion check
+            *this = std::move(formatted);
+        }
 
-        this->_setLength(newStringLength); // could call postflight, but would do extra assertion check
+        va_end(argsCopy);
     }
 
     ASSERT_INVARIANT();
 }
 #endif /* VAULT_VARARG_STRING_FORMATTING_SUPPORT */
 
+void VString::_appendFmt(const char* pattern, const VStringFormatArgument* args, int numArgs) {
+    ASSERT_INVARIANT();
+
+    if (pattern == NULL) {
+        return;
+    }
+
+    int estimatedLength = mU.mI.mStringLength + static_cast<int>(::strlen(pattern));
+    for (int i = 0; i < numArgs; ++i) {
+        estimatedLength += args[i].estimateLength();
+    }
+
+    this->preflight(estimatedLength);
+
+    // Copy each run of literal text in one step, and substitute the arguments between runs.
+    char scratch[VStringFormatArgument::kScratchBufferSize];
+    int nextArgIndex = 0;
+    const char* runStart = pattern;
+    const char* p = pattern;
+    for (;;) {
+        bool isEnd = (*p == VCHAR_NULL_TERMINATOR);
+        bool isPlaceholder = (p[0] == '{') && (p[1] == '}') && (nextArgIndex < numArgs);
+        bool isEscapedBrace = ((p[0] == '{') || (p[0] == '}')) && (p[1] == p[0]);
+        if (!isEnd && !isPlaceholder && !isEscapedBrace) {
+            ++p;
+            continue;
+        }
+
+        this->_appendChars(runStart, static_cast<int>(p - runStart) + (isEscapedBrace ? 1 : 0)); // An escaped brace ends its run with one brace.
+
+        if (isEnd) {
+            break;
+        }
+
+        if (isPlaceholder) {
+            int length;
+            const char* text = args[nextArgIndex++].getText(scratch, length);
+            this->_appendChars(text, length);
+        }
+
+        p += 2;
+        runStart = p;
+    }
+
+    ASSERT_INVARIANT();
+}
+
+void VString::_appendChars(const char* chars, int length) {
+    if (length == 0) {
+        return;
+    }
+
+    int newLength = mU.mI.mStringLength + length;
+    if (newLength >= this->_getBufferLength()) {
+        // If the chars are part of this string, find them again in the new buffer.
+        const char* buffer = _get();
+        bool charsAreOurs = (chars >= buffer) && (chars < buffer + mU.mI.mStringLength);
+        int offset = static_cast<int>(chars - buffer);
+
+        this->preflight(newLength);
+
+        if (charsAreOurs) {
+            chars = _get() + offset;
+        }
+    }
+
+    ::memcpy(&(_set()[mU.mI.mStringLength]), chars, static_cast<VSizeType>(length));
+    this->_setLength(newLength);
+}
+
 void VString::_setLength(int stringLength) {
     if (stringLength < 0) {
         throw VRangeException(VSTRING_FORMAT("VString::_setLength: Out of bounds negative value %d.", stringLength));
@@ -2001,9 +2322,9 @@ void VString::_setLength(int stringLength) {
     }
 
     if ((stringLength == 0) && !mU.mI.mUsingInternalBuffer && (mU.mX.mHeapBufferPtr != NULL)) {
-        // String length is being set to zero and we had a heap buffer. Delete the buffer and switch to a zero length internal buffer.
+        // String length is being set to zero and we had a heap buffer. Release the buffer and switch to a zero length internal buffer.
         // Note: We could consider also switching to the internal buffer (with a copy and a heap buffer delete) if we are changing length from large to small.
-        delete [] mU.mX.mHeapBufferPtr;
+        this->_releaseHeapBuffer();
         mU.mX.mHeapBufferPtr = NULL;
         mU.mX.mHeapBufferLength = 0;
         mU.mI.mUsingInternalBuffer = true;
@@ -2017,98 +2338,24 @@ void VString::_setLength(int stringLength) {
     mU.mI.mNumCodePoints = -1; // force recalc by next call to getNumCodePoints() if ever called
 }
 
-Vs64 VString::_parseSignedInteger() const {
-    Vs64 result = CONST_S64(0);
-    Vs64 multiplier = CONST_S64(1);
-
-    if (mU.mI.mStringLength != 0) {
-        // Iterate over the characters backwards, building the result.
-        // If we encounter something illegal, throw the VRangeException.
-        const char* buf = _get();
-        for (int i = mU.mI.mStringLength - 1; i >= 0; --i) {
-            switch (buf[i]) {
-                case '-':
-                    if (i != 0) {
-                        throw VRangeException(VSTRING_FORMAT("VString::_parseSignedInteger %c at index %d is invalid format.", buf[i], i));
-                    }
-
-                    result = -result;
-                    break;
-
-                case '+':
-                    if (i != 0) {
-                        throw VRangeException(VSTRING_FORMAT("VString::_parseSignedInteger %c at index %d is invalid format.", buf[i], i));
-                    }
-                    break;
-
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                    result += (multiplier * (static_cast<int>(buf[i] - '0')));
-                    break;
-
-                default:
-                    throw VRangeException(VSTRING_FORMAT("VString::_parseSignedInteger %c at index %d is invalid format.", buf[i], i));
-                    break;
-            }
-
-            multiplier *= 10;
-        }
-    }
-
-    return result;
+void VString::_assignS64(Vs64 i) {
+    char digits[VNumberFormat::kMaxIntegerLength];
+    this->copyFromBuffer(digits, 0, VNumberFormat::formatS64(i, digits));
 }
 
-Vu64 VString::_parseUnsignedInteger() const {
-    Vu64 result = CONST_U64(0);
-    Vs64 multiplier = CONST_S64(1);
-
-    if (mU.mI.mStringLength != 0) {
-        // Iterate over the characters backwards, building the result.
-        // If we encounter something illegal, throw the VRangeException.
-        const char* buf = _get();
-        for (int i = mU.mI.mStringLength - 1; i >= 0; --i) {
-            switch (buf[i]) {
-                case '-':
-                    throw VRangeException(VSTRING_FORMAT("VString::_parseUnsignedInteger %c at index %d is invalid format.", buf[i], i));
-                    break;
-
-                case '+':
-                    if (i != 0) {
-                        throw VRangeException(VSTRING_FORMAT("VString::_parseUnsignedInteger %c at index %d is invalid format.", buf[i], i));
-                    }
-                    break;
-
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                    result += (multiplier * (static_cast<int>(buf[i] - '0')));
-                    break;
-
-                default:
-                    throw VRangeException(VSTRING_FORMAT("VString::_parseUnsignedInteger %c at index %d is invalid format.", buf[i], i));
-                    break;
-            }
+void VString::_assignU64(Vu64 i) {
+    char digits[VNumberFormat::kMaxIntegerLength];
+    this->copyFromBuffer(digits, 0, VNumberFormat::formatU64(i, digits));
+}
 
-            multiplier *= 10;
-        }
-    }
+void VString::_appendS64(Vs64 i) {
+    char digits[VNumberFormat::kMaxIntegerLength];
+    this->_appendChars(digits, VNumberFormat::formatS64(i, digits));
+}
 
-    return result;
+void VString::_appendU64(Vu64 i) {
+    char digits[VNumberFormat::kMaxIntegerLength];
+    this->_appendChars(digits, VNumberFormat::formatU64(i, digits));
 }
 
 void VString::_assertInvariant() const {
@@ -2210,6 +2457,47 @@ void VString::_assignFromCFString(const CFStringRef& s) {
 }
 #endif /* VAULT_CORE_FOUNDATION_SUPPORT */
 
+// static
+char* VString::_newHeapBuffer(int bufferLength) {
+    char* buffer = new char[VString::_getHeapBufferRefCountOffset(bufferLength) + static_cast<int>(sizeof(std::atomic<int>))];
+    std::atomic_init(VString::_getHeapBufferRefCount(buffer, bufferLength), 1);
+    return buffer;
+}
+
+void VString::_makeHeapBufferUnique() {
+    char* newBuffer = VString::_newHeapBuffer(mU.mX.mHeapBufferLength);
+    ::memcpy(newBuffer, mU.mX.mHeapBufferPtr, static_cast<VSizeType>(mU.mI.mStringLength + 1));
+    this->_releaseHeapBuffer();
+    mU.mX.mHeapBufferPtr = newBuffer;
+}
+
+void VString::_releaseHeapBuffer() {
+    // The acquire-release ordering makes every other sharer's use of the buffer happen before whichever one deletes it.
+    if (VString::_getHeapBufferRefCount(mU.mX.mHeapBufferPtr, mU.mX.mHeapBufferLength)->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete [] mU.mX.mHeapBufferPtr;
+    }
+}
+
+void VString::_shareHeapBuffer(const VString& s) {
+    // Add our reference before releasing our old one, in case they are the same buffer.
+    VString::_getHeapBufferRefCount(s.mU.mX.mHeapBufferPtr, s.mU.mX.mHeapBufferLength)->fetch_add(1, std::memory_order_relaxed);
+
+    if (!mU.mI.mUsingInternalBuffer) {
+        this->_releaseHeapBuffer();
+    }
+
+    mU.mI.mUsingInternalBuffer = false;
+    mU.mX.mHeapBufferPtr = s.mU.mX.mHeapBufferPtr;
+    mU.mX.mHeapBufferLength = s.mU.mX.mHeapBufferLength;
+    mU.mI.mStringLength = s.mU.mI.mStringLength;
+    mU.mI.mNumCodePoints = s.mU.mI.mNumCodePoints;
+}
+
+void VString::_takeBuffer(VString& s) {
+    mU = s.mU;
+    s._construct();
+}
+
 void VString::_construct() {
     // Clearing the mX fields is just to have less garabage showing in the debugger from the get-go.
     // Not required, and will be defeated once the mU.mI.mInternalBuffer holds a non-empty string.
@@ -2227,6 +2515,59 @@ void VString::_determineNumCodePoints() const {
     if (this->isEmpty()) { // optimize away need to call countUTF8CodePoints() and have it set up counting loop in the first place
         mU.mI.mNumCodePoints = 0;
     } else {
-        mU.mI.mNumCodePoints = VCodePoint::countUTF8CodePoints(this->getDataBufferConst(), this->length());
+        const Vu8* buffer = this->getDataBufferConst();
+        int asciiLength = VCodePoint::getASCIIPrefixLength(buffer, mU.mI.mStringLength);
+        if (asciiLength == mU.mI.mStringLength) {
+            mU.mI.mNumCodePoints = mU.mI.mStringLength;
+        } else {
+            int numCodePoints = asciiLength + VCodePoint::countUTF8CodePoints(buffer + asciiLength, mU.mI.mStringLength - asciiLength);
+            mU.mI.mNumCodePoints = (numCodePoints == mU.mI.mStringLength) ? -2 : numCodePoints;
+        }
+    }
+}
+
+// VStringFormatArgument ------------------------------------------------------
+
+const char* VStringFormatArgument::getText(char* scratch, int& length) const {
+    switch (mKind) {
+        case kBool:
+            length = (mValue.mUnsigned != 0) ? 4 : 5;
+            return (mValue.mUnsigned != 0) ? "true" : "false";
+
+        case kChar:
+            scratch[0] = static_cast<char>(mValue.mSigned);
+            length = 1;
+            return scratch;
+
+        case kSigned:
+            length = VNumberFormat::formatS64(mValue.mSigned, scratch);
+            return scratch;
+
+        case kUnsigned:
+            length = VNumberFormat::formatU64(mValue.mUnsigned, scratch);
+            return scratch;
+
+        case kDouble:
+            // A fixed directive, so that doubles look the same as with VSTRING_DOUBLE.
+            length = ::snprintf(scratch, static_cast<VSizeType>(kScratchBufferSize), VSTRING_FORMATTER_DOUBLE, mValue.mDouble);
+            if ((length < 0) || (length >= kScratchBufferSize)) {
+                length = 0;
+            }
+
+            return scratch;
+
+        case kChars:
+            if (mChars != NULL) {
+                length = (mLength < 0) ? static_cast<int>(::strlen(mChars)) : mLength;
+                return mChars;
+            }
+
+            break;
+
+        case kNone:
+            break;
     }
+
+    length = 0;
+    return scratch;
 }
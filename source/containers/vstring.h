@@ -16,6 +16,7 @@ License: MIT. See LICENSE.md in the Vault top level directory.
 #include "vstringiterator.h"
 
 class VChar;
+class VStringFormatArgument;
 
 #ifdef VAULT_CORE_FOUNDATION_SUPPORT
 #ifdef __OBJC__
@@ -193,6 +194,18 @@ and formatting.
 Methods that modify the string will expand the buffer as necessary, so you
 don't have to worry about overflowing the buffer. If the buffer needs to be
 expanded but the object is unable to expand it, a VException will be thrown.
+
+Copying a string that is too long for the internal buffer does not copy its
+characters: the copy shares the original's heap buffer, which has a thread-safe
+reference count, and whichever string is modified first takes its own copy of
+the buffer at that point (copy-on-write). So passing, returning and storing long
+strings by value is cheap, and separate VString objects that share a buffer may
+be used freely from different threads. As before, a single VString object must
+not be modified by one thread while another thread uses it. Moving a string
+(from a temporary, or with std::move) takes its buffer without touching the
+reference count at all. Note that a pointer obtained from buffer() or
+getDataBuffer() is only good until the string is next copied, assigned or
+modified in any other way.
 */
 class VString {
     public:
@@ -240,6 +253,11 @@ class VString {
         */
         VString(const VString& s);
         /**
+        Move constructor -- takes the other string's buffer, leaving it empty.
+        @param    s    the string to move from
+        */
+        VString(VString&& s) noexcept;
+        /**
         Constructs a string from a char. The explicit keyword is to
         prevent the previous VString s(n) meaning of preflight string
         to size "n" from compiling.
@@ -327,6 +345,11 @@ class VString {
         */
         VString& operator=(const VString& s);
         /**
+        Move assignment operator -- takes the other string's buffer, leaving it empty.
+        @param    s    the string to move from
+        */
+        VString& operator=(VString&& s) noexcept;
+        /**
         Assign from a pointer to VString.
         @param    s    the string pointer to copy
         */
@@ -607,6 +630,36 @@ class VString {
         */
         void format(const char* formatText, ...);
 #endif
+        /**
+        Returns a string formatted from a pattern in which each "{}" is replaced by the
+        next argument; "{{" and "}}" produce literal braces. Unlike VSTRING_FORMAT there
+        are no type directives to get wrong: each argument is formatted according to its
+        C++ type, and the pattern is scanned once without printf parsing or a measuring pass.
+        Supported argument types are the integer types, bool ("true"/"false"), char,
+        float and double (formatted like VSTRING_DOUBLE), C strings, and VString.
+        A "{}" with no argument left is copied as is, and extra arguments are ignored.
+        Example: VString::fmt("locker '{}' waited {} ms", lockerName, elapsedMilliseconds)
+        @param    pattern    the pattern text
+        @param    args       the values to substitute
+        @return the formatted string
+        */
+        template <typename... ARG_TYPES>
+        static VString fmt(const char* pattern, const ARG_TYPES&... args);
+        /**
+        Like fmt(), but appends the formatted text to this string.
+        @param    pattern    the pattern text
+        @param    args       the values to substitute
+        */
+        template <typename... ARG_TYPES>
+        void appendFmt(const char* pattern, const ARG_TYPES&... args);
+        /**
+        Like appendFmt(), but with arguments that have already been captured, for callers
+        that obtain them at run time, such as a reader decoding binary log records.
+        @param    pattern    the pattern text
+        @param    args       the captured arguments
+        @param    numArgs    the number of captured arguments
+        */
+        void appendFmtArguments(const char* pattern, const VStringFormatArgument* args, int numArgs) { this->_appendFmt(pattern, args, numArgs); }
 
         /**
         Inserts the specified code point into the string at the
@@ -686,6 +739,20 @@ class VString {
         */
         int getNumCodePoints() const;
         /**
+        Returns true if every byte of the string is ASCII (0x00 to 0x7F), in which case every
+        code point is a single byte and code point offsets are byte offsets. This is computed
+        along with the code point count and cached with it, so iterators and truncation use it
+        to skip UTF-8 decoding entirely for ASCII strings.
+        @return true if the string is pure ASCII
+        */
+        bool isASCII() const;
+        /**
+        Returns true if the string is well-formed UTF-8. See VCodePoint::isValidUTF8().
+        An ASCII string is always valid and is answered from the cached state.
+        @return true if the string is valid UTF-8
+        */
+        bool isValidUTF8() const;
+        /**
         Returns the string length in bytes. Note that this is not the same
         as the number of code points.
         @return the string length in bytes
@@ -846,6 +913,20 @@ class VString {
         */
         int compareIgnoreCase(const char* s) const;
         /**
+        Returns a hash of the string's bytes, suitable for keying unordered containers;
+        std::hash<VString> uses this. Equal strings have equal hash values.
+        @return the hash value
+        */
+        VSizeType hashValue() const;
+        /**
+        Returns a hash of the string's bytes with ASCII letters folded to lower case, so
+        that strings that are equalsIgnoreCase() have equal hash values. Use with
+        VStringHashIgnoreCase and VStringEqualIgnoreCase to key unordered containers by
+        case-insensitive names.
+        @return the hash value
+        */
+        VSizeType hashValueIgnoreCase() const;
+        /**
         Returns true if this string starts with the specified string.
         @param  s   the string to compare with
         @return true if this string starts with the specified string
@@ -1066,7 +1147,7 @@ class VString {
         integer range. The allowed format is ([+|-][0*][0-9]). That is, a leading
         plus or minus sign is allowed, as are leading zeroes, followed by digits.
         If the string is empty, the value is zero. If the string contains an invalid
-        character sequence, VRangeException
+        character sequence or evaluates to an out-of-range integer, VRangeException
         is thrown. This function is similar in purpose to atoi().
         */
         Vs64 parseS64() const;
@@ -1075,18 +1156,33 @@ class VString {
         integer range. The allowed format is ([+][0*][0-9]). That is, a leading
         plus sign is allowed, as are leading zeroes, followed by digits.
         If the string is empty, the value is zero. If the string contains an invalid
-        character sequence, VRangeException
+        character sequence or evaluates to an out-of-range integer, VRangeException
         is thrown. This function is similar in purpose to atoi().
         */
         Vu64 parseU64() const;
         /**
-        Parses the string as a VDouble integer. The string must conform to the specification
-        of strtod() given by ISO C and POSIX IEEE 1003.1. In the case of an illegal string,
-        VRangeException is thrown. This function is similar in purpose to (and my rely on)
-        sscanf() using the "%lf" format. An empty string is deemed to have the value 0.0.
+        Parses the string as a VDouble. The string must start with a decimal number as
+        specified for strtod() by ISO C and POSIX IEEE 1003.1, or "inf" or "nan"; leading
+        whitespace is skipped and text after the number is ignored, as with sscanf() using
+        the "%lf" format. Unlike sscanf(), the result does not depend on the C locale
+        and is correctly rounded. In the case of an illegal string, VRangeException is
+        thrown. An empty string is deemed to have the value 0.0.
         */
         VDouble parseDouble() const;
         /**
+        Sets the string to the shortest text that parseDouble() reads back as exactly the
+        same value, such as "0.1" or "6.02214076e+23". Use this rather than VSTRING_DOUBLE,
+        which always writes 6 decimal places, when a double must survive a trip through text.
+        See VNumberFormat::formatDouble() for the exact form.
+        @param  d   the value to format
+        */
+        void formatRoundTrip(VDouble d);
+        /**
+        Appends the shortest text that parseDouble() reads back as exactly the same value.
+        @param  d   the value to format
+        */
+        void appendRoundTrip(VDouble d);
+        /**
         Sets the character at the specified index to the specified value.
         If the index is out of range, a VException is thrown.
         @param  i   the index (0 to length-1)
@@ -1308,8 +1404,10 @@ class VString {
     private:
 
         void _setLength(int stringLength);
-        Vs64 _parseSignedInteger() const;
-        Vu64 _parseUnsignedInteger() const;
+        void _assignS64(Vs64 i);    ///< Sets the string to the decimal form of i, formatted in place by VNumberFormat.
+        void _assignU64(Vu64 i);    ///< Sets the string to the decimal form of i, formatted in place by VNumberFormat.
+        void _appendS64(Vs64 i);    ///< Appends the decimal form of i, formatted in place by VNumberFormat.
+        void _appendU64(Vu64 i);    ///< Appends the decimal form of i, formatted in place by VNumberFormat.
 
         /** Asserts if any invariant is broken. */
         void _assertInvariant() const;
@@ -1324,6 +1422,21 @@ class VString {
         */
         static int _determineSprintfLength(const char* formatText, va_list args);
 #endif
+        /**
+        Appends text formatted by fmt() or appendFmt(), after their arguments have been
+        captured in an array.
+        @param  pattern     the pattern text
+        @param  args        the captured arguments
+        @param  numArgs     the number of captured arguments
+        */
+        void _appendFmt(const char* pattern, const VStringFormatArgument* args, int numArgs);
+        /**
+        Appends chars to the string, growing the buffer if needed. The chars may be part of
+        this string. Used by _appendFmt(), which preflights once and then appends many pieces.
+        @param  chars   the chars to append
+        @param  length  the number of chars to append
+        */
+        void _appendChars(const char* chars, int length);
 
         /**
         This is where we do the conversion and assignment for all APIs that
@@ -1388,10 +1501,16 @@ class VString {
         even for an empty string which is usually in the internal buffer space. The buffer is mutable and so this
         API should be used in any non-const function where it needs to write to the buffer. This function is
         named _set() for conciseness of code in the internal implementation. It means to obtain "setter" (read-write)
-        access to the buffer.
+        access to the buffer. If the heap buffer is shared with other strings, this string first takes its own copy.
         @return a valid pointer to a mutable null-terminated C string buffer, which may be the internal buffer or an external buffer
         */
-        char* _set() { return mU.mI.mUsingInternalBuffer ? mU.mI.mInternalBuffer : mU.mX.mHeapBufferPtr; }
+        char* _set() {
+            if (!mU.mI.mUsingInternalBuffer && this->_isSharedHeapBuffer()) {
+                this->_makeHeapBufferUnique();
+            }
+
+            return mU.mI.mUsingInternalBuffer ? mU.mI.mInternalBuffer : mU.mX.mHeapBufferPtr;
+        }
         /**
         Returns the buffer length of the buffer that is in use (internal or external). The length is the capacity of
         the buffer including a null terminator; another way of saying this that the length is one greater than the
@@ -1404,18 +1523,74 @@ class VString {
         int _getBufferLength() const { return mU.mI.mUsingInternalBuffer ? VSTRING_INTERNAL_BUFFER_SIZE : mU.mX.mHeapBufferLength; }
         /**
         Computes the number of code points in the string and stores it in mI.mNumCodePoints; meant to be called internally, lazily,
-        by getNumCodePoints() if mI.mNumCodePoints is -1. If the string is empty, the answer is 0; otherwise, the function iterates
-        over the string buffer and counts the code points found.
+        by getNumCodePoints() and isASCII() if mI.mNumCodePoints is -1. If the string is empty, the answer is 0; otherwise, the function
+        skips the leading ASCII run 8 bytes at a time and counts the code points in the rest. If the count equals the length but the
+        string is not ASCII (only possible with stray UTF-8 continuation bytes), it stores -2 so that isASCII() stays exact.
         */
         void _determineNumCodePoints() const;
 
+        // Copy-on-write bookkeeping for heap buffers. Each heap allocation holds the buffer's chars followed
+        // by a reference count of the strings sharing it. A shared buffer is never modified; _set() gives
+        // the string its own copy first.
+
+        /**
+        Allocates a heap buffer with its reference count set to 1.
+        @param  bufferLength    the number of chars the buffer must hold, including the null terminator
+        @return the new buffer
+        */
+        static char* _newHeapBuffer(int bufferLength);
+        /**
+        Returns the offset of the reference count that follows a heap buffer's chars, rounded
+        up so that the count is aligned whatever the buffer length.
+        @param  bufferLength    the heap buffer's length
+        @return the offset of the reference count
+        */
+        static int _getHeapBufferRefCountOffset(int bufferLength) {
+            const int kAlignment = static_cast<int>(sizeof(std::atomic<int>));
+            return ((bufferLength + kAlignment - 1) / kAlignment) * kAlignment;
+        }
+        /**
+        Returns the reference count that follows a heap buffer's chars.
+        @param  buffer          the heap buffer
+        @param  bufferLength    the heap buffer's length
+        @return the reference count
+        */
+        static std::atomic<int>* _getHeapBufferRefCount(const char* buffer, int bufferLength) {
+            return reinterpret_cast<std::atomic<int>*>(const_cast<char*>(buffer) + _getHeapBufferRefCountOffset(bufferLength));
+        }
+        /**
+        Returns true if our heap buffer is shared with another string. Only call this when using a heap buffer.
+        @return true if the reference count is greater than 1
+        */
+        bool _isSharedHeapBuffer() const { return _getHeapBufferRefCount(mU.mX.mHeapBufferPtr, mU.mX.mHeapBufferLength)->load(std::memory_order_acquire) > 1; }
+        /**
+        Replaces our shared heap buffer with a private copy of the same length.
+        */
+        void _makeHeapBufferUnique();
+        /**
+        Gives up our reference to our heap buffer, deleting it if no other string shares it. The caller must
+        then switch to a different buffer. Only call this when using a heap buffer.
+        */
+        void _releaseHeapBuffer();
+        /**
+        Makes this string share another string's heap buffer, releasing our own buffer if we have one.
+        @param  s   a string that is using a heap buffer
+        */
+        void _shareHeapBuffer(const VString& s);
+        /**
+        Takes another string's state, including its buffer, leaving it empty. Our own heap buffer must
+        already have been released.
+        @param  s   the string to take from
+        */
+        void _takeBuffer(VString& s);
+
         // Finally, the union that defines our internal structure.
         union {
 
             // When mI.mUsingInternalBuffer == true, we use mI.mInternalBuffer to store the string data.
             struct {
                 int         mStringLength;                                  ///< The length of the string; this is always valid.
-                mutable int mNumCodePoints;                                 ///< The number of UTF-8 code points in the string; this is lazily calculated and a value of -1 means we must scan to calculate it. It gets set to 0 whenever mStringLength is set to 0, and set to -1 whenever mStringLength is set to something else.
+                mutable int mNumCodePoints;                                 ///< The number of UTF-8 code points in the string; this is lazily calculated and a value of -1 means we must scan to calculate it. It gets set to 0 whenever mStringLength is set to 0, and set to -1 whenever mStringLength is set to something else. It equals mStringLength exactly when the string is pure ASCII; -2 means the count is mStringLength but the string is not ASCII.
                 bool        mUsingInternalBuffer : 1;                       ///< True if mI.mInternalBuffer is valid, vs. mX.mHeapBufferPtr; this is always valid. It is a bitfield so that we don't have to explicitly do bit masking, and the debugger will display it correctly.
                 int         mPadBits : 7;                                   ///< Unused bits in mI, overlaps with mX.mHeapBufferLength which is valid when mI.mUsingInternalBuffer is false.
                 char        mInternalBuffer[VSTRING_INTERNAL_BUFFER_SIZE];  ///< The embedded character buffer, when mI.mUsingInternalBuffer is true; when mI.mUsingInternalBuffer is false, it is n/a and may appear to contain garbage.
@@ -1425,8 +1600,8 @@ class VString {
             struct {
                 int         mStringLength_Alias;                            ///< Do not use. Occupies same memory as mI.mStringLength, which should be used instead.
                 int         mNumCodePoints_Alias;                           ///< Do not use. Occupies same memory as mI.mNumCodePoints, which should be used instead.
-                int         mHeapBufferLength;                              ///< The size of the mHeapBufferPtr new[] allocated memory; when mI.mUsingInternalBuffer is true, it is n/a and may appear to contain garbage.
-                char*       mHeapBufferPtr;                                 ///< Pointer to our new[] allocated memory; when mI.mUsingInternalBuffer is true, it is n/a and may appear to contain garbage.
+                int         mHeapBufferLength;                              ///< The number of chars mHeapBufferPtr can hold, including the null terminator (its reference count follows them); when mI.mUsingInternalBuffer is true, it is n/a and may appear to contain garbage.
+                char*       mHeapBufferPtr;                                 ///< Pointer to our new[] allocated memory, which may be shared with other strings; when mI.mUsingInternalBuffer is true, it is n/a and may appear to contain garbage.
             } mX; ///< Union part for heap-allocated buffer space.
 
         } mU; ///< Union for overlaying mI internal and mX external views of string buffer storage. mI.mStringLength and mI.mUsingInternalBuffer are always valid and authoritative.
@@ -1484,4 +1659,105 @@ inline VString& operator<<(VString& s, Vs64 i) { s += i; return s; }    ///< App
 
 inline VString& operator<<(VString& s, VDouble f) { s += f; return s; } ///< Appends to the string by copying a VDouble as string. @param    s    the string @param    f    the VDouble to append @return the string
 
+/**
+VStringHashIgnoreCase is a hash function object for unordered containers keyed by
+case-insensitive names; pair it with VStringEqualIgnoreCase. For example:
+std::unordered_map<VString, int, VStringHashIgnoreCase, VStringEqualIgnoreCase>
+*/
+struct VStringHashIgnoreCase {
+    VSizeType operator()(const VString& s) const { return s.hashValueIgnoreCase(); } ///< @param s a string @return its case-insensitive hash value
+};
+
+/**
+VStringEqualIgnoreCase is an equality function object for unordered containers keyed
+by case-insensitive names; pair it with VStringHashIgnoreCase.
+*/
+struct VStringEqualIgnoreCase {
+    bool operator()(const VString& lhs, const VString& rhs) const { return lhs.equalsIgnoreCase(rhs); } ///< @param lhs a string @param rhs a string @return true if they are equal ignoring case
+};
+
+namespace std {
+/**
+Lets VString key std::unordered_map and std::unordered_set directly.
+*/
+template <>
+struct hash<VString> {
+    size_t operator()(const VString& s) const { return s.hashValue(); } ///< @param s a string @return its hash value
+};
+}
+
+/**
+VStringFormatArgument captures one argument to VString::fmt() along with its type,
+so that fmt() can format it without a printf directive. Instances are created
+implicitly by fmt() and only live for the duration of the call; a string argument
+is referenced, not copied.
+*/
+class VStringFormatArgument {
+    public:
+
+        VStringFormatArgument() : mKind(kNone), mChars(NULL), mLength(0) { mValue.mSigned = 0; }                            ///< Constructs an argument with no value, which formats as nothing.
+        VStringFormatArgument(bool b) : mKind(kBool), mChars(NULL), mLength(0) { mValue.mUnsigned = b ? 1 : 0; }            ///< Captures a bool. @param b the value
+        VStringFormatArgument(char c) : mKind(kChar), mChars(NULL), mLength(0) { mValue.mSigned = c; }                      ///< Captures a char. @param c the value
+        VStringFormatArgument(signed char i) : mKind(kSigned), mChars(NULL), mLength(0) { mValue.mSigned = i; }             ///< Captures an integer. @param i the value
+        VStringFormatArgument(unsigned char i) : mKind(kUnsigned), mChars(NULL), mLength(0) { mValue.mUnsigned = i; }       ///< Captures an integer. @param i the value
+        VStringFormatArgument(short i) : mKind(kSigned), mChars(NULL), mLength(0) { mValue.mSigned = i; }                   ///< Captures an integer. @param i the value
+        VStringFormatArgument(unsigned short i) : mKind(kUnsigned), mChars(NULL), mLength(0) { mValue.mUnsigned = i; }      ///< Captures an integer. @param i the value
+        VStringFormatArgument(int i) : mKind(kSigned), mChars(NULL), mLength(0) { mValue.mSigned = i; }                     ///< Captures an integer. @param i the value
+        VStringFormatArgument(unsigned int i) : mKind(kUnsigned), mChars(NULL), mLength(0) { mValue.mUnsigned = i; }        ///< Captures an integer. @param i the value
+        VStringFormatArgument(long i) : mKind(kSigned), mChars(NULL), mLength(0) { mValue.mSigned = i; }                    ///< Captures an integer. @param i the value
+        VStringFormatArgument(unsigned long i) : mKind(kUnsigned), mChars(NULL), mLength(0) { mValue.mUnsigned = i; }       ///< Captures an integer. @param i the value
+        VStringFormatArgument(long long i) : mKind(kSigned), mChars(NULL), mLength(0) { mValue.mSigned = i; }               ///< Captures an integer. @param i the value
+        VStringFormatArgument(unsigned long long i) : mKind(kUnsigned), mChars(NULL), mLength(0) { mValue.mUnsigned = i; }  ///< Captures an integer. @param i the value
+        VStringFormatArgument(float f) : mKind(kDouble), mChars(NULL), mLength(0) { mValue.mDouble = f; }                   ///< Captures a float. @param f the value
+        VStringFormatArgument(double d) : mKind(kDouble), mChars(NULL), mLength(0) { mValue.mDouble = d; }                  ///< Captures a double. @param d the value
+        VStringFormatArgument(const char* s) : mKind(kChars), mChars(s), mLength(-1) { mValue.mSigned = 0; }                ///< Captures a C string; NULL formats as nothing. @param s the value
+        VStringFormatArgument(const VString& s) : mKind(kChars), mChars(s.chars()), mLength(s.length()) { mValue.mSigned = 0; } ///< Captures a string. @param s the value
+        VStringFormatArgument(const void* p) = delete; ///< Other pointers would otherwise silently convert to bool.
+
+        /**
+        Returns the likely length of the argument's text, so that the result can be
+        preflighted once rather than grown for each argument.
+        @return the likely number of chars getText() will return
+        */
+        int estimateLength() const { return (mKind == kChars) ? ((mLength < 0) ? 32 : mLength) : 20; }
+        /**
+        Returns the argument's text. Strings are returned in place; other values are
+        formatted into the supplied scratch buffer.
+        @param  scratch a buffer of at least kScratchBufferSize chars
+        @param  length  set to the number of chars of text, which is not null-terminated
+        @return a pointer to the text
+        */
+        const char* getText(char* scratch, int& length) const;
+
+        static const int kScratchBufferSize = 400; ///< Enough for the longest double formatted like VSTRING_DOUBLE.
+
+    private:
+
+        enum Kind { kNone, kBool, kChar, kSigned, kUnsigned, kDouble, kChars };
+
+        Kind        mKind;      ///< Which kind of value was captured.
+        const char* mChars;     ///< For kChars, the characters.
+        int         mLength;    ///< For kChars, the number of characters, or -1 if the C string length has not been determined.
+        union {
+            Vs64    mSigned;    ///< For kSigned and kChar.
+            Vu64    mUnsigned;  ///< For kUnsigned and kBool.
+            VDouble mDouble;    ///< For kDouble.
+        } mValue;               ///< The captured value, unless a string.
+};
+
+// static
+template <typename... ARG_TYPES>
+VString VString::fmt(const char* pattern, const ARG_TYPES&... args) {
+    VString result;
+    result.appendFmt(pattern, args...);
+    return result;
+}
+
+template <typename... ARG_TYPES>
+void VString::appendFmt(const char* pattern, const ARG_TYPES&... args) {
+    // The extra trailing element keeps the array from being empty when there are no arguments.
+    const VStringFormatArgument capturedArgs[] = { VStringFormatArgument(args)..., VStringFormatArgument() };
+    this->_appendFmt(pattern, capturedArgs, static_cast<int>(sizeof...(ARG_TYPES)));
+}
+
 #endif /* vstring_h */
@@ -0,0 +1,108 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+/** @file */
+
+#include "vstringatom.h"
+
+#include "vmutex.h"
+#include "vmutexlocker.h"
+
+V_STATIC_INIT_TRACE
+
+// This style of static mutex declaration and access ensures correct
+// initialization if accessed during the static initialization phase.
+// Logging is suppressed because the logger itself uses atoms.
+static VMutex* _mutexInstance() {
+    static VMutex* gVStringAtomMutex = new VMutex("gVStringAtomMutex", true/*suppress logging*/);
+    return gVStringAtomMutex;
+}
+
+// _mutexInstance() must be used internally whenever referencing the atom table.
+// The table and its entries are never deleted, because atoms may be used during static destruction.
+
+// static
+VStringAtom::Table& VStringAtom::_getTable() {
+    static Table* gAtomTable = new Table();
+    return *gAtomTable;
+}
+
+VStringAtom::VStringAtom()
+    : mEntry(NULL)
+    {
+    static const Entry* kEmptyEntry = VStringAtom::_intern(VString::EMPTY());
+    mEntry = kEmptyEntry;
+}
+
+VStringAtom::VStringAtom(const VString& s)
+    : mEntry(VStringAtom::_intern(s))
+    {
+}
+
+VStringAtom::VStringAtom(const char* s)
+    : mEntry(NULL)
+    {
+    VString value;
+    value.copyFromBuffer(s, 0, static_cast<int>(::strlen(s)));
+    mEntry = VStringAtom::_intern(value);
+}
+
+// static
+bool VStringAtom::find(const VString& s, VStringAtom& atom) {
+    VMutexLocker locker(_mutexInstance(), "VStringAtom::find");
+
+    Table::const_iterator position = _getTable().find(s);
+    if (position == _getTable().end()) {
+        return false;
+    }
+
+    atom.mEntry = position->second;
+    return true;
+}
+
+// static
+const VStringAtom::Entry* VStringAtom::_intern(const VString& s) {
+    VMutexLocker locker(_mutexInstance(), "VStringAtom::_intern");
+    return VStringAtom::_internLocked(s);
+}
+
+// static
+const VStringAtom::Entry* VStringAtom::_internLocked(const VString& s) {
+    // ASSUMES CALLER HOLDS _mutexInstance().
+
+    Table::const_iterator position = _getTable().find(s);
+    if (position != _getTable().end()) {
+        return position->second;
+    }
+
+    // Intern the related strings first. Each is either already folded or shorter, so the recursion ends.
+    // Only ASCII letters are folded, matching VString::equalsIgnoreCase() and hashValueIgnoreCase().
+    VString folded(s);
+    Vu8* foldedBytes = folded.getDataBuffer();
+    for (int i = 0; i < folded.length(); ++i) {
+        if ((foldedBytes[i] >= 'A') && (foldedBytes[i] <= 'Z')) {
+            foldedBytes[i] = static_cast<Vu8>(foldedBytes[i] + ('a' - 'A'));
+        }
+    }
+
+    const Entry* pathParent = NULL;
+    int lastDotIndex = s.lastIndexOf('.');
+    if (lastDotIndex >= 0) {
+        VString parentPath;
+        s.getSubstring(parentPath, 0, lastDotIndex);
+        pathParent = VStringAtom::_internLocked(parentPath);
+    }
+
+    Entry* entry = new Entry();
+    entry->mString = s;
+    entry->mHash = s.hashValue();
+    entry->mFolded = (folded == s) ? entry : VStringAtom::_internLocked(folded);
+    entry->mPathParent = pathParent;
+
+    _getTable()[s] = entry;
+    return entry;
+}
@@ -0,0 +1,143 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+#ifndef vstringatom_h
+#define vstringatom_h
+
+/** @file */
+
+#include "vtypes.h"
+
+#include "vstring.h"
+
+/**
+    @ingroup vstring
+*/
+
+/**
+VStringAtom is a lightweight handle to an interned string. Every distinct string
+value is interned exactly once in a global, thread-safe table, and every atom for
+that value refers to the same immutable table entry. Comparing two atoms is therefore
+a single pointer compare, and the hash value and the case-folded form are computed
+once, when the string is first interned, rather than every time they are needed.
+
+Atoms are meant for the short names that hot paths compare over and over: logger
+names, bento data type tags, settings keys. Interned strings are never removed from
+the table, so do not intern an unbounded set of strings (such as names that include
+client addresses or ids); use find() to look up such a string without interning it.
+
+Interning takes a lock, so a hot path should intern its names once (for example in
+a function-local static or a member variable) and then use the atoms. Copying,
+comparing and hashing atoms, and all the accessors, take no lock.
+
+A default-constructed atom refers to the empty string.
+*/
+class VStringAtom {
+    public:
+
+        /**
+        Constructs an atom for the empty string.
+        */
+        VStringAtom();
+        /**
+        Constructs an atom for the supplied string, interning it if it is not already interned.
+        If the string is a dotted path, all of its parent paths are interned as well.
+        @param  s   the string value
+        */
+        explicit VStringAtom(const VString& s);
+        /**
+        Constructs an atom for the supplied C string, interning it if it is not already interned.
+        @param  s   the string value
+        */
+        explicit VStringAtom(const char* s);
+        ~VStringAtom() {}
+
+        VStringAtom(const VStringAtom& other) : mEntry(other.mEntry) {}                                 ///< Copies the handle. @param other the atom to copy
+        VStringAtom& operator=(const VStringAtom& other) { mEntry = other.mEntry; return *this; }      ///< Copies the handle. @param other the atom to copy @return this atom
+
+        /**
+        Looks up a string without interning it. Use this to test names from an unbounded
+        set against a bounded set of interned names.
+        @param  s       the string value
+        @param  atom    set to the string's atom if it is interned; unchanged if not
+        @return true if the string is interned
+        */
+        static bool find(const VString& s, VStringAtom& atom);
+
+        const VString& getString() const { return mEntry->mString; }            ///< Returns the interned string. @return the string, which lives as long as the program
+        const char* chars() const { return mEntry->mString.chars(); }           ///< Returns the interned string's chars. @return the chars, which live as long as the program
+        int length() const { return mEntry->mString.length(); }                 ///< Returns the interned string's length in bytes. @return the length
+        bool isEmpty() const { return mEntry->mString.isEmpty(); }              ///< Returns true if this is the empty string's atom. @return true if empty
+        VSizeType getHash() const { return mEntry->mHash; }                     ///< Returns the string's hashValue(), computed when it was interned. @return the hash value
+        VSizeType getHashIgnoreCase() const { return mEntry->mFolded->mHash; }  ///< Returns the string's hashValueIgnoreCase(), computed when it was interned. @return the hash value
+
+        /**
+        Returns the atom for this string with its ASCII letters folded to lower case.
+        Two atoms are equalsIgnoreCase() if and only if their folded atoms are equal.
+        @return the folded atom, which is this atom if the string has no upper case letters
+        */
+        VStringAtom getFolded() const { return VStringAtom(mEntry->mFolded); }
+        /**
+        Returns true if this string is equal to the other ignoring the case of ASCII letters.
+        Unlike VString::equalsIgnoreCase(), this is a single pointer compare.
+        @param  other   the atom to compare with
+        @return true if the strings are equal ignoring case
+        */
+        bool equalsIgnoreCase(const VStringAtom& other) const { return mEntry->mFolded == other.mEntry->mFolded; }
+
+        /**
+        Returns true if the string is a dotted path ("a.b.c") with a parent path.
+        @return true if the string contains a '.'
+        */
+        bool hasPathParent() const { return mEntry->mPathParent != NULL; }
+        /**
+        Returns the parent of a dotted path: the part before the last '.'. For example, the
+        parent of "vault.messages.VMessageHandler" is "vault.messages". Only valid if hasPathParent().
+        @return the parent path's atom
+        */
+        VStringAtom getPathParent() const { return VStringAtom(mEntry->mPathParent); }
+
+        friend inline bool operator==(const VStringAtom& lhs, const VStringAtom& rhs);
+        friend inline bool operator!=(const VStringAtom& lhs, const VStringAtom& rhs);
+        friend inline bool operator<(const VStringAtom& lhs, const VStringAtom& rhs);
+
+    private:
+
+        /** One interned string; created once and never changed or deleted. */
+        struct Entry {
+            VString         mString;        ///< The string value.
+            VSizeType       mHash;          ///< mString.hashValue().
+            const Entry*    mFolded;        ///< The entry for the ASCII-lower-cased string; this entry if they are the same.
+            const Entry*    mPathParent;    ///< The entry for the part before the last '.', or NULL if there is no '.'.
+        };
+
+        typedef std::unordered_map<VString, const Entry*> Table;
+
+        explicit VStringAtom(const Entry* entry) : mEntry(entry) {}
+
+        static Table& _getTable();                              ///< Returns the table of interned strings.
+        static const Entry* _intern(const VString& s);          ///< Returns the entry for s, creating it if needed.
+        static const Entry* _internLocked(const VString& s);    ///< Same as _intern() but the caller holds the table mutex.
+
+        const Entry* mEntry; ///< The interned string; never NULL.
+};
+
+inline bool operator==(const VStringAtom& lhs, const VStringAtom& rhs) { return lhs.mEntry == rhs.mEntry; }   ///< Compares lhs and rhs for equality. @param lhs an atom @param rhs an atom @return true if they are the same string
+inline bool operator!=(const VStringAtom& lhs, const VStringAtom& rhs) { return lhs.mEntry != rhs.mEntry; }   ///< Compares lhs and rhs for inequality. @param lhs an atom @param rhs an atom @return true if they are different strings
+inline bool operator<(const VStringAtom& lhs, const VStringAtom& rhs) { return lhs.mEntry < rhs.mEntry; }     ///< Orders atoms by identity, for use as ordered container keys; the order is not alphabetical and varies between runs. @param lhs an atom @param rhs an atom @return true if lhs orders before rhs
+
+namespace std {
+/**
+Lets VStringAtom key std::unordered_map and std::unordered_set using its precomputed hash.
+*/
+template <>
+struct hash<VStringAtom> {
+    size_t operator()(const VStringAtom& atom) const { return atom.getHash(); } ///< @param atom an atom @return its hash value
+};
+}
+
+#endif /* vstringatom_h */
@@ -0,0 +1,287 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+/** @file */
+
+#include "vstringbuilder.h"
+#include "vtypes_internal.h"
+
+#include "vchar.h"
+#include "vnumberformat.h"
+#include "vexception.h"
+#include "viostream.h"
+
+V_STATIC_INIT_TRACE
+
+VStringBuilder::VStringBuilder(int firstChunkSize)
+    : mChunks()
+    , mCurrentChunkIndex(-1)
+    , mLength(0)
+    , mFirstChunkSize(V_MAX(firstChunkSize, 16))
+    {
+}
+
+VStringBuilder::~VStringBuilder() {
+    this->clear();
+}
+
+void VStringBuilder::reserve(int length) {
+    if (length > 0) {
+        (void) this->_reserveContiguous(length);
+    }
+}
+
+void VStringBuilder::append(const char* chars, int length) {
+    // Fill the current chunk, and put whatever does not fit into the next one.
+    while (length > 0) {
+        if (mCurrentChunkIndex >= 0) {
+            Chunk& chunk = mChunks[mCurrentChunkIndex];
+            int numToCopy = V_MIN(length, chunk.mCapacity - chunk.mLength);
+            ::memcpy(chunk.mBuffer + chunk.mLength, chars, static_cast<VSizeType>(numToCopy));
+            chunk.mLength += numToCopy;
+            mLength += numToCopy;
+            chars += numToCopy;
+            length -= numToCopy;
+        }
+
+        if (length > 0) {
+            (void) this->_reserveContiguous(length);
+        }
+    }
+}
+
+void VStringBuilder::appendRepeated(char c, int count) {
+    while (count > 0) {
+        if (mCurrentChunkIndex >= 0) {
+            Chunk& chunk = mChunks[mCurrentChunkIndex];
+            int numToFill = V_MIN(count, chunk.mCapacity - chunk.mLength);
+            ::memset(chunk.mBuffer + chunk.mLength, c, static_cast<VSizeType>(numToFill));
+            chunk.mLength += numToFill;
+            mLength += numToFill;
+            count -= numToFill;
+        }
+
+        if (count > 0) {
+            (void) this->_reserveContiguous(count);
+        }
+    }
+}
+
+void VStringBuilder::appendS64(Vs64 i) {
+    char* digits = this->_reserveContiguous(VNumberFormat::kMaxIntegerLength);
+    this->_commit(VNumberFormat::formatS64(i, digits));
+}
+
+void VStringBuilder::appendU64(Vu64 i) {
+    char* digits = this->_reserveContiguous(VNumberFormat::kMaxIntegerLength);
+    this->_commit(VNumberFormat::formatU64(i, digits));
+}
+
+void VStringBuilder::appendRoundTrip(VDouble d) {
+    char* digits = this->_reserveContiguous(VNumberFormat::kMaxDoubleLength);
+    this->_commit(VNumberFormat::formatDouble(d, digits));
+}
+
+#ifdef VAULT_VARARG_STRING_FORMATTING_SUPPORT
+void VStringBuilder::appendFormat(const char* formatText, ...) {
+    if (formatText == NULL) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, formatText);
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+
+    // Format into the room left in the current chunk. Only if the result does not fit do we
+    // move to a chunk big enough for it (including vsnprintf's null terminator) and format again.
+    char* buffer = this->_reserveContiguous(1);
+    int room = mChunks[mCurrentChunkIndex].mCapacity - mChunks[mCurrentChunkIndex].mLength;
+    int length = vault::vsnprintf(buffer, static_cast<VSizeType>(room), formatText, args);
+
+    if ((length >= 0) && (length < room)) {
+        this->_commit(length);
+    } else if (length >= 0) {
+        buffer = this->_reserveContiguous(length + 1);
+        (void) vault::vsnprintf(buffer, static_cast<VSizeType>(length + 1), formatText, argsCopy);
+        this->_commit(length);
+    } else {
+        // Some libraries only tell us the result did not fit; let VString work out the length.
+        VString formatted;
+        formatted.vaFormat(formatText, argsCopy);
+        this->append(formatted);
+    }
+
+    va_end(argsCopy);
+    va_end(args);
+}
+#endif /* VAULT_VARARG_STRING_FORMATTING_SUPPORT */
+
+char VStringBuilder::charAt(Vs64 index) const {
+    if ((index < 0) || (index >= mLength)) {
+        throw VRangeException(VSTRING_FORMAT("VStringBuilder::charAt: index " VSTRING_FORMATTER_S64 " is out of range for length " VSTRING_FORMATTER_S64 ".", index, mLength));
+    }
+
+    for (VSizeType i = 0; ; ++i) {
+        const Chunk& chunk = mChunks[i];
+        if (index < chunk.mLength) {
+            return chunk.mBuffer[index];
+        }
+
+        index -= chunk.mLength;
+    }
+}
+
+void VStringBuilder::truncateLength(Vs64 length) {
+    if ((length < 0) || (length > mLength)) {
+        throw VRangeException(VSTRING_FORMAT("VStringBuilder::truncateLength: length " VSTRING_FORMATTER_S64 " is out of range for length " VSTRING_FORMATTER_S64 ".", length, mLength));
+    }
+
+    if (mCurrentChunkIndex < 0) {
+        return;
+    }
+
+    // Find the chunk where the text now ends; it becomes the current chunk and the ones after it are emptied.
+    Vs64 remaining = length;
+    int newCurrentChunkIndex = 0;
+    while (remaining > mChunks[newCurrentChunkIndex].mLength) {
+        remaining -= mChunks[newCurrentChunkIndex].mLength;
+        ++newCurrentChunkIndex;
+    }
+
+    mChunks[newCurrentChunkIndex].mLength = static_cast<int>(remaining);
+    for (int i = newCurrentChunkIndex + 1; i <= mCurrentChunkIndex; ++i) {
+        mChunks[i].mLength = 0;
+    }
+
+    mCurrentChunkIndex = newCurrentChunkIndex;
+    mLength = length;
+}
+
+void VStringBuilder::clear() {
+    for (VSizeType i = 0; i < mChunks.size(); ++i) {
+        delete [] mChunks[i].mBuffer;
+    }
+
+    mChunks.clear();
+    mCurrentChunkIndex = -1;
+    mLength = 0;
+}
+
+void VStringBuilder::copyToString(VString& s) const {
+    s.truncateLength(0);
+    this->appendToString(s);
+}
+
+void VStringBuilder::appendToString(VString& s) const {
+    if (mLength == 0) {
+        return;
+    }
+
+    Vs64 newLength = s.length() + mLength;
+    if (newLength >= V_MAX_S32) {
+        throw VRangeException(VSTRING_FORMAT("VStringBuilder::appendToString: length " VSTRING_FORMATTER_S64 " is too long for a VString.", newLength));
+    }
+
+    int offset = s.length();
+    s.preflight(static_cast<int>(newLength));
+    char* buffer = s.buffer();
+    for (int i = 0; i <= mCurrentChunkIndex; ++i) {
+        ::memcpy(buffer + offset, mChunks[i].mBuffer, static_cast<VSizeType>(mChunks[i].mLength));
+        offset += mChunks[i].mLength;
+    }
+
+    s.postflight(offset);
+}
+
+VString VStringBuilder::toString() const {
+    VString s;
+    this->appendToString(s);
+    return s;
+}
+
+void VStringBuilder::writeToStream(VIOStream& stream) const {
+    for (int i = 0; i <= mCurrentChunkIndex; ++i) {
+        if (mChunks[i].mLength != 0) {
+            (void) stream.write(reinterpret_cast<const Vu8*>(mChunks[i].mBuffer), mChunks[i].mLength);
+        }
+    }
+}
+
+char* VStringBuilder::_reserveContiguous(int length) {
+    if (mCurrentChunkIndex >= 0) {
+        Chunk& chunk = mChunks[mCurrentChunkIndex];
+        if (chunk.mCapacity - chunk.mLength >= length) {
+            return chunk.mBuffer + chunk.mLength;
+        }
+    }
+
+    // Any room left in the current chunk is abandoned. Each new chunk is twice as large as
+    // the one before, so the number of allocations grows only with the log of the length.
+    int chunkSize = mFirstChunkSize;
+    if (mCurrentChunkIndex >= 0) {
+        int currentChunkSize = mChunks[mCurrentChunkIndex].mCapacity;
+        chunkSize = (currentChunkSize < kMaxChunkSize / 2) ? currentChunkSize * 2 : V_MAX(currentChunkSize, static_cast<int>(kMaxChunkSize));
+    }
+
+    chunkSize = V_MAX(chunkSize, length);
+
+    int nextChunkIndex = mCurrentChunkIndex + 1;
+    if (nextChunkIndex == static_cast<int>(mChunks.size())) {
+        Chunk emptyChunk = { NULL, 0, 0 };
+        mChunks.push_back(emptyChunk); // Added before allocating, so that clear() frees the buffer even if a later allocation throws.
+    }
+
+    // A chunk kept from before a truncateLength() is reused if it is big enough.
+    Chunk& nextChunk = mChunks[nextChunkIndex];
+    if (nextChunk.mCapacity < length) {
+        delete [] nextChunk.mBuffer;
+        nextChunk.mBuffer = NULL;
+        nextChunk.mCapacity = 0;
+        nextChunk.mBuffer = new char[chunkSize];
+        nextChunk.mCapacity = chunkSize;
+    }
+
+    mCurrentChunkIndex = nextChunkIndex;
+    return nextChunk.mBuffer;
+}
+
+void VStringBuilder::_appendFmt(const char* pattern, const VStringFormatArgument* args, int numArgs) {
+    if (pattern == NULL) {
+        return;
+    }
+
+    // Copy each run of literal text in one step, and substitute the arguments between runs.
+    char scratch[VStringFormatArgument::kScratchBufferSize];
+    int nextArgIndex = 0;
+    const char* runStart = pattern;
+    const char* p = pattern;
+    for (;;) {
+        bool isEnd = (*p == VCHAR_NULL_TERMINATOR);
+        bool isPlaceholder = (p[0] == '{') && (p[1] == '}') && (nextArgIndex < numArgs);
+        bool isEscapedBrace = ((p[0] == '{') || (p[0] == '}')) && (p[1] == p[0]);
+        if (!isEnd && !isPlaceholder && !isEscapedBrace) {
+            ++p;
+            continue;
+        }
+
+        this->append(runStart, static_cast<int>(p - runStart) + (isEscapedBrace ? 1 : 0)); // An escaped brace ends its run with one brace.
+
+        if (isEnd) {
+            break;
+        }
+
+        if (isPlaceholder) {
+            int length;
+            const char* text = args[nextArgIndex++].getText(scratch, length);
+            this->append(text, length);
+        }
+
+        p += 2;
+        runStart = p;
+    }
+}
@@ -0,0 +1,199 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+#ifndef vstringbuilder_h
+#define vstringbuilder_h
+
+/** @file */
+
+#include "vtypes.h"
+
+#include "vstring.h"
+
+class VIOStream;
+
+/**
+    @ingroup vstring
+*/
+
+/**
+VStringBuilder accumulates a large string from many small appends. VString grows its
+buffer a little at a time and copies its whole contents each time it grows, so building
+a megabyte of text with += copies it over and over. VStringBuilder instead keeps its text
+in a list of chunks: when a chunk is full it starts a new one, twice as large as the last
+(up to kMaxChunkSize), and never moves what it has already written. Each append is
+therefore amortized O(1) no matter how long the text gets.
+
+When the text is complete, either materialize it with one allocation and one copy per
+chunk (copyToString(), appendToString(), toString()), or write the chunks straight to a
+stream (writeToStream()) without ever making a contiguous copy.
+
+Formatted appends (appendFmt(), appendFormat()) and number appends write directly into
+the chunk, without building a temporary VString.
+
+A VStringBuilder is not thread-safe and not copyable.
+*/
+class VStringBuilder {
+    public:
+
+        static const int kDefaultFirstChunkSize = 256;      ///< The size of the first chunk unless the constructor is told otherwise.
+        static const int kMaxChunkSize = 1024 * 1024;       ///< Chunks stop doubling in size once they reach this size.
+
+        /**
+        Constructs an empty builder. No memory is allocated until the first append.
+        @param  firstChunkSize  the size of the first chunk; supply the expected length to get a single chunk
+        */
+        explicit VStringBuilder(int firstChunkSize = kDefaultFirstChunkSize);
+        ~VStringBuilder();
+
+        Vs64 length() const { return mLength; }         ///< Returns the number of chars appended. @return the length in bytes
+        bool isEmpty() const { return mLength == 0; }   ///< Returns true if nothing has been appended. @return true if the length is zero
+
+        /**
+        Makes sure that the specified number of chars can be appended without allocating.
+        Use it when the final length is roughly known, so that the text lands in a single
+        chunk; any room left in the current chunk is abandoned if it is not enough.
+        @param  length  the number of chars about to be appended
+        */
+        void reserve(int length);
+
+        /**
+        Appends chars.
+        @param  chars   the chars to append; they need not be null-terminated
+        @param  length  the number of chars to append
+        */
+        void append(const char* chars, int length);
+        void append(const char* s) { this->append(s, static_cast<int>(::strlen(s))); }  ///< Appends a C string. @param s the null-terminated chars to append
+        void append(const VString& s) { this->append(s.chars(), s.length()); }          ///< Appends a string. @param s the string to append
+        /**
+        Appends one char.
+        @param  c   the char to append
+        */
+        void append(char c);
+        /**
+        Appends a char repeated, such as spaces for indentation.
+        @param  c       the char to append
+        @param  count   the number of times to append it
+        */
+        void appendRepeated(char c, int count);
+        void appendS64(Vs64 i);             ///< Appends a signed integer in decimal. @param i the value
+        void appendU64(Vu64 i);             ///< Appends an unsigned integer in decimal. @param i the value
+        /**
+        Appends a double as the shortest text that parses back to the same value, as
+        VString::appendRoundTrip() does.
+        @param  d   the value
+        */
+        void appendRoundTrip(VDouble d);
+        /**
+        Appends text formatted like VString::appendFmt(): each "{}" in the pattern is
+        replaced by the next argument, formatted according to its C++ type.
+        @param  pattern the pattern text
+        @param  args    the values to substitute
+        */
+        template <typename... ARG_TYPES>
+        void appendFmt(const char* pattern, const ARG_TYPES&... args);
+#ifdef VAULT_VARARG_STRING_FORMATTING_SUPPORT
+        /**
+        Appends text formatted by sprintf-like formatting, formatting directly into the chunk.
+        @param  formatText  the format text
+        @param  ...         varargs to be formatted
+        */
+        void appendFormat(const char* formatText, ...);
+#endif
+
+        VStringBuilder& operator+=(const VString& s) { this->append(s); return *this; }       ///< Appends a string. @param s the string to append @return this builder
+        VStringBuilder& operator+=(const char* s) { this->append(s); return *this; }          ///< Appends a C string. @param s the chars to append @return this builder
+        VStringBuilder& operator+=(char c) { this->append(c); return *this; }                 ///< Appends a char. @param c the char to append @return this builder
+
+        /**
+        Returns the char at the specified index. This must find the chunk holding the
+        char, so it is meant for occasional peeks rather than scanning the text.
+        @param  index   the index, which must be less than length()
+        @return the char
+        */
+        char charAt(Vs64 index) const;
+        /**
+        Shortens the text. The chunks are kept, so that the builder can be filled again
+        without allocating; use clear() to release them.
+        @param  length  the new length, which must not exceed length()
+        */
+        void truncateLength(Vs64 length);
+        /**
+        Empties the builder and releases its memory.
+        */
+        void clear();
+
+        /**
+        Replaces a string's contents with the text, allocating the string's buffer once.
+        @param  s   the string to copy to
+        */
+        void copyToString(VString& s) const;
+        /**
+        Appends the text to a string, growing the string's buffer once.
+        @param  s   the string to append to
+        */
+        void appendToString(VString& s) const;
+        /**
+        Returns the text as a string.
+        @return the text
+        */
+        VString toString() const;
+        /**
+        Writes the text to a stream, one chunk at a time, without first copying it into
+        a contiguous buffer. Line endings are written as they are in the text.
+        @param  stream  the stream to write to
+        */
+        void writeToStream(VIOStream& stream) const;
+
+    private:
+
+        VStringBuilder(const VStringBuilder&); // not copyable
+        VStringBuilder& operator=(const VStringBuilder&); // not assignable
+
+        /** One block of text. A chunk before the current one may have unused room at its end. */
+        struct Chunk {
+            char*   mBuffer;    ///< The chunk's storage.
+            int     mLength;    ///< The number of chars written to it.
+            int     mCapacity;  ///< The size of mBuffer.
+        };
+
+        /**
+        Returns a pointer to at least the specified number of contiguous writable chars,
+        moving on to the next chunk (or allocating one) if the current chunk is too full.
+        The caller writes the chars and then calls _commit().
+        @param  length  the number of chars needed
+        @return where to write them
+        */
+        char* _reserveContiguous(int length);
+        void _commit(int length) { mChunks[mCurrentChunkIndex].mLength += length; mLength += length; }   ///< Records chars written after _reserveContiguous(). @param length the number written
+        void _appendFmt(const char* pattern, const VStringFormatArgument* args, int numArgs);           ///< Implements appendFmt() once the arguments are captured.
+
+        std::vector<Chunk>  mChunks;                ///< The chunks, in order; those after mCurrentChunkIndex are empty and kept for reuse.
+        int                 mCurrentChunkIndex;     ///< The chunk being appended to, or -1 before the first append.
+        Vs64                mLength;                ///< The total number of chars in all chunks.
+        int                 mFirstChunkSize;        ///< The size to make the first chunk.
+};
+
+inline void VStringBuilder::append(char c) {
+    if ((mCurrentChunkIndex >= 0) && (mChunks[mCurrentChunkIndex].mLength < mChunks[mCurrentChunkIndex].mCapacity)) {
+        Chunk& chunk = mChunks[mCurrentChunkIndex];
+        chunk.mBuffer[chunk.mLength++] = c;
+        ++mLength;
+    } else {
+        *(this->_reserveContiguous(1)) = c;
+        this->_commit(1);
+    }
+}
+
+template <typename... ARG_TYPES>
+void VStringBuilder::appendFmt(const char* pattern, const ARG_TYPES&... args) {
+    // The extra trailing element keeps the array from being empty when there are no arguments.
+    const VStringFormatArgument capturedArgs[] = { VStringFormatArgument(args)..., VStringFormatArgument() };
+    this->_appendFmt(pattern, capturedArgs, static_cast<int>(sizeof...(ARG_TYPES)));
+}
+
+#endif /* vstringbuilder_h */
@@ -171,19 +171,40 @@ class VStringIterator {
                 --n;
             }
 
+            // In an ASCII string every code point is one byte, so there is nothing to decode.
+            if (mSource.isASCII()) {
+                if (n > (mSourceLength - mCurrentCodePointOffset)) {
+                    mCurrentCodePointOffset = mSourceLength;
+                    VStringIteratorThrowOutOfBoundsEnd();
+                }
+
+                mCurrentCodePointOffset += n;
+                return;
+            }
+
+            const Vu8* buffer = mSource.getDataBufferConst();
             for (int i = 0; i < n; ++i) {
                 if (mCurrentCodePointOffset == mSourceLength) {
                     VStringIteratorThrowOutOfBoundsEnd();
                 }
 
-                VCodePoint cp(mSource.getDataBufferConst(), mCurrentCodePointOffset);
-                mCurrentCodePointOffset += cp.getUTF8Length();
+                mCurrentCodePointOffset += VCodePoint::getUTF8LengthFromUTF8StartByte(buffer[mCurrentCodePointOffset]);
             }
         }
         
         void _moveOffsetBackwardInBuffer(int n) {
             // If we are at [0], we just move backwards to [-1], and we never move beyond that. (Iterating off the end of
             // a container is undefined behavior. At least)
+            if (mSource.isASCII()) {
+                if (n > mCurrentCodePointOffset) {
+                    mCurrentCodePointOffset = 0;
+                    VStringIteratorThrowOutOfBoundsBegin();
+                }
+
+                mCurrentCodePointOffset -= n;
+                return;
+            }
+
             const Vu8* bufferPtr = mSource.getDataBufferConst() + mCurrentCodePointOffset;
             for (int i = 0; i < n; ++i) {
             
@@ -0,0 +1,61 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+/** @file */
+
+#include "vmemorymappedfile.h"
+#include "vtypes_internal.h"
+
+#include "vexception.h"
+#include <sys/mman.h>
+
+void VMemoryMappedFile::_platform_setSize(Vs64 size) {
+#ifndef VPLATFORM_MAC /* Mac OS X has no posix_fallocate() */
+    // When growing, reserve the new blocks so a full disk fails here rather than with a SIGBUS when a mapped page is first written.
+    const Vs64 currentSize = this->getSize();
+    if (size > currentSize) {
+        int error = ::posix_fallocate(mFile, static_cast<off_t>(currentSize), static_cast<off_t>(size - currentSize));
+        if (error == 0) {
+            return;
+        }
+
+        if ((error != EINVAL) && (error != EOPNOTSUPP)) { // otherwise the file system cannot reserve blocks, so just extend the file
+            throw VException(VSystemError(error), VSTRING_FORMAT("VMemoryMappedFile::_platform_setSize failed reserving size " VSTRING_FORMATTER_S64 " for '%s'.", size, mNode.getPath().chars()));
+        }
+    }
+#endif
+
+    int result = ::ftruncate(mFile, static_cast<off_t>(size));
+
+    if (result != 0) {
+        throw VException(VSystemError(), VSTRING_FORMAT("VMemoryMappedFile::_platform_setSize failed with result %d setting size " VSTRING_FORMATTER_S64 " for '%s'.", result, size, mNode.getPath().chars()));
+    }
+}
+
+Vu8* VMemoryMappedFile::_platform_map(Vs64 offset, Vs64 length) {
+    void* region = ::mmap(NULL, static_cast<size_t>(length), PROT_READ | PROT_WRITE, MAP_SHARED, mFile, static_cast<off_t>(offset));
+
+    if (region == MAP_FAILED) {
+        throw VException(VSystemError(), VSTRING_FORMAT("VMemoryMappedFile::_platform_map failed mapping offset " VSTRING_FORMATTER_S64 " length " VSTRING_FORMATTER_S64 " of '%s'.", offset, length, mNode.getPath().chars()));
+    }
+
+    return static_cast<Vu8*>(region);
+}
+
+void VMemoryMappedFile::_platform_sync(Vu8* region, Vs64 length, bool wait) {
+    (void) ::msync(region, static_cast<size_t>(length), wait ? MS_SYNC : MS_ASYNC);
+}
+
+// static
+void VMemoryMappedFile::_platform_unmap(Vu8* region, Vs64 length) {
+    (void) ::munmap(region, static_cast<size_t>(length));
+}
+
+// static
+Vs64 VMemoryMappedFile::_platform_getGranularity() {
+    return static_cast<Vs64>(::sysconf(_SC_PAGESIZE));
+}
@@ -0,0 +1,62 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+/** @file */
+
+#include "vmemorymappedfile.h"
+#include "vtypes_internal.h"
+
+#include "vexception.h"
+
+void VMemoryMappedFile::_platform_setSize(Vs64 size) {
+    errno_t result = ::_chsize_s(mFile, size);
+
+    if (result != 0) {
+        throw VException(VSTRING_FORMAT("VMemoryMappedFile::_platform_setSize failed with errno %d setting size " VSTRING_FORMATTER_S64 " for '%s'.", (int) result, size, mNode.getPath().chars()));
+    }
+}
+
+Vu8* VMemoryMappedFile::_platform_map(Vs64 offset, Vs64 length) {
+    // The mapping object only needs to live until the view is mapped; the view keeps the mapping alive.
+    HANDLE fileHandle = reinterpret_cast<HANDLE>(::_get_osfhandle(mFile));
+    Vs64 mappingSize = offset + length;
+    HANDLE mappingHandle = ::CreateFileMappingW(fileHandle, NULL, PAGE_READWRITE, static_cast<DWORD>(mappingSize >> 32), static_cast<DWORD>(mappingSize & 0xFFFFFFFF), NULL);
+    if (mappingHandle == NULL) {
+        throw VException(VSystemError(), VSTRING_FORMAT("VMemoryMappedFile::_platform_map failed creating a mapping of " VSTRING_FORMATTER_S64 " bytes of '%s'.", mappingSize, mNode.getPath().chars()));
+    }
+
+    void* region = ::MapViewOfFile(mappingHandle, FILE_MAP_WRITE, static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset & 0xFFFFFFFF), static_cast<SIZE_T>(length));
+    VSystemError mapError; // capture before CloseHandle() can change it
+    (void) ::CloseHandle(mappingHandle);
+
+    if (region == NULL) {
+        throw VException(mapError, VSTRING_FORMAT("VMemoryMappedFile::_platform_map failed mapping offset " VSTRING_FORMATTER_S64 " length " VSTRING_FORMATTER_S64 " of '%s'.", offset, length, mNode.getPath().chars()));
+    }
+
+    return static_cast<Vu8*>(region);
+}
+
+void VMemoryMappedFile::_platform_sync(Vu8* region, Vs64 length, bool wait) {
+    // FlushViewOfFile starts writing the pages; only flushing the file's buffers waits for the disk.
+    (void) ::FlushViewOfFile(region, static_cast<SIZE_T>(length));
+
+    if (wait) {
+        (void) ::FlushFileBuffers(reinterpret_cast<HANDLE>(::_get_osfhandle(mFile)));
+    }
+}
+
+// static
+void VMemoryMappedFile::_platform_unmap(Vu8* region, Vs64 /*length*/) {
+    (void) ::UnmapViewOfFile(region);
+}
+
+// static
+Vs64 VMemoryMappedFile::_platform_getGranularity() {
+    SYSTEM_INFO systemInfo;
+    ::GetSystemInfo(&systemInfo);
+    return static_cast<Vs64>(systemInfo.dwAllocationGranularity);
+}
@@ -0,0 +1,85 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+/** @file */
+
+#include "vmemorymappedfile.h"
+#include "vtypes_internal.h"
+
+#include "vexception.h"
+
+VMemoryMappedFile::VMemoryMappedFile(const VFSNode& node)
+    : mNode(node)
+    , mFile(-1)
+    {
+}
+
+VMemoryMappedFile::~VMemoryMappedFile() {
+    this->close();
+}
+
+void VMemoryMappedFile::openReadWrite() {
+    // Mapping for writing needs the file open for reading too; and unlike VFileSystem::open(), we
+    // must supply permissions, because READWRITE_MODE may create the file.
+    mFile = VPlatformAPI::open(mNode.getPath(), READWRITE_MODE, OPEN_CREATE_PERMISSIONS);
+
+    if (mFile == -1) {
+        throw VException(VSystemError(), VSTRING_FORMAT("VMemoryMappedFile::openReadWrite failed to open '%s'.", mNode.getPath().chars()));
+    }
+}
+
+void VMemoryMappedFile::close() {
+    if (mFile != -1) {
+        (void) VFileSystem::close(mFile);
+        mFile = -1;
+    }
+}
+
+Vs64 VMemoryMappedFile::getSize() const {
+    Vs64 size = static_cast<Vs64>(VFileSystem::lseek(mFile, 0, SEEK_END));
+
+    if (size < 0) {
+        throw VException(VSystemError(), VSTRING_FORMAT("VMemoryMappedFile::getSize failed for '%s'.", mNode.getPath().chars()));
+    }
+
+    return size;
+}
+
+void VMemoryMappedFile::setSize(Vs64 size) {
+    if (size < 0) {
+        throw VRangeException(VSTRING_FORMAT("VMemoryMappedFile::setSize: Invalid size " VSTRING_FORMATTER_S64 " for '%s'.", size, mNode.getPath().chars()));
+    }
+
+    this->_platform_setSize(size);
+}
+
+Vu8* VMemoryMappedFile::map(Vs64 offset, Vs64 length) {
+    if ((offset < 0) || (length <= 0) || ((offset % VMemoryMappedFile::getGranularity()) != 0)) {
+        throw VRangeException(VSTRING_FORMAT("VMemoryMappedFile::map: Invalid region offset " VSTRING_FORMATTER_S64 " length " VSTRING_FORMATTER_S64 " for '%s'.", offset, length, mNode.getPath().chars()));
+    }
+
+    return this->_platform_map(offset, length);
+}
+
+void VMemoryMappedFile::sync(Vu8* region, Vs64 length, bool wait) {
+    if (length > 0) {
+        this->_platform_sync(region, length, wait);
+    }
+}
+
+// static
+void VMemoryMappedFile::unmap(Vu8* region, Vs64 length) {
+    if (region != NULL) {
+        VMemoryMappedFile::_platform_unmap(region, length);
+    }
+}
+
+// static
+Vs64 VMemoryMappedFile::getGranularity() {
+    static const Vs64 kGranularity = VMemoryMappedFile::_platform_getGranularity();
+    return kGranularity;
+}
@@ -0,0 +1,120 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+#ifndef vmemorymappedfile_h
+#define vmemorymappedfile_h
+
+/** @file */
+
+#include "vfsnode.h"
+
+/**
+    @ingroup vfilesystem
+*/
+
+/**
+VMemoryMappedFile opens a file for reading and writing through memory mappings. You can map
+any number of windows ("regions") of the file at once; writes to a region's memory are writes
+to the file, which the OS carries out some time later, or when you sync the region.
+
+Map offsets must be a multiple of getGranularity(). A region must lie within the file, so
+extend the file with setSize() before mapping beyond its end; the extended part reads as zeroes.
+
+Regions remain valid after the file is closed, until they are unmapped. The caller owns the
+regions it maps and must unmap them.
+
+The mapping calls are implemented in the platform-specific vmemorymappedfile_platform.cpp.
+*/
+class VMemoryMappedFile {
+    public:
+
+        /**
+        Constructs the object for the specified file, without opening it.
+        @param  node    the file
+        */
+        VMemoryMappedFile(const VFSNode& node);
+        /**
+        Destructor, closes the file if it is open. It does not unmap any regions.
+        */
+        ~VMemoryMappedFile();
+
+        /**
+        Opens the file for reading and writing, creating it if it does not exist.
+        Throws a VException if it cannot be opened.
+        */
+        void openReadWrite();
+        /**
+        Closes the file if it is open.
+        */
+        void close();
+        /**
+        Returns true if the file is open.
+        @return obvious
+        */
+        bool isOpen() const { return mFile != -1; }
+        /**
+        Returns the file's node.
+        @return obvious
+        */
+        const VFSNode& getNode() const { return mNode; }
+
+        /**
+        Returns the current size of the file.
+        @return the size in bytes
+        */
+        Vs64 getSize() const;
+        /**
+        Extends or truncates the file to the specified size. Throws a VException on failure.
+        Where the platform and file system support it, extending the file reserves its disk blocks,
+        so running out of space throws here rather than failing a later write to a mapped region.
+        @param  size    the new size in bytes
+        */
+        void setSize(Vs64 size);
+
+        /**
+        Maps a region of the file for reading and writing. Throws a VException on failure.
+        @param  offset  the file offset of the start of the region; must be a multiple of getGranularity()
+        @param  length  the length of the region; the region must lie within the file
+        @return the address of the region's first byte
+        */
+        Vu8* map(Vs64 offset, Vs64 length);
+        /**
+        Writes the modified pages of a region to the file.
+        @param  region  the address returned by map()
+        @param  length  the number of bytes from the start of the region to write out
+        @param  wait    true to wait until the data is on disk; false to just start writing it out
+        */
+        void sync(Vu8* region, Vs64 length, bool wait);
+        /**
+        Unmaps a region.
+        @param  region  the address returned by map()
+        @param  length  the length passed to map()
+        */
+        static void unmap(Vu8* region, Vs64 length);
+        /**
+        Returns the unit of mapping offsets: the page size, or on Windows the allocation granularity.
+        @return the granularity in bytes
+        */
+        static Vs64 getGranularity();
+
+    private:
+
+        VMemoryMappedFile(const VMemoryMappedFile&); // not copyable
+        VMemoryMappedFile& operator=(const VMemoryMappedFile&); // not assignable
+
+        // These are implemented in the platform-specific vmemorymappedfile_platform.cpp.
+        void _platform_setSize(Vs64 size);
+        Vu8* _platform_map(Vs64 offset, Vs64 length);
+        void _platform_sync(Vu8* region, Vs64 length, bool wait);
+        static void _platform_unmap(Vu8* region, Vs64 length);
+        static Vs64 _platform_getGranularity();
+
+        VFSNode mNode;  ///< The file.
+        int     mFile;  ///< The open file descriptor, or -1.
+};
+
+#endif /* vmemorymappedfile_h */
@@ -19,6 +19,94 @@ static const Vu8 NINE_BYTE_LENGTH_INDICATOR_BYTE = 0xFD;
 
 #undef sscanf
 
+#ifdef VBYTESWAP_NEEDED
+
+/*
+These swap every value in a buffer of 2-, 4-, or 8-byte values in place, for the
+bulk array read/write methods. The loads and stores go through memcpy so that the
+buffer may hold any type of that width (including VDouble) without aliasing
+problems. Compilers reduce them to plain loads and stores, turn the shifts into a
+bswap, and vectorize the loop when the target has a byte shuffle (SSSE3, NEON);
+a per-value call to VbyteSwap32() etc. prevents all of that.
+*/
+
+static void _byteSwapValues16(Vu8* buffer, int numValues) {
+    for (int i = 0; i < numValues; ++i) {
+        Vu16 value;
+        ::memcpy(&value, buffer + (i * 2), 2);
+        value = static_cast<Vu16>((value >> 8) | (value << 8));
+        ::memcpy(buffer + (i * 2), &value, 2);
+    }
+}
+
+static void _byteSwapValues32(Vu8* buffer, int numValues) {
+    for (int i = 0; i < numValues; ++i) {
+        Vu32 value;
+        ::memcpy(&value, buffer + (i * 4), 4);
+        value = ((value >> 24) & 0x000000FFU) |
+                ((value >> 8)  & 0x0000FF00U) |
+                ((value << 8)  & 0x00FF0000U) |
+                ((value << 24) & 0xFF000000U);
+        ::memcpy(buffer + (i * 4), &value, 4);
+    }
+}
+
+static void _byteSwapValues64(Vu8* buffer, int numValues) {
+    for (int i = 0; i < numValues; ++i) {
+        Vu64 value;
+        ::memcpy(&value, buffer + (i * 8), 8);
+        value = ((value >> 56) & CONST_U64(0x00000000000000FF)) |
+                ((value >> 40) & CONST_U64(0x000000000000FF00)) |
+                ((value >> 24) & CONST_U64(0x0000000000FF0000)) |
+                ((value >> 8)  & CONST_U64(0x00000000FF000000)) |
+                ((value << 8)  & CONST_U64(0x000000FF00000000)) |
+                ((value << 24) & CONST_U64(0x0000FF0000000000)) |
+                ((value << 40) & CONST_U64(0x00FF000000000000)) |
+                ((value << 56) & CONST_U64(0xFF00000000000000));
+        ::memcpy(buffer + (i * 8), &value, 8);
+    }
+}
+
+static void _byteSwapValues(Vu8* buffer, int valueSize, int numValues) {
+    switch (valueSize) {
+        case 2: _byteSwapValues16(buffer, numValues); break;
+        case 4: _byteSwapValues32(buffer, numValues); break;
+        case 8: _byteSwapValues64(buffer, numValues); break;
+        default: break;
+    }
+}
+
+#endif /* VBYTESWAP_NEEDED */
+
+static void _readValues(VBinaryIOStream& stream, Vu8* buffer, int valueSize, int numValues) {
+    if (numValues <= 0) {
+        return;
+    }
+
+    stream.readGuaranteed(buffer, static_cast<Vs64>(valueSize) * numValues);
+#ifdef VBYTESWAP_NEEDED
+    _byteSwapValues(buffer, valueSize, numValues);
+#endif
+}
+
+static void _writeValues(VBinaryIOStream& stream, const Vu8* buffer, int valueSize, int numValues) {
+    if (numValues <= 0) {
+        return;
+    }
+
+    Vs64 numBytes = static_cast<Vs64>(valueSize) * numValues;
+#ifdef VBYTESWAP_NEEDED
+    if (valueSize > 1) {
+        // The caller's values are const, so swap a copy and write that.
+        std::vector<Vu8> swapped(buffer, buffer + numBytes);
+        _byteSwapValues(&swapped[0], valueSize, numValues);
+        (void) stream.write(&swapped[0], numBytes);
+        return;
+    }
+#endif
+    (void) stream.write(buffer, numBytes);
+}
+
 VBinaryIOStream::VBinaryIOStream(VStream& rawStream)
     : VIOStream(rawStream)
     {
@@ -205,6 +293,26 @@ Vs64 VBinaryIOStream::readDynamicCount() {
         return (Vs64) lengthKind;
 }
 
+void VBinaryIOStream::readS8Array(Vs8* values, int numValues) {
+    _readValues(*this, reinterpret_cast<Vu8*>(values), 1, numValues);
+}
+
+void VBinaryIOStream::readS16Array(Vs16* values, int numValues) {
+    _readValues(*this, reinterpret_cast<Vu8*>(values), 2, numValues);
+}
+
+void VBinaryIOStream::readS32Array(Vs32* values, int numValues) {
+    _readValues(*this, reinterpret_cast<Vu8*>(values), 4, numValues);
+}
+
+void VBinaryIOStream::readS64Array(Vs64* values, int numValues) {
+    _readValues(*this, reinterpret_cast<Vu8*>(values), 8, numValues);
+}
+
+void VBinaryIOStream::readDoubleArray(VDouble* values, int numValues) {
+    _readValues(*this, reinterpret_cast<Vu8*>(values), 8, numValues);
+}
+
 void VBinaryIOStream::writeS8(Vs8 i) {
     Vs8 value = i;
     (void) this->write(reinterpret_cast<Vu8*>(&value), CONST_S64(1));
@@ -334,6 +442,26 @@ void VBinaryIOStream::writeDynamicCount(Vs64 count) {
     }
 }
 
+void VBinaryIOStream::writeS8Array(const Vs8* values, int numValues) {
+    _writeValues(*this, reinterpret_cast<const Vu8*>(values), 1, numValues);
+}
+
+void VBinaryIOStream::writeS16Array(const Vs16* values, int numValues) {
+    _writeValues(*this, reinterpret_cast<const Vu8*>(values), 2, numValues);
+}
+
+void VBinaryIOStream::writeS32Array(const Vs32* values, int numValues) {
+    _writeValues(*this, reinterpret_cast<const Vu8*>(values), 4, numValues);
+}
+
+void VBinaryIOStream::writeS64Array(const Vs64* values, int numValues) {
+    _writeValues(*this, reinterpret_cast<const Vu8*>(values), 8, numValues);
+}
+
+void VBinaryIOStream::writeDoubleArray(const VDouble* values, int numValues) {
+    _writeValues(*this, reinterpret_cast<const Vu8*>(values), 8, numValues);
+}
+
 // static
 int VBinaryIOStream::getDynamicCountLength(Vs64 count) {
     if (count <= MAX_ONE_BYTE_LENGTH) {
@@ -317,6 +317,40 @@ class VBinaryIOStream : public VIOStream {
         */
         Vs64 readDynamicCount();
 
+        /**
+        Reads an array of signed 8-bit values from the stream with a single read.
+        The caller supplies storage for the values; no count is read.
+        @param  values      the buffer to fill; must have room for numValues elements
+        @param  numValues   the number of values to read
+        */
+        void readS8Array(Vs8* values, int numValues);
+        /**
+        Reads an array of signed 16-bit values from the stream with a single read,
+        and then converts them to host byte order in place. This is equivalent to,
+        but much faster than, calling readS16() once per element.
+        @param  values      the buffer to fill; must have room for numValues elements
+        @param  numValues   the number of values to read
+        */
+        void readS16Array(Vs16* values, int numValues);
+        /**
+        Reads an array of signed 32-bit values; see readS16Array().
+        @param  values      the buffer to fill; must have room for numValues elements
+        @param  numValues   the number of values to read
+        */
+        void readS32Array(Vs32* values, int numValues);
+        /**
+        Reads an array of signed 64-bit values; see readS16Array().
+        @param  values      the buffer to fill; must have room for numValues elements
+        @param  numValues   the number of values to read
+        */
+        void readS64Array(Vs64* values, int numValues);
+        /**
+        Reads an array of double-precision floating-point values; see readS16Array().
+        @param  values      the buffer to fill; must have room for numValues elements
+        @param  numValues   the number of values to read
+        */
+        void readDoubleArray(VDouble* values, int numValues);
+
         /**
         Writes a signed 8-bit value to the stream.
         @param    i    the Vs8
@@ -418,6 +452,41 @@ class VBinaryIOStream : public VIOStream {
         */
         void writeDynamicCount(Vs64 count);
 
+        /**
+        Writes an array of signed 8-bit values to the stream with a single write.
+        No count is written; the caller writes one first if the reader needs it.
+        @param  values      the values to write
+        @param  numValues   the number of values to write
+        */
+        void writeS8Array(const Vs8* values, int numValues);
+        /**
+        Writes an array of signed 16-bit values to the stream with a single write,
+        converting them to network byte order in a scratch buffer if the host byte
+        order differs. The bytes written are identical to calling writeS16() once
+        per element.
+        @param  values      the values to write
+        @param  numValues   the number of values to write
+        */
+        void writeS16Array(const Vs16* values, int numValues);
+        /**
+        Writes an array of signed 32-bit values; see writeS16Array().
+        @param  values      the values to write
+        @param  numValues   the number of values to write
+        */
+        void writeS32Array(const Vs32* values, int numValues);
+        /**
+        Writes an array of signed 64-bit values; see writeS16Array().
+        @param  values      the values to write
+        @param  numValues   the number of values to write
+        */
+        void writeS64Array(const Vs64* values, int numValues);
+        /**
+        Writes an array of double-precision floating-point values; see writeS16Array().
+        @param  values      the values to write
+        @param  numValues   the number of values to write
+        */
+        void writeDoubleArray(const VDouble* values, int numValues);
+
         /**
         Returns the number of bytes that the specified count value would take in
         a stream when streamed using the dynamic count format.
@@ -361,6 +361,7 @@ class VStream {
         static Vs64 streamCopy(VStream& fromStream, VIOStream& toStream, Vs64 numBytesToCopy, Vs64 tempBufferSize = 16384);
 
         friend class VWriteBufferedStream;
+        friend class VTextIOStream; // readLine() scans buffer-based streams in place via _getReadIOPtr()
 
         /**
         Returns the name of the stream that it was given when constructed.
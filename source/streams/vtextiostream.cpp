@@ -20,6 +20,10 @@ VTextIOStream::VTextIOStream(VStream& rawStream, int lineEndingsWriteKind) :
     mPendingCharacter(0),
     mReadState(kReadStateReady),
     mLineBuffer(),
+    mReadBuffer(),
+    mReadBufferSize(0),
+    mReadBufferStart(0),
+    mReadBufferEnd(0),
 #ifndef VCOMPILER_MSVC /* GCC EffC++ warnings want this initializer, but then VC++ warns about default initialization. */
     mLineEndingChars(),
 #endif
@@ -29,6 +33,13 @@ VTextIOStream::VTextIOStream(VStream& rawStream, int lineEndingsWriteKind) :
 }
 
 void VTextIOStream::readLine(VString& s, bool includeLineEnding) {
+    if (this->_canReadLineInBulk()) {
+        int length;
+        const char* chars = this->_readLineInBulk(length, includeLineEnding);
+        s.copyFromBuffer(chars, 0, length);
+        return;
+    }
+
     // Note: We append char-by-char, but VString should already be optimized to
     // avoid actually re-allocating its buffer for each single-char expansion.
 
@@ -118,11 +129,54 @@ void VTextIOStream::readLine(VString& s, bool includeLineEnding) {
     s = mLineBuffer;
 }
 
+const char* VTextIOStream::readLineChars(int& length, bool includeLineEnding) {
+    if (this->_canReadLineInBulk()) {
+        return this->_readLineInBulk(length, includeLineEnding);
+    }
+
+    this->readLine(mLineBuffer, includeLineEnding);
+    length = mLineBuffer.length();
+    return mLineBuffer.chars();
+}
+
 VCodePoint VTextIOStream::readUTF8CodePoint() {
     VCodePoint cp(*this);
     return cp;
 }
 
+void VTextIOStream::readGuaranteed(Vu8* targetBuffer, Vs64 numBytesToRead) {
+    Vs64 numBufferedBytes = V_MIN(numBytesToRead, static_cast<Vs64>(mReadBufferEnd - mReadBufferStart));
+    if (numBufferedBytes > 0) {
+        ::memcpy(targetBuffer, &mReadBuffer[mReadBufferStart], static_cast<VSizeType>(numBufferedBytes));
+        this->_consumeReadWindow(numBufferedBytes);
+        targetBuffer += numBufferedBytes;
+        numBytesToRead -= numBufferedBytes;
+    }
+
+    if (numBytesToRead > 0) {
+        VIOStream::readGuaranteed(targetBuffer, numBytesToRead);
+    }
+}
+
+Vu8 VTextIOStream::readGuaranteedByte() {
+    if (mReadBufferStart < mReadBufferEnd) {
+        return mReadBuffer[mReadBufferStart++];
+    }
+
+    return VIOStream::readGuaranteedByte();
+}
+
+void VTextIOStream::setReadBufferSize(int bufferSize) {
+    mReadBufferSize = V_MAX(0, bufferSize);
+
+    // If bytes are still buffered, they will be returned first; the buffer is resized when next filled.
+    if ((mReadBufferSize == 0) && (mReadBufferStart == mReadBufferEnd)) {
+        std::vector<Vu8>().swap(mReadBuffer);
+        mReadBufferStart = 0;
+        mReadBufferEnd = 0;
+    }
+}
+
 VChar VTextIOStream::readCharacterByte() {
     char c;
 
@@ -131,24 +185,60 @@ VChar VTextIOStream::readCharacterByte() {
     return c;
 }
 
+// Appends bytes to a string, growing its buffer at most once.
+static void _appendBytes(VString& s, const Vu8* bytes, Vs64 numBytes) {
+    Vs64 newLength = s.length() + numBytes;
+    if (newLength >= V_MAX_S32) {
+        throw VRangeException(VSTRING_FORMAT("VTextIOStream: line length " VSTRING_FORMATTER_S64 " is too long for a VString.", newLength));
+    }
+
+    int length = s.length();
+    s.preflight(static_cast<int>(newLength));
+    ::memcpy(s.buffer() + length, bytes, static_cast<VSizeType>(numBytes));
+    s.postflight(static_cast<int>(newLength));
+}
+
 void VTextIOStream::readAll(VString& s, bool includeLineEndings) {
+    // We read to EOF, so reading ahead cannot take anything the caller would read afterward.
+    int savedReadBufferSize = mReadBufferSize;
+    if (savedReadBufferSize == 0) {
+        this->setReadBufferSize(kDefaultReadBufferSize);
+    }
+
     try {
-        VString line;
         for (;;) {
-            this->readLine(line, includeLineEndings);
-            s += line;
+            int length;
+            const char* chars = this->readLineChars(length, includeLineEndings);
+            _appendBytes(s, reinterpret_cast<const Vu8*>(chars), length);
         }
-    } catch (const VEOFException&) {}
+    } catch (const VEOFException&) {
+    } catch (...) {
+        this->setReadBufferSize(savedReadBufferSize);
+        throw;
+    }
+
+    this->setReadBufferSize(savedReadBufferSize);
 }
 
 void VTextIOStream::readAll(VStringVector& lines) {
+    int savedReadBufferSize = mReadBufferSize;
+    if (savedReadBufferSize == 0) {
+        this->setReadBufferSize(kDefaultReadBufferSize);
+    }
+
     try {
         VString line;
         for (;;) {
             this->readLine(line);
             lines.push_back(line);
         }
-    } catch (const VEOFException&) {}
+    } catch (const VEOFException&) {
+    } catch (...) {
+        this->setReadBufferSize(savedReadBufferSize);
+        throw;
+    }
+
+    this->setReadBufferSize(savedReadBufferSize);
 }
 
 void VTextIOStream::writeLine(const VString& s) {
@@ -247,6 +337,193 @@ void VTextIOStream::_updateLineEndingsReadKind(int lineEndingKind) {
 
 }
 
+bool VTextIOStream::_canReadLineInBulk() const {
+    return (mReadBufferStart < mReadBufferEnd) || (mReadBufferSize > 0) || (mRawStream._getReadIOPtr() != NULL);
+}
+
+/*
+Returns a pointer to the first 0x0A or 0x0D in the bytes, or NULL if there is none.
+Neither byte can occur inside a multi-byte UTF-8 sequence, so we can search bytes
+rather than code points. We look for each with memchr, over a range that doubles
+each time it comes up empty; that way a file with only one kind of line ending does
+not make us search far past the end of each line for the other kind.
+*/
+static const Vu8* _findLineEnding(const Vu8* bytes, const Vu8* end) {
+    Vs64 rangeLength = 64;
+    while (bytes < end) {
+        const Vu8* rangeEnd = (end - bytes > rangeLength) ? bytes + rangeLength : end;
+        const Vu8* lf = static_cast<const Vu8*>(::memchr(bytes, 0x0A, static_cast<VSizeType>(rangeEnd - bytes)));
+        const Vu8* crSearchEnd = (lf == NULL) ? rangeEnd : lf;
+        const Vu8* cr = static_cast<const Vu8*>(::memchr(bytes, 0x0D, static_cast<VSizeType>(crSearchEnd - bytes)));
+        if (cr != NULL) {
+            return cr;
+        }
+
+        if (lf != NULL) {
+            return lf;
+        }
+
+        bytes = rangeEnd;
+        rangeLength *= 2;
+    }
+
+    return NULL;
+}
+
+const char* VTextIOStream::_readLineInBulk(int& length, bool includeLineEnding) {
+    // This follows the same state machine as the char-by-char readLine(), but takes
+    // each run of ordinary characters in one step. A line is returned in place if it
+    // lies entirely within one window; otherwise its pieces are gathered in mLineBuffer.
+
+    mLineBuffer = VString::EMPTY();
+
+    bool readFirstByteOfLine = false;
+
+    // A character left over from the char-by-char readLine() comes first.
+    if (mPendingCharacter.isNotNull()) {
+        VCodePoint c = mPendingCharacter;
+        mPendingCharacter = VCodePoint(0);
+        readFirstByteOfLine = true;
+
+        if (c == 0x0A) {
+            if (includeLineEnding) {
+                mLineBuffer += c;
+            }
+
+            this->_updateLineEndingsReadKind(kLineEndingsUnix);
+            length = mLineBuffer.length();
+            return mLineBuffer.chars();
+        } else if (c == 0x0D) {
+            mReadState = kReadStateGot0x0D;
+        } else {
+            mLineBuffer += c;
+        }
+    }
+
+    const Vu8* bytes;
+    Vs64 numBytes;
+    while (this->_getReadWindow(bytes, numBytes)) {
+        readFirstByteOfLine = true;
+
+        if (mReadState == kReadStateGot0x0D) {
+            // The last byte we saw was a 0x0D (possibly at the end of the previous block);
+            // the next byte tells us whether it was a DOS or a Mac line ending.
+            mReadState = kReadStateReady;
+
+            if (bytes[0] == 0x0A) {
+                this->_consumeReadWindow(1);
+
+                if (includeLineEnding) {
+                    mLineBuffer += VCodePoint(0x0D);
+                    mLineBuffer += VCodePoint(0x0A);
+                }
+
+                this->_updateLineEndingsReadKind(kLineEndingsDOS);
+            } else {
+                if (includeLineEnding) {
+                    mLineBuffer += VCodePoint(0x0D);
+                }
+
+                this->_updateLineEndingsReadKind(kLineEndingsMac);
+            }
+
+            break;
+        }
+
+        const Vu8* lineEnding = _findLineEnding(bytes, bytes + numBytes);
+
+        if (lineEnding == NULL) { // the line continues beyond this window
+            _appendBytes(mLineBuffer, bytes, numBytes);
+            this->_consumeReadWindow(numBytes);
+            continue;
+        }
+
+        Vs64 textLength = lineEnding - bytes;
+        Vs64 lineEndingLength = 1;
+
+        if (*lineEnding == 0x0A) {
+            this->_updateLineEndingsReadKind(kLineEndingsUnix);
+        } else if (textLength + 1 == numBytes) { // the 0x0D is the last byte we have, so wait for the next window
+            _appendBytes(mLineBuffer, bytes, textLength);
+            this->_consumeReadWindow(numBytes);
+            mReadState = kReadStateGot0x0D;
+            continue;
+        } else if (lineEnding[1] == 0x0A) {
+            lineEndingLength = 2;
+            this->_updateLineEndingsReadKind(kLineEndingsDOS);
+        } else {
+            this->_updateLineEndingsReadKind(kLineEndingsMac);
+        }
+
+        Vs64 lineLength = textLength + (includeLineEnding ? lineEndingLength : 0);
+        if (lineLength >= V_MAX_S32) {
+            throw VRangeException(VSTRING_FORMAT("VTextIOStream: line length " VSTRING_FORMATTER_S64 " is too long for a VString.", lineLength));
+        }
+
+        // Consuming the bytes does not move them, so the line can be returned in place.
+        this->_consumeReadWindow(textLength + lineEndingLength);
+
+        if (mLineBuffer.isEmpty()) {
+            length = static_cast<int>(lineLength);
+            return reinterpret_cast<const char*>(bytes);
+        }
+
+        _appendBytes(mLineBuffer, bytes, lineLength);
+        break;
+    }
+
+    // Throw EOF if we fail reading very first byte of line.
+    // Otherwise, we'll return whatever we read, and throw next time.
+    if (!readFirstByteOfLine) {
+        throw VEOFException("EOF");
+    }
+
+    length = mLineBuffer.length();
+    return mLineBuffer.chars();
+}
+
+bool VTextIOStream::_getReadWindow(const Vu8*& bytes, Vs64& numBytes) {
+    if (mReadBufferStart < mReadBufferEnd) {
+        bytes = &mReadBuffer[mReadBufferStart];
+        numBytes = mReadBufferEnd - mReadBufferStart;
+        return true;
+    }
+
+    const Vu8* rawBytes = mRawStream._getReadIOPtr();
+    if (rawBytes != NULL) {
+        bytes = rawBytes;
+        numBytes = mRawStream._prepareToRead(mRawStream.available());
+        return numBytes > 0;
+    }
+
+    if (mReadBufferSize == 0) {
+        return false;
+    }
+
+    // Like the char-by-char readLine(), we treat no bytes available as the end of input,
+    // and we only ask for as many bytes as are available so that a socket read cannot block.
+    Vs64 numBytesToRead = V_MIN(static_cast<Vs64>(mReadBufferSize), mRawStream.available());
+    if (numBytesToRead <= 0) {
+        return false;
+    }
+
+    mReadBuffer.resize(static_cast<VSizeType>(mReadBufferSize));
+    mReadBufferStart = 0;
+    mReadBufferEnd = static_cast<int>(mRawStream.read(&mReadBuffer[0], numBytesToRead));
+
+    bytes = &mReadBuffer[0];
+    numBytes = mReadBufferEnd;
+    return numBytes > 0;
+}
+
+void VTextIOStream::_consumeReadWindow(Vs64 numBytes) {
+    if (mReadBufferStart < mReadBufferEnd) {
+        mReadBufferStart += static_cast<int>(numBytes);
+    } else {
+        mRawStream._finishRead(numBytes);
+    }
+}
+
 int VTextIOStream::getLineEndingsReadKindForWrite() const {
     int writeKind = kUseNativeLineEndings;
 
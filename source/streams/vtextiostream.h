@@ -27,10 +27,24 @@ the native mode for the platform the code is running on.
 You can find out what the line ending mode is when reading, in case
 you need to tell the user (imagine implementing a line ending selection
 the way the CodeWarrior IDE does).
+
+readLine() reads in bulk whenever it can, finding line endings with memchr
+rather than examining each code point. If the raw stream keeps its data in a
+buffer (a VMemoryStream), lines are found in place without any read-ahead.
+For other streams (files, sockets) you can turn on a read buffer with
+setReadBufferSize(); readLine() then pulls blocks of that size from the raw
+stream. Because that reads ahead of the lines returned, you must not read,
+skip, or seek the raw stream (or call read(), skip(), seek() or available()
+on this object) while hasPendingCharacter() is true; readLine(), readLineChars(),
+readUTF8CodePoint(), readCharacterByte() and readGuaranteed() all consume the
+buffered bytes first. readAll() turns the read buffer on for its duration,
+since it reads to EOF anyway.
 */
 class VTextIOStream : public VIOStream {
     public:
 
+        static const int kDefaultReadBufferSize = 65536; ///< The read buffer size readAll() uses if the caller has not set one.
+
         /** Values for mLineEndingsReadKind, set as we read the stream and figure out what its format is. */
         enum {
             kLineEndingsUnknown,    ///< Indicates that we have not yet read a line ending.
@@ -75,6 +89,18 @@ class VTextIOStream : public VIOStream {
                                     to be included in the string that is returned
         */
         void readLine(VString& s, bool includeLineEnding = false);
+        /**
+        Reads the next line of text like readLine(), but returns it without copying
+        it when it can: the chars point into the raw stream's buffer or this object's
+        read buffer. They remain valid only until the next read from this object or
+        change to the raw stream, and are not null-terminated.
+
+        @param    length               set to the number of chars in the line
+        @param    includeLineEnding    true if you want the line ending character(s)
+                                    to be included in the returned chars
+        @return a pointer to the line's chars
+        */
+        const char* readLineChars(int& length, bool includeLineEnding = false);
 
         /**
         Reads the next code point (1 to 4 bytes) from the stream, even if it is part
@@ -100,6 +126,26 @@ class VTextIOStream : public VIOStream {
         */
         virtual VChar readCharacterByte();
 
+        // VIOStream overrides, which take bytes from the read buffer before the raw stream:
+        virtual void readGuaranteed(Vu8* targetBuffer, Vs64 numBytesToRead);
+        virtual Vu8 readGuaranteedByte();
+
+        /**
+        Sets the size of the blocks that readLine() reads from a raw stream that does
+        not keep its data in a buffer. The default is zero, meaning no read buffer:
+        readLine() then reads one code point at a time, so that it never reads
+        beyond the end of the line (which matters if the caller will go on to read
+        the raw stream directly). Bytes already buffered are still returned by
+        subsequent reads if you turn the buffer off.
+        @param    bufferSize    the read buffer size in bytes, or zero for none
+        */
+        void setReadBufferSize(int bufferSize);
+        /**
+        Returns the read buffer size set by setReadBufferSize().
+        @return the read buffer size in bytes, or zero for none
+        */
+        int getReadBufferSize() const { return mReadBufferSize; }
+
         /**
         Primarily useful for reading from an underlying file stream, reads until
         eof is encountered, and returns the entire stream as a single string, by
@@ -172,17 +218,53 @@ class VTextIOStream : public VIOStream {
         @param    kind    one of the mLineEndingsWriteKind enum values
         */
         void setLineEndingsKind(int kind);
+        /**
+        Returns true if a character has already been read from the raw stream but
+        not yet returned to the caller (this happens after reading a Mac-style 0x0D
+        line ending, and whenever the read buffer holds bytes). Code that bypasses
+        this object to read the raw stream directly must not do so while a character
+        is pending.
+        @return true if a character is pending
+        */
+        bool hasPendingCharacter() const { return mPendingCharacter.isNotNull() || (mReadBufferStart < mReadBufferEnd); }
+        /**
+        Returns the character(s) that writeLineEnd() writes, according to the
+        mLineEndingsWriteKind property. This lets code that composes text in its
+        own buffer use the same line endings before writing the buffer with writeString().
+        @param  numChars    set to the number of line ending chars (0 if kUseSuppliedLineEndings)
+        @return a pointer to the line ending chars
+        */
+        const Vu8* getLineEndingChars(int& numChars) const { numChars = mLineEndingCharsLength; return mLineEndingChars; }
 
     private:
 
         /** Updates the mLineEndingsReadKind based on the kind of line ending just detected. */
         void _updateLineEndingsReadKind(int lineEndingKind);
+        /** Returns true if readLine() can scan for line endings in bulk rather than reading code points. */
+        bool _canReadLineInBulk() const;
+        /** Implements readLineChars() by scanning blocks with memchr; readLine() copies the result. */
+        const char* _readLineInBulk(int& length, bool includeLineEnding);
+        /**
+        Returns the bytes that can be scanned next without blocking: those in the read
+        buffer, or else those in the raw stream's buffer, or else a block newly read
+        into the read buffer.
+        @param  bytes       set to point to the bytes
+        @param  numBytes    set to the number of bytes
+        @return false if there are no more bytes (EOF)
+        */
+        bool _getReadWindow(const Vu8*& bytes, Vs64& numBytes);
+        /** Marks bytes returned by _getReadWindow() as read. @param numBytes the number of bytes to consume */
+        void _consumeReadWindow(Vs64 numBytes);
 
         int         mLineEndingsReadKind;   ///< During read, the kind of line endings we think the file is using.
         int         mLineEndingsWriteKind;  ///< During write, the kind of line endings the caller wants us to use.
         VCodePoint  mPendingCharacter;      ///< During read we may have a pending character while reading DOS line endings.
         int         mReadState;             ///< During read we have to maintain parsing state.
         VString     mLineBuffer;            ///< Temporarily holds each line of the file as we read it.
+        std::vector<Vu8> mReadBuffer;       ///< The read buffer; bytes read ahead from the raw stream by readLine().
+        int         mReadBufferSize;        ///< The size of blocks to read into mReadBuffer; zero if read buffering is off.
+        int         mReadBufferStart;       ///< The offset in mReadBuffer of the next byte to return.
+        int         mReadBufferEnd;         ///< The offset in mReadBuffer after the last byte read ahead.
         Vu8         mLineEndingChars[2];    ///< One or both bytes may be used, as indicated by mLineEndingCharsLength.
         int         mLineEndingCharsLength; ///< Describes how much of mLineEndingChars array should be written as line ending.
 
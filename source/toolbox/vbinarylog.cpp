@@ -0,0 +1,514 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+/** @file */
+
+#include "vbinarylog.h"
+
+#include "vthread.h"
+#include "vsettings.h"
+#include "vbento.h"
+#include "vexception.h"
+
+static const Vu8 BINARY_LOG_MAGIC[4] = { 'V', 'B', 'L', 'G' };
+static const Vu8 BINARY_LOG_FORMAT_VERSION = 1;
+static const int BINARY_LOG_HEADER_LENGTH = 6; // the kind, the magic number and the format version
+static const VString BINARY_LOG_TIME_FORMAT("y-MM-dd HH:mm:ss.SSS"); // the same as VLogAppender's default
+
+static std::atomic<Vu32> gNextBinaryLogSiteID(1); // 0 means a site has no ID yet
+static std::atomic<Vu32> gNextBinaryLogThreadIndex(0);
+
+// Messages and raw lines that reach a VBinaryLogAppender as text are written as events of these sites.
+static VBinaryLogSite gTextMessageSite("{}", "", 0);
+static VBinaryLogSite gLocatedTextMessageSite("@ {}:{}: {}", "", 0);
+
+// VBinaryLogSite -------------------------------------------------------------
+
+Vu32 VBinaryLogSite::_assignID() const {
+    // If two threads race to log from a new site, one ID goes unused.
+    Vu32 newID = gNextBinaryLogSiteID.fetch_add(1);
+    Vu32 existingID = 0;
+    if (mID.compare_exchange_strong(existingID, newID)) {
+        return newID;
+    }
+
+    return existingID;
+}
+
+// VBinaryLogRecord -----------------------------------------------------------
+
+void VBinaryLogRecord::putEventHeader(Vu32 siteID, int level) {
+    bool isEvent = (this->getKind() == kEvent);
+    if (isEvent) {
+        this->_putU32(siteID);
+        this->_putU32(static_cast<Vu32>(level));
+    }
+
+    this->_putU64(static_cast<Vu64>(VInstant().getValue()));
+    mThreadIndex = VBinaryLogRecord::getCurrentThreadIndex();
+    this->_putU32(mThreadIndex);
+
+    if (isEvent) {
+        mNumArgumentsOffset = mLength;
+        this->_putU8(0);
+    }
+}
+
+void VBinaryLogRecord::putArgument(double d) {
+    if (this->_beginArgument(kDoubleArgument, 8)) {
+        Vu64 bits;
+        ::memcpy(&bits, &d, 8);
+        this->_putU64(bits);
+    }
+}
+
+void VBinaryLogRecord::putString(const char* chars, int length, bool isArgument) {
+    if (isArgument) {
+        if (!this->_beginArgument(kStringArgument, 4)) {
+            return;
+        }
+    } else if (mLength > kMaxLength - 4) {
+        return;
+    }
+
+    length = V_MIN(length, kMaxLength - mLength - 4);
+    this->_putU32(static_cast<Vu32>(length));
+    if (length > 0) {
+        ::memcpy(mBytes + mLength, chars, static_cast<VSizeType>(length));
+        mLength += length;
+    }
+}
+
+// static
+Vu32 VBinaryLogRecord::getCurrentThreadIndex() {
+    static thread_local Vu32 threadIndex = gNextBinaryLogThreadIndex.fetch_add(1);
+    return threadIndex;
+}
+
+bool VBinaryLogRecord::_beginArgument(ArgumentKind kind, int valueLength) {
+    if ((mNumArgumentsOffset < 0) || (mBytes[mNumArgumentsOffset] == V_MAX_U8) || (mLength + 1 + valueLength > kMaxLength)) {
+        return false;
+    }
+
+    this->_putU8(static_cast<Vu8>(kind));
+    ++mBytes[mNumArgumentsOffset];
+    return true;
+}
+
+// VBinaryLogAppender ---------------------------------------------------------
+
+VBinaryLogAppender::VBinaryLogAppender(const VString& name, const VString& filePath, int level)
+    : VLogAppender(name, DONT_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY())
+    , mLevel(level)
+    , mFileStream(VFSNode(filePath))
+    , mBufferMutex()
+    , mBuffer(new Vu8[kBufferSize])
+    , mBufferLength(0)
+    , mDefinedSites()
+    , mDefinedThreads()
+    {
+    this->_openFile();
+}
+
+VBinaryLogAppender::VBinaryLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults)
+    : VLogAppender(settings, defaults)
+    , mLevel(_getIntInitSetting("level", settings, defaults, VLoggerLevel::ALL))
+    , mFileStream()
+    , mBufferMutex()
+    , mBuffer(new Vu8[kBufferSize])
+    , mBufferLength(0)
+    , mDefinedSites()
+    , mDefinedThreads()
+    {
+    // As with VFileLogAppender, the default file is named after the appender, in the base log directory.
+    VString defaultPath;
+    VLogger::getBaseLogDirectory().getChildPath(settings.getString("name") + ".vblog", defaultPath);
+    mFileStream.setNode(VFSNode(_getStringInitSetting("path", settings, defaults, defaultPath)));
+
+    this->_openFile();
+}
+
+VBinaryLogAppender::~VBinaryLogAppender() {
+    try {
+        std::lock_guard<std::mutex> locker(mBufferMutex);
+        this->_writeBuffer();
+    } catch (...) {} // prevent exceptions from escaping destructor
+
+    delete [] mBuffer;
+}
+
+void VBinaryLogAppender::addInfo(VBentoNode& infoNode) const {
+    VLogAppender::addInfo(infoNode);
+    infoNode.addString("type", "VBinaryLogAppender");
+    infoNode.addString("file", mFileStream.getNode().getPath());
+    infoNode.addInt("level", mLevel);
+}
+
+void VBinaryLogAppender::flush() {
+    std::lock_guard<std::mutex> locker(mBufferMutex);
+    this->_writeBuffer();
+}
+
+void VBinaryLogAppender::_emitMessage(int level, const char* file, int line, const VString& message, const VString& /*specifiedLoggerName*/, const VString& /*actualLoggerName*/) {
+    VBinaryLogSite& site = (file == NULL) ? gTextMessageSite : gLocatedTextMessageSite;
+    VBinaryLogRecord record(VBinaryLogRecord::kEvent);
+    record.putEventHeader(site.getID(), level);
+    if (file == NULL) {
+        record.putArguments(message);
+    } else {
+        record.putArguments(file, line, message);
+    }
+
+    this->_writeEvent(site, level, record);
+}
+
+void VBinaryLogAppender::_emitRawLine(const VString& line) {
+    VBinaryLogRecord record(VBinaryLogRecord::kRawLine);
+    record.putEventHeader(0, 0);
+    record.putString(line.chars(), line.length());
+
+    std::lock_guard<std::mutex> locker(mBufferMutex);
+    this->_defineThread(record.getThreadIndex());
+    this->_append(record);
+}
+
+void VBinaryLogAppender::_openFile() {
+    VFSNode newLogFileDir;
+    mFileStream.getNode().getParentNode(newLogFileDir);
+    newLogFileDir.mkdirs();
+
+    mFileStream.openReadWrite();
+    mFileStream.seek(CONST_S64(0), SEEK_END);
+
+    VBinaryLogRecord header(VBinaryLogRecord::kHeader);
+    for (int i = 0; i < 4; ++i) {
+        header.putU8(BINARY_LOG_MAGIC[i]);
+    }
+
+    header.putU8(BINARY_LOG_FORMAT_VERSION);
+
+    std::lock_guard<std::mutex> locker(mBufferMutex);
+    this->_append(header);
+    this->_writeBuffer();
+}
+
+void VBinaryLogAppender::_writeEvent(const VBinaryLogSite& site, int level, const VBinaryLogRecord& record) {
+    std::lock_guard<std::mutex> locker(mBufferMutex);
+
+    Vu32 siteID = site.getID();
+    if (siteID >= mDefinedSites.size()) {
+        mDefinedSites.resize(siteID + 1, false);
+    }
+
+    if (!mDefinedSites[siteID]) {
+        VBinaryLogRecord definition(VBinaryLogRecord::kSiteDefinition);
+        definition.putU32(siteID);
+        definition.putS32(site.getLine());
+        definition.putString(site.getFile(), static_cast<int>(::strlen(site.getFile())));
+        definition.putString(site.getPattern(), static_cast<int>(::strlen(site.getPattern())));
+        this->_append(definition);
+        mDefinedSites[siteID] = true;
+    }
+
+    this->_defineThread(record.getThreadIndex());
+    this->_append(record);
+
+    if (level <= VLoggerLevel::ERROR) {
+        this->_writeBuffer();
+    }
+}
+
+void VBinaryLogAppender::_defineThread(Vu32 threadIndex) {
+    if (threadIndex >= mDefinedThreads.size()) {
+        mDefinedThreads.resize(threadIndex + 1, false);
+    }
+
+    if (mDefinedThreads[threadIndex]) {
+        return;
+    }
+
+    VString threadName = VSTRING_U32(threadIndex); // if the name cannot be had, the index will do
+    try {
+        threadName = VThread::getCurrentThreadName();
+    } catch (...) {
+    }
+
+    VBinaryLogRecord definition(VBinaryLogRecord::kThreadDefinition);
+    definition.putU32(threadIndex);
+    definition.putString(threadName.chars(), threadName.length());
+    this->_append(definition);
+    mDefinedThreads[threadIndex] = true;
+}
+
+void VBinaryLogAppender::_append(const VBinaryLogRecord& record) {
+    if (mBufferLength + record.getLength() > kBufferSize) {
+        this->_writeBuffer();
+    }
+
+    ::memcpy(mBuffer + mBufferLength, record.getBytes(), static_cast<VSizeType>(record.getLength()));
+    mBufferLength += record.getLength();
+}
+
+void VBinaryLogAppender::_writeBuffer() {
+    if (mBufferLength == 0) {
+        return;
+    }
+
+    (void) mFileStream.write(mBuffer, mBufferLength);
+    mBufferLength = 0;
+    mFileStream.flush();
+}
+
+// VBinaryLogReader -----------------------------------------------------------
+
+VBinaryLogReader::VBinaryLogReader(VStream& stream)
+    : mInput(stream)
+    , mWindowStart(0)
+    , mWindowEnd(0)
+    , mInputEnded(false)
+    , mHeaderSeen(false)
+    , mSites()
+    , mThreadNames()
+    , mTimeStampFormatter(BINARY_LOG_TIME_FORMAT)
+    {
+}
+
+bool VBinaryLogReader::readEvent(VBinaryLogEvent& event) {
+    for (;;) {
+        this->_fillWindow();
+        const int numBytes = mWindowEnd - mWindowStart;
+        if (numBytes == 0) {
+            return false;
+        }
+
+        VMemoryStream recordBuffer(mWindow + mWindowStart, VMemoryStream::kAllocatedUnknown, false, numBytes, numBytes);
+        VBinaryIOStream record(recordBuffer);
+        const int nextHeaderOffset = mHeaderSeen ? this->_findNextHeader() : -1;
+        bool isEvent = false;
+        bool isComplete = true;
+        try {
+            isEvent = this->_readRecord(record, event);
+        } catch (const VEOFException& /*ex*/) {
+            isComplete = false;
+        } catch (const VException& /*ex*/) {
+            if (nextHeaderOffset < 0) {
+                throw;
+            }
+
+            isComplete = false;
+        }
+
+        // A record that runs into a header was cut short when its writer stopped, and a later run appended after it.
+        const int recordLength = static_cast<int>(recordBuffer.getIOOffset());
+        if ((nextHeaderOffset >= 0) && (!isComplete || (recordLength > nextHeaderOffset))) {
+            mWindowStart += nextHeaderOffset;
+            continue;
+        }
+
+        if (!isComplete) {
+            if (mInputEnded) {
+                return false; // cut short at the end of the input
+            }
+
+            throw VException("VBinaryLogReader::readEvent: A record is longer than any the writer produces.");
+        }
+
+        mWindowStart += recordLength;
+        if (isEvent) {
+            return true;
+        }
+    }
+}
+
+VString VBinaryLogReader::formatEvent(const VBinaryLogEvent& event, bool useUTC) const {
+    if (event.mIsRawLine) {
+        return event.mMessage;
+    }
+
+    VString line = useUTC ? mTimeStampFormatter.formatUTCString(event.mWhen) : mTimeStampFormatter.formatLocalString(event.mWhen);
+    line.appendFmt(" {} | {} | ", VLoggerLevel::getName(event.mLevel), event.mThreadName);
+    if (event.mFile.isNotEmpty()) {
+        line.appendFmt("@ {}:{}: ", event.mFile, event.mLine);
+    }
+
+    line += event.mMessage;
+    return line;
+}
+
+// Reads a string written by putString(). Unlike VBinaryIOStream::readString32(), it refuses a length
+// that no record can hold, which is what a record cut short in its length field may yield.
+static void _readRecordString(VBinaryIOStream& record, VString& s) {
+    int length = static_cast<int>(record.readS32());
+    if ((length < 0) || (length > VBinaryLogRecord::kMaxLength)) {
+        throw VException(VSTRING_FORMAT("VBinaryLogReader: A string length of %d is not possible in a record.", length));
+    }
+
+    if (length == 0) {
+        s = VString::EMPTY();
+    } else {
+        s.preflight(length);
+        record.readGuaranteed(s.getDataBuffer(), length);
+        s.postflight(length);
+    }
+}
+
+void VBinaryLogReader::_fillWindow() {
+    if (mInputEnded || (mWindowEnd - mWindowStart >= VBinaryLogRecord::kMaxLength + BINARY_LOG_HEADER_LENGTH)) {
+        return;
+    }
+
+    ::memmove(mWindow, mWindow + mWindowStart, static_cast<VSizeType>(mWindowEnd - mWindowStart));
+    mWindowEnd -= mWindowStart;
+    mWindowStart = 0;
+
+    while (!mInputEnded && (mWindowEnd < kWindowSize)) {
+        Vs64 numBytesRead = mInput.read(mWindow + mWindowEnd, kWindowSize - mWindowEnd);
+        if (numBytesRead <= 0) {
+            mInputEnded = true;
+        } else {
+            mWindowEnd += static_cast<int>(numBytesRead);
+        }
+    }
+}
+
+int VBinaryLogReader::_findNextHeader() const {
+    // A record that was cut short is shorter than the longest record, so the header that follows it starts within that length.
+    const int lastOffset = V_MIN(VBinaryLogRecord::kMaxLength - 1, mWindowEnd - mWindowStart - BINARY_LOG_HEADER_LENGTH);
+    for (int offset = 1; offset <= lastOffset; ++offset) {
+        const Vu8* header = mWindow + mWindowStart + offset;
+        if ((header[0] == VBinaryLogRecord::kHeader) && (::memcmp(header + 1, BINARY_LOG_MAGIC, 4) == 0) && (header[5] == BINARY_LOG_FORMAT_VERSION)) {
+            return offset;
+        }
+    }
+
+    return -1;
+}
+
+bool VBinaryLogReader::_readRecord(VBinaryIOStream& record, VBinaryLogEvent& event) {
+    Vu8 kind = record.readU8();
+    if (!mHeaderSeen && (kind != VBinaryLogRecord::kHeader)) {
+        throw VException("VBinaryLogReader::readEvent: The input does not start with a binary log header.");
+    }
+
+    switch (kind) {
+        case VBinaryLogRecord::kHeader:
+            this->_readHeader(record);
+            return false;
+
+        case VBinaryLogRecord::kSiteDefinition: {
+            Vu32 siteID = record.readU32();
+            SiteDefinition& site = mSites[siteID];
+            site.mLine = record.readS32();
+            _readRecordString(record, site.mFile);
+            _readRecordString(record, site.mPattern);
+            return false;
+        }
+
+        case VBinaryLogRecord::kThreadDefinition: {
+            Vu32 threadIndex = record.readU32();
+            _readRecordString(record, mThreadNames[threadIndex]);
+            return false;
+        }
+
+        case VBinaryLogRecord::kEvent: {
+            Vu32 siteID = record.readU32();
+            event.mLevel = record.readS32();
+            this->_readEventHeader(record, event);
+
+            SiteDefinitionMap::const_iterator site = mSites.find(siteID);
+            if (site == mSites.end()) {
+                throw VException(VSTRING_FORMAT("VBinaryLogReader::readEvent: An event refers to undefined site " VSTRING_FORMATTER_U32 ".", siteID));
+            }
+
+            event.mIsRawLine = false;
+            event.mFile = site->second.mFile;
+            event.mLine = site->second.mLine;
+            this->_readArguments(record, site->second.mPattern, event.mMessage);
+            return true;
+        }
+
+        case VBinaryLogRecord::kRawLine:
+            event.mIsRawLine = true;
+            event.mLevel = 0;
+            event.mFile = VString::EMPTY();
+            event.mLine = 0;
+            this->_readEventHeader(record, event);
+            _readRecordString(record, event.mMessage);
+            return true;
+
+        default:
+            throw VException(VSTRING_FORMAT("VBinaryLogReader::readEvent: Unknown record kind %d.", static_cast<int>(kind)));
+    }
+}
+
+void VBinaryLogReader::_readHeader(VBinaryIOStream& record) {
+    Vu8 magic[4];
+    record.readGuaranteed(magic, 4);
+    if (::memcmp(magic, BINARY_LOG_MAGIC, 4) != 0) {
+        throw VException("VBinaryLogReader::_readHeader: The input is not a binary log.");
+    }
+
+    Vu8 version = record.readU8();
+    if (version != BINARY_LOG_FORMAT_VERSION) {
+        throw VException(VSTRING_FORMAT("VBinaryLogReader::_readHeader: Unsupported binary log format version %d.", static_cast<int>(version)));
+    }
+
+    // Each run of the writer numbers its sites and threads afresh.
+    mHeaderSeen = true;
+    mSites.clear();
+    mThreadNames.clear();
+}
+
+void VBinaryLogReader::_readEventHeader(VBinaryIOStream& record, VBinaryLogEvent& event) {
+    event.mWhen.setValue(record.readS64());
+
+    Vu32 threadIndex = record.readU32();
+    ThreadNameMap::const_iterator threadName = mThreadNames.find(threadIndex);
+    event.mThreadName = (threadName == mThreadNames.end()) ? VSTRING_U32(threadIndex) : threadName->second;
+}
+
+void VBinaryLogReader::_readArguments(VBinaryIOStream& record, const VString& pattern, VString& message) {
+    int numArgs = record.readU8();
+
+    // The string arguments are stored first, in a vector that never reallocates, because
+    // each VStringFormatArgument refers to its string's characters rather than copying them.
+    VStringVector strings;
+    strings.reserve(static_cast<VSizeType>(numArgs));
+    std::vector<VStringFormatArgument> args;
+    args.reserve(static_cast<VSizeType>(numArgs));
+
+    for (int i = 0; i < numArgs; ++i) {
+        Vu8 kind = record.readU8();
+        switch (kind) {
+            case VBinaryLogRecord::kBoolArgument:
+                args.push_back(VStringFormatArgument(record.readU8() != 0));
+                break;
+            case VBinaryLogRecord::kCharArgument:
+                args.push_back(VStringFormatArgument(static_cast<char>(record.readU8())));
+                break;
+            case VBinaryLogRecord::kSignedArgument:
+                args.push_back(VStringFormatArgument(record.readS64()));
+                break;
+            case VBinaryLogRecord::kUnsignedArgument:
+                args.push_back(VStringFormatArgument(record.readU64()));
+                break;
+            case VBinaryLogRecord::kDoubleArgument:
+                args.push_back(VStringFormatArgument(record.readDouble()));
+                break;
+            case VBinaryLogRecord::kStringArgument:
+                strings.push_back(VString::EMPTY());
+                _readRecordString(record, strings.back());
+                args.push_back(VStringFormatArgument(strings.back()));
+                break;
+            default:
+                throw VException(VSTRING_FORMAT("VBinaryLogReader::_readArguments: Unknown argument kind %d.", static_cast<int>(kind)));
+        }
+    }
+
+    message = VString::EMPTY();
+    message.appendFmtArguments(pattern.chars(), args.data(), numArgs);
+}
@@ -0,0 +1,355 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+#ifndef vbinarylog_h
+#define vbinarylog_h
+
+/** @file */
+
+#include "vlogger.h"
+#include "vbinaryiostream.h"
+
+#include <mutex>
+
+/**
+    @ingroup vlogger
+*/
+
+/**
+Binary logging moves the cost of formatting a log message from the thread that logs it to
+whoever reads the log later. Each call site has a pattern in the form used by VString::fmt(),
+which is written to the log once; each call writes only the site's ID, the level, a time stamp,
+a thread index, and the raw bytes of its arguments. A VBinaryLogReader (and the
+vbinarylogdecoder command-line tool built on it) turns the records back into text.
+
+Use the VLOGGER_BINARY macro to log to a VBinaryLogAppender:
+
+    VLOGGER_BINARY(*appender, VLoggerLevel::DEBUG, "session {} read {} bytes in {} ms", sessionID, numBytes, elapsedMilliseconds);
+
+The arguments may be of any type VString::fmt() accepts. They are captured by value when the call
+is made (strings are copied), so nothing is referenced after the call returns.
+
+The file consists of records, each starting with a kind byte; multi-byte values are in network
+byte order, and strings are written as by VBinaryIOStream::writeString32(). The appender writes a
+header record each time it opens the file, and a definition record the first time it writes an
+event for each site or thread, so a file can be appended to by successive runs and still be read
+on its own.
+*/
+
+/**
+A call site that logs in binary. The VLOGGER_BINARY macro declares one as a static local, which
+the compiler initializes without any run-time code; it is assigned an ID the first time it logs.
+*/
+class VBinaryLogSite {
+    public:
+
+        /**
+        Constructs the site. The strings must outlive it; the macro passes literals.
+        @param  pattern the message pattern, in the form used by VString::fmt()
+        @param  file    the source file name, or an empty string
+        @param  line    the source line number, or 0
+        */
+        constexpr VBinaryLogSite(const char* pattern, const char* file, int line) : mPattern(pattern), mFile(file), mLine(line), mID(0) {}
+
+        Vu32 getID() const { Vu32 id = mID.load(std::memory_order_relaxed); return (id != 0) ? id : this->_assignID(); } ///< Returns the site's ID, assigning one if this is its first use. @return the ID
+        const char* getPattern() const { return mPattern; } ///< Returns the message pattern. @return obvious
+        const char* getFile() const { return mFile; }       ///< Returns the source file name. @return obvious
+        int getLine() const { return mLine; }               ///< Returns the source line number. @return obvious
+
+    private:
+
+        VBinaryLogSite(const VBinaryLogSite&); // not copyable
+        VBinaryLogSite& operator=(const VBinaryLogSite&); // not assignable
+
+        Vu32 _assignID() const; ///< Assigns the next unused ID, unless another thread has just done so. @return the ID
+
+        const char*                 mPattern;   ///< The message pattern.
+        const char*                 mFile;      ///< The source file name.
+        int                         mLine;      ///< The source line number.
+        mutable std::atomic<Vu32>   mID;        ///< The ID written in each event, or 0 until the site first logs.
+};
+
+/**
+One record of a binary log, encoded into a fixed-size buffer so that building it allocates nothing.
+A string argument that does not fit is truncated, and any argument after it that does not fit is
+dropped; normal messages are far shorter than the limit.
+*/
+class VBinaryLogRecord {
+    public:
+
+        static const int kMaxLength = 1024; ///< The largest record that is written.
+
+        /** The kind of a record, its first byte. */
+        enum Kind {
+            kHeader,            ///< Starts each run of records: a magic number and a format version.
+            kSiteDefinition,    ///< A site's ID, line number, file name, and pattern.
+            kThreadDefinition,  ///< A thread's index and name.
+            kEvent,             ///< A site's ID, the level, the time stamp, the thread index, and the arguments.
+            kRawLine            ///< The time stamp, the thread index, and a line to be read back as is.
+        };
+
+        /** The kind of an argument of an event, the first byte of its value. */
+        enum ArgumentKind {
+            kBoolArgument,      ///< A bool, as one byte.
+            kCharArgument,      ///< A char, as one byte.
+            kSignedArgument,    ///< Any signed integer type, as 8 bytes.
+            kUnsignedArgument,  ///< Any unsigned integer type, as 8 bytes.
+            kDoubleArgument,    ///< A float or double, as 8 bytes.
+            kStringArgument     ///< A C string or VString, length-prefixed.
+        };
+
+        /**
+        Starts a record of the specified kind.
+        @param  kind    the kind of record
+        */
+        explicit VBinaryLogRecord(Kind kind) : mLength(0), mNumArgumentsOffset(-1), mThreadIndex(0) { this->_putU8(static_cast<Vu8>(kind)); }
+        ~VBinaryLogRecord() {}
+
+        /**
+        Writes the fixed part of an event or raw line record: the site ID (events only) and level,
+        the current time, and the calling thread's index.
+        @param  siteID  the site ID, ignored for a raw line
+        @param  level   the level, ignored for a raw line
+        */
+        void putEventHeader(Vu32 siteID, int level);
+
+        /**
+        Appends an event's arguments.
+        @param  args    the values to append
+        */
+        template <typename... ARG_TYPES>
+        void putArguments(const ARG_TYPES&... args) {
+            const int unused[] = { 0, (this->putArgument(args), 0)... };
+            (void) unused;
+        }
+
+        void putArgument(bool b) { if (this->_beginArgument(kBoolArgument, 1)) this->_putU8(b ? 1 : 0); }                        ///< Appends a bool argument. @param b the value
+        void putArgument(char c) { if (this->_beginArgument(kCharArgument, 1)) this->_putU8(static_cast<Vu8>(c)); }              ///< Appends a char argument. @param c the value
+        void putArgument(signed char i) { this->_putSignedArgument(i); }            ///< Appends an integer argument. @param i the value
+        void putArgument(unsigned char i) { this->_putUnsignedArgument(i); }        ///< Appends an integer argument. @param i the value
+        void putArgument(short i) { this->_putSignedArgument(i); }                  ///< Appends an integer argument. @param i the value
+        void putArgument(unsigned short i) { this->_putUnsignedArgument(i); }       ///< Appends an integer argument. @param i the value
+        void putArgument(int i) { this->_putSignedArgument(i); }                    ///< Appends an integer argument. @param i the value
+        void putArgument(unsigned int i) { this->_putUnsignedArgument(i); }         ///< Appends an integer argument. @param i the value
+        void putArgument(long i) { this->_putSignedArgument(i); }                   ///< Appends an integer argument. @param i the value
+        void putArgument(unsigned long i) { this->_putUnsignedArgument(i); }        ///< Appends an integer argument. @param i the value
+        void putArgument(long long i) { this->_putSignedArgument(i); }              ///< Appends an integer argument. @param i the value
+        void putArgument(unsigned long long i) { this->_putUnsignedArgument(i); }   ///< Appends an integer argument. @param i the value
+        void putArgument(float f) { this->putArgument(static_cast<VDouble>(f)); }   ///< Appends a float argument. @param f the value
+        void putArgument(double d);                                                 ///< Appends a double argument. @param d the value
+        void putArgument(const char* s) { this->putString(s, (s == NULL) ? 0 : static_cast<int>(::strlen(s)), true); }   ///< Appends a C string argument; NULL is appended as empty. @param s the value
+        void putArgument(const VString& s) { this->putString(s.chars(), s.length(), true); }                                ///< Appends a string argument. @param s the value
+        void putArgument(const void* p) = delete; ///< Other pointers would otherwise silently convert to bool.
+
+        /**
+        Appends a length-prefixed string, truncated to fit.
+        @param  chars       the characters
+        @param  length      the number of characters
+        @param  isArgument  true if the string is an event argument, which is preceded by its kind and counted
+        */
+        void putString(const char* chars, int length, bool isArgument = false);
+        void putU8(Vu8 i) { if (mLength < kMaxLength) this->_putU8(i); }                         ///< Appends a byte, if it fits. @param i the value
+        void putU32(Vu32 i) { if (mLength <= kMaxLength - 4) this->_putU32(i); }                 ///< Appends a 32-bit value, if it fits. @param i the value
+        void putS32(Vs32 i) { this->putU32(static_cast<Vu32>(i)); }                              ///< Appends a 32-bit value, if it fits. @param i the value
+
+        Kind getKind() const { return static_cast<Kind>(mBytes[0]); }   ///< Returns the kind of record. @return obvious
+        Vu32 getThreadIndex() const { return mThreadIndex; }            ///< Returns the thread index written by putEventHeader(). @return obvious
+        const Vu8* getBytes() const { return mBytes; }                  ///< Returns the encoded record. @return obvious
+        int getLength() const { return mLength; }                       ///< Returns the number of bytes in the encoded record. @return obvious
+
+        static Vu32 getCurrentThreadIndex(); ///< Returns the calling thread's index, assigned the first time it logs in binary and never reused. @return obvious
+
+    private:
+
+        VBinaryLogRecord(const VBinaryLogRecord&); // not copyable
+        VBinaryLogRecord& operator=(const VBinaryLogRecord&); // not assignable
+
+        // Shifting puts bytes in network order on any host, and compiles to a byte swap where one is needed,
+        // rather than the function call the V_BYTESWAP macros make.
+        void _putU8(Vu8 i) { mBytes[mLength++] = i; }
+        void _putU32(Vu32 i) { Vu8* p = mBytes + mLength; p[0] = static_cast<Vu8>(i >> 24); p[1] = static_cast<Vu8>(i >> 16); p[2] = static_cast<Vu8>(i >> 8); p[3] = static_cast<Vu8>(i); mLength += 4; }
+        void _putU64(Vu64 i) { this->_putU32(static_cast<Vu32>(i >> 32)); this->_putU32(static_cast<Vu32>(i)); }
+        void _putSignedArgument(Vs64 i) { if (this->_beginArgument(kSignedArgument, 8)) this->_putU64(static_cast<Vu64>(i)); }
+        void _putUnsignedArgument(Vu64 i) { if (this->_beginArgument(kUnsignedArgument, 8)) this->_putU64(i); }
+        bool _beginArgument(ArgumentKind kind, int valueLength); ///< Writes an argument's kind and counts it, if it and a value of the specified length fit. @return true if the value should be written
+
+        Vu8     mBytes[kMaxLength];     ///< The encoded record.
+        int     mLength;                ///< The number of bytes in mBytes.
+        int     mNumArgumentsOffset;    ///< For an event, where its argument count is in mBytes.
+        Vu32    mThreadIndex;           ///< The thread index written by putEventHeader().
+};
+
+/**
+An appender that writes a binary log file, which is read back with VBinaryLogReader. Its
+logBinary() function, normally called through VLOGGER_BINARY, is the point of it. Messages that
+reach it through the normal logging path are written too, with their text already formatted, and
+raw lines are written as is.
+
+Records are collected in a buffer that is written to the file when it fills, when an event at
+ERROR level or more severe is logged, when flush() is called, and when the appender is destructed.
+
+It defines the following additional properties:
+- "path" (string)
+  Defaults to "<name>.vblog" in the base log directory. Specifies the file path for the log file,
+  which is appended to.
+- "level" (int)
+  Defaults to VLoggerLevel::ALL. The level above which VLOGGER_BINARY does not log.
+*/
+class VBinaryLogAppender : public VLogAppender {
+    public:
+
+        static const int kBufferSize = 65536; ///< The number of bytes collected before they are written to the file.
+
+        VBinaryLogAppender(const VString& name, const VString& filePath, int level = VLoggerLevel::ALL);
+        VBinaryLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults);
+        virtual ~VBinaryLogAppender();
+        virtual void addInfo(VBentoNode& infoNode) const;
+
+        bool isEnabledFor(int level) const { return level <= mLevel; }  ///< Returns true if logBinary() at the specified level would log. @param level obvious @return obvious
+        int getLevel() const { return mLevel; }                         ///< Returns the level above which logBinary() does not log. @return obvious
+        void setLevel(int level) { mLevel = level; }                    ///< Sets the level above which logBinary() does not log. @param level obvious
+
+        /**
+        Logs an event from the specified site. The level is not checked here; VLOGGER_BINARY checks it first.
+        @param  site    the call site
+        @param  level   the level of the event
+        @param  args    the values for the site's pattern
+        */
+        template <typename... ARG_TYPES>
+        void logBinary(const VBinaryLogSite& site, int level, const ARG_TYPES&... args) {
+            VBinaryLogRecord record(VBinaryLogRecord::kEvent);
+            record.putEventHeader(site.getID(), level);
+            record.putArguments(args...);
+            this->_writeEvent(site, level, record);
+        }
+
+        /**
+        Writes the records collected so far to the file.
+        */
+        void flush();
+
+    protected:
+        virtual void _emitMessage(int level, const char* file, int line, const VString& message, const VString& specifiedLoggerName, const VString& actualLoggerName);
+        virtual void _emitRawLine(const VString& line);
+
+    private:
+
+        VBinaryLogAppender(const VBinaryLogAppender&); // not copyable
+        VBinaryLogAppender& operator=(const VBinaryLogAppender&); // not assignable
+
+        void _openFile(); // constructor helper
+        void _writeEvent(const VBinaryLogSite& site, int level, const VBinaryLogRecord& record);    ///< Writes an event, preceded by any definitions it needs.
+        void _defineThread(Vu32 threadIndex);           ///< Writes a thread's definition the first time one of its records is written; the caller must hold mBufferMutex.
+        void _append(const VBinaryLogRecord& record);   ///< Adds a record to the buffer, first writing the buffer out if it is full; the caller must hold mBufferMutex.
+        void _writeBuffer();                            ///< Writes the buffer to the file and flushes it; the caller must hold mBufferMutex.
+
+        int                 mLevel;             ///< The level above which VLOGGER_BINARY does not log.
+        VBufferedFileStream mFileStream;        ///< The file we append to.
+        // A VMutex reads the clock and records the locker's name on every lock, which would cost more
+        // than the rest of a binary log call, so the state below is guarded by a plain std::mutex. The
+        // text path takes it inside mMutex; logBinary() takes only this one.
+        std::mutex          mBufferMutex;
+        Vu8*                mBuffer;            ///< Records not yet written to the file.
+        int                 mBufferLength;      ///< The number of bytes in mBuffer.
+        std::vector<bool>   mDefinedSites;      ///< Indexed by site ID, true if the site's definition has been written to the file.
+        std::vector<bool>   mDefinedThreads;    ///< Indexed by thread index, true if the thread's definition has been written to the file.
+};
+
+/**
+One record read back from a binary log by VBinaryLogReader.
+*/
+struct VBinaryLogEvent {
+    VBinaryLogEvent() : mIsRawLine(false), mWhen(), mLevel(0), mThreadName(), mFile(), mLine(0), mMessage() {}
+
+    bool        mIsRawLine;     ///< True if the record was a raw line, in which case only mWhen, mThreadName and mMessage are set.
+    VInstant    mWhen;          ///< When the event was logged.
+    int         mLevel;         ///< The level it was logged at.
+    VString     mThreadName;    ///< The name the logging thread had when it first logged to the file.
+    VString     mFile;          ///< The source file name of the call site, or empty.
+    int         mLine;          ///< The source line number of the call site, or 0.
+    VString     mMessage;       ///< The site's pattern formatted with the event's arguments, or the raw line.
+};
+
+/**
+Reads the records of a binary log and formats them as text. A record cut short by the end of the
+input, as when the writer stopped in the middle of writing its buffer, is treated as the end. A
+record cut short by the header of a later run, as when a run that crashed was followed by another
+that appended to the file, is skipped, and reading continues with that run. (A string argument
+that happens to contain a header's bytes is mistaken for one, which costs the event it is in.)
+*/
+class VBinaryLogReader {
+    public:
+
+        /**
+        Constructs a reader of the specified stream, which must be positioned at a header record,
+        as at the start of a file.
+        @param  stream  the stream to read from
+        */
+        explicit VBinaryLogReader(VStream& stream);
+        ~VBinaryLogReader() {}
+
+        /**
+        Reads the next event or raw line, processing any header and definition records before it.
+        Throws a VException if the input is not a binary log or refers to an undefined site.
+        @param  event   set to the event read
+        @return true if an event was read, false at the end of the input
+        */
+        bool readEvent(VBinaryLogEvent& event);
+        /**
+        Formats an event as a text log line in the default layout of VLogAppender; a raw line is returned as is.
+        @param  event   the event
+        @param  useUTC  true to show the time stamp in UTC rather than local time
+        @return the line of text
+        */
+        VString formatEvent(const VBinaryLogEvent& event, bool useUTC = false) const;
+
+    private:
+
+        VBinaryLogReader(const VBinaryLogReader&); // not copyable
+        VBinaryLogReader& operator=(const VBinaryLogReader&); // not assignable
+
+        /** What a site definition record supplies. */
+        struct SiteDefinition {
+            VString mFile;      ///< The source file name.
+            int     mLine;      ///< The source line number.
+            VString mPattern;   ///< The message pattern.
+        };
+
+        typedef std::map<Vu32, SiteDefinition> SiteDefinitionMap;
+        typedef std::map<Vu32, VString> ThreadNameMap;
+
+        static const int kWindowSize = 2 * VBinaryLogRecord::kMaxLength; ///< Room for the longest record and a header that may follow within its length.
+
+        void _fillWindow();                             ///< Moves the unread bytes to the start of mWindow and reads more input after them, unless there are enough for a record.
+        int _findNextHeader() const;                    ///< Returns the offset from mWindowStart of a header that starts within the length of a record there, or -1.
+        bool _readRecord(VBinaryIOStream& record, VBinaryLogEvent& event); ///< Reads one record from the window. @return true if it was an event or raw line, which is set in event
+        void _readHeader(VBinaryIOStream& record);      ///< Checks the rest of a header record and forgets the definitions read before it.
+        void _readEventHeader(VBinaryIOStream& record, VBinaryLogEvent& event); ///< Reads the time stamp and thread index that start an event or raw line record.
+        void _readArguments(VBinaryIOStream& record, const VString& pattern, VString& message); ///< Reads an event's arguments and formats its message.
+
+        VStream&                mInput;                 ///< The stream we read.
+        Vu8                     mWindow[kWindowSize];   ///< Input read ahead, so that a record can be checked against a header that follows it.
+        int                     mWindowStart;           ///< The offset in mWindow of the next record.
+        int                     mWindowEnd;             ///< The offset in mWindow after the last byte read.
+        bool                    mInputEnded;            ///< True once the input has been read to its end.
+        bool                    mHeaderSeen;            ///< True once the first header record has been read.
+        SiteDefinitionMap       mSites;                 ///< The sites defined since the last header.
+        ThreadNameMap           mThreadNames;           ///< The threads defined since the last header.
+        VLogTimeStampFormatter  mTimeStampFormatter;    ///< Formats time stamps as VLogAppender does by default.
+};
+
+/**
+Logs an event in binary to a VBinaryLogAppender, if the appender's level allows it. The pattern
+must be a string literal; it is only written to the log the first time the call site logs.
+@param  appender    the VBinaryLogAppender (an object, not a pointer)
+@param  level       the level of the event
+@param  pattern     the message pattern, in the form used by VString::fmt()
+@param  ...         the values for the pattern
+*/
+#define VLOGGER_BINARY(appender, level, pattern, ...) do { if (!VLOGGER_LEVEL_COMPILED_IN(level) || !(appender).isEnabledFor(level)) break; static VBinaryLogSite vloggerBinaryLogSite(pattern, __FILE__, __LINE__); (appender).logBinary(vloggerBinaryLogSite, level, ##__VA_ARGS__); } while (false)
+
+#endif /* vbinarylog_h */
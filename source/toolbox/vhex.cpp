@@ -8,9 +8,64 @@ http://www.bombaydigital.com/
 
 #include "vhex.h"
 
+#include "vstream.h"
 #include "vtextiostream.h"
 #include "vbinaryiostream.h"
 #include "vchar.h"
+#include "vnumberformat.h"
+
+/*
+The two uppercase hex digits of every byte value, in byte order. Encoding a byte
+is a 2-char copy from offset 2 * byteValue.
+*/
+static const char kHexDigitPairs[] =
+    "000102030405060708090A0B0C0D0E0F"
+    "101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F"
+    "303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F"
+    "505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F"
+    "707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F"
+    "909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+    "B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+    "D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+    "F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+/*
+The nibble value of every char: 0-15 for the hex digits in either case, and 0 for
+anything else (which is what hexCharToNibble() has always returned for them).
+*/
+static const Vu8 kHexDigitValues[256] = {
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  0,  0,  0,  0,  0,  0,
+     0, 10, 11, 12, 13, 14, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0, 10, 11, 12, 13, 14, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+static inline Vu8 _hexDigitValue(char hexChar) {
+    return kHexDigitValues[static_cast<Vu8>(hexChar)];
+}
+
+static inline char _printableASCIIChar(Vu8 byteValue) {
+    return ((byteValue <= 0x20) || (byteValue > 0x7E)) ? '.' : static_cast<char>(byteValue);
+}
 
 // static
 void VHex::bufferToHexString(const Vu8* buffer, Vs64 bufferLength, VString& s, bool wantLeading0x) {
@@ -21,52 +76,54 @@ void VHex::bufferToHexString(const Vu8* buffer, Vs64 bufferLength, VString& s, b
 
     s.preflight(hexStringLength);
 
-    char*   hexStringBuffer = s.buffer();
-    int     hexStringIndex = 0;
-    int     bufferIndex = 0;
-    char    highNibbleChar;
-    char    lowNibbleChar;
+    char* hexStringBuffer = s.buffer();
 
     if (wantLeading0x) {
-        hexStringBuffer[hexStringIndex++] = '0';
-        hexStringBuffer[hexStringIndex++] = 'x';
+        *hexStringBuffer++ = '0';
+        *hexStringBuffer++ = 'x';
     }
 
-    while (bufferIndex < bufferLength) {
-        VHex::byteToHexChars(buffer[bufferIndex++], &highNibbleChar, &lowNibbleChar);
-
-        hexStringBuffer[hexStringIndex++] = highNibbleChar;
-        hexStringBuffer[hexStringIndex++] = lowNibbleChar;
-    }
+    VHex::bytesToHexChars(buffer, bufferLength, hexStringBuffer);
 
     s.postflight(hexStringLength);
 }
 
 // static
 void VHex::hexStringToBuffer(const VString& hexDigits, Vu8* buffer, bool hasLeading0x) {
-    int     digitsIndex = 0;
-    int     bufferIndex = 0;
-    int     numDigits = hexDigits.length();
-    bool    oddNumHexDigits = (numDigits % 2) != 0;
-    char    highNibbleChar = '0';
-    char    lowNibbleChar;
+    int digitsIndex = hasLeading0x ? 2 : 0;
+    int numDigits = hexDigits.length();
 
-    if (hasLeading0x) {
-        digitsIndex += 2;
+    if (digitsIndex < numDigits) {
+        (void) VHex::hexCharsToBytes(hexDigits.chars() + digitsIndex, numDigits - digitsIndex, buffer);
     }
+}
 
-    while (digitsIndex < numDigits) {
-        if (oddNumHexDigits) {
-            // First time through, use high nibble of 0, treat next digit as low nibble.
-            lowNibbleChar = hexDigits.charAt(digitsIndex++);
-            oddNumHexDigits = false; // done compensating for odd length, don't do again
-        } else {
-            highNibbleChar = hexDigits.charAt(digitsIndex++);
-            lowNibbleChar = hexDigits.charAt(digitsIndex++);
-        }
+// static
+void VHex::bytesToHexChars(const Vu8* bytes, Vs64 numBytes, char* hexChars) {
+    for (Vs64 i = 0; i < numBytes; ++i) {
+        const char* digits = &kHexDigitPairs[2 * bytes[i]];
+        hexChars[0] = digits[0];
+        hexChars[1] = digits[1];
+        hexChars += 2;
+    }
+}
+
+// static
+Vs64 VHex::hexCharsToBytes(const char* hexChars, Vs64 numHexChars, Vu8* bytes) {
+    Vu8* nextByte = bytes;
+
+    // An odd number of digits means the first one stands alone as a low nibble.
+    if ((numHexChars % 2) != 0) {
+        *nextByte++ = _hexDigitValue(*hexChars++);
+        --numHexChars;
+    }
 
-        buffer[bufferIndex++] = VHex::hexCharsToByte(highNibbleChar, lowNibbleChar);
+    for (; numHexChars > 0; numHexChars -= 2) {
+        *nextByte++ = static_cast<Vu8>((_hexDigitValue(hexChars[0]) << 4) | _hexDigitValue(hexChars[1]));
+        hexChars += 2;
     }
+
+    return nextByte - bytes;
 }
 
 // static
@@ -89,67 +146,47 @@ void VHex::hexToString(const VString& hexDigits, VString& text, bool hasLeading0
 
 // static
 void VHex::byteToHexString(Vu8 byteValue, VString& s) {
-    char hexChars[3];
-
-    hexChars[2] = 0;
-    VHex::byteToHexChars(byteValue, &hexChars[0], &hexChars[1]);
-
-    s = hexChars;
+    s.copyFromBuffer(&kHexDigitPairs[2 * byteValue], 0, 2);
 }
 
 // static
 void VHex::byteToHexChars(Vu8 byteValue, char* highNibbleChar, char* lowNibbleChar) {
-    *highNibbleChar = VHex::nibbleToHexChar(static_cast<Vu8>(byteValue >> 4));
-    *lowNibbleChar = VHex::nibbleToHexChar(static_cast<Vu8>(byteValue & 0x0F));
+    *highNibbleChar = kHexDigitPairs[2 * byteValue];
+    *lowNibbleChar = kHexDigitPairs[2 * byteValue + 1];
 }
 
 // static
 Vu8 VHex::hexStringToByte(const char* twoHexDigits) {
-    Vu8 highNibble = VHex::hexCharToNibble(twoHexDigits[0]);
-    Vu8 lowNibble = VHex::hexCharToNibble(twoHexDigits[1]);
-
-    return static_cast<Vu8>((highNibble << 4) | lowNibble);
+    return static_cast<Vu8>((_hexDigitValue(twoHexDigits[0]) << 4) | _hexDigitValue(twoHexDigits[1]));
 }
 
 // static
 Vu8 VHex::hexCharsToByte(char highNibbleChar, char lowNibbleChar) {
-    Vu8 highNibble = VHex::hexCharToNibble(highNibbleChar);
-    Vu8 lowNibble = VHex::hexCharToNibble(lowNibbleChar);
-
-    return static_cast<Vu8>((highNibble << 4) | lowNibble);
+    return static_cast<Vu8>((_hexDigitValue(highNibbleChar) << 4) | _hexDigitValue(lowNibbleChar));
 }
 
 // static
 char VHex::nibbleToHexChar(Vu8 nibbleValue) {
-    nibbleValue &= 0x0F;    // ensure that the high 4 bits are zero
-
-    if (nibbleValue < 0x0A)
-        return static_cast<char>('0' + nibbleValue);
-    else
-        return static_cast<char>('A' + (nibbleValue - 0x0A));
+    return kHexDigitPairs[2 * (nibbleValue & 0x0F) + 1]; // the low digit of 0x00 through 0x0F
 }
 
 // static
 Vu8 VHex::hexCharToNibble(char hexChar) {
-    if ((hexChar >= '0') && (hexChar <= '9'))
-        return static_cast<Vu8>(hexChar - '0');
-    else if ((hexChar >= 'A') && (hexChar <= 'F'))
-        return static_cast<Vu8>(0x0A + hexChar - 'A');
-    else if ((hexChar >= 'a') && (hexChar <= 'f'))
-        return static_cast<Vu8>(0x0A + hexChar - 'a');
-    else
-        return 0;
+    return _hexDigitValue(hexChar);
 }
 
 // static
 void VHex::bufferToPrintableASCIIString(const Vu8* buffer, Vs64 bufferLength, VString& s) {
+    int length = s.length();
+    int newLength = length + static_cast<int>(bufferLength);
+
+    s.preflight(newLength);
+    char* chars = s.buffer() + length;
     for (int i = 0; i < (int) bufferLength; ++i) {
-        char asciiValue = static_cast<char>(buffer[i]);
-        if ((asciiValue <= 0x20) || (asciiValue > 0x7E)) {
-            asciiValue = '.';
-        }
-        s += asciiValue;
+        chars[i] = _printableASCIIChar(buffer[i]);
     }
+
+    s.postflight(newLength);
 }
 
 // static
@@ -201,127 +238,154 @@ void VHex::readHexDump(VTextIOStream& inputStream, VBinaryIOStream& outputStream
     } while (line.isNotEmpty());
 }
 
+// The longest row label: "0x" plus 8 hex digits, or up to 19 decimal digits; then ": ".
+static const int kMaxRowLabelLength = 21;
+
+static char* _newRowBuffer(int numBytesPerRow, int indentCount) {
+    // Indent, label, 3 chars per byte of hex, 3 spaces, 1 char per byte of ASCII, and a line ending.
+    return new char[V_MAX(0, indentCount) + kMaxRowLabelLength + (4 * V_MAX(0, numBytesPerRow)) + 3 + 2];
+}
+
 VHex::VHex(VTextIOStream* outputStream, int numBytesPerRow, int indentCount, bool labelsInHex, bool showASCIIValues)
     : mOutputStream(outputStream)
+    , mOutputRawStream(NULL)
     , mNumBytesPerRow(numBytesPerRow)
     , mIndentCount(indentCount)
     , mLabelsInHex(labelsInHex)
     , mShowASCIIValues(showASCIIValues)
     , mStartColumn(0)
     , mOffset(0)
-    , mPendingBufferUsed(0)
-    , mPendingBuffer(NULL)
-    , mLineBuffer()
+    , mLineBuffer(NULL)
     {
-    mPendingBuffer = new Vu8[mNumBytesPerRow];
+    mLineBuffer = _newRowBuffer(mNumBytesPerRow, mIndentCount);
+}
+
+VHex::VHex(VStream& outputStream, int numBytesPerRow, int indentCount, bool labelsInHex, bool showASCIIValues)
+    : mOutputStream(NULL)
+    , mOutputRawStream(&outputStream)
+    , mNumBytesPerRow(numBytesPerRow)
+    , mIndentCount(indentCount)
+    , mLabelsInHex(labelsInHex)
+    , mShowASCIIValues(showASCIIValues)
+    , mStartColumn(0)
+    , mOffset(0)
+    , mLineBuffer(NULL)
+    {
+    mLineBuffer = _newRowBuffer(mNumBytesPerRow, mIndentCount);
 }
 
 VHex::~VHex() {
-    delete [] mPendingBuffer;
+    delete [] mLineBuffer;
     mOutputStream = NULL; // we don't own it, so don't delete it
+    mOutputRawStream = NULL; // we don't own it, so don't delete it
 }
 
 void VHex::printHex(const Vu8* buffer, Vs64 length, Vs64 offset) {
+    // Rows are printed straight from the caller's buffer. If the previous call ended
+    // mid-row, the first row picks up at that column.
+    const Vu8* bytes = buffer + offset;
+
     while (length > 0) {
-        if (mPendingBufferUsed == mNumBytesPerRow - mStartColumn) {
-            this->_printPending();
+        int numBytesInRow = static_cast<int>(V_MIN(length, static_cast<Vs64>(mNumBytesPerRow - mStartColumn)));
+        if (numBytesInRow <= 0) {
+            break; // a row width of zero can hold no bytes
         }
 
-        mPendingBuffer[mPendingBufferUsed++] = buffer[offset++];
-
-        --length;
+        this->_printRow(bytes, numBytesInRow);
+        bytes += numBytesInRow;
+        length -= numBytesInRow;
     }
-
-    this->flush();
 }
 
 void VHex::reset() {
-    this->_printPending();
-
     mStartColumn = 0;
     mOffset = 0;
 }
 
 void VHex::flush() {
-    this->_printPending();
 }
 
-void VHex::_printPending() {
-    if (mPendingBufferUsed > 0) {
-        char highNibbleChar;
-        char lowNibbleChar;
+void VHex::_printRow(const Vu8* bytes, int numBytes) {
+    char* p = mLineBuffer;
 
-        mLineBuffer = VString::EMPTY();
-
-        // Add spaces to indent.
-        for (int i = 0; i < mIndentCount; ++i) {
-            mLineBuffer += ' ';
-        }
-
-        // Add the label.
-        if (mLabelsInHex) {
-            VString label(VSTRING_ARGS("0x%08X: ", (int) mOffset));
-            mLineBuffer += label;
-        } else {
-            VString label(VSTRING_ARGS("%08lld: ", mOffset));
-            mLineBuffer += label;
-        }
+    // Add spaces to indent.
+    for (int i = 0; i < mIndentCount; ++i) {
+        *p++ = ' ';
+    }
 
-        // If we're starting mid-row, add spaces to indent.
-        for (int i = 0; i < mStartColumn; ++i) {
-            mLineBuffer += "   ";
+    // Add the label: 8 hex digits of the low 32 bits of the offset, or at least 8 decimal digits.
+    if (mLabelsInHex) {
+        Vu32 label = static_cast<Vu32>(mOffset);
+        *p++ = '0';
+        *p++ = 'x';
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            VHex::byteToHexChars(static_cast<Vu8>(label >> shift), p, p + 1);
+            p += 2;
         }
-
-        // Now append our hex data.
-        for (int i = 0; i < mPendingBufferUsed; ++i) {
-            VHex::byteToHexChars(mPendingBuffer[i], &highNibbleChar, &lowNibbleChar);
-            mLineBuffer += highNibbleChar;
-            mLineBuffer += lowNibbleChar;
-            mLineBuffer += ' ';
+    } else {
+        char digits[VNumberFormat::kMaxIntegerLength];
+        int numDigits = VNumberFormat::formatS64(mOffset, digits);
+        for (int i = numDigits; i < 8; ++i) {
+            *p++ = '0';
         }
 
-        // Now do the ASCII stuff if necessary.
-        if (mShowASCIIValues) {
-            // If we're starting mid-row, add spaces to indent.
-            for (int i = mPendingBufferUsed; i < mNumBytesPerRow - mStartColumn; ++i) {
-                mLineBuffer += "   ";
-            }
+        ::memcpy(p, digits, static_cast<VSizeType>(numDigits));
+        p += numDigits;
+    }
 
-            mLineBuffer += "   ";
+    *p++ = ':';
+    *p++ = ' ';
 
-            for (int i = 0; i < mStartColumn; ++i) {
-                mLineBuffer += ' ';
-            }
+    // If we're starting mid-row, add spaces to indent.
+    for (int i = 0; i < mStartColumn; ++i) {
+        *p++ = ' ';
+        *p++ = ' ';
+        *p++ = ' ';
+    }
 
-            // Append the ASCII data
-            for (int i = 0; i < mPendingBufferUsed; ++i) {
-                char    asciiValue = (char) mPendingBuffer[i];
+    // Now append our hex data.
+    for (int i = 0; i < numBytes; ++i) {
+        VHex::byteToHexChars(bytes[i], p, p + 1);
+        p[2] = ' ';
+        p += 3;
+    }
 
-                if ((asciiValue <= 0x20) || (asciiValue > 0x7E)) {
-                    asciiValue = '.';
-                }
+    // Now do the ASCII stuff if necessary.
+    if (mShowASCIIValues) {
+        // Pad out the rest of the row's hex columns, then the gap before the ASCII.
+        int numPaddingChars = (3 * (mNumBytesPerRow - mStartColumn - numBytes)) + 3 + mStartColumn;
+        ::memset(p, ' ', static_cast<VSizeType>(numPaddingChars));
+        p += numPaddingChars;
 
-                mLineBuffer += asciiValue;
-            }
-        }
-
-        // Keep track of column in case of split lines
-        if (mNumBytesPerRow == 0) {
-            mStartColumn = 0;
-        } else {
-            mStartColumn = (mStartColumn + mPendingBufferUsed) % mNumBytesPerRow;
+        // Append the ASCII data
+        for (int i = 0; i < numBytes; ++i) {
+            *p++ = _printableASCIIChar(bytes[i]);
         }
+    }
 
-        // Reset pending indicators
-        mOffset += mPendingBufferUsed;
-        mPendingBufferUsed = 0;
+    // Keep track of column in case of split lines
+    if (mNumBytesPerRow == 0) {
+        mStartColumn = 0;
+    } else {
+        mStartColumn = (mStartColumn + numBytes) % mNumBytesPerRow;
+    }
 
-        // Finally, shove the string out to the stream or output pipe.
-        if (mOutputStream == NULL) {
-            std::cout << mLineBuffer.chars() << std::endl;
-        } else {
-            mOutputStream->writeLine(mLineBuffer);
-        }
+    mOffset += numBytes;
+
+    // Finally, shove the row out to the stream or output pipe, with its line ending, in one write.
+    if (mOutputStream != NULL) {
+        int numLineEndingChars;
+        const Vu8* lineEndingChars = mOutputStream->getLineEndingChars(numLineEndingChars);
+        ::memcpy(p, lineEndingChars, static_cast<VSizeType>(numLineEndingChars));
+        p += numLineEndingChars;
+        (void) mOutputStream->write(reinterpret_cast<const Vu8*>(mLineBuffer), p - mLineBuffer);
+    } else if (mOutputRawStream != NULL) {
+        const VString& lineEnding = VString::NATIVE_LINE_ENDING();
+        ::memcpy(p, lineEnding.chars(), static_cast<VSizeType>(lineEnding.length()));
+        p += lineEnding.length();
+        (void) mOutputRawStream->write(reinterpret_cast<const Vu8*>(mLineBuffer), p - mLineBuffer);
+    } else {
+        std::cout.write(mLineBuffer, p - mLineBuffer);
+        std::cout << std::endl;
     }
 }
-
@@ -11,6 +11,7 @@ http://www.bombaydigital.com/
 
 #include "vstring.h"
 
+class VStream;
 class VTextIOStream;
 class VBinaryIOStream;
 
@@ -27,9 +28,17 @@ The static functions can be used standalone; they build up functionality
 to convert between buffer and hex string, using simpler functions to
 convert between shorter sequences of bytes and characters.
 
+The buffer conversions are table-driven: each byte is encoded by copying
+its two digits from a 256-entry table, and each pair of digits is decoded
+with two lookups, so converting a large buffer involves no per-byte
+branching or string appends. Use bytesToHexChars() and hexCharsToBytes()
+to convert between raw buffers without going through a VString at all.
+
 If you want a pretty hex dump, instantiate a VHex object with formatting
 parameters, and then call its printHex() method with the desired output
-object.
+object. Each row is formatted into a buffer allocated once by the
+constructor and written to the output with a single write, so dumping a
+large buffer does no per-row allocation.
 */
 class VHex {
     public:
@@ -49,6 +58,23 @@ class VHex {
         @param    hasLeading0x    true if the hexadecimal string starts with a leading "0x"
         */
         static void hexStringToBuffer(const VString& hexDigits, Vu8* buffer, bool hasLeading0x = false);
+        /**
+        Writes the uppercase hexadecimal digits for a buffer of bytes to a char buffer.
+        @param    bytes        the bytes to encode
+        @param    numBytes    the number of bytes to encode
+        @param    hexChars    the buffer to write to, at least 2 * numBytes chars; it is not null-terminated
+        */
+        static void bytesToHexChars(const Vu8* bytes, Vs64 numBytes, char* hexChars);
+        /**
+        Decodes hexadecimal digits (in either case) to a buffer of bytes. As with
+        hexStringToBuffer(), an odd number of digits is decoded as if it had a leading
+        zero, and a char that is not a hex digit is decoded as zero.
+        @param    hexChars        the hex digits to decode; they need not be null-terminated
+        @param    numHexChars        the number of hex digits
+        @param    bytes            the buffer to write to, at least (numHexChars + 1) / 2 bytes
+        @return the number of bytes written
+        */
+        static Vs64 hexCharsToBytes(const char* hexChars, Vs64 numHexChars, Vu8* bytes);
 
         /**
         Produces a hexadecimal string representation of the specified buffer data.
@@ -144,6 +170,16 @@ class VHex {
         */
         VHex(VTextIOStream* outputStream = NULL, int numBytesPerRow = 16, int indentCount = 2, bool labelsInHex = false, bool showASCIIValues = true);
         /**
+        Creates a hex dump object that writes to a raw stream, ending each row with
+        the platform's native line ending.
+        @param    outputStream    the stream to write to
+        @param    numBytesPerRow    the number of data bytes to display per row of text output
+        @param    indentCount        the number of spaces to lead each row with
+        @param    labelsInHex        true if the offset labels should be given in hex, false for decimal
+        @param    showASCIIValues    true if each byte's ASCII equivalent should be displayed
+        */
+        VHex(VStream& outputStream, int numBytesPerRow = 16, int indentCount = 2, bool labelsInHex = false, bool showASCIIValues = true);
+        /**
         Destructor.
         */
         virtual ~VHex();
@@ -160,7 +196,9 @@ class VHex {
         */
         void reset();
         /**
-        Flushes any unwritten output.
+        Flushes any unwritten output. Each call to printHex() writes all of its rows,
+        including a final partial row, so there is never anything left to flush; this
+        is retained for compatibility.
         */
         void flush();
 
@@ -170,20 +208,22 @@ class VHex {
         VHex& operator=(const VHex&); // not assignable
 
         /**
-        Prints the pending data to the output stream or stdout.
+        Formats one row of the dump into mLineBuffer and writes it to the output.
+        The row starts at mStartColumn, and mOffset and mStartColumn are advanced past it.
+        @param    bytes       the bytes to show in the row
+        @param    numBytes    the number of bytes, at most mNumBytesPerRow - mStartColumn
         */
-        void _printPending();
+        void _printRow(const Vu8* bytes, int numBytes);
 
-        VTextIOStream*  mOutputStream;      ///< The stream we write to, or NULL for stdout.
+        VTextIOStream*  mOutputStream;      ///< The text stream we write to, or NULL.
+        VStream*        mOutputRawStream;   ///< The raw stream we write to, or NULL. If both are NULL we write to stdout.
         int             mNumBytesPerRow;    ///< The number of bytes of binary data per output row.
         int             mIndentCount;       ///< The number of spaces to indent each row.
         bool            mLabelsInHex;       ///< True if the offset labels should be shown in hex.
         bool            mShowASCIIValues;   ///< True if the bytes' ASCII equivalents should be shown.
         int             mStartColumn;       ///< The start column of the current row.
         Vs64            mOffset;            ///< The current offset in the data being processed.
-        int             mPendingBufferUsed; ///< The amount of pending data we have accumulated w/o writing.
-        Vu8*            mPendingBuffer;     ///< The buffer holding the accumulated data not yet written.
-        VString         mLineBuffer;        ///< The temporary output buffer, allocated here so we don't do it for every line.
+        char*           mLineBuffer;        ///< The row output buffer, allocated here so we don't do it for every line; big enough for the longest row and its line ending.
 };
 
 #endif /* vhex_h */
@@ -9,19 +9,27 @@ License: MIT. See LICENSE.md in the Vault top level directory.
 
 #include "vlogger.h"
 
+#include "vbinarylog.h"
 #include "vthread.h"
 #include "vmutexlocker.h"
 #include "vsettings.h"
 #include "vbento.h"
 #include "vchar.h"
+#include "vsemaphore.h"
+#include "vshutdownregistry.h"
+
+#include <queue>
+#include <set>
 
 static const VNamedLoggerPtr NULL_NAMED_LOGGER_PTR;
 static const VLogAppenderPtr NULL_LOG_APPENDER_PTR;
 
-volatile int VLogger::gMaxActiveLevel = 0;
+std::atomic<int> VLogger::gMaxActiveLevel(0);
+std::atomic<int> VLogger::gDefaultLogLevel(0);
 VNamedLoggerPtr VLogger::gDefaultLogger = NULL_NAMED_LOGGER_PTR;
 VLogAppenderPtr VLogger::gDefaultAppender = NULL_LOG_APPENDER_PTR;
 VFSNode VLogger::gBaseLogDirectory(".");
+std::atomic<int> VLogger::gConfigurationGeneration(0);
 
 // VNamedLogger ---------------------------------------------------------------
 
@@ -33,7 +41,8 @@ VNamedLogger::VNamedLogger(const VString& name, int level, const VStringVector&
     , mAppenderNames(appenderNames)
     , mSpecificAppender(specificAppender)
     , mRepetitionFilter()
-    , mPrintStackConfig() {
+    , mPrintStackConfig()
+    , mRateLimiter() {
     if (appenderNames.empty() && (specificAppender == NULL_LOG_APPENDER_PTR)) {
         mAppenderNames.push_back(VString::EMPTY());
     }
@@ -56,7 +65,13 @@ void VNamedLogger::addAppender(const VString& appenderName) {
 }
 
 void VNamedLogger::log(int level, const char* file, int line, const VString& message, const VString& specifiedLoggerName) {
-    if (level > mLevel) {
+    if (!this->isEnabledFor(level)) {
+        return;
+    }
+
+    int numSuppressed = 0;
+    bool admitted = this->_admit(level, numSuppressed);
+    if (!admitted && (numSuppressed == 0)) {
         return;
     }
 
@@ -68,7 +83,11 @@ void VNamedLogger::log(int level, const char* file, int line, const VString& mes
     }
 
     VMutexLocker locker(&mAppendersMutex, "VNamedLogger::log");
-    if (mRepetitionFilter.checkMessage(*this, level, file, line, message, specifiedLoggerName, mName)) {
+    if (numSuppressed > 0) {
+        this->_emitToAppenders(level, file, line, true, VLoggerRateLimiter::formatSummary(numSuppressed), specifiedLoggerName, false, VString::EMPTY());
+    }
+
+    if (admitted && mRepetitionFilter.checkMessage(*this, level, file, line, message, specifiedLoggerName, mName)) {
         this->_emitToAppenders(level, file, line, true, message, specifiedLoggerName, false, VString::EMPTY());
         if (mPrintStackConfig.shouldPrintStack(level, *this)) {
             locker.unlock(); // avoid recursive deadlock, we're done with our data until we recur
@@ -79,7 +98,7 @@ void VNamedLogger::log(int level, const char* file, int line, const VString& mes
 
 void VNamedLogger::addInfo(VBentoNode& infoNode) const {
     infoNode.addString("name", mName);
-    infoNode.addInt("level", mLevel);
+    infoNode.addInt("level", this->getLevel());
 
     if (this->isDefaultLogger()) {
         infoNode.addBool("is-default-logger", true);
@@ -93,6 +112,13 @@ void VNamedLogger::addInfo(VBentoNode& infoNode) const {
 
     infoNode.addBool("repetition-filter-enabled", mRepetitionFilter.isEnabled());
     infoNode.addInt("print-stack-level", mPrintStackConfig.getLevel());
+
+    if (mRateLimiter.isEnabled()) {
+        infoNode.addInt("rate-limit", mRateLimiter.getMessagesPerSecond());
+        infoNode.addInt("rate-limit-burst", mRateLimiter.getBurst());
+        infoNode.addInt("sample-every", mRateLimiter.getSampleEvery());
+        infoNode.addString("rate-limit-level", VLoggerLevel::getName(mRateLimiter.getLevel()));
+    }
 }
 
 void VNamedLogger::log(int level, const VString& message) {
@@ -100,12 +126,24 @@ void VNamedLogger::log(int level, const VString& message) {
 }
 
 void VNamedLogger::logHexDump(int level, const VString& message, const VString& specifiedLoggerName, const Vu8* buffer, Vs64 length) {
-    if (level > mLevel) {
+    if (!this->isEnabledFor(level)) {
+        return;
+    }
+
+    int numSuppressed = 0;
+    bool admitted = this->_admit(level, numSuppressed);
+    if (!admitted && (numSuppressed == 0)) {
         return;
     }
 
     VNamedLogger::_breakpointLocationForLog();
 
+    if (!admitted) {
+        VMutexLocker locker(&mAppendersMutex, "VNamedLogger::logHexDump");
+        this->_emitToAppenders(level, NULL, 0, true, VLoggerRateLimiter::formatSummary(numSuppressed), specifiedLoggerName, false, VString::EMPTY());
+        return;
+    }
+
     // Try to be efficient here:
     // Form the hex dump only if the length is > 0.
     // But do it once ahead of time, then interate over the appenders, writing to each one.
@@ -113,24 +151,35 @@ void VNamedLogger::logHexDump(int level, const VString& message, const VString&
     VString hexString;
     if (length > 0) {
         VMemoryStream   tempBuffer;
-        VTextIOStream   stream(tempBuffer);
-        VHex            hex(&stream);
+        VHex            hex(tempBuffer);
         hex.printHex(buffer, length);
         hexString.copyFromBuffer((const char*)tempBuffer.getBuffer(), 0, (int) tempBuffer.getEOFOffset());
     }
 
     VMutexLocker locker(&mAppendersMutex, "VNamedLogger::logHexDump");
+    if (numSuppressed > 0) {
+        this->_emitToAppenders(level, NULL, 0, true, VLoggerRateLimiter::formatSummary(numSuppressed), specifiedLoggerName, false, VString::EMPTY());
+    }
+
     this->_emitToAppenders(level, NULL, 0, true, message, specifiedLoggerName, true, hexString);
 }
 
+void VNamedLogger::emitSuppressedSummary() {
+    int numSuppressed = mRateLimiter.takeSuppressed(true);
+    if (numSuppressed > 0) {
+        // Everything held back was at the rate limit's level or more detailed.
+        VMutexLocker locker(&mAppendersMutex, "VNamedLogger::emitSuppressedSummary");
+        this->_emitToAppenders(mRateLimiter.getLevel(), NULL, 0, true, VLoggerRateLimiter::formatSummary(numSuppressed), VString::EMPTY(), false, VString::EMPTY());
+    }
+}
+
 void VNamedLogger::emitStackCrawlLine(const VString& message) {
     VMutexLocker locker(&mAppendersMutex, "VNamedLogger::emitStackCrawlLine");
     this->_emitToAppenders(VLoggerLevel::TRACE /* not used for raw line emit */, NULL, 0, false, VString::EMPTY(), VString::EMPTY(), true, message);
 }
 
 void VNamedLogger::setLevel(int level) {
-    int oldLevel = mLevel;
-    mLevel = level;
+    int oldLevel = mLevel.exchange(level, std::memory_order_relaxed);
     VLogger::checkMaxActiveLogLevelForChangedLogger(oldLevel, level);
 }
 
@@ -151,8 +200,18 @@ void VNamedLogger::_emitToAppenders(int level, const char* file, int line, bool
     VLogger::emitToGlobalAppenders(level, file, line, emitMessage, message, specifiedLoggerName, mName, emitRawLine, rawLine);
 }
 
+bool VNamedLogger::_admit(int level, int& numSuppressed) {
+    if (mRateLimiter.appliesTo(level)) {
+        return mRateLimiter.admit(numSuppressed);
+    }
+
+    // A message that is not subject to the limits still reports a storm that has ended.
+    numSuppressed = mRateLimiter.isEnabled() ? mRateLimiter.takeSuppressed(false) : 0;
+    return true;
+}
+
 VString VNamedLogger::_toString() const {
-    VString s(VSTRING_ARGS("VNamedLogger '%s' (%d) ->", mName.chars(), mLevel));
+    VString s(VSTRING_ARGS("VNamedLogger '%s' (%d) ->", mName.chars(), this->getLevel()));
 
     VMutexLocker locker(&mAppendersMutex, "VNamedLogger::_toString");
     for (VStringVector::const_iterator i = mAppenderNames.begin(); i != mAppenderNames.end(); ++i) {
@@ -203,6 +262,28 @@ class VRollingFileLogAppenderFactory : public VLogAppenderFactory {
             { infoNode.addString("type", "VRollingFileLogAppenderFactory"); }
 };
 
+class VMappedFileLogAppenderFactory : public VLogAppenderFactory {
+    public:
+        VMappedFileLogAppenderFactory() : VLogAppenderFactory() {}
+        virtual ~VMappedFileLogAppenderFactory() {}
+
+        virtual VLogAppenderPtr instantiateLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults) const
+            { return VLogAppenderPtr(new VMappedFileLogAppender(settings, defaults)); }
+        virtual void addInfo(VBentoNode& infoNode) const
+            { infoNode.addString("type", "VMappedFileLogAppenderFactory"); }
+};
+
+class VBinaryLogAppenderFactory : public VLogAppenderFactory {
+    public:
+        VBinaryLogAppenderFactory() : VLogAppenderFactory() {}
+        virtual ~VBinaryLogAppenderFactory() {}
+
+        virtual VLogAppenderPtr instantiateLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults) const
+            { return VLogAppenderPtr(new VBinaryLogAppender(settings, defaults)); }
+        virtual void addInfo(VBentoNode& infoNode) const
+            { infoNode.addString("type", "VBinaryLogAppenderFactory"); }
+};
+
 class VSilentLogAppenderFactory : public VLogAppenderFactory {
     public:
         VSilentLogAppenderFactory() : VLogAppenderFactory() {}
@@ -236,6 +317,28 @@ class VStringVectorLogAppenderFactory : public VLogAppenderFactory {
             { infoNode.addString("type", "VStringVectorLogAppenderFactory"); }
 };
 
+class VCaptureLogAppenderFactory : public VLogAppenderFactory {
+    public:
+        VCaptureLogAppenderFactory() : VLogAppenderFactory() {}
+        virtual ~VCaptureLogAppenderFactory() {}
+
+        virtual VLogAppenderPtr instantiateLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults) const
+            { return VLogAppenderPtr(new VCaptureLogAppender(settings, defaults)); }
+        virtual void addInfo(VBentoNode& infoNode) const
+            { infoNode.addString("type", "VCaptureLogAppenderFactory"); }
+};
+
+class VAsyncLogAppenderFactory : public VLogAppenderFactory {
+    public:
+        VAsyncLogAppenderFactory() : VLogAppenderFactory() {}
+        virtual ~VAsyncLogAppenderFactory() {}
+
+        virtual VLogAppenderPtr instantiateLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults) const
+            { return VLogAppenderPtr(new VAsyncLogAppender(settings, defaults)); }
+        virtual void addInfo(VBentoNode& infoNode) const
+            { infoNode.addString("type", "VAsyncLogAppenderFactory"); }
+};
+
 // VLogger -------------------------------------------------------------------
 
 // This style of static mutex declaration and access ensures correct
@@ -253,6 +356,22 @@ static VNamedLoggerMap& _getLoggerMap() {
     return *gLoggerMap;
 };
 
+// Same loggers as _getLoggerMap(), keyed by name atom for lookups. Every registered name is interned,
+// along with its parent paths, so a name that is not interned cannot match any logger.
+typedef std::unordered_map<VStringAtom, VNamedLoggerPtr> VNamedLoggerAtomMap;
+static VNamedLoggerAtomMap& _getLoggerAtomMap() {
+    static VNamedLoggerAtomMap* gLoggerAtomMap = new VNamedLoggerAtomMap();
+    return *gLoggerAtomMap;
+}
+
+// Loggers that a VNamedLoggerCache has resolved to. A cache holds only a raw pointer, so these are kept
+// alive here, even after they leave the registry, until shutdown().
+typedef std::set<VNamedLoggerPtr> VNamedLoggerSet;
+static VNamedLoggerSet& _getCachedLoggers() {
+    static VNamedLoggerSet* gCachedLoggers = new VNamedLoggerSet();
+    return *gCachedLoggers;
+}
+
 typedef std::map<VString, VLogAppenderPtr> VLogAppendersMap;
 static VLogAppendersMap& _getAppendersMap() {
     static VLogAppendersMap* gAppendersMap = new VLogAppendersMap();
@@ -327,9 +446,11 @@ void VLogger::installNewLogAppender(const VSettingsNode& appenderSettings, const
     VMutexLocker locker(_mutexInstance(), "VLogger::installNewLogAppender");
     VLogAppenderFactoriesMap::const_iterator pos = _getAppenderFactoriesMap().find(appenderSettings.getString("kind"));
     if (pos != _getAppenderFactoriesMap().end()) {
-        VLogAppenderPtr appender = pos->second->instantiateLogAppender(appenderSettings, appenderDefaults);
-
+        // Instantiate without the lock held, because some appenders (such as "async") look up other appenders.
+        VLogAppenderFactoryPtr factory = pos->second;
         locker.unlock();
+
+        VLogAppenderPtr appender = factory->instantiateLogAppender(appenderSettings, appenderDefaults);
         VLogger::registerLogAppender(appender);
     }
 }
@@ -362,6 +483,15 @@ void VLogger::installNewNamedLogger(const VSettingsNode& loggerSettings) {
         logger->setPrintStackInfo(printStackLevel, maxNumOccurrences, timeLimit);
     }
 
+    int rateLimit = loggerSettings.getInt("rate-limit", 0);
+    int sampleEvery = loggerSettings.getInt("sample-every", 1);
+    if ((rateLimit > 0) || (sampleEvery > 1)) {
+        int rateLimitLevel = VLoggerLevel::fromString(loggerSettings.getString("rate-limit-level", "WARN"));
+        int burst = loggerSettings.getInt("rate-limit-burst", rateLimit);
+        VDuration summaryInterval = loggerSettings.getDuration("rate-limit-summary-interval", VDuration::SECOND() * 10);
+        logger->setRateLimitInfo(rateLimitLevel, rateLimit, burst, sampleEvery, summaryInterval);
+    }
+
     VMutexLocker locker(_mutexInstance(), "VLogger::installNewNamedLogger");
     VLogger::_registerLogger(logger, false);
 }
@@ -396,9 +526,13 @@ void VLogger::configure(const VFSNode& baseLogDirectory, const VSettingsNode& lo
     VLogger::registerLogAppenderFactory("cout", VLogAppenderFactoryPtr(new VCoutLogAppenderFactory()));
     VLogger::registerLogAppenderFactory("file", VLogAppenderFactoryPtr(new VFileLogAppenderFactory()));
     VLogger::registerLogAppenderFactory("rolling-file", VLogAppenderFactoryPtr(new VRollingFileLogAppenderFactory()));
+    VLogger::registerLogAppenderFactory("mapped-file", VLogAppenderFactoryPtr(new VMappedFileLogAppenderFactory()));
     VLogger::registerLogAppenderFactory("silent", VLogAppenderFactoryPtr(new VSilentLogAppenderFactory()));
     VLogger::registerLogAppenderFactory("string", VLogAppenderFactoryPtr(new VStringLogAppenderFactory()));
     VLogger::registerLogAppenderFactory("string-vector", VLogAppenderFactoryPtr(new VStringVectorLogAppenderFactory()));
+    VLogger::registerLogAppenderFactory("capture", VLogAppenderFactoryPtr(new VCaptureLogAppenderFactory()));
+    VLogger::registerLogAppenderFactory("async", VLogAppenderFactoryPtr(new VAsyncLogAppenderFactory()));
+    VLogger::registerLogAppenderFactory("binary", VLogAppenderFactoryPtr(new VBinaryLogAppenderFactory()));
 
     // Stash any per-appender defaults in a map while we configure, so we can pass them to the factories we call.
     std::map<VString, const VSettingsNode*> defaultsForAppenders;
@@ -431,14 +565,36 @@ void VLogger::configure(const VFSNode& baseLogDirectory, const VSettingsNode& lo
 void VLogger::shutdown() {
     VMutexLocker locker(_mutexInstance(), "VLogger::shutdown");
 
+    // Report what the loggers' rate limits are holding back while their appenders are still registered.
+    // The mutex is released meanwhile, because finding the appenders takes it.
+    VNamedLoggerMap loggers = _getLoggerMap();
+    locker.unlock();
+    for (VNamedLoggerMap::const_iterator i = loggers.begin(); i != loggers.end(); ++i) {
+        i->second->emitSuppressedSummary();
+    }
+
+    locker.lock();
+
     // Clear all shared_ptr references. This will allow all referenced objects to be deleted (unless someone outside retains a reference).
+    // The appenders are released after unlocking, because an appender that owns a thread (VAsyncLogAppender) waits for
+    // it to end when deleted, and the thread may log on its way out.
+    VLogAppenderPtr defaultAppender = gDefaultAppender;
+    VLogAppendersMap appenders;
+    appenders.swap(_getAppendersMap());
+    VNamedLoggerSet cachedLoggers; // advancing the generation below makes every call site resolve again before using its cache
+    cachedLoggers.swap(_getCachedLoggers());
+
     gDefaultLogger.reset();
     gDefaultAppender.reset();
     _getLoggerMap().clear();
-    _getAppendersMap().clear();
+    _getLoggerAtomMap().clear();
     _getAppenderFactoriesMap().clear();
 
-    gMaxActiveLevel = 0;
+    gMaxActiveLevel.store(0, std::memory_order_relaxed);
+    VLogger::_updateDefaultLogLevel();
+    ++gConfigurationGeneration;
+
+    locker.unlock();
 }
 
 // static
@@ -489,6 +645,8 @@ void VLogger::deregisterLogAppender(const VString& name) {
 
 // static
 void VLogger::deregisterLogger(VNamedLoggerPtr namedLogger) {
+    namedLogger->emitSuppressedSummary(); // before taking the mutex, which finding its appenders takes
+
     VMutexLocker locker(_mutexInstance(), "VLogger::deregisterLogger");
 
     if (gDefaultLogger == namedLogger) {
@@ -500,6 +658,12 @@ void VLogger::deregisterLogger(VNamedLoggerPtr namedLogger) {
         _getLoggerMap().erase(pos);
     }
 
+    VStringAtom nameAtom;
+    if (VStringAtom::find(namedLogger->getName(), nameAtom)) {
+        (void) _getLoggerAtomMap().erase(nameAtom);
+    }
+
+    ++gConfigurationGeneration;
     VLogger::_checkMaxActiveLogLevelForRemovedLogger(namedLogger->getLevel());
 }
 
@@ -511,17 +675,6 @@ void VLogger::deregisterLogger(const VString& name) {
     }
 }
 
-// static
-bool VLogger::isDefaultLogLevelActive(int level) {
-    return VLogger::isLogLevelActive(level) && VLogger::getDefaultLogger()->isEnabledFor(level);
-}
-
-// static
-bool VLogger::isLogLevelActive(int level) {
-    // No locking necessary to simply read this volatile value.
-    return (level <= gMaxActiveLevel);
-}
-
 // static
 VNamedLoggerPtr VLogger::getDefaultLogger() {
     VMutexLocker locker(_mutexInstance(), "VLogger::getDefaultLogger");
@@ -548,6 +701,8 @@ void VLogger::setDefaultLogger(VNamedLoggerPtr namedLogger) {
     VMutexLocker locker(_mutexInstance(), "VLogger::getDefaultLogger");
     VLogger::_reportLoggerChange(true, "setDefaultLogger", gDefaultLogger, namedLogger);
     gDefaultLogger = namedLogger;
+    VLogger::_updateDefaultLogLevel();
+    ++gConfigurationGeneration;
     VLogger::_reportLoggerChange(false, "setDefaultLogger", gDefaultLogger, namedLogger);
 }
 
@@ -585,6 +740,12 @@ VNamedLoggerPtr VLogger::findNamedLogger(const VString& name) {
     return VLogger::_findNamedLoggerFromPathName(name);
 }
 
+// static
+VNamedLoggerPtr VLogger::findNamedLogger(const VStringAtom& name) {
+    VMutexLocker locker(_mutexInstance(), "VLogger::findNamedLogger");
+    return VLogger::_findNamedLoggerFromPathAtom(name);
+}
+
 // static
 VNamedLoggerPtr VLogger::findNamedLoggerForLevel(const VString& name, int level) {
     // Fast as possible short-circuit: If no logger is enabled at the level (global int test), further searching is not necessary.
@@ -607,6 +768,28 @@ VNamedLoggerPtr VLogger::findNamedLoggerForLevel(const VString& name, int level)
     return logger;
 }
 
+// static
+VNamedLoggerPtr VLogger::findNamedLoggerForLevel(const VStringAtom& name, int level) {
+    // Fast as possible short-circuit: If no logger is enabled at the level (global int test), further searching is not necessary.
+    if (! VLogger::isLogLevelActive(level)) {
+        return NULL_NAMED_LOGGER_PTR;
+    }
+
+    VNamedLoggerPtr logger = VLogger::findNamedLogger(name);
+
+    // If found but level is too high, return null so it won't log.
+    if ((logger != nullptr) && (logger->getLevel() < level)) {
+        return NULL_NAMED_LOGGER_PTR;
+    }
+
+    // If not found, get the default logger with a level check (returns null if level is too high).
+    if (logger == nullptr) {
+        logger = VLogger::findDefaultLoggerForLevel(level);
+    }
+
+    return logger;
+}
+
 #ifdef VLOGGER_INTERNAL_DEBUGGING
 // static
 void VLogger::_reportAppenderChange(bool before, const VString& label, const VLogAppenderPtr& was, const VLogAppenderPtr& is) {
@@ -695,7 +878,7 @@ VBentoNode* VLogger::_commandGetInfo() {
     VBentoNode* appendersNode = rootNode->addNewChildNode("appenders");
     VBentoNode* loggersNode = rootNode->addNewChildNode("loggers");
 
-    rootNode->addInt("max-active-log-level", gMaxActiveLevel);
+    rootNode->addInt("max-active-log-level", gMaxActiveLevel.load(std::memory_order_relaxed));
 
     const VLogAppenderFactoriesMap& factories = _getAppenderFactoriesMap();
     for (VLogAppenderFactoriesMap::const_iterator i = factories.begin(); i != factories.end(); ++i) {
@@ -732,6 +915,17 @@ VString VLogger::_commandGetInfoString() {
     return s;
 }
 
+// static
+void VLogger::commandRollAppender(const VString& appenderName) {
+    VLogAppenderPtrList appenders = VLogger::getAllAppenders();
+    for (VLogAppenderPtrList::const_iterator i = appenders.begin(); i != appenders.end(); ++i) {
+        VRollingFileLogAppender* rollingAppender = dynamic_cast<VRollingFileLogAppender*>((*i).get());
+        if ((rollingAppender != NULL) && (appenderName.isEmpty() || (rollingAppender->getName() == appenderName))) {
+            rollingAppender->roll();
+        }
+    }
+}
+
 // static
 void VLogger::commandSetLogLevel(const VString& loggerName, int level) {
 
@@ -814,6 +1008,8 @@ void VLogger::_registerLogger(VNamedLoggerPtr namedLogger, bool asDefaultLogger)
     }
 
     _getLoggerMap()[namedLogger->getName()] = namedLogger;
+    _getLoggerAtomMap()[VStringAtom(namedLogger->getName())] = namedLogger;
+    ++gConfigurationGeneration;
 
     VLogger::_checkMaxActiveLogLevelForNewLogger(namedLogger->getLevel());
 
@@ -825,9 +1021,11 @@ void VLogger::_checkMaxActiveLogLevelForNewLogger(int newActiveLevel) {
     // ASSUMES CALLER HOLDS _mutexInstance().
 
     // If the logger has a higher level, then its level is the new max.
-    if (newActiveLevel > gMaxActiveLevel) {
-        gMaxActiveLevel = newActiveLevel;
+    if (newActiveLevel > gMaxActiveLevel.load(std::memory_order_relaxed)) {
+        gMaxActiveLevel.store(newActiveLevel, std::memory_order_relaxed);
     }
+
+    VLogger::_updateDefaultLogLevel();
 }
 
 // static
@@ -841,9 +1039,11 @@ void VLogger::_checkMaxActiveLogLevelForRemovedLogger(int removedActiveLevel) {
     // ASSUMES CALLER HOLDS _mutexInstance().
 
     // If the logger had the highest level, we need to search to find the new max.
-    if (removedActiveLevel >= gMaxActiveLevel) {
+    if (removedActiveLevel >= gMaxActiveLevel.load(std::memory_order_relaxed)) {
         VLogger::_recalculateMaxActiveLogLevel();
     }
+
+    VLogger::_updateDefaultLogLevel();
 }
 
 // static
@@ -858,11 +1058,14 @@ void VLogger::_checkMaxActiveLogLevelForChangedLogger(int oldActiveLevel, int ne
 
     // If the logger's new level is higher than current max, then its level is the new max.
     // Otherwise, if the old level was the max, and the new level is lower than it, we need to search to find the new max.
-    if (newActiveLevel > gMaxActiveLevel) {
-        gMaxActiveLevel = newActiveLevel;
-    } else if ((oldActiveLevel >= gMaxActiveLevel) && (newActiveLevel < gMaxActiveLevel)) {
+    int maxActiveLevel = gMaxActiveLevel.load(std::memory_order_relaxed);
+    if (newActiveLevel > maxActiveLevel) {
+        gMaxActiveLevel.store(newActiveLevel, std::memory_order_relaxed);
+    } else if ((oldActiveLevel >= maxActiveLevel) && (newActiveLevel < maxActiveLevel)) {
         VLogger::_recalculateMaxActiveLogLevel();
     }
+
+    VLogger::_updateDefaultLogLevel();
 }
 
 // static
@@ -875,33 +1078,230 @@ void VLogger::_recalculateMaxActiveLogLevel() {
         newMax = V_MAX(newMax, (*i).second->getLevel());
     }
 
-    gMaxActiveLevel = newMax;
+    gMaxActiveLevel.store(newMax, std::memory_order_relaxed);
 }
 
 // static
-VNamedLoggerPtr VLogger::_findNamedLoggerFromExactName(const VString& name) {
-    VNamedLoggerMap::const_iterator pos = _getLoggerMap().find(name);
-    if (pos == _getLoggerMap().end()) {
-        return NULL_NAMED_LOGGER_PTR;
-    }
+void VLogger::_updateDefaultLogLevel() {
+    // ASSUMES CALLER HOLDS _mutexInstance().
 
-    return pos->second;
+    // With no default logger, the VLOGGER macros will get one created at INFO level by getDefaultLogger().
+    int defaultLoggerLevel = (gDefaultLogger == nullptr) ? VLoggerLevel::INFO : gDefaultLogger->getLevel();
+    gDefaultLogLevel.store(V_MIN(defaultLoggerLevel, gMaxActiveLevel.load(std::memory_order_relaxed)), std::memory_order_relaxed);
 }
 
 // static
 VNamedLoggerPtr VLogger::_findNamedLoggerFromPathName(const VString& pathName) {
+    // Strip trailing path components until we reach an interned name; from there the atoms know their parent paths.
     VString nextNameToSearch(pathName);
+    VStringAtom nextAtomToSearch;
+    while (!VStringAtom::find(nextNameToSearch, nextAtomToSearch)) {
+        int lastDotIndex = nextNameToSearch.lastIndexOf('.');
+        if (lastDotIndex < 0) {
+            return NULL_NAMED_LOGGER_PTR;
+        }
+
+        nextNameToSearch.truncateLength(lastDotIndex);
+    }
+
+    return VLogger::_findNamedLoggerFromPathAtom(nextAtomToSearch);
+}
+
+// static
+int VLogger::_findNamedOrDefaultLogger(const VString& name, VNamedLogger*& logger) {
+    VMutexLocker locker(_mutexInstance(), "VLogger::_findNamedOrDefaultLogger");
+
+    VNamedLoggerPtr foundLogger = VLogger::_findNamedLoggerFromPathName(name);
+    if (foundLogger == nullptr) {
+        if (gDefaultLogger == nullptr) {
+            VLogger::_registerLogger(VNamedLoggerPtr(new VNamedLogger("default", VLoggerLevel::INFO, VStringVector())), true);
+        }
+
+        foundLogger = gDefaultLogger;
+    }
+
+    // The cache keeps only the raw pointer; keep the logger alive for it even if it is deregistered.
+    (void) _getCachedLoggers().insert(foundLogger);
+    logger = foundLogger.get();
+
+    // Changes are made with the mutex held, so this is the generation in which the result is correct.
+    return gConfigurationGeneration.load();
+}
+
+// static
+VNamedLoggerPtr VLogger::_findNamedLoggerFromPathAtom(const VStringAtom& pathName) {
+    const VNamedLoggerAtomMap& loggers = _getLoggerAtomMap();
+    VStringAtom nextAtomToSearch(pathName);
+    while (true) {
+        VNamedLoggerAtomMap::const_iterator pos = loggers.find(nextAtomToSearch);
+        if (pos != loggers.end()) {
+            return pos->second;
+        }
+
+        if (!nextAtomToSearch.hasPathParent()) {
+            return NULL_NAMED_LOGGER_PTR;
+        }
+
+        nextAtomToSearch = nextAtomToSearch.getPathParent();
+    }
+}
+
+// VThreadCache --------------------------------------------------------------
+
+static std::atomic<Vu64> gNextThreadCacheOwnerID(1); // 0 marks an unused entry
+
+/**
+A few values that a thread keeps for particular objects, such as the time stamp it last formatted
+with a VLogTimeStampFormatter, so that it can find them again without taking a lock. Declare one
+as a static thread_local. Each object is identified by a key derived from an ID it gets from
+newOwnerID() when constructed, rather than by its address, so that a new object at a destroyed
+one's address does not find the old one's entries; the entries of a destroyed object are simply
+never found again. When all the entries are in use, a new key replaces them in turn.
+*/
+template <typename VALUE, int NUM_ENTRIES>
+class VThreadCache {
+    public:
+
+        static Vu64 newOwnerID() { return gNextThreadCacheOwnerID++; } ///< Returns an ID that no other object has had. @return the ID, never 0
+
+        VThreadCache() : mNextEntryToReplace(0) { for (int i = 0; i < NUM_ENTRIES; ++i) { mKeys[i] = 0; } }
+        ~VThreadCache() {}
+
+        VALUE* find(Vu64 key) { for (int i = 0; i < NUM_ENTRIES; ++i) { if (mKeys[i] == key) { return &mValues[i]; } } return NULL; } ///< Returns the key's value, or NULL if it has none. @param key a non-zero key @return obvious
+        VALUE& add(Vu64 key) { int i = mNextEntryToReplace; mNextEntryToReplace = (i + 1) % NUM_ENTRIES; mKeys[i] = key; return mValues[i]; } ///< Gives the key an entry, replacing another key's; the caller sets its value, which is left as the other key had it. @param key a non-zero key not already present @return the value
+
+    private:
+
+        VThreadCache(const VThreadCache&); // not copyable
+        VThreadCache& operator=(const VThreadCache&); // not assignable
+
+        Vu64    mKeys[NUM_ENTRIES];     ///< The key of each entry; 0 if unused.
+        VALUE   mValues[NUM_ENTRIES];   ///< The value of each entry.
+        int     mNextEntryToReplace;    ///< The entry add() uses next.
+};
+
+// VLogTimeStampFormatter ----------------------------------------------------
+
+static const int kMaxNumMillisecondFields = 4;  // A specifier with more millisecond fields than this is formatted in full.
+static const int kNumTimeStampCacheEntries = 4; // The number of time stamps each thread keeps: enough for a few appenders, in local and UTC time.
+
+/**
+The time stamp a thread last formatted with one VLogTimeStampFormatter in one time zone.
+*/
+struct VLogTimeStampCacheEntry {
+    VLogTimeStampCacheEntry() : mSecond(0), mText() {}
+
+    Vs64    mSecond;                                        ///< The second (VInstant value / 1000) that mText was formatted for.
+    VString mText;                                          ///< The time stamp at the start of mSecond, with zeros in its millisecond fields.
+    int     mMillisecondOffsets[kMaxNumMillisecondFields];  ///< Where in mText each millisecond field starts.
+};
+
+VLogTimeStampFormatter::VLogTimeStampFormatter(const VString& formatSpecifier)
+    : mID(VThreadCache<VLogTimeStampCacheEntry, kNumTimeStampCacheEntries>::newOwnerID())
+    , mFormatter(formatSpecifier)
+    , mIsPatchable(false)
+    , mSegmentFormatters()
+    , mMillisecondWidths()
+    {
+    // Split the specifier around its runs of 'S'. In quoted text an 'S' is not a field, so we
+    // don't try to split a specifier that has any. A field of one or two 'S' is as wide as the
+    // number, so it cannot be patched in place.
+    if (formatSpecifier.contains('\'')) {
+        return;
+    }
+
+    VStringVector segments;
+    std::vector<int> millisecondWidths;
+    const char* chars = formatSpecifier.chars();
+    const int length = formatSpecifier.length();
+    int segmentStart = 0;
+    int i = 0;
+    while (i < length) {
+        if (chars[i] != 'S') {
+            ++i;
+            continue;
+        }
+
+        int fieldStart = i;
+        while ((i < length) && (chars[i] == 'S')) {
+            ++i;
+        }
+
+        if (((i - fieldStart) < 3) || (static_cast<int>(millisecondWidths.size()) == kMaxNumMillisecondFields)) {
+            return;
+        }
 
-    while (nextNameToSearch.contains('.')) {
-        VNamedLoggerPtr foundLogger = VLogger::_findNamedLoggerFromExactName(nextNameToSearch);
-        if (foundLogger != nullptr) {
-            return foundLogger;
+        VString segment;
+        formatSpecifier.getSubstring(segment, segmentStart, fieldStart);
+        segments.push_back(segment);
+        millisecondWidths.push_back(i - fieldStart);
+        segmentStart = i;
+    }
+
+    VString lastSegment;
+    formatSpecifier.getSubstring(lastSegment, segmentStart, length);
+    segments.push_back(lastSegment);
+
+    for (VStringVector::const_iterator segment = segments.begin(); segment != segments.end(); ++segment) {
+        mSegmentFormatters.push_back(VInstantFormatter(*segment));
+    }
+
+    mMillisecondWidths = millisecondWidths;
+    mIsPatchable = true;
+}
+
+VString VLogTimeStampFormatter::_format(const VInstant& when, bool isUTC) const {
+    // VInstantFormatter shows the milliseconds of a time before 1970 as a negative number; leave those to it.
+    if (!mIsPatchable || !when.isSpecific() || (when.getValue() < 0)) {
+        return isUTC ? when.getUTCString(mFormatter) : when.getLocalString(mFormatter);
+    }
+
+    static thread_local VThreadCache<VLogTimeStampCacheEntry, kNumTimeStampCacheEntries> cache;
+
+    const Vs64 second = when.getValue() / 1000;
+    const int millisecond = static_cast<int>(when.getValue() % 1000);
+
+    const Vu64 key = (mID << 1) | (isUTC ? 1 : 0);
+    VLogTimeStampCacheEntry* entry = cache.find(key);
+    if ((entry == NULL) || (entry->mSecond != second)) {
+        if (entry == NULL) {
+            entry = &cache.add(key);
+        }
+
+        // Format each segment at the start of the second, leaving zeros where the milliseconds go.
+        VInstant secondStart;
+        secondStart.setValue(second * 1000);
+        entry->mSecond = second;
+        entry->mText = VString::EMPTY();
+        for (VSizeType i = 0; i < mSegmentFormatters.size(); ++i) {
+            if (i > 0) {
+                entry->mMillisecondOffsets[i - 1] = entry->mText.length();
+                for (int digitIndex = 0; digitIndex < mMillisecondWidths[i - 1]; ++digitIndex) {
+                    entry->mText += '0';
+                }
+            }
+
+            if (mSegmentFormatters[i].getFormatSpecifier().isNotEmpty()) {
+                entry->mText += isUTC ? secondStart.getUTCString(mSegmentFormatters[i]) : secondStart.getLocalString(mSegmentFormatters[i]);
+            }
         }
+    }
 
-        nextNameToSearch.substringInPlace(0, nextNameToSearch.lastIndexOf('.'));
+    const int length = entry->mText.length();
+    VString timeStamp;
+    timeStamp.preflight(length);
+    char* buffer = timeStamp.buffer();
+    ::memcpy(buffer, entry->mText.chars(), static_cast<VSizeType>(length));
+    for (VSizeType i = 0; i < mMillisecondWidths.size(); ++i) {
+        int digits = millisecond;
+        for (int digitIndex = entry->mMillisecondOffsets[i] + mMillisecondWidths[i] - 1; digits != 0; --digitIndex) {
+            buffer[digitIndex] = static_cast<char>('0' + (digits % 10));
+            digits /= 10;
+        }
     }
 
-    return VLogger::_findNamedLoggerFromExactName(nextNameToSearch);
+    timeStamp.postflight(length);
+    return timeStamp;
 }
 
 // VLogAppender ------------------------------------------------------
@@ -916,6 +1316,7 @@ VLogAppender::VLogAppender(const VString& name, bool formatOutput, const VString
     , mFormatOutput(formatOutput)
     , mFormatSpec(formatSpec.isEmpty() ? DEFAULT_APPENDER_FORMAT_SPEC : formatSpec)
     , mTimeFormatter(timeFormat.isEmpty() ? DEFAULT_TIME_FORMAT : timeFormat)
+    , mTimeStampFormatter(mTimeFormatter.getFormatSpecifier())
     , mFormatUsesLocalTime(mFormatSpec.contains("$localtime"))
     , mFormatUsesUTCTime(mFormatSpec.contains("$utctime"))
     , mFormatUsesLevel(mFormatSpec.contains("$level"))
@@ -923,7 +1324,9 @@ VLogAppender::VLogAppender(const VString& name, bool formatOutput, const VString
     , mFormatUsesLocation(mFormatSpec.contains("$location"))
     , mFormatUsesSpecifiedLoggerName(mFormatSpec.contains("$specifiedlogger"))
     , mFormatUsesActualLoggerName(mFormatSpec.contains("$actuallogger"))
+    , mFormatTokens()
     {
+    this->_compileFormatSpec();
 }
 
 VLogAppender::VLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults)
@@ -932,6 +1335,7 @@ VLogAppender::VLogAppender(const VSettingsNode& settings, const VSettingsNode& d
     , mFormatOutput(VLogAppender::_getBooleanInitSetting("format-output", settings, defaults, DO_FORMAT_OUTPUT))
     , mFormatSpec(VLogAppender::_getStringInitSetting("format-spec", settings, defaults, DEFAULT_APPENDER_FORMAT_SPEC))
     , mTimeFormatter(VLogAppender::_getStringInitSetting("time-format", settings, defaults, DEFAULT_TIME_FORMAT))
+    , mTimeStampFormatter(mTimeFormatter.getFormatSpecifier())
     , mFormatUsesLocalTime(mFormatSpec.contains("$localtime"))
     , mFormatUsesUTCTime(mFormatSpec.contains("$utctime"))
     , mFormatUsesLevel(mFormatSpec.contains("$level"))
@@ -939,7 +1343,9 @@ VLogAppender::VLogAppender(const VSettingsNode& settings, const VSettingsNode& d
     , mFormatUsesLocation(mFormatSpec.contains("$location"))
     , mFormatUsesSpecifiedLoggerName(mFormatSpec.contains("$specifiedlogger"))
     , mFormatUsesActualLoggerName(mFormatSpec.contains("$actuallogger"))
+    , mFormatTokens()
     {
+    this->_compileFormatSpec();
 }
 
 VLogAppender::~VLogAppender() {
@@ -992,6 +1398,16 @@ int VLogAppender::_getIntInitSetting(const VString& attributePath, const VSettin
     return settings.getInt(attributePath, defaults.getInt(attributePath, defaultValue));
 }
 
+// static
+VDuration VLogAppender::_getDurationInitSetting(const VString& attributePath, const VSettingsNode& settings, const VSettingsNode& defaults, const VDuration& defaultValue) {
+    return settings.getDuration(attributePath, defaults.getDuration(attributePath, defaultValue));
+}
+
+// static
+Vs64 VLogAppender::_getS64InitSetting(const VString& attributePath, const VSettingsNode& settings, const VSettingsNode& defaults, Vs64 defaultValue) {
+    return settings.getS64(attributePath, defaults.getS64(attributePath, defaultValue));
+}
+
 // static
 VString VLogAppender::_getStringInitSetting(const VString& attributePath, const VSettingsNode& settings, const VSettingsNode& defaults, const VString& defaultValue) {
     return settings.getString(attributePath, defaults.getString(attributePath, defaultValue));
@@ -1006,6 +1422,12 @@ void VLogAppender::_emitMessage(int level, const char* file, int line, const VSt
     }
 }
 
+void VLogAppender::_emitRawLines(const VStringVector& lines) {
+    for (VStringVector::const_iterator i = lines.begin(); i != lines.end(); ++i) {
+        this->_emitRawLine(*i);
+    }
+}
+
 VString VLogAppender::_formatMessage(int level, const char* file, int line, const VString& message, const VString& specifiedLoggerName, const VString& actualLoggerName) {
     VInstant now;
     VInstant trueNow(now); // copy constructor avoids another call to read the clock
@@ -1016,61 +1438,144 @@ VString VLogAppender::_formatMessage(int level, const char* file, int line, cons
         trueNow.setTrueNow();
     }
 
-    VString formattedMessage = mFormatSpec;
-    
-    // I am do replacement in this order (mainly with $message last) to be sure that
-    // none of the replacements put a $ specifier into the string.
+    // Work out the text of each variable the spec uses, once, however many times it appears.
+    const VString* values[kNumFormatTokenKinds];
+    for (int i = 0; i < kNumFormatTokenKinds; ++i) {
+        values[i] = &VString::EMPTY();
+    }
+
+    VString localTimeStampString;
     if (mFormatUsesLocalTime) {
-        VString localTimeStampString;
         if (prependTrueTime) {
             localTimeStampString = trueNow.getLocalString(mTimeFormatter) + " ";
         }
 
-        localTimeStampString += now.getLocalString(mTimeFormatter);
-        formattedMessage.replace("$localtime", localTimeStampString);
+        localTimeStampString += mTimeStampFormatter.formatLocalString(now);
+        values[kFormatLocalTime] = &localTimeStampString;
     }
 
+    VString utcTimeStampString;
     if (mFormatUsesUTCTime) {
-        VString utcTimeStampString;
         if (prependTrueTime) {
             utcTimeStampString = trueNow.getUTCString(mTimeFormatter) + " ";
         }
-        utcTimeStampString += now.getUTCString(mTimeFormatter);
-        formattedMessage.replace("$utctime", utcTimeStampString);
+
+        utcTimeStampString += mTimeStampFormatter.formatUTCString(now);
+        values[kFormatUTCTime] = &utcTimeStampString;
     }
 
+    VString levelName;
     if (mFormatUsesLevel) {
-        formattedMessage.replace("$level", VLoggerLevel::getName(level));
+        levelName = VLoggerLevel::getName(level);
+        values[kFormatLevel] = &levelName;
     }
 
-    if (mFormatUsesLocation) {
-        if (file == NULL) {
-            formattedMessage.replace("$location", VString::EMPTY());
-        } else {
-            formattedMessage.replace("$location", VSTRING_FORMAT("@ %s:%d: ", file, line));
-        }
+    VString location;
+    if (mFormatUsesLocation && (file != NULL)) {
+        location = VSTRING_FORMAT("@ %s:%d: ", file, line);
+        values[kFormatLocation] = &location;
     }
 
+    static const VString THREAD_VARIABLE("$thread");
+    VString threadName;
     if (mFormatUsesThread) {
+        values[kFormatThread] = &THREAD_VARIABLE; // if the name cannot be had, the variable is left as is
         try {
-            formattedMessage.replace("$thread", VThread::getCurrentThreadName());
+            threadName = VThread::getCurrentThreadName();
+            values[kFormatThread] = &threadName;
         } catch (...) {
         }
     }
 
-    if (mFormatUsesSpecifiedLoggerName) {
-        formattedMessage.replace("$specifiedlogger", specifiedLoggerName);
+    values[kFormatSpecifiedLoggerName] = &specifiedLoggerName;
+    values[kFormatActualLoggerName] = &actualLoggerName;
+    values[kFormatMessage] = &message;
+
+    // Size the result exactly, then copy each piece into place in order.
+    int formattedLength = 0;
+    for (FormatTokenList::const_iterator i = mFormatTokens.begin(); i != mFormatTokens.end(); ++i) {
+        formattedLength += (i->mKind == kFormatLiteral) ? i->mText.length() : values[i->mKind]->length();
     }
 
-    if (mFormatUsesActualLoggerName) {
-        formattedMessage.replace("$actuallogger", actualLoggerName);
+    VString formattedMessage;
+    if (formattedLength == 0) {
+        return formattedMessage;
     }
 
-    formattedMessage.replace("$message", message);
+    formattedMessage.preflight(formattedLength);
+    char* buffer = formattedMessage.buffer();
+    int offset = 0;
+    for (FormatTokenList::const_iterator i = mFormatTokens.begin(); i != mFormatTokens.end(); ++i) {
+        const VString& piece = (i->mKind == kFormatLiteral) ? i->mText : *values[i->mKind];
+        ::memcpy(buffer + offset, piece.chars(), static_cast<VSizeType>(piece.length()));
+        offset += piece.length();
+    }
 
+    formattedMessage.postflight(formattedLength);
     return formattedMessage;
 }
 
+void VLogAppender::_compileFormatSpec() {
+    static const struct {
+        const char*     mName;
+        FormatTokenKind mKind;
+    } VARIABLES[] = {
+        { "$localtime",         kFormatLocalTime },
+        { "$utctime",           kFormatUTCTime },
+        { "$level",             kFormatLevel },
+        { "$thread",            kFormatThread },
+        { "$location",          kFormatLocation },
+        { "$specifiedlogger",   kFormatSpecifiedLoggerName },
+        { "$actuallogger",      kFormatActualLoggerName },
+        { "$message",           kFormatMessage }
+    };
+    const int kNumVariables = static_cast<int>(sizeof(VARIABLES) / sizeof(VARIABLES[0]));
+
+    mFormatTokens.clear();
+
+    const char* spec = mFormatSpec.chars();
+    const int specLength = mFormatSpec.length();
+    int literalStart = 0;
+    int i = 0;
+    while (i < specLength) {
+        int variableIndex = -1;
+        if (spec[i] == '$') {
+            for (int v = 0; v < kNumVariables; ++v) {
+                if (::strncmp(spec + i, VARIABLES[v].mName, ::strlen(VARIABLES[v].mName)) == 0) {
+                    variableIndex = v;
+                    break;
+                }
+            }
+        }
+
+        if (variableIndex < 0) {
+            ++i; // literal text, including a '$' that does not start a variable
+            continue;
+        }
+
+        FormatToken token;
+        if (i > literalStart) {
+            token.mKind = kFormatLiteral;
+            mFormatSpec.getSubstring(token.mText, literalStart, i);
+            mFormatTokens.push_back(token);
+        }
+
+        token.mKind = VARIABLES[variableIndex].mKind;
+        token.mText = VString::EMPTY();
+        mFormatTokens.push_back(token);
+
+        i += static_cast<int>(::strlen(VARIABLES[variableIndex].mName));
+        literalStart = i;
+    }
+
+    if (specLength > literalStart) {
+        FormatToken token;
+        token.mKind = kFormatLiteral;
+        mFormatSpec.getSubstring(token.mText, literalStart, specLength);
+        mFormatTokens.push_back(token);
+    }
+}
+
 VString VLogAppender::_toString() const {
     return VSTRING_FORMAT("VLogAppender '%s'", mName.chars());
 }
@@ -1151,50 +1656,625 @@ void VFileLogAppender::_emitRawLine(const VString& line) {
     mOutputStream.flush();
 }
 
+void VFileLogAppender::_emitRawLines(const VStringVector& lines) {
+    for (VStringVector::const_iterator i = lines.begin(); i != lines.end(); ++i) {
+        mOutputStream.writeLine(*i);
+    }
+
+    mOutputStream.flush();
+}
+
+// VLogAppenderWorkerThread --------------------------------------------------
+
+/**
+The background thread owned by an appender that has work to do off the logging path
+(VAsyncLogAppender, VRollingFileLogAppender, VMappedFileLogAppender). Its run() calls the
+appender's _runWorker(), which loops, sleeping in waitForWake() between rounds of work, until
+the appender's stop flag is set; stopAndJoin() sets it and waits for the thread to end.
+*/
+template <class APPENDER>
+class VLogAppenderWorkerThread : public VThread {
+    public:
+        VLogAppenderWorkerThread(const VString& name, APPENDER& appender)
+            : VThread(name, "vault.logger.VLogAppenderWorkerThread", kDontDeleteSelfAtEnd, kCreateThreadJoinable, NULL)
+            , mAppender(appender)
+            , mWakeMutex(name, true/*this mutex itself must not log*/)
+            , mWakeSemaphore()
+            , mWakePending(false)
+            {}
+        virtual ~VLogAppenderWorkerThread() {}
+
+        virtual void run() { mAppender._runWorker(); }
+
+        /**
+        Creates and starts the thread for an appender, named after the appender.
+        @param  appenderClassName   the appender's class name, for the thread name
+        @param  appender            the appender
+        @return the running thread, which the appender deletes after stopAndJoin()
+        */
+        static VLogAppenderWorkerThread* startFor(const char* appenderClassName, APPENDER& appender) {
+            VLogAppenderWorkerThread* thread = new VLogAppenderWorkerThread(VSTRING_FORMAT("%s(%s)", appenderClassName, appender.getName().chars()), appender);
+            thread->start();
+            return thread;
+        }
+
+        /**
+        Sets the appender's stop flag, which _runWorker() checks each time it wakes, wakes the thread,
+        and waits for it to end. VThread::stop() is not used, because VThread::join() does not wait for
+        a stopped thread.
+        @param  isStopped   the appender's stop flag
+        @return false if the flag was already set, in which case this does nothing
+        */
+        bool stopAndJoin(std::atomic<bool>& isStopped) {
+            if (isStopped.exchange(true)) {
+                return false;
+            }
+
+            this->wake();
+            (void) this->join();
+            return true;
+        }
+
+        void wake() { VMutexLocker locker(&mWakeMutex, "VLogAppenderWorkerThread::wake"); mWakePending = true; mWakeSemaphore.signal(); } ///< Ends a waitForWake() in progress, or the next one if none is in progress.
+        void waitForWake(const VDuration& timeout) { VMutexLocker locker(&mWakeMutex, "VLogAppenderWorkerThread::waitForWake"); if (!mWakePending) { mWakeSemaphore.wait(&mWakeMutex, timeout); } mWakePending = false; } ///< Sleeps until woken or timed out.
+
+    private:
+        APPENDER&   mAppender;      ///< The appender whose work we do.
+        VMutex      mWakeMutex;     ///< Used with mWakeSemaphore.
+        VSemaphore  mWakeSemaphore; ///< Signaled to wake us.
+        bool        mWakePending;   ///< True if wake() was called since the last waitForWake() returned; guarded by mWakeMutex.
+};
+
 // VRollingFileLogAppender ---------------------------------------------------
 
-VRollingFileLogAppender::VRollingFileLogAppender(const VString& name, bool formatOutput, const VString& formatSpec, const VString& timeFormat, const VString& /*dirPath*/, const VString& /*fileNamePrefix*/, int /*maxNumLines*/)
+/**
+One of a VRollingFileLogAppender's files, opened for writing.
+*/
+struct VRollingLogFile {
+    VRollingLogFile(const VFSNode& node, int sequence) : mFileStream(node), mOutputStream(mFileStream), mSequence(sequence) {}
+
+    VBufferedFileStream mFileStream;    ///< The underlying file stream.
+    VTextIOStream       mOutputStream;  ///< The text stream we write to.
+    int                 mSequence;      ///< The sequence number in the file name.
+};
+
+VRollingFileLogAppender::VRollingFileLogAppender(const VString& name, bool formatOutput, const VString& formatSpec, const VString& timeFormat, const VString& dirPath, const VString& fileNamePrefix, Vs64 maxFileSize, const VDuration& rollInterval, int maxNumArchives)
     : VLogAppender(name, formatOutput, formatSpec, timeFormat)
+    , mDirectory(dirPath)
+    , mFileNamePrefix(fileNamePrefix)
+    , mMaxFileSize(maxFileSize)
+    , mRollInterval(rollInterval)
+    , mMaxNumArchives(maxNumArchives)
+    , mLineEndingLength(0)
+    , mCurrentFile(NULL)
+    , mCurrentFileSize(0)
+    , mRollTime()
+    , mCurrentSequence(0)
+    , mHousekeepingMutex(VSTRING_FORMAT("VRollingFileLogAppender(%s)", name.chars()), true/*this mutex itself must not log*/)
+    , mNextFile(NULL)
+    , mNextSequence(0)
+    , mRetiredFiles()
+    , mIsStopped(false)
+    , mWorkerThread(NULL)
     {
+    this->_init();
 }
 
 VRollingFileLogAppender::VRollingFileLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults)
     : VLogAppender(settings, defaults)
+    , mDirectory(_getStringInitSetting("dir", settings, defaults, VLogger::getBaseLogDirectory().getPath()))
+    , mFileNamePrefix(_getStringInitSetting("prefix", settings, defaults, settings.getString("name")))
+    , mMaxFileSize(_getS64InitSetting("max-size", settings, defaults, kDefaultMaxFileSize))
+    , mRollInterval(_getDurationInitSetting("roll-interval", settings, defaults, VDuration::POSITIVE_INFINITY()))
+    , mMaxNumArchives(_getIntInitSetting("max-archives", settings, defaults, kDefaultMaxNumArchives))
+    , mLineEndingLength(0)
+    , mCurrentFile(NULL)
+    , mCurrentFileSize(0)
+    , mRollTime()
+    , mCurrentSequence(0)
+    , mHousekeepingMutex(VSTRING_FORMAT("VRollingFileLogAppender(%s)", mName.chars()), true/*this mutex itself must not log*/)
+    , mNextFile(NULL)
+    , mNextSequence(0)
+    , mRetiredFiles()
+    , mIsStopped(false)
+    , mWorkerThread(NULL)
     {
-    /* todo: use these settings properties to construct, something like:
-        mDirPath = VLogAppender::_getStringInitSetting("dir", settings, defaults, VLogger::getBaseLogDirectory().getPath());
-        mPrefix = VLogAppender::_getStringInitSetting("prefix", settings, defaults, settings.getString("name"));
-        mMaxLines = VLogAppender::_getIntInitSetting("max-lines", settings, defaults, 10000);
-    */
+    this->_init();
+}
+
+void VRollingFileLogAppender::_init() {
+    (void) vault::VgetNativeLineEnding(mLineEndingLength);
+
+    // Continue numbering after the highest-numbered file already present.
+    mDirectory.mkdirs();
+    VStringVector fileNames;
+    mDirectory.list(fileNames);
+    for (VStringVector::const_iterator i = fileNames.begin(); i != fileNames.end(); ++i) {
+        int sequence;
+        if (this->_parseSequence(*i, sequence)) {
+            mNextSequence = V_MAX(mNextSequence, sequence);
+        }
+    }
+
+    ++mNextSequence;
+    mCurrentFile = this->_openLogFile(mNextSequence++);
+    mCurrentSequence = mCurrentFile->mSequence;
+    if (mRollInterval != VDuration::POSITIVE_INFINITY()) {
+        mRollTime += mRollInterval;
+    }
+
+    mWorkerThread = VLogAppenderWorkerThread<VRollingFileLogAppender>::startFor("VRollingFileLogAppender", *this);
+}
+
+VRollingFileLogAppender::~VRollingFileLogAppender() {
+    (void) mWorkerThread->stopAndJoin(mIsStopped);
+    delete mWorkerThread;
+
+    for (std::vector<VRollingLogFile*>::const_iterator i = mRetiredFiles.begin(); i != mRetiredFiles.end(); ++i) {
+        delete *i;
+    }
+
+    if (mNextFile != NULL) {
+        _removeUnusedLogFile(mNextFile);
+    }
+
+    delete mCurrentFile;
 }
 
 void VRollingFileLogAppender::addInfo(VBentoNode& infoNode) const {
     VLogAppender::addInfo(infoNode);
     infoNode.addString("type", "VRollingFileLogAppender");
-    // TODO: current file etc.
+    infoNode.addString("dir", mDirectory.getPath());
+    infoNode.addString("prefix", mFileNamePrefix);
+    infoNode.addS64("max-size", mMaxFileSize);
+    infoNode.addDuration("roll-interval", mRollInterval);
+    infoNode.addInt("max-archives", mMaxNumArchives);
+    infoNode.addString("file", this->getCurrentFileNode().getPath());
 }
 
-void VRollingFileLogAppender::_emitRawLine(const VString& /*line*/) {
-    // TODO!
+void VRollingFileLogAppender::roll() {
+    VMutexLocker locker(&mMutex, "VRollingFileLogAppender::roll");
+    this->_roll();
 }
 
-// VSilentLogAppender ----------------------------------------------------------
+VFSNode VRollingFileLogAppender::getCurrentFileNode() const {
+    VMutexLocker locker(const_cast<VMutex*>(&mMutex), "VRollingFileLogAppender::getCurrentFileNode");
+    return mCurrentFile->mFileStream.getNode();
+}
 
-void VSilentLogAppender::addInfo(VBentoNode& infoNode) const {
-    VLogAppender::addInfo(infoNode);
-    infoNode.addString("type", "VSilentLogAppender");
+void VRollingFileLogAppender::_emitRawLine(const VString& line) {
+    this->_writeLine(line);
+    mCurrentFile->mOutputStream.flush();
 }
 
-// VStringLogAppender ----------------------------------------------------------
+void VRollingFileLogAppender::_emitRawLines(const VStringVector& lines) {
+    for (VStringVector::const_iterator i = lines.begin(); i != lines.end(); ++i) {
+        this->_writeLine(*i);
+    }
 
-VStringLogAppender::VStringLogAppender(const VString& name, bool formatOutput, const VString& formatSpec, const VString& timeFormat)
-    : VLogAppender(name, formatOutput, formatSpec, timeFormat)
-    , mLines()
-    {
+    mCurrentFile->mOutputStream.flush();
 }
 
-VStringLogAppender::VStringLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults)
+void VRollingFileLogAppender::_writeLine(const VString& line) {
+    Vs64 lineSize = line.length() + mLineEndingLength;
+    bool fileIsFull = (mMaxFileSize > 0) && (mCurrentFileSize > 0) && (mCurrentFileSize + lineSize > mMaxFileSize);
+    bool fileIsOld = (mRollInterval != VDuration::POSITIVE_INFINITY()) && (VInstant() >= mRollTime);
+    if (fileIsFull || fileIsOld) {
+        this->_roll();
+    }
+
+    mCurrentFile->mOutputStream.writeLine(line);
+    mCurrentFileSize += lineSize;
+}
+
+void VRollingFileLogAppender::_roll() {
+    mCurrentFile->mOutputStream.flush();
+
+    VRollingLogFile* nextFile;
+    /* locker scope */ {
+        VMutexLocker locker(&mHousekeepingMutex, "VRollingFileLogAppender::_roll");
+        nextFile = mNextFile;
+        mNextFile = NULL;
+        if (nextFile == NULL) {
+            nextFile = this->_openLogFile(mNextSequence++); // The helper thread has not prepared one yet.
+        }
+
+        // Switch the sequence before the helper thread can see the retired file, so that it counts that file as an archive.
+        mRetiredFiles.push_back(mCurrentFile);
+        mCurrentSequence = nextFile->mSequence;
+    }
+
+    mCurrentFile = nextFile;
+    mCurrentFileSize = 0;
+    if (mRollInterval != VDuration::POSITIVE_INFINITY()) {
+        mRollTime = VInstant() + mRollInterval;
+    }
+
+    mWorkerThread->wake();
+}
+
+VRollingLogFile* VRollingFileLogAppender::_openLogFile(int sequence) const {
+    VRollingLogFile* file = new VRollingLogFile(VFSNode(mDirectory, VSTRING_FORMAT("%s.%06d.log", mFileNamePrefix.chars(), sequence)), sequence);
+
+    try {
+        file->mFileStream.openWrite();
+    } catch (...) {
+        delete file;
+        throw;
+    }
+
+    return file;
+}
+
+// static
+void VRollingFileLogAppender::_removeUnusedLogFile(VRollingLogFile* file) {
+    // The file was never written to, so remove it rather than leave an empty file behind.
+    VFSNode node = file->mFileStream.getNode();
+    delete file;
+    (void) node.rm();
+}
+
+void VRollingFileLogAppender::_deleteOldFiles() const {
+    if (mMaxNumArchives < 0) {
+        return;
+    }
+
+    // The earlier files are those numbered below the current file; the prepared next file is numbered above it.
+    int currentSequence = mCurrentSequence.load();
+    std::vector<int> earlierSequences;
+    VStringVector fileNames;
+    mDirectory.list(fileNames);
+    for (VStringVector::const_iterator i = fileNames.begin(); i != fileNames.end(); ++i) {
+        int sequence;
+        if (this->_parseSequence(*i, sequence) && (sequence < currentSequence)) {
+            earlierSequences.push_back(sequence);
+        }
+    }
+
+    std::sort(earlierSequences.begin(), earlierSequences.end());
+    const int numToDelete = static_cast<int>(earlierSequences.size()) - mMaxNumArchives;
+    for (int i = 0; i < numToDelete; ++i) {
+        VFSNode oldFile(mDirectory, VSTRING_FORMAT("%s.%06d.log", mFileNamePrefix.chars(), earlierSequences[i]));
+        (void) oldFile.rm();
+    }
+}
+
+bool VRollingFileLogAppender::_parseSequence(const VString& fileName, int& sequence) const {
+    // Match "<prefix>.<digits>.log".
+    const int digitsStart = mFileNamePrefix.length() + 1;
+    const int digitsEnd = fileName.length() - 4;
+    const char* chars = fileName.chars();
+    if ((digitsEnd <= digitsStart) || !fileName.startsWith(mFileNamePrefix) || (chars[digitsStart - 1] != '.') || !fileName.endsWith(".log")) {
+        return false;
+    }
+
+    int value = 0;
+    for (int i = digitsStart; i < digitsEnd; ++i) {
+        if ((chars[i] < '0') || (chars[i] > '9') || (value > (V_MAX_S32 - 9) / 10)) {
+            return false;
+        }
+
+        value = (value * 10) + (chars[i] - '0');
+    }
+
+    sequence = value;
+    return true;
+}
+
+void VRollingFileLogAppender::_runWorker() {
+    bool isFirstPass = true;
+    while (!mIsStopped.load()) {
+        std::vector<VRollingLogFile*> retiredFiles;
+        int nextSequence = -1;
+        /* locker scope */ {
+            VMutexLocker locker(&mHousekeepingMutex, "VRollingFileLogAppender::_runWorker");
+            retiredFiles.swap(mRetiredFiles);
+            if (mNextFile == NULL) {
+                nextSequence = mNextSequence++;
+            }
+        }
+
+        // Prepare the next file without the lock, so that a roll meanwhile waits only for the pointer
+        // exchange. If that roll found no file ready and opened a later-numbered one itself, ours would
+        // be out of order, so we discard it and prepare another on the next pass.
+        if (nextSequence != -1) {
+            VRollingLogFile* nextFile = NULL;
+            try {
+                nextFile = this->_openLogFile(nextSequence);
+            } catch (...) {} // a roll will try again, and report the error to the logging thread
+
+            if (nextFile != NULL) {
+                bool isOutOfOrder;
+                /* locker scope */ {
+                    VMutexLocker locker(&mHousekeepingMutex, "VRollingFileLogAppender::_runWorker");
+                    isOutOfOrder = (nextSequence < mCurrentSequence.load());
+                    if (!isOutOfOrder) {
+                        mNextFile = nextFile;
+                    }
+                }
+
+                if (isOutOfOrder) {
+                    _removeUnusedLogFile(nextFile);
+                    mWorkerThread->wake();
+                }
+            }
+        }
+
+        for (std::vector<VRollingLogFile*>::const_iterator i = retiredFiles.begin(); i != retiredFiles.end(); ++i) {
+            delete *i; // closes the file
+        }
+
+        if (isFirstPass || !retiredFiles.empty()) {
+            try {
+                this->_deleteOldFiles();
+            } catch (...) {} // there is nowhere to report it but the log
+        }
+
+        isFirstPass = false;
+        mWorkerThread->waitForWake(VDuration::MINUTE());
+    }
+}
+
+// VMappedFileLogAppender ----------------------------------------------------
+
+/**
+One of a VMappedFileLogAppender's segments, mapped for writing. Its length is the appender's segment size.
+*/
+struct VMappedLogSegment {
+    VMappedLogSegment(Vs64 offset, Vu8* data) : mOffset(offset), mData(data) {}
+
+    Vs64    mOffset;    ///< The file offset of the segment.
+    Vu8*    mData;      ///< The mapped memory.
+};
+
+VMappedFileLogAppender::VMappedFileLogAppender(const VString& name, bool formatOutput, const VString& formatSpec, const VString& timeFormat, const VString& filePath, Vs64 segmentSize, const VDuration& syncInterval)
+    : VLogAppender(name, formatOutput, formatSpec, timeFormat)
+    , mFile(VFSNode(filePath))
+    , mSegmentSize(segmentSize)
+    , mSyncInterval(syncInterval)
+    , mLineEnding(NULL)
+    , mLineEndingLength(0)
+    , mCurrentSegment(NULL)
+    , mWriteOffset(0)
+    , mHousekeepingMutex(VSTRING_FORMAT("VMappedFileLogAppender(%s)", name.chars()), true/*this mutex itself must not log*/)
+    , mNextSegment(NULL)
+    , mNextSegmentOffset(0)
+    , mRetiredSegments()
+    , mRetiringMutex(VSTRING_FORMAT("VMappedFileLogAppender(%s).retiring", name.chars()), true/*this mutex itself must not log*/)
+    , mIsStopped(false)
+    , mWorkerThread(NULL)
+    {
+    this->_init();
+}
+
+VMappedFileLogAppender::VMappedFileLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults)
     : VLogAppender(settings, defaults)
+    , mFile(VFSNode(_getStringInitSetting("path", settings, defaults, VFSNode(VLogger::getBaseLogDirectory(), settings.getString("name") + ".log").getPath())))
+    , mSegmentSize(_getS64InitSetting("segment-size", settings, defaults, kDefaultSegmentSize))
+    , mSyncInterval(_getDurationInitSetting("sync-interval", settings, defaults, VDuration::SECOND()))
+    , mLineEnding(NULL)
+    , mLineEndingLength(0)
+    , mCurrentSegment(NULL)
+    , mWriteOffset(0)
+    , mHousekeepingMutex(VSTRING_FORMAT("VMappedFileLogAppender(%s)", mName.chars()), true/*this mutex itself must not log*/)
+    , mNextSegment(NULL)
+    , mNextSegmentOffset(0)
+    , mRetiredSegments()
+    , mRetiringMutex(VSTRING_FORMAT("VMappedFileLogAppender(%s).retiring", mName.chars()), true/*this mutex itself must not log*/)
+    , mIsStopped(false)
+    , mWorkerThread(NULL)
+    {
+    this->_init();
+}
+
+void VMappedFileLogAppender::_init() {
+    mLineEnding = vault::VgetNativeLineEnding(mLineEndingLength);
+
+    // Segments must start on a mapping boundary.
+    const Vs64 granularity = VMemoryMappedFile::getGranularity();
+    mSegmentSize = V_MAX(granularity, ((mSegmentSize + granularity - 1) / granularity) * granularity);
+
+    VFSNode dir;
+    mFile.getNode().getParentNode(dir);
+    dir.mkdirs();
+    mFile.openReadWrite();
+
+    // Resume after any data already in the file. Mapping the segment that contains the end of the
+    // data also sizes the file to the end of that segment, which truncates any zero tail beyond it.
+    const Vs64 dataLength = this->_findDataLength();
+    mNextSegmentOffset = (dataLength / mSegmentSize) * mSegmentSize;
+    /* locker scope */ {
+        VMutexLocker locker(&mHousekeepingMutex, "VMappedFileLogAppender::_init");
+        mCurrentSegment = this->_mapNextSegment();
+    }
+    mWriteOffset = dataLength - mCurrentSegment->mOffset;
+
+    mWorkerThread = VLogAppenderWorkerThread<VMappedFileLogAppender>::startFor("VMappedFileLogAppender", *this);
+}
+
+VMappedFileLogAppender::~VMappedFileLogAppender() {
+    (void) mWorkerThread->stopAndJoin(mIsStopped);
+    delete mWorkerThread;
+
+    const Vs64 dataLength = mCurrentSegment->mOffset + mWriteOffset;
+    for (std::vector<VMappedLogSegment*>::const_iterator i = mRetiredSegments.begin(); i != mRetiredSegments.end(); ++i) {
+        mFile.sync((*i)->mData, mSegmentSize, true);
+        VMemoryMappedFile::unmap((*i)->mData, mSegmentSize);
+        delete *i;
+    }
+
+    mFile.sync(mCurrentSegment->mData, mWriteOffset, true);
+    VMemoryMappedFile::unmap(mCurrentSegment->mData, mSegmentSize);
+    delete mCurrentSegment;
+
+    if (mNextSegment != NULL) {
+        VMemoryMappedFile::unmap(mNextSegment->mData, mSegmentSize);
+        delete mNextSegment;
+    }
+
+    // Remove the unwritten tail, so that the file holds exactly the data written.
+    try {
+        mFile.setSize(dataLength);
+    } catch (...) {} // the next appender for the file will truncate it instead
+
+    mFile.close();
+}
+
+void VMappedFileLogAppender::addInfo(VBentoNode& infoNode) const {
+    VLogAppender::addInfo(infoNode);
+    infoNode.addString("type", "VMappedFileLogAppender");
+    infoNode.addString("file", mFile.getNode().getPath());
+    infoNode.addS64("segment-size", mSegmentSize);
+    infoNode.addDuration("sync-interval", mSyncInterval);
+    infoNode.addS64("data-length", this->getDataLength());
+}
+
+void VMappedFileLogAppender::sync() {
+    VMutexLocker locker(&mMutex, "VMappedFileLogAppender::sync");
+    VMutexLocker retiringLocker(&mRetiringMutex, "VMappedFileLogAppender::sync"); // waits for segments the helper thread is retiring
+    VMutexLocker housekeepingLocker(&mHousekeepingMutex, "VMappedFileLogAppender::sync");
+
+    for (std::vector<VMappedLogSegment*>::const_iterator i = mRetiredSegments.begin(); i != mRetiredSegments.end(); ++i) {
+        mFile.sync((*i)->mData, mSegmentSize, true);
+    }
+
+    mFile.sync(mCurrentSegment->mData, mWriteOffset, true);
+}
+
+Vs64 VMappedFileLogAppender::getDataLength() const {
+    VMutexLocker locker(const_cast<VMutex*>(&mMutex), "VMappedFileLogAppender::getDataLength");
+    return mCurrentSegment->mOffset + mWriteOffset;
+}
+
+void VMappedFileLogAppender::_emitRawLine(const VString& line) {
+    this->_writeLine(line);
+}
+
+void VMappedFileLogAppender::_emitRawLines(const VStringVector& lines) {
+    for (VStringVector::const_iterator i = lines.begin(); i != lines.end(); ++i) {
+        this->_writeLine(*i);
+    }
+}
+
+Vs64 VMappedFileLogAppender::_findDataLength() {
+    // Log text contains no zero bytes, so the data ends at the last non-zero byte. Search back from the
+    // end of the file a segment at a time; normally only the last segment's zero tail is examined.
+    Vs64 end = mFile.getSize();
+    while (end > 0) {
+        const Vs64 windowOffset = ((end - 1) / mSegmentSize) * mSegmentSize;
+        const Vs64 windowLength = end - windowOffset;
+        const Vu8* window = mFile.map(windowOffset, windowLength);
+        Vs64 length = windowLength;
+        while ((length > 0) && (window[length - 1] == 0)) {
+            --length;
+        }
+
+        VMemoryMappedFile::unmap(const_cast<Vu8*>(window), windowLength);
+
+        if (length > 0) {
+            return windowOffset + length;
+        }
+
+        end = windowOffset;
+    }
+
+    return 0;
+}
+
+void VMappedFileLogAppender::_writeLine(const VString& line) {
+    this->_write(reinterpret_cast<const Vu8*>(line.chars()), line.length());
+    this->_write(mLineEnding, mLineEndingLength);
+}
+
+void VMappedFileLogAppender::_write(const Vu8* data, Vs64 length) {
+    while (length > 0) {
+        if (mWriteOffset == mSegmentSize) {
+            this->_advanceSegment();
+        }
+
+        const Vs64 numBytes = V_MIN(length, mSegmentSize - mWriteOffset);
+        ::memcpy(mCurrentSegment->mData + mWriteOffset, data, static_cast<size_t>(numBytes));
+        mWriteOffset += numBytes;
+        data += numBytes;
+        length -= numBytes;
+    }
+}
+
+void VMappedFileLogAppender::_advanceSegment() {
+    /* locker scope */ {
+        VMutexLocker locker(&mHousekeepingMutex, "VMappedFileLogAppender::_advanceSegment");
+        VMappedLogSegment* nextSegment = mNextSegment;
+        mNextSegment = NULL;
+        if (nextSegment == NULL) {
+            nextSegment = this->_mapNextSegment(); // The helper thread has not prepared one yet.
+        }
+
+        mRetiredSegments.push_back(mCurrentSegment);
+        mCurrentSegment = nextSegment;
+    }
+
+    mWriteOffset = 0;
+    mWorkerThread->wake();
+}
+
+VMappedLogSegment* VMappedFileLogAppender::_mapNextSegment() {
+    const Vs64 offset = mNextSegmentOffset;
+    mFile.setSize(offset + mSegmentSize);
+    VMappedLogSegment* segment = new VMappedLogSegment(offset, mFile.map(offset, mSegmentSize));
+    mNextSegmentOffset += mSegmentSize;
+    return segment;
+}
+
+void VMappedFileLogAppender::_runWorker() {
+    while (!mIsStopped.load()) {
+        // Only this thread and the destructor unmap segments, so the current segment stays mapped after we unlock.
+        VMutexLocker retiringLocker(&mRetiringMutex, "VMappedFileLogAppender::_runWorker");
+        VMappedLogSegment* currentSegment;
+        std::vector<VMappedLogSegment*> retiredSegments;
+        /* locker scope */ {
+            VMutexLocker locker(&mHousekeepingMutex, "VMappedFileLogAppender::_runWorker");
+            currentSegment = mCurrentSegment;
+            retiredSegments.swap(mRetiredSegments);
+
+            if (mNextSegment == NULL) {
+                try {
+                    mNextSegment = this->_mapNextSegment();
+                } catch (...) {} // an advance will try again, and report the error to the logging thread
+            }
+        }
+
+        for (std::vector<VMappedLogSegment*>::const_iterator i = retiredSegments.begin(); i != retiredSegments.end(); ++i) {
+            mFile.sync((*i)->mData, mSegmentSize, true);
+            VMemoryMappedFile::unmap((*i)->mData, mSegmentSize);
+            delete *i;
+        }
+
+        mFile.sync(currentSegment->mData, mSegmentSize, false);
+        retiringLocker.unlock();
+
+        mWorkerThread->waitForWake(mSyncInterval);
+    }
+}
+
+// VSilentLogAppender ----------------------------------------------------------
+
+void VSilentLogAppender::addInfo(VBentoNode& infoNode) const {
+    VLogAppender::addInfo(infoNode);
+    infoNode.addString("type", "VSilentLogAppender");
+}
+
+// VStringLogAppender ----------------------------------------------------------
+
+VStringLogAppender::VStringLogAppender(const VString& name, bool formatOutput, const VString& formatSpec, const VString& timeFormat)
+    : VLogAppender(name, formatOutput, formatSpec, timeFormat)
+    , mPendingLines()
+    , mLines()
+    {
+}
+
+VStringLogAppender::VStringLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults)
+    : VLogAppender(settings, defaults)
+    , mPendingLines()
     , mLines()
     {
 }
@@ -1204,9 +2284,28 @@ void VStringLogAppender::addInfo(VBentoNode& infoNode) const {
     infoNode.addString("type", "VStringLogAppender");
 }
 
+const VString& VStringLogAppender::getLines() const {
+    VMutexLocker locker(const_cast<VMutex*>(&mMutex), "VStringLogAppender::getLines"); // emitting threads append to mPendingLines
+    this->_gatherLines();
+    return mLines;
+}
+
+const char* VStringLogAppender::orphanLines() {
+    VMutexLocker locker(&mMutex, "VStringLogAppender::orphanLines");
+    this->_gatherLines();
+    mPendingLines.clear();
+    return mLines.orphanDataBuffer();
+}
+
+void VStringLogAppender::_gatherLines() const {
+    // Move the lines emitted since the last call onto the end of the string in one step.
+    mPendingLines.appendToString(mLines);
+    mPendingLines.truncateLength(0);
+}
+
 void VStringLogAppender::_emitRawLine(const VString& line) {
-    mLines += line;
-    mLines += VString::NATIVE_LINE_ENDING();
+    mPendingLines += line;
+    mPendingLines += VString::NATIVE_LINE_ENDING();
 }
 
 // VStringVectorLogAppender ---------------------------------------------------
@@ -1243,6 +2342,511 @@ void VStringVectorLogAppender::_emitRawLine(const VString& line) {
     mStorage->push_back(line);
 }
 
+// VCaptureLogAppender -------------------------------------------------------
+
+static const int kNumCaptureBufferCacheEntries = 4; // The number of capture appenders whose buffer each thread finds without a lock.
+
+/**
+One captured line and its place in the order of all lines emitted to the appender.
+*/
+struct VCaptureLogLine {
+    VCaptureLogLine(Vs64 sequence, const VString& text) : mSequence(sequence), mText(text) {}
+
+    Vs64    mSequence;  ///< The appender-wide sequence number.
+    VString mText;      ///< The line.
+};
+
+/**
+The lines one thread has emitted to a VCaptureLogAppender. Only that thread appends to it, so its
+mutex is contended only while the lines are being read or cleared.
+*/
+struct VCaptureLogBuffer {
+    VCaptureLogBuffer(const VString& name) : mMutex(name, true/*this mutex itself must not log*/), mLines() {}
+
+    VMutex                          mMutex; ///< Guards mLines.
+    std::vector<VCaptureLogLine>    mLines; ///< The lines, in increasing sequence order.
+};
+
+typedef VThreadCache<VCaptureLogBuffer*, kNumCaptureBufferCacheEntries> VCaptureLogBufferCache; ///< Each thread's buffers for a few VCaptureLogAppenders, which own them.
+
+VCaptureLogAppender::VCaptureLogAppender(const VString& name, bool formatOutput, const VString& formatSpec, const VString& timeFormat)
+    : VLogAppender(name, formatOutput, formatSpec, timeFormat)
+    , mID(VCaptureLogBufferCache::newOwnerID())
+    , mNextSequence(0)
+    , mBuffersMutex(VSTRING_FORMAT("VCaptureLogAppender(%s)", name.chars()), true/*this mutex itself must not log*/)
+    , mBuffers()
+    {
+}
+
+VCaptureLogAppender::VCaptureLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults)
+    : VLogAppender(settings, defaults)
+    , mID(VCaptureLogBufferCache::newOwnerID())
+    , mNextSequence(0)
+    , mBuffersMutex(VSTRING_FORMAT("VCaptureLogAppender(%s)", mName.chars()), true/*this mutex itself must not log*/)
+    , mBuffers()
+    {
+}
+
+VCaptureLogAppender::~VCaptureLogAppender() {
+    // Threads' cache entries for us are never matched again, because appender IDs are not reused.
+    vault::vectorDeleteAll(mBuffers);
+}
+
+void VCaptureLogAppender::addInfo(VBentoNode& infoNode) const {
+    VLogAppender::addInfo(infoNode);
+    infoNode.addString("type", "VCaptureLogAppender");
+    infoNode.addInt("num-lines", this->getNumLines());
+}
+
+void VCaptureLogAppender::emit(int level, const char* file, int line, bool emitMessage, const VString& message, const VString& specifiedLoggerName, const VString& actualLoggerName, bool emitRawLine, const VString& rawLine) {
+    VLogAppender::_breakpointLocationForEmit();
+
+    // Format before taking a sequence number, so the number reflects when the line was complete.
+    VString messageLine;
+    if (emitMessage) {
+        messageLine = mFormatOutput ? this->_formatMessage(level, file, line, message, specifiedLoggerName, actualLoggerName) : message;
+    }
+
+    if (emitMessage) {
+        this->_emitRawLine(messageLine);
+    }
+
+    if (emitRawLine) {
+        this->_emitRawLine(rawLine);
+    }
+}
+
+void VCaptureLogAppender::getLines(VStringVector& lines) const {
+    VMutexLocker locker(&mBuffersMutex, "VCaptureLogAppender::getLines");
+
+    std::vector<VMutexLocker*> bufferLockers;
+    for (std::vector<VCaptureLogBuffer*>::const_iterator i = mBuffers.begin(); i != mBuffers.end(); ++i) {
+        bufferLockers.push_back(new VMutexLocker(&(*i)->mMutex, "VCaptureLogAppender::getLines"));
+    }
+
+    // Each buffer is already in sequence order, so repeatedly take the lowest next line among them.
+    typedef std::pair<Vs64, size_t> SequenceAndBufferIndex;
+    std::priority_queue<SequenceAndBufferIndex, std::vector<SequenceAndBufferIndex>, std::greater<SequenceAndBufferIndex> > nextLines;
+    std::vector<size_t> positions(mBuffers.size(), 0);
+    size_t numLines = 0;
+    for (size_t i = 0; i < mBuffers.size(); ++i) {
+        numLines += mBuffers[i]->mLines.size();
+        if (!mBuffers[i]->mLines.empty()) {
+            nextLines.push(SequenceAndBufferIndex(mBuffers[i]->mLines[0].mSequence, i));
+        }
+    }
+
+    lines.reserve(lines.size() + numLines);
+    while (!nextLines.empty()) {
+        const size_t bufferIndex = nextLines.top().second;
+        nextLines.pop();
+
+        const std::vector<VCaptureLogLine>& bufferLines = mBuffers[bufferIndex]->mLines;
+        lines.push_back(bufferLines[positions[bufferIndex]].mText);
+        if (++positions[bufferIndex] < bufferLines.size()) {
+            nextLines.push(SequenceAndBufferIndex(bufferLines[positions[bufferIndex]].mSequence, bufferIndex));
+        }
+    }
+
+    vault::vectorDeleteAll(bufferLockers);
+}
+
+VString VCaptureLogAppender::getText() const {
+    VStringVector lines;
+    this->getLines(lines);
+
+    VStringBuilder text;
+    for (VStringVector::const_iterator i = lines.begin(); i != lines.end(); ++i) {
+        text += *i;
+        text += VString::NATIVE_LINE_ENDING();
+    }
+
+    return text.toString();
+}
+
+int VCaptureLogAppender::getNumLines() const {
+    VMutexLocker locker(&mBuffersMutex, "VCaptureLogAppender::getNumLines");
+
+    size_t numLines = 0;
+    for (std::vector<VCaptureLogBuffer*>::const_iterator i = mBuffers.begin(); i != mBuffers.end(); ++i) {
+        VMutexLocker bufferLocker(&(*i)->mMutex, "VCaptureLogAppender::getNumLines");
+        numLines += (*i)->mLines.size();
+    }
+
+    return static_cast<int>(numLines);
+}
+
+void VCaptureLogAppender::clear() {
+    VMutexLocker locker(&mBuffersMutex, "VCaptureLogAppender::clear");
+
+    // The buffers stay in place, because the threads that own them still refer to them.
+    for (std::vector<VCaptureLogBuffer*>::const_iterator i = mBuffers.begin(); i != mBuffers.end(); ++i) {
+        VMutexLocker bufferLocker(&(*i)->mMutex, "VCaptureLogAppender::clear");
+        (*i)->mLines.clear();
+    }
+}
+
+void VCaptureLogAppender::_emitRawLine(const VString& line) {
+    VCaptureLogBuffer* buffer = this->_getThreadBuffer();
+    VMutexLocker locker(&buffer->mMutex, "VCaptureLogAppender::_emitRawLine");
+    buffer->mLines.push_back(VCaptureLogLine(mNextSequence++, line));
+}
+
+VCaptureLogBuffer* VCaptureLogAppender::_getThreadBuffer() {
+    static thread_local VCaptureLogBufferCache cache;
+
+    VCaptureLogBuffer** cachedBuffer = cache.find(mID);
+    if (cachedBuffer != NULL) {
+        return *cachedBuffer;
+    }
+
+    // The thread's first emit to us, or its entry was replaced by another appender's: start a new
+    // buffer. An abandoned buffer keeps its lines, and merging by sequence puts them in place.
+    VCaptureLogBuffer* buffer = new VCaptureLogBuffer(VSTRING_FORMAT("VCaptureLogAppender(%s).buffer", mName.chars()));
+    /* locker scope */ {
+        VMutexLocker locker(&mBuffersMutex, "VCaptureLogAppender::_getThreadBuffer");
+        mBuffers.push_back(buffer);
+    }
+
+    cache.add(mID) = buffer;
+    return buffer;
+}
+
+// VAsyncLogAppender ---------------------------------------------------------
+
+// The async appenders that are alive, so that the shutdown registry can write out what they have queued.
+typedef std::vector<VAsyncLogAppender*> VAsyncLogAppenderList;
+
+static VMutex* _asyncAppendersMutexInstance() {
+    static VMutex* gAsyncAppendersMutex = new VMutex("gAsyncAppendersMutex", true/*this mutex itself must not log*/);
+    return gAsyncAppendersMutex;
+}
+
+static void _stopAsyncAppenders();
+
+// _asyncAppendersMutexInstance() must be locked when calling this.
+static VAsyncLogAppenderList& _getAsyncAppenders() {
+    static VAsyncLogAppenderList* gAsyncAppenders = NULL;
+    if (gAsyncAppenders == NULL) {
+        gAsyncAppenders = new VAsyncLogAppenderList();
+        VShutdownRegistry::instance()->registerFunction(_stopAsyncAppenders);
+    }
+
+    return *gAsyncAppenders;
+}
+
+static void _stopAsyncAppenders() {
+    // Holding the lock keeps an appender from being deleted while we stop it.
+    VMutexLocker locker(_asyncAppendersMutexInstance(), "_stopAsyncAppenders");
+    VAsyncLogAppenderList& appenders = _getAsyncAppenders();
+    for (VAsyncLogAppenderList::const_iterator i = appenders.begin(); i != appenders.end(); ++i) {
+        (*i)->stop();
+    }
+}
+
+static VLogAppenderPtr _findTargetAppender(const VString& name) {
+    VMutexLocker locker(_mutexInstance(), "VAsyncLogAppender _findTargetAppender");
+    return VLogger::findAppender(name);
+}
+
+VAsyncLogAppender::VAsyncLogAppender(const VString& name, VLogAppenderPtr target, int capacity, int batchSize, const VDuration& flushInterval, OverflowPolicy overflowPolicy, int overflowLevel)
+    : VLogAppender(name, true/*the target's setting is what counts*/, VString::EMPTY(), VString::EMPTY())
+    , mTarget(target)
+    , mSlots(NULL)
+    , mCapacity(capacity)
+    , mBatchSize(batchSize)
+    , mFlushInterval(flushInterval)
+    , mOverflowPolicy(overflowPolicy)
+    , mOverflowLevel(overflowLevel)
+    , mEnqueuePosition(0)
+    , mDequeuePosition(0)
+    , mNumDropped(0)
+    , mNumDroppedReported(0)
+    , mIsStopped(false)
+    , mDrainMutex(VSTRING_FORMAT("VAsyncLogAppender(%s)", name.chars()), true/*this mutex itself must not log*/)
+    , mWriterThread(NULL)
+    {
+    this->_init();
+}
+
+VAsyncLogAppender::VAsyncLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults)
+    : VLogAppender(settings, defaults)
+    , mTarget(_findTargetAppender(_getStringInitSetting("target", settings, defaults, VString::EMPTY())))
+    , mSlots(NULL)
+    , mCapacity(_getIntInitSetting("capacity", settings, defaults, kDefaultCapacity))
+    , mBatchSize(_getIntInitSetting("batch-size", settings, defaults, kDefaultBatchSize))
+    , mFlushInterval(_getDurationInitSetting("flush-interval", settings, defaults, 100 * VDuration::MILLISECOND()))
+    , mOverflowPolicy(VAsyncLogAppender::_overflowPolicyFromString(_getStringInitSetting("overflow", settings, defaults, "block")))
+    , mOverflowLevel(VLoggerLevel::fromString(_getStringInitSetting("overflow-level", settings, defaults, "WARN")))
+    , mEnqueuePosition(0)
+    , mDequeuePosition(0)
+    , mNumDropped(0)
+    , mNumDroppedReported(0)
+    , mIsStopped(false)
+    , mDrainMutex(VSTRING_FORMAT("VAsyncLogAppender(%s)", mName.chars()), true/*this mutex itself must not log*/)
+    , mWriterThread(NULL)
+    {
+    this->_init();
+}
+
+void VAsyncLogAppender::_init() {
+    if (mTarget == nullptr) {
+        throw VStackTraceException(VSTRING_FORMAT("VAsyncLogAppender '%s' has no target appender.", mName.chars()));
+    }
+
+    // A power of two lets a queue position be turned into a slot index with a mask.
+    int capacity = 2;
+    while ((capacity < mCapacity) && (capacity < (1 << 24))) {
+        capacity *= 2;
+    }
+
+    mCapacity = capacity;
+    mBatchSize = V_MAX(1, V_MIN(mBatchSize, mCapacity));
+    if (mFlushInterval < VDuration::MILLISECOND()) {
+        mFlushInterval = VDuration::MILLISECOND(); // zero would mean the writer waits with no timeout
+    }
+
+    mSlots = new Slot[mCapacity];
+    for (int i = 0; i < mCapacity; ++i) {
+        std::atomic_init(&mSlots[i].mSequence, static_cast<Vu64>(i));
+        mSlots[i].mHasMessageLine = false;
+        mSlots[i].mHasRawLine = false;
+    }
+
+    /* locker scope */ {
+        VMutexLocker locker(_asyncAppendersMutexInstance(), "VAsyncLogAppender::_init");
+        _getAsyncAppenders().push_back(this);
+    }
+
+    mWriterThread = VLogAppenderWorkerThread<VAsyncLogAppender>::startFor("VAsyncLogAppender", *this);
+}
+
+VAsyncLogAppender::~VAsyncLogAppender() {
+    /* locker scope */ {
+        VMutexLocker locker(_asyncAppendersMutexInstance(), "VAsyncLogAppender::~VAsyncLogAppender");
+        VAsyncLogAppenderList& appenders = _getAsyncAppenders();
+        appenders.erase(std::remove(appenders.begin(), appenders.end(), this), appenders.end());
+    }
+
+    try {
+        this->stop();
+    } catch (...) {} // prevent exceptions from escaping destructor
+
+    delete mWriterThread;
+    delete [] mSlots;
+}
+
+void VAsyncLogAppender::addInfo(VBentoNode& infoNode) const {
+    VLogAppender::addInfo(infoNode);
+    infoNode.addString("type", "VAsyncLogAppender");
+    infoNode.addString("target", mTarget->getName());
+    infoNode.addInt("capacity", mCapacity);
+    infoNode.addInt("batch-size", mBatchSize);
+    infoNode.addDuration("flush-interval", mFlushInterval);
+
+    if (mOverflowPolicy == kBlockWhenFull) {
+        infoNode.addString("overflow", "block");
+    } else if (mOverflowPolicy == kDropWhenFull) {
+        infoNode.addString("overflow", "drop");
+    } else {
+        infoNode.addString("overflow", "drop-below");
+        infoNode.addString("overflow-level", VLoggerLevel::getName(mOverflowLevel));
+    }
+
+    infoNode.addS64("dropped", mNumDropped.load());
+}
+
+void VAsyncLogAppender::emit(int level, const char* file, int line, bool emitMessage, const VString& message, const VString& specifiedLoggerName, const VString& actualLoggerName, bool emitRawLine, const VString& rawLine) {
+    VLogAppender::_breakpointLocationForEmit();
+
+    // Format here rather than on the writer thread, so that the time stamp and thread name are those of the logging thread.
+    VString messageLine;
+    if (emitMessage) {
+        messageLine = mTarget->mFormatOutput ? mTarget->_formatMessage(level, file, line, message, specifiedLoggerName, actualLoggerName) : message;
+    }
+
+    VString rawLineCopy;
+    if (emitRawLine) {
+        rawLineCopy = rawLine;
+    }
+
+    for (;;) {
+        if (mIsStopped.load()) {
+            this->_emitDirectly(emitMessage, messageLine, emitRawLine, rawLineCopy);
+            return;
+        }
+
+        if (this->_tryEnqueue(emitMessage, messageLine, emitRawLine, rawLineCopy)) {
+            // If stop() ran its final flush between our check above and the enqueue, nobody else will write these lines.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (mIsStopped.load()) {
+                this->flush();
+            }
+
+            return;
+        }
+
+        // The queue is full. The writer thread cannot wait for itself to make room, so anything it logs is dropped.
+        if (this->_shouldDropWhenFull(level) || (VThread::getCurrentThread() == mWriterThread)) {
+            ++mNumDropped;
+            return;
+        }
+
+        mWriterThread->wake();
+        VThread::sleep(VDuration::MILLISECOND());
+    }
+}
+
+void VAsyncLogAppender::flush() {
+    VMutexLocker locker(&mDrainMutex, "VAsyncLogAppender::flush");
+    this->_drain();
+}
+
+void VAsyncLogAppender::stop() {
+    // From here on, emit() writes directly; it takes mDrainMutex first, so its lines follow any the writer is still writing.
+    if (mWriterThread->stopAndJoin(mIsStopped)) {
+        this->flush();
+    }
+}
+
+bool VAsyncLogAppender::_tryEnqueue(bool hasMessageLine, VString& messageLine, bool hasRawLine, VString& rawLine) {
+    const Vu64 mask = static_cast<Vu64>(mCapacity - 1);
+    Vu64 position = mEnqueuePosition.load(std::memory_order_relaxed);
+
+    for (;;) {
+        Slot& slot = mSlots[position & mask];
+        Vs64 difference = static_cast<Vs64>(slot.mSequence.load(std::memory_order_acquire) - position);
+
+        if (difference == 0) {
+            // The slot is free for this position. Claim it, unless another thread claims the position first.
+            if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                slot.mHasMessageLine = hasMessageLine;
+                slot.mMessageLine = std::move(messageLine);
+                slot.mHasRawLine = hasRawLine;
+                slot.mRawLine = std::move(rawLine);
+                slot.mSequence.store(position + 1, std::memory_order_release); // publish the entry to the writer
+
+                if (((position + 1) % static_cast<Vu64>(mBatchSize)) == 0) {
+                    mWriterThread->wake();
+                }
+
+                return true;
+            }
+        } else if (difference < 0) {
+            return false; // The writer has not yet emptied this slot since its previous lap: the queue is full.
+        } else {
+            position = mEnqueuePosition.load(std::memory_order_relaxed); // Another thread filled this position; try the latest one.
+        }
+    }
+}
+
+bool VAsyncLogAppender::_shouldDropWhenFull(int level) const {
+    if (mOverflowPolicy == kDropWhenFull) {
+        return true;
+    }
+
+    if (mOverflowPolicy == kDropBelowLevelWhenFull) {
+        return level > mOverflowLevel; // higher level numbers are less severe
+    }
+
+    return false;
+}
+
+void VAsyncLogAppender::_emitDirectly(bool hasMessageLine, const VString& messageLine, bool hasRawLine, const VString& rawLine) {
+    VMutexLocker locker(&mDrainMutex, "VAsyncLogAppender::_emitDirectly");
+    this->_drain(); // anything still queued was emitted first
+
+    VStringVector lines;
+    if (hasMessageLine) {
+        lines.push_back(messageLine);
+    }
+
+    if (hasRawLine) {
+        lines.push_back(rawLine);
+    }
+
+    this->_writeBatch(lines);
+}
+
+void VAsyncLogAppender::_drain() {
+    const Vu64 mask = static_cast<Vu64>(mCapacity - 1);
+    VStringVector batch;
+
+    for (;;) {
+        Slot& slot = mSlots[mDequeuePosition & mask];
+        if (slot.mSequence.load(std::memory_order_acquire) != mDequeuePosition + 1) {
+            break; // not yet filled
+        }
+
+        if (slot.mHasMessageLine) {
+            batch.push_back(std::move(slot.mMessageLine));
+        }
+
+        if (slot.mHasRawLine) {
+            batch.push_back(std::move(slot.mRawLine));
+        }
+
+        slot.mSequence.store(mDequeuePosition + static_cast<Vu64>(mCapacity), std::memory_order_release); // free the slot for the next lap
+        ++mDequeuePosition;
+
+        if (static_cast<int>(batch.size()) >= mBatchSize) {
+            this->_writeBatch(batch);
+        }
+    }
+
+    Vs64 numDropped = mNumDropped.load();
+    if (numDropped != mNumDroppedReported) {
+        batch.push_back(VSTRING_FORMAT("VAsyncLogAppender '%s' dropped " VSTRING_FORMATTER_S64 " messages because its queue was full.", mName.chars(), numDropped - mNumDroppedReported));
+        mNumDroppedReported = numDropped;
+    }
+
+    if (!batch.empty()) {
+        this->_writeBatch(batch);
+    }
+}
+
+void VAsyncLogAppender::_writeBatch(VStringVector& batch) {
+    VMutexLocker locker(&mTarget->mMutex, "VAsyncLogAppender::_writeBatch");
+
+    try {
+        mTarget->_emitRawLines(batch);
+    } catch (...) {} // a failing target must not stop the writer; there is nowhere to report it but the log
+
+    batch.clear();
+}
+
+void VAsyncLogAppender::_runWorker() {
+    while (!mIsStopped.load()) {
+        Vu64 drainedPosition;
+        /* locker scope */ {
+            VMutexLocker locker(&mDrainMutex, "VAsyncLogAppender::_runWorker");
+            this->_drain();
+            drainedPosition = mDequeuePosition;
+        }
+
+        // Sleep unless a batch's worth arrived while we were writing. A wake signal sent just before we wait
+        // is missed, but then we only wait until the flush interval is up.
+        if (mEnqueuePosition.load() - drainedPosition < static_cast<Vu64>(mBatchSize)) {
+            mWriterThread->waitForWake(mFlushInterval);
+        }
+    }
+
+    this->flush();
+}
+
+// static
+VAsyncLogAppender::OverflowPolicy VAsyncLogAppender::_overflowPolicyFromString(const VString& s) {
+    if (s.equalsIgnoreCase("block")) {
+        return kBlockWhenFull;
+    } else if (s.equalsIgnoreCase("drop")) {
+        return kDropWhenFull;
+    } else if (s.equalsIgnoreCase("drop-below")) {
+        return kDropBelowLevelWhenFull;
+    }
+
+    throw VRangeException(VSTRING_FORMAT("VAsyncLogAppender: invalid overflow policy '%s'.", s.chars()));
+}
+
 // VStringLogger -------------------------------------------------------------
 
 VStringLogger::VStringLogger(const VString& name, int level, bool formatOutput, const VString& formatSpec, const VString& timeFormat)
@@ -1468,3 +3072,98 @@ bool VLoggerPrintStackConfig::shouldPrintStack(int level, VNamedLogger& logger)
     return printStack;
 }
 
+// VLoggerRateLimiter ---------------------------------------------------------
+
+VLoggerRateLimiter::VLoggerRateLimiter(int messagesPerSecond, int burst, int sampleEvery, int level, const VDuration& summaryInterval)
+    : mEnabled(false)
+    , mMessagesPerSecond(0)
+    , mBurst(1)
+    , mSampleEvery(1)
+    , mLevel(level)
+    , mSummaryIntervalMilliseconds(0)
+    , mMessageInterval(0)
+    , mBurstTolerance(0)
+    , mBucketFullTime(0)
+    , mSampleCounter(0)
+    , mNumSuppressed(0)
+    , mLastSummaryTime(0)
+    {
+    this->configure(messagesPerSecond, burst, sampleEvery, level, summaryInterval);
+}
+
+void VLoggerRateLimiter::configure(int messagesPerSecond, int burst, int sampleEvery, int level, const VDuration& summaryInterval) {
+    mMessagesPerSecond = V_MAX(0, messagesPerSecond);
+    mBurst = V_MAX(1, burst);
+    mSampleEvery = V_MAX(1, sampleEvery);
+    mLevel = level;
+    mSummaryIntervalMilliseconds = summaryInterval.getDurationMilliseconds();
+    mEnabled = (mMessagesPerSecond > 0) || (mSampleEvery > 1);
+
+    // The bucket is measured in microseconds: each message uses one interval's worth, and the time at
+    // which the bucket will be full again can run up to (burst - 1) intervals ahead of now.
+    mMessageInterval = (mMessagesPerSecond > 0) ? (CONST_S64(1000000) / mMessagesPerSecond) : 0;
+    mBurstTolerance = mMessageInterval * (mBurst - 1);
+
+    mBucketFullTime.store(0, std::memory_order_relaxed);
+    mSampleCounter.store(0, std::memory_order_relaxed);
+    mNumSuppressed.store(0, std::memory_order_relaxed);
+    mLastSummaryTime.store(VInstant::snapshot(), std::memory_order_relaxed);
+}
+
+bool VLoggerRateLimiter::admit(int& numSuppressed) {
+    bool admitted = (mSampleEvery == 1) || ((mSampleCounter.fetch_add(1, std::memory_order_relaxed) % static_cast<Vu32>(mSampleEvery)) == 0);
+    Vs64 now = -1;
+    if (admitted && (mMessageInterval > 0)) {
+        now = VInstant::snapshot();
+        admitted = this->_admitToBucket(now * 1000);
+    }
+
+    if (!admitted) {
+        mNumSuppressed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    numSuppressed = this->_takeSuppressed(false, now);
+    return admitted;
+}
+
+int VLoggerRateLimiter::takeSuppressed(bool evenIfNotDue) {
+    return this->_takeSuppressed(evenIfNotDue, -1);
+}
+
+// static
+VString VLoggerRateLimiter::formatSummary(int numSuppressed) {
+    return VSTRING_FORMAT("[rate limit] %d messages suppressed", numSuppressed);
+}
+
+int VLoggerRateLimiter::_takeSuppressed(bool evenIfNotDue, Vs64 nowMilliseconds) {
+    if (mNumSuppressed.load(std::memory_order_relaxed) == 0) {
+        return 0;
+    }
+
+    if (nowMilliseconds < 0) {
+        nowMilliseconds = VInstant::snapshot();
+    }
+
+    // Only the thread that moves the last summary time forward reports the count.
+    Vs64 lastSummaryTime = mLastSummaryTime.load(std::memory_order_relaxed);
+    if ((!evenIfNotDue && ((nowMilliseconds - lastSummaryTime) < mSummaryIntervalMilliseconds)) || !mLastSummaryTime.compare_exchange_strong(lastSummaryTime, nowMilliseconds, std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    return mNumSuppressed.exchange(0, std::memory_order_relaxed);
+}
+
+bool VLoggerRateLimiter::_admitToBucket(Vs64 nowMicroseconds) {
+    Vs64 bucketFullTime = mBucketFullTime.load(std::memory_order_relaxed);
+    for (;;) {
+        Vs64 startTime = V_MAX(bucketFullTime, nowMicroseconds);
+        if ((startTime - nowMicroseconds) > mBurstTolerance) {
+            return false; // The bucket is empty.
+        }
+
+        if (mBucketFullTime.compare_exchange_weak(bucketFullTime, startTime + mMessageInterval, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
@@ -14,7 +14,10 @@ License: MIT. See LICENSE.md in the Vault top level directory.
 
 #include "vmutex.h"
 #include "vbufferedfilestream.h"
+#include "vmemorymappedfile.h"
 #include "vtextiostream.h"
+#include "vstringatom.h"
+#include "vstringbuilder.h"
 
 // Microsoft steals this symbol name globally. Take it back.
 #ifdef VPLATFORM_WIN
@@ -28,6 +31,10 @@ License: MIT. See LICENSE.md in the Vault top level directory.
 class VSettings;
 class VSettingsNode;
 class VBentoNode;
+template <class APPENDER> class VLogAppenderWorkerThread;
+struct VRollingLogFile;
+struct VMappedLogSegment;
+struct VCaptureLogBuffer;
 
 /**
 
@@ -194,6 +201,32 @@ class VBentoNode;
       long stack tracing will continue to emit once triggered. It is another way of preventing runaway
       repeated stack tracing.
 
+    A logger can also limit how much output gets through during a storm of messages (see
+    VLoggerRateLimiter), with these settings on its <logger> element:
+    - "rate-limit" (int)
+      Defaults to 0, meaning no limit. The sustained number of messages per second that get through.
+    - "rate-limit-burst" (int)
+      Defaults to the "rate-limit" value. The number of messages that can get through at once after
+      a quiet period.
+    - "sample-every" (int)
+      Defaults to 1, meaning no sampling. Only 1 in this many messages is logged.
+    - "rate-limit-level" (level name or int)
+      Defaults to WARN. Messages at this level or more detailed are subject to "rate-limit" and
+      "sample-every"; ERROR and FATAL messages always get through by default.
+    - "rate-limit-summary-interval" (duration string such as "10s")
+      Defaults to 10 seconds. The number of messages held back is logged, in a line such as
+      "[rate limit] 1234 messages suppressed", at most this often: with the next message logged
+      to the logger at any level once the interval has passed, even one that is held back itself.
+      Whatever is still held back when the logger is deregistered, or at VLogger::shutdown(), is
+      logged then, so the end of a storm is not lost.
+    For example:
+    <pre>
+        <logger name="client-protocol" level="80" rate-limit="20" rate-limit-burst="100" />
+    </pre>
+    For a single log statement, the VLOGGER_RATE_LIMITED and VLOGGER_SAMPLED macros (and their
+    VLOGGER_NAMED_ forms) apply a limit to just that call site. Because they check the limit before
+    evaluating the message, suppressed messages are never formatted.
+
     <h1>Custom Appenders</h1>
 
     Call VLogger::registerLogAppenderFactory() to make your custom appender available to the system.
@@ -211,9 +244,19 @@ class VBentoNode;
     @ingroup vlogger
 */
 
+// VAULT_LOG_MIN_LEVEL, which vconfigure.h may define, is the most detailed level compiled into the
+// VLOGGER macros below. A call whose constant level is more detailed (numerically higher) than it
+// is a constant-false branch that the compiler removes, along with the evaluation of its message.
+// For example, defining it as 60 (VLoggerLevel::INFO) in a release build compiles out every DEBUG
+// and TRACE call. If not defined, all levels are compiled in and filtered only at runtime.
+#ifndef VAULT_LOG_MIN_LEVEL
+    #define VAULT_LOG_MIN_LEVEL 100 /* VLoggerLevel::ALL */
+#endif
+#define VLOGGER_LEVEL_COMPILED_IN(level) ((level) <= VAULT_LOG_MIN_LEVEL)
+
 // This first set of macros sends output to the default logger.
-#define VLOGGER_LEVEL(level, message) do { if (!VLogger::isDefaultLogLevelActive(level)) break; VLogger::getDefaultLogger()->log(level, NULL, 0, message, VString::EMPTY()); } while (false)
-#define VLOGGER_LEVEL_FILELINE(level, message, file, line) do { if (!VLogger::isDefaultLogLevelActive(level)) break; VLogger::getDefaultLogger()->log(level, file, line, message, VString::EMPTY()); } while (false)
+#define VLOGGER_LEVEL(level, message) do { if (!VLOGGER_LEVEL_COMPILED_IN(level) || !VLogger::isDefaultLogLevelActive(level)) break; VLogger::getDefaultLogger()->log(level, NULL, 0, message, VString::EMPTY()); } while (false)
+#define VLOGGER_LEVEL_FILELINE(level, message, file, line) do { if (!VLOGGER_LEVEL_COMPILED_IN(level) || !VLogger::isDefaultLogLevelActive(level)) break; VLogger::getDefaultLogger()->log(level, file, line, message, VString::EMPTY()); } while (false)
 #define VLOGGER_LINE(level, message) VLOGGER_LEVEL_FILELINE(level, message, __FILE__, __LINE__)
 #define VLOGGER_FATAL_AND_THROW(message) do { VLogger::getDefaultLogger()->log(VLoggerLevel::FATAL, __FILE__, __LINE__, message); throw VStackTraceException(message); } while (false)
 #define VLOGGER_FATAL(message) VLOGGER_LEVEL_FILELINE(VLoggerLevel::FATAL, message, __FILE__, __LINE__)
@@ -222,12 +265,18 @@ class VBentoNode;
 #define VLOGGER_INFO(message) VLOGGER_LEVEL(VLoggerLevel::INFO, message)
 #define VLOGGER_DEBUG(message) VLOGGER_LEVEL(VLoggerLevel::DEBUG, message)
 #define VLOGGER_TRACE(message) VLOGGER_LEVEL(VLoggerLevel::TRACE, message)
-#define VLOGGER_HEXDUMP(level, message, buffer, length) do { if (!VLogger::isDefaultLogLevelActive(level)) break; VLogger::getDefaultLogger()->logHexDump(level, message, VString::EMPTY(), buffer, length); } while (false)
-#define VLOGGER_WOULD_LOG(level) (VLogger::isDefaultLogLevelActive(level))
-
-// This set of macros sends output to a specified named logger.
-#define VLOGGER_NAMED_LEVEL(loggername, level, message) do { if (!VLogger::isLogLevelActive(level)) break; VNamedLoggerPtr nl = VLogger::findNamedLoggerForLevel(loggername, level); if (nl != nullptr) nl->log(level, NULL, 0, message, loggername); } while (false)
-#define VLOGGER_NAMED_LEVEL_FILELINE(loggername, level, message, file, line) do { if (!VLogger::isLogLevelActive(level)) break; VNamedLoggerPtr nl = VLogger::findNamedLoggerForLevel(loggername, level); if (nl != nullptr) nl->log(level, file, line, message, loggername); } while (false)
+#define VLOGGER_HEXDUMP(level, message, buffer, length) do { if (!VLOGGER_LEVEL_COMPILED_IN(level) || !VLogger::isDefaultLogLevelActive(level)) break; VLogger::getDefaultLogger()->logHexDump(level, message, VString::EMPTY(), buffer, length); } while (false)
+#define VLOGGER_WOULD_LOG(level) (VLOGGER_LEVEL_COMPILED_IN(level) && VLogger::isDefaultLogLevelActive(level))
+// These limit output from a single call site with a VLoggerRateLimiter; the message is evaluated only if it gets through.
+// A call site's count of suppressed messages is logged by a later call at that site, once the summary interval has passed.
+#define VLOGGER_LIMITED(level, messagesPerSecond, sampleEvery, message) do { if (!VLOGGER_LEVEL_COMPILED_IN(level) || !VLogger::isDefaultLogLevelActive(level)) break; static VLoggerRateLimiter vloggerRateLimiter(messagesPerSecond, messagesPerSecond, sampleEvery); int vloggerNumSuppressed; bool vloggerAdmitted = vloggerRateLimiter.admit(vloggerNumSuppressed); if (!vloggerAdmitted && (vloggerNumSuppressed == 0)) break; VNamedLoggerPtr vlogger = VLogger::getDefaultLogger(); if (vloggerNumSuppressed > 0) vlogger->log(level, (level <= VLoggerLevel::ERROR) ? __FILE__ : NULL, (level <= VLoggerLevel::ERROR) ? __LINE__ : 0, VLoggerRateLimiter::formatSummary(vloggerNumSuppressed), VString::EMPTY()); if (vloggerAdmitted) vlogger->log(level, (level <= VLoggerLevel::ERROR) ? __FILE__ : NULL, (level <= VLoggerLevel::ERROR) ? __LINE__ : 0, message, VString::EMPTY()); } while (false)
+#define VLOGGER_RATE_LIMITED(level, messagesPerSecond, message) VLOGGER_LIMITED(level, messagesPerSecond, 1, message)
+#define VLOGGER_SAMPLED(level, sampleEvery, message) VLOGGER_LIMITED(level, 0, sampleEvery, message)
+
+// This set of macros sends output to a specified named logger. Each call site keeps, per thread, the logger
+// its name last resolved to (see VNamedLoggerCache), so that logging does not lock or search the logger tree.
+#define VLOGGER_NAMED_LEVEL(loggername, level, message) do { if (!VLOGGER_LEVEL_COMPILED_IN(level) || !VLogger::isLogLevelActive(level)) break; static thread_local VNamedLoggerCache vloggerNamedLoggerCache; VNamedLogger* nl = vloggerNamedLoggerCache.findLoggerForLevel(loggername, level); if (nl != NULL) nl->log(level, NULL, 0, message, loggername); } while (false)
+#define VLOGGER_NAMED_LEVEL_FILELINE(loggername, level, message, file, line) do { if (!VLOGGER_LEVEL_COMPILED_IN(level) || !VLogger::isLogLevelActive(level)) break; static thread_local VNamedLoggerCache vloggerNamedLoggerCache; VNamedLogger* nl = vloggerNamedLoggerCache.findLoggerForLevel(loggername, level); if (nl != NULL) nl->log(level, file, line, message, loggername); } while (false)
 #define VLOGGER_NAMED_LINE(loggername, level, message) VLOGGER_NAMED_LEVEL_FILELINE(loggername, level, message, __FILE__, __LINE__)
 #define VLOGGER_NAMED_FATAL(loggername, message) VLOGGER_NAMED_LEVEL_FILELINE(loggername, VLoggerLevel::FATAL, message, __FILE__, __LINE__)
 #define VLOGGER_NAMED_ERROR(loggername, message) VLOGGER_NAMED_LEVEL_FILELINE(loggername, VLoggerLevel::ERROR, message, __FILE__, __LINE__)
@@ -235,12 +284,54 @@ class VBentoNode;
 #define VLOGGER_NAMED_INFO(loggername, message) VLOGGER_NAMED_LEVEL(loggername, VLoggerLevel::INFO, message)
 #define VLOGGER_NAMED_DEBUG(loggername, message) VLOGGER_NAMED_LEVEL(loggername, VLoggerLevel::DEBUG, message)
 #define VLOGGER_NAMED_TRACE(loggername, message) VLOGGER_NAMED_LEVEL(loggername, VLoggerLevel::TRACE, message)
-#define VLOGGER_NAMED_HEXDUMP(loggername, level, message, buffer, length) do { if (!VLogger::isLogLevelActive(level)) break; VNamedLoggerPtr nl = VLogger::findNamedLoggerForLevel(loggername, level); if (nl != nullptr) nl->logHexDump(level, message, loggername, buffer, length); } while (false)
-#define VLOGGER_NAMED_WOULD_LOG(loggername, level) (VLogger::isLogLevelActive(level) && (VLogger::findNamedLoggerForLevel(loggername, level) != nullptr))
+#define VLOGGER_NAMED_HEXDUMP(loggername, level, message, buffer, length) do { if (!VLOGGER_LEVEL_COMPILED_IN(level) || !VLogger::isLogLevelActive(level)) break; static thread_local VNamedLoggerCache vloggerNamedLoggerCache; VNamedLogger* nl = vloggerNamedLoggerCache.findLoggerForLevel(loggername, level); if (nl != NULL) nl->logHexDump(level, message, loggername, buffer, length); } while (false)
+#define VLOGGER_NAMED_LIMITED(loggername, level, messagesPerSecond, sampleEvery, message) do { if (!VLOGGER_LEVEL_COMPILED_IN(level) || !VLogger::isLogLevelActive(level)) break; static thread_local VNamedLoggerCache vloggerNamedLoggerCache; VNamedLogger* nl = vloggerNamedLoggerCache.findLoggerForLevel(loggername, level); if (nl == NULL) break; static VLoggerRateLimiter vloggerRateLimiter(messagesPerSecond, messagesPerSecond, sampleEvery); int vloggerNumSuppressed; bool vloggerAdmitted = vloggerRateLimiter.admit(vloggerNumSuppressed); if (!vloggerAdmitted && (vloggerNumSuppressed == 0)) break; if (vloggerNumSuppressed > 0) nl->log(level, (level <= VLoggerLevel::ERROR) ? __FILE__ : NULL, (level <= VLoggerLevel::ERROR) ? __LINE__ : 0, VLoggerRateLimiter::formatSummary(vloggerNumSuppressed), loggername); if (vloggerAdmitted) nl->log(level, (level <= VLoggerLevel::ERROR) ? __FILE__ : NULL, (level <= VLoggerLevel::ERROR) ? __LINE__ : 0, message, loggername); } while (false)
+#define VLOGGER_NAMED_RATE_LIMITED(loggername, level, messagesPerSecond, message) VLOGGER_NAMED_LIMITED(loggername, level, messagesPerSecond, 1, message)
+#define VLOGGER_NAMED_SAMPLED(loggername, level, sampleEvery, message) VLOGGER_NAMED_LIMITED(loggername, level, 0, sampleEvery, message)
+#define VLOGGER_NAMED_WOULD_LOG(loggername, level) (VLOGGER_LEVEL_COMPILED_IN(level) && VLogger::isLogLevelActive(level) && [&]() -> bool { static thread_local VNamedLoggerCache vloggerNamedLoggerCache; return vloggerNamedLoggerCache.findLoggerForLevel(loggername, level) != NULL; }())
 
 #define VLOGGER_APPENDER_EMIT(appender, level, message) do { (appender).emit(level, (level <= VLoggerLevel::ERROR) ? __FILE__ : NULL, (level <= VLoggerLevel::ERROR) ? __LINE__ : 0, true, message, VString::EMPTY(), VString::EMPTY(), false, VString::EMPTY()); } while (false)
 #define VLOGGER_APPENDER_EMIT_FILELINE(appender, level, message, file, line) do { (appender).emit(level, file, line, true, message, VString::EMPTY(), VString::EMPTY(), false, VString::EMPTY()); } while (false)
 
+/**
+VLogTimeStampFormatter formats the time stamps of log lines. Lines logged within the same second
+differ only in their millisecond digits, so rather than running the full VInstantFormatter (and a
+local time conversion) for every line, each thread keeps the text it last formatted for each
+formatter and time zone. A time in the same second copies that text and writes in the milliseconds;
+only a new second formats again, which is also when the local time offset (and so a change in
+daylight saving time) is looked up again.
+
+The result is identical to VInstantFormatter's. Specifiers that cannot be patched this way, because
+they contain quoted text or a millisecond field narrower than three digits (whose width varies), are
+simply formatted in full every time.
+*/
+class VLogTimeStampFormatter {
+    public:
+
+        /**
+        Constructs a formatter for the default locale.
+        @param  formatSpecifier the format to apply, as for VInstantFormatter
+        */
+        explicit VLogTimeStampFormatter(const VString& formatSpecifier);
+        ~VLogTimeStampFormatter() {}
+
+        VString formatLocalString(const VInstant& when) const { return this->_format(when, false); }    ///< Returns the same as when.getLocalString() with a VInstantFormatter of our specifier. @param when the time @return the time stamp
+        VString formatUTCString(const VInstant& when) const { return this->_format(when, true); }       ///< Returns the same as when.getUTCString() with a VInstantFormatter of our specifier. @param when the time @return the time stamp
+
+    private:
+
+        VLogTimeStampFormatter(const VLogTimeStampFormatter&); // not copyable
+        VLogTimeStampFormatter& operator=(const VLogTimeStampFormatter&); // not assignable
+
+        VString _format(const VInstant& when, bool isUTC) const;
+
+        Vu64                            mID;                    ///< Identifies this formatter's entries in the per-thread cache; never reused, unlike an address.
+        VInstantFormatter               mFormatter;             ///< Formats the whole time stamp, when it cannot be patched.
+        bool                            mIsPatchable;           ///< True if the specifier's output can be patched as described above.
+        std::vector<VInstantFormatter>  mSegmentFormatters;     ///< The specifier split around its millisecond fields; one more than mMillisecondWidths.
+        std::vector<int>                mMillisecondWidths;     ///< The number of digits of each millisecond field.
+};
+
 /**
 VLogAppender is an abstract base class that defines the API for writing output to a destination.
 */
@@ -348,12 +439,22 @@ class VLogAppender {
         @param  line    the actual line to be emitted as is (it has already been formatted if that was needed)
         */
         virtual void _emitRawLine(const VString& /*line*/) {}
+        /**
+        Writes a batch of lines that have already been formatted. The base class implementation calls
+        _emitRawLine() for each one; an appender whose medium has a per-write cost, such as a flush,
+        can override this to pay that cost once per batch. VAsyncLogAppender calls it from its writer
+        thread with mMutex locked.
+        @param  lines   the lines to be emitted as is, in order
+        */
+        virtual void _emitRawLines(const VStringVector& lines);
 
         // These helper functions are meant to be used by subclasses constructing from settings.
         // Such constructors usually need to get settings, and fall back first to configured defaults, then to a specific default value.
         static bool _getBooleanInitSetting(const VString& attributePath, const VSettingsNode& settings, const VSettingsNode& defaults, bool defaultValue);
         static int _getIntInitSetting(const VString& attributePath, const VSettingsNode& settings, const VSettingsNode& defaults, int defaultValue);
+        static Vs64 _getS64InitSetting(const VString& attributePath, const VSettingsNode& settings, const VSettingsNode& defaults, Vs64 defaultValue);
         static VString _getStringInitSetting(const VString& attributePath, const VSettingsNode& settings, const VSettingsNode& defaults, const VString& defaultValue);
+        static VDuration _getDurationInitSetting(const VString& attributePath, const VSettingsNode& settings, const VSettingsNode& defaults, const VDuration& defaultValue);
 
         VMutex              mMutex;          ///< A mutex to protect against multiple threads' messages from being intertwined;
                                                 // subclasses may access this carefully; note that it is locked prior to any
@@ -363,10 +464,11 @@ class VLogAppender {
         bool                mFormatOutput;  ///< True if this appender should format messages it is asked to emit.
         VString             mFormatSpec;    ///< If formatting, this defines the format.
         VInstantFormatter   mTimeFormatter; ///< If formatting and time stamp is printed, this defines the format. See VInstantFormatter for specification.
+        VLogTimeStampFormatter mTimeStampFormatter; ///< Produces mTimeFormatter's output for each line, reusing the work done for the previous line in the same second.
         
         // These fields cache state of the mFormatSpec. This allows _formatMessage() to avoid unnecessary work
         // when we know the format doesn't need everything to be supplied. If we allow mFormatSpec to be set
-        // after construction, these will have to be re-calculated at that time.
+        // after construction, these (and mFormatTokens) will have to be re-calculated at that time.
         bool    mFormatUsesLocalTime;
         bool    mFormatUsesUTCTime;
         bool    mFormatUsesLevel;
@@ -375,11 +477,39 @@ class VLogAppender {
         bool    mFormatUsesSpecifiedLoggerName;
         bool    mFormatUsesActualLoggerName;
 
+        /** The kinds of piece a compiled mFormatSpec is made of: literal text, or one of the $ variables. */
+        enum FormatTokenKind {
+            kFormatLiteral,
+            kFormatLocalTime,
+            kFormatUTCTime,
+            kFormatLevel,
+            kFormatThread,
+            kFormatLocation,
+            kFormatSpecifiedLoggerName,
+            kFormatActualLoggerName,
+            kFormatMessage,
+            kNumFormatTokenKinds
+        };
+
+        /** One piece of a compiled mFormatSpec. */
+        struct FormatToken {
+            FormatTokenKind mKind;  ///< What the piece renders.
+            VString         mText;  ///< For kFormatLiteral, the text to copy.
+        };
+
+        typedef std::vector<FormatToken> FormatTokenList;
+        FormatTokenList mFormatTokens; ///< mFormatSpec split at its $ variables at construction, so that _formatMessage() renders each line in one pass.
+
     private:
 
+        void _compileFormatSpec(); ///< Fills mFormatTokens from mFormatSpec.
+
         VString _toString() const; ///< For diagnostics, returns a string representation of this appender and its name.
 
         static void _breakpointLocationForEmit(); ///< A convenient place to set a debugger breakpoint for any appender emitting output.
+
+        friend class VAsyncLogAppender; // it formats with, locks, and writes to the appender it decorates
+        friend class VCaptureLogAppender; // its emit() replaces ours, so it calls _breakpointLocationForEmit() itself
 };
 
 typedef VSharedPtr<VLogAppender> VLogAppenderPtr;
@@ -494,6 +624,96 @@ class VLoggerPrintStackConfig {
         VInstant    mExpiration;    ///< Internal instant for when the configured duration expires and we turn back to OFF
 };
 
+/**
+VLoggerRateLimiter limits how many messages get through during a storm of log output, where
+VLoggerRepetitionFilter only catches exact repeats. It combines two limits, either of which may be off:
+- 1-in-N sampling: only every Nth message is considered.
+- A token bucket: messages get through at a sustained rate of so many per second, with up to
+  a burst's worth allowed at once after a quiet period.
+
+The number of messages held back is counted. A caller of admit() also gets that count, at most
+once per summary interval, whether or not its own message gets through, so it can log a
+"N messages suppressed" line; the summaries keep appearing periodically as long as the storm
+lasts. takeSuppressed() gets the count without a message, to report it once a storm has ended.
+
+admit() takes no lock: the bucket is kept as the time at which it will next be full (the
+"generic cell rate algorithm"), in a single atomic value, so it is cheap to call for every message.
+configure() is not thread-safe and should be called before logging begins.
+
+A VNamedLogger has one (see VNamedLogger::setRateLimitInfo), and the VLOGGER_LIMITED macros
+declare one for their call site.
+*/
+class VLoggerRateLimiter {
+    public:
+
+        /**
+        Constructs the limiter.
+        @param  messagesPerSecond   the sustained rate at which messages get through; 0 or less means no rate limit
+        @param  burst               the number of messages that can get through at once; at least 1
+        @param  sampleEvery         1 in this many messages is considered; 1 or less means no sampling
+        @param  level               the least detailed level that is subject to the limits (see appliesTo())
+        @param  summaryInterval     the minimum time between reports of the number of suppressed messages
+        */
+        VLoggerRateLimiter(int messagesPerSecond = 0, int burst = 1, int sampleEvery = 1, int level = 0 /* VLoggerLevel::OFF */, const VDuration& summaryInterval = VDuration::SECOND() * 10);
+        ~VLoggerRateLimiter() {}
+
+        /**
+        Changes the limits; the arguments are the same as for the constructor.
+        */
+        void configure(int messagesPerSecond, int burst, int sampleEvery, int level, const VDuration& summaryInterval);
+
+        bool isEnabled() const { return mEnabled; } ///< Returns true if any limit is in effect. @return obvious
+        bool appliesTo(int level) const { return mEnabled && (level >= mLevel); } ///< Returns true if messages at the specified level are subject to the limits. @param level obvious @return obvious
+        int getMessagesPerSecond() const { return mMessagesPerSecond; } ///< Returns the sustained rate, or 0 if there is no rate limit. @return obvious
+        int getBurst() const { return mBurst; } ///< Returns the number of messages that can get through at once. @return obvious
+        int getSampleEvery() const { return mSampleEvery; } ///< Returns N for 1-in-N sampling, or 1 if there is no sampling. @return obvious
+        int getLevel() const { return mLevel; } ///< Returns the least detailed level subject to the limits. @return obvious
+
+        /**
+        Decides whether a message gets through the limits, counting it as suppressed if not.
+        @param  numSuppressed   set to the number of messages suppressed since the last summary
+                                (including this one), if a summary is due; otherwise set to 0
+        @return true if the message should be logged
+        */
+        bool admit(int& numSuppressed);
+
+        /**
+        Returns the number of messages suppressed since the last summary, and starts counting
+        again, if a summary is due; for a caller that is not subject to the limits itself.
+        @param  evenIfNotDue    true to return the count even if the summary interval has not passed
+        @return the count, or 0 if there is none or no summary is due
+        */
+        int takeSuppressed(bool evenIfNotDue);
+
+        /**
+        Returns the text of a line reporting suppressed messages.
+        @param  numSuppressed   the count from admit()
+        @return the summary line text
+        */
+        static VString formatSummary(int numSuppressed);
+
+    private:
+
+        VLoggerRateLimiter(const VLoggerRateLimiter&); // not copyable
+        VLoggerRateLimiter& operator=(const VLoggerRateLimiter&); // not assignable
+
+        bool _admitToBucket(Vs64 nowMicroseconds);
+        int _takeSuppressed(bool evenIfNotDue, Vs64 nowMilliseconds); ///< Implements takeSuppressed(), given the snapshot time or -1 to take it if needed.
+
+        bool                mEnabled;               ///< True if either limit is in effect.
+        int                 mMessagesPerSecond;     ///< The sustained rate, or 0.
+        int                 mBurst;                 ///< The bucket size.
+        int                 mSampleEvery;           ///< N for 1-in-N sampling, or 1.
+        int                 mLevel;                 ///< The least detailed level subject to the limits.
+        Vs64                mSummaryIntervalMilliseconds; ///< The minimum time between summaries.
+        Vs64                mMessageInterval;       ///< Microseconds of bucket capacity one message uses.
+        Vs64                mBurstTolerance;        ///< Microseconds the bucket can be ahead of now and still admit a message.
+        std::atomic<Vs64>   mBucketFullTime;        ///< The snapshot time, in microseconds, at which the bucket will be full again.
+        std::atomic<Vu32>   mSampleCounter;         ///< Counts messages for sampling.
+        std::atomic<int>    mNumSuppressed;         ///< Messages suppressed since the last summary.
+        std::atomic<Vs64>   mLastSummaryTime;       ///< The snapshot time, in milliseconds, of the last summary.
+};
+
 /**
 VNamedLogger defines an object to which log output is initially sent. A logger has a name (that is used
 to locate it and direct output to it) and a level (which the logger uses to filter what it receives).
@@ -571,8 +791,8 @@ class VNamedLogger : public VEnableSharedFromThis<VNamedLogger> {
         void emitStackCrawlLine(const VString& message);
 
         const VString& getName() const { return mName; }            ///< Returns the logger's name. @return obvious
-        bool isEnabledFor(int level) { return level <= mLevel; }    ///< Returns true if the logger's current level would allow the specified level to emit. @param level obvious @return obvious
-        int getLevel() const { return mLevel; }                     ///< Returns the logger's current level. @return obvious
+        bool isEnabledFor(int level) { return level <= mLevel.load(std::memory_order_relaxed); } ///< Returns true if the logger's current level would allow the specified level to emit. @param level obvious @return obvious
+        int getLevel() const { return mLevel.load(std::memory_order_relaxed); }                 ///< Returns the logger's current level. @return obvious
         void setLevel(int level);                                   ///< Sets the logger's level. @param level the level above which messages are filtered
 
         void setRepetitionFilterEnabled(bool enabled) { mRepetitionFilter.setEnabled(enabled); }    ///< Enabled or disables repetition filtering by this logger. @param enabled obvious
@@ -592,6 +812,24 @@ class VNamedLogger : public VEnableSharedFromThis<VNamedLogger> {
         */
         void setPrintStackInfo(int printStackLevel, int maxNumOccurrences, const VDuration& timeLimit) { mPrintStackConfig.configure(printStackLevel, maxNumOccurrences, timeLimit); }
         /**
+        Configures rate limiting and sampling for this logger (see VLoggerRateLimiter). Messages held
+        back are counted, and a line giving the count is emitted when a later message is logged at
+        any level, at most once per summary interval, and by emitSuppressedSummary(). Like
+        setPrintStackInfo(), call this before logging.
+        @param  rateLimitLevel      messages at this level or more detailed are subject to the limits
+        @param  messagesPerSecond   the sustained rate at which messages get through; 0 means no rate limit
+        @param  burst               the number of messages that can get through at once
+        @param  sampleEvery         1 in this many messages is considered; 1 means no sampling
+        @param  summaryInterval     the minimum time between lines reporting suppressed messages
+        */
+        void setRateLimitInfo(int rateLimitLevel, int messagesPerSecond, int burst, int sampleEvery, const VDuration& summaryInterval) { mRateLimiter.configure(messagesPerSecond, burst, sampleEvery, rateLimitLevel, summaryInterval); }
+        /**
+        Emits the line giving the number of messages held back by the rate limit, if there are any,
+        without waiting for the summary interval. VLogger calls this when it deregisters the logger
+        and at shutdown, while the appenders are still registered.
+        */
+        void emitSuppressedSummary();
+        /**
         Returns true if this logger is currently the default logger.
         @return obvious
         */
@@ -622,17 +860,19 @@ class VNamedLogger : public VEnableSharedFromThis<VNamedLogger> {
 
     private:
 
+        bool _admit(int level, int& numSuppressed); ///< Applies the rate limit to a message, and gets the count of suppressed messages if a summary is due. @return true if the message should be logged
         VString _toString() const; ///< For diagnostics, returns a string representation of this appender and its name.
 
         static void _breakpointLocationForLog(); ///< A convenient place to set a debugger breakpoint for any appender emitting output.
 
         VString                 mName;              ///< The logger name. Used to find it if logged to by name.
-        int                     mLevel;             ///< The level above which log output is filtered.
+        std::atomic<int>        mLevel;             ///< The level above which log output is filtered. Read without locking.
         mutable VMutex          mAppendersMutex;    ///< A mutex we use to ensure the mutable data below is stable when we access it, even if multiple threads log to us simultaneously.
         VStringVector           mAppenderNames;     ///< A list of appender names to which we emit. An empty string means the default appender.
         VLogAppenderPtr         mSpecificAppender;  ///< If not null, a specific appender instance we emit to.
         VLoggerRepetitionFilter mRepetitionFilter;  ///< Used to prevent repetitive info from clogging output.
         VLoggerPrintStackConfig mPrintStackConfig;  ///< Settings that control whether we add a stack trace for log messages at certain levels.
+        VLoggerRateLimiter      mRateLimiter;       ///< Limits how many messages get through during a storm of output. Checked without locking.
 
         friend class VLoggerRepetitionFilter; // it can call our _emitToAppenders when we call it from our log() function
         friend class VLoggerPrintStackConfig; // ditto
@@ -824,7 +1064,9 @@ class VLogger {
         */
         static void deregisterLogAppender(const VString& name);
         /**
-        Removes the specified logger from the registry.
+        Removes the specified logger from the registry. The logger is destroyed when the last reference
+        to it is released, except that a logger a VLOGGER_NAMED_* call site has resolved to is kept,
+        along with its appenders, until shutdown(), because call sites cache it by raw pointer.
         @param  namedLogger    the logger to deregister
         */
         static void deregisterLogger(VNamedLoggerPtr namedLogger);
@@ -846,17 +1088,20 @@ class VLogger {
         static void checkMaxActiveLogLevelForChangedLogger(int oldActiveLevel, int newActiveLevel);
 
         /**
-        Returns true if the default logger is active for the specified level.
+        Returns true if the default logger is active for the specified level. This is a single
+        relaxed atomic read, without locking, so that a VLOGGER macro at a filtered level costs
+        only a comparison.
         @param  level   the level to check
         @return true if the default logger would log at that level
         */
-        static bool isDefaultLogLevelActive(int level);
+        static bool isDefaultLogLevelActive(int level) { return level <= gDefaultLogLevel.load(std::memory_order_relaxed); }
         /**
-        Returns true if any registered logger is active for the specified level
+        Returns true if any registered logger is active for the specified level. Like
+        isDefaultLogLevelActive(), this is a single relaxed atomic read.
         @param  level   the level to check
         @return true if some registered logger would log at that level
         */
-        static bool isLogLevelActive(int level);
+        static bool isLogLevelActive(int level) { return level <= gMaxActiveLevel.load(std::memory_order_relaxed); }
 
         // The following "getters" and "finders" have the following consistent naming convention:
         // - "get" always returns a valid object; it may need to create the object in question
@@ -904,6 +1149,20 @@ class VLogger {
         @return a logger (@ Nullable)
         */
         static VNamedLoggerPtr findNamedLoggerForLevel(const VString& name, int level);
+        /**
+        Returns the specified logger, if it exists; null otherwise. Resolving an atom does no string
+        work at all, so code that logs to the same name repeatedly can keep the name's atom.
+        @param  name    the name of the logger to find
+        @return a logger (@ Nullable)
+        */
+        static VNamedLoggerPtr findNamedLogger(const VStringAtom& name);
+        /**
+        Returns the specified logger, if it exists AND it is active for the specified level; null otherwise.
+        @param  name    the name of the logger to find
+        @param  level   the level to check as active for the found logger
+        @return a logger (@ Nullable)
+        */
+        static VNamedLoggerPtr findNamedLoggerForLevel(const VStringAtom& name, int level);
 
         // Appenders:
         /**
@@ -980,16 +1239,24 @@ class VLogger {
         static void _recalculateMaxActiveLogLevel(); // Called when one of the _check... methods decides the max active log level may indeed have changed, and must be recalculated.
 
         // These two methods are how we really search for a specified named logger.
-        static VNamedLoggerPtr _findNamedLoggerFromExactName(const VString& name);      ///< Return the logger with the specified name, or null if it doesn't exist. (@ Nullable)
-        static VNamedLoggerPtr _findNamedLoggerFromPathName(const VString& pathName);   ///< Return a logger using a dot-separated path name, falling back to an exact name find. (@ Nullable)
+        static VNamedLoggerPtr _findNamedLoggerFromPathName(const VString& pathName);       ///< Return a logger using a dot-separated path name, falling back to an exact name find. (@ Nullable)
+        static VNamedLoggerPtr _findNamedLoggerFromPathAtom(const VStringAtom& pathName);   ///< Same as _findNamedLoggerFromPathName, walking the atom's interned parent paths. (@ Nullable)
+
+        // This is how a VNamedLoggerCache resolves a name. Unlike the helpers above, it locks.
+        static int _findNamedOrDefaultLogger(const VString& name, VNamedLogger*& logger); ///< Sets logger to the named logger, or to the default logger if none matches, and keeps it alive until shutdown(); returns the configuration generation it is valid for.
+
+        static void _updateDefaultLogLevel(); // Called whenever the default logger, its level, or the max active log level may have changed.
 
         // _mutexInstance() must be used internally whenever referencing these variables:
-        volatile static int     gMaxActiveLevel;    ///< The max level of any registered logger. Used to optimize the VLOGGER macros so they can return early if a log statement won't pass level filters.
+        static std::atomic<int> gMaxActiveLevel;    ///< The max level of any registered logger. Used to optimize the VLOGGER_NAMED macros so they can return early if a log statement won't pass level filters. Read without locking.
+        static std::atomic<int> gDefaultLogLevel;   ///< The level the default logger would log at, capped by gMaxActiveLevel. Used the same way by the VLOGGER macros. Read without locking.
         static VNamedLoggerPtr  gDefaultLogger;     ///< The default logger that is logged to by the simple VLOGGER macros and by the VLOGGER_NAMED macros if the named logger is not found. Created on first reference if needed.
         static VLogAppenderPtr  gDefaultAppender;   ///< The default appender that is emitted to by a logger if the logger has no appender specified. A VCoutAppender is created on first reference if needed.
         static VFSNode          gBaseLogDirectory;  ///< The directory within which any file-oriented loggers should write all their data.
+        static std::atomic<int> gConfigurationGeneration; ///< Advanced whenever a change to the loggers could change what a name resolves to; read without locking by VNamedLoggerCache.
 
         friend class VLoggerUnit;  // unit tests directly examine our state
+        friend class VNamedLoggerCache; // it reads gConfigurationGeneration and resolves names through _findNamedOrDefaultLogger
         friend bool VNamedLogger::isDefaultLogger() const;
         friend bool VLogAppender::isDefaultAppender() const;
 
@@ -1004,6 +1271,55 @@ class VLogger {
 #endif /* VLOGGER_INTERNAL_DEBUGGING */
 };
 
+/**
+VNamedLoggerCache remembers which logger a name resolved to, so that a VLOGGER_NAMED_* call site
+can find its logger again without taking the VLogger mutex or walking the dotted path hierarchy.
+Each macro call site has its own thread_local instance, so in the steady state a lookup is a
+single atomic load of VLogger's configuration generation plus a comparison with the name last
+resolved. The instance holds only a raw pointer to the logger, because a thread that never logs
+from the call site again must not keep the logger alive; instead VLogger keeps every logger that
+a cache has resolved to alive until VLogger::shutdown() (see VLogger::deregisterLogger()).
+Registering or deregistering a logger, or changing the default logger, advances the generation,
+which makes every cache resolve its name again (under the mutex) on its next use. Changing a
+logger's level does not, because the level is checked on each lookup.
+*/
+class VNamedLoggerCache {
+    public:
+
+        VNamedLoggerCache() : mGeneration(-1), mName(), mLogger(NULL) {}
+        ~VNamedLoggerCache() {}
+
+        /**
+        Returns the logger that the name resolves to, if it is active for the specified level; null
+        otherwise. Like VLogger::findNamedLoggerForLevel(), if no logger matches the name, the default
+        logger is used. The result is owned by VLogger and valid until VLogger::shutdown().
+        @param  name    the name of the logger to find
+        @param  level   the level to check as active for the found logger
+        @return a logger (@ Nullable)
+        */
+        VNamedLogger* findLoggerForLevel(const VString& name, int level);
+
+    private:
+
+        VNamedLoggerCache(const VNamedLoggerCache&); // not copyable
+        VNamedLoggerCache& operator=(const VNamedLoggerCache&); // not assignable
+
+        VNamedLogger* _getLoggerForLevel(int level) const { return ((mLogger != NULL) && mLogger->isEnabledFor(level)) ? mLogger : NULL; } ///< Applies the level check to the cached logger.
+
+        int             mGeneration;    ///< VLogger's configuration generation when mLogger was resolved; -1 before the first lookup.
+        VString         mName;          ///< The name mLogger was resolved from.
+        VNamedLogger*   mLogger;        ///< The logger the name resolved to, which may be the default logger; kept alive by VLogger.
+};
+
+inline VNamedLogger* VNamedLoggerCache::findLoggerForLevel(const VString& name, int level) {
+    if ((mGeneration != VLogger::gConfigurationGeneration.load(std::memory_order_acquire)) || (mName != name)) {
+        mGeneration = VLogger::_findNamedOrDefaultLogger(name, mLogger);
+        mName = name;
+    }
+
+    return this->_getLoggerForLevel(level);
+}
+
 /**
 An appender that emits to the console using the std::cout stream.
 It defines no additional settings properties.
@@ -1032,6 +1348,7 @@ class VFileLogAppender : public VLogAppender {
         virtual void addInfo(VBentoNode& infoNode) const;
     protected:
         virtual void _emitRawLine(const VString& line);
+        virtual void _emitRawLines(const VStringVector& lines);
     private:
         void _openFile(); // constructor helper
         VBufferedFileStream mFileStream;    ///< The underlying file stream we open and write to.
@@ -1039,24 +1356,170 @@ class VFileLogAppender : public VLogAppender {
 };
 
 /**
-Not yet implemented. An appender that emits to rolling log files.
-It will define several properties to control the limits on log file size
-and the lifecycle for cleaning up "old" files. I plan to define a class
-that has a global housekeeping object which all rolling file appenders register with,
-to indicate their file patterns, directories, lifetimes, and currently in use file.
-The housekeeper task will periodically remove sufficiently old files as long as they
-are not currently in use. Another approach might be to only fire a cleaning job upon
-rollover, since although a file can become old due to the passing of time, if no rollover
-occurs then there is no growth in the number of files on disk.
+An appender that emits to a series of files, starting a new file when the current one reaches a size
+limit or has been written for a time limit, and deleting the oldest files beyond a count. The files
+are named "<prefix>.<sequence>.log", where the sequence number (six digits or more) continues from
+the highest one already in the directory, so a restart never overwrites earlier output.
+
+A helper thread owned by the appender opens the next file before it is needed, closes each file
+after the appender has moved on from it, and deletes old files. Starting a new file therefore only
+swaps which open file is written to; the logging thread opens a file itself only in the unlikely
+case that the helper has not yet prepared one. The prepared file exists on disk, empty, until it is
+used; it is removed when the appender is destructed. If the logging thread does have to open a file
+while the helper is still preparing one, the helper's file is removed unused, so its sequence number
+is skipped: numbers always increase but may have gaps.
+
+It defines the following additional properties:
+- "dir" (string)
+  Defaults to the base log directory. The directory to write the files in; it is created if needed.
+- "prefix" (string)
+  Defaults to the appender name. The first part of each file name.
+- "max-size" (int)
+  Defaults to 10485760 (10 MB). A new file is started rather than let the current one grow beyond
+  this many bytes; a single longer line still gets a file of its own. 0 means no size limit.
+- "roll-interval" (duration string such as "1d")
+  Defaults to infinity ("INFINITY"), meaning no time limit. A new file is started for the first
+  line written after the current file has been in use this long.
+- "max-archives" (int)
+  Defaults to 10. The number of earlier files to keep; -1 keeps them all.
 */
 class VRollingFileLogAppender : public VLogAppender {
     public:
-        VRollingFileLogAppender(const VString& name, bool formatOutput, const VString& formatSpec, const VString& timeFormat, const VString& dirPath, const VString& fileNamePrefix, int maxNumLines);
+
+        static const Vs64 kDefaultMaxFileSize = CONST_S64(10485760);    ///< The default "max-size".
+        static const int kDefaultMaxNumArchives = 10;                   ///< The default "max-archives".
+
+        VRollingFileLogAppender(const VString& name, bool formatOutput, const VString& formatSpec, const VString& timeFormat, const VString& dirPath, const VString& fileNamePrefix, Vs64 maxFileSize = kDefaultMaxFileSize, const VDuration& rollInterval = VDuration::POSITIVE_INFINITY(), int maxNumArchives = kDefaultMaxNumArchives);
         VRollingFileLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults);
-        virtual ~VRollingFileLogAppender() {}
+        virtual ~VRollingFileLogAppender();
         virtual void addInfo(VBentoNode& infoNode) const;
+
+        /**
+        Starts a new file now, regardless of the limits.
+        */
+        void roll();
+        /**
+        Returns the file currently being written.
+        @return the file's node
+        */
+        VFSNode getCurrentFileNode() const;
+
+    protected:
+        virtual void _emitRawLine(const VString& line);
+        virtual void _emitRawLines(const VStringVector& lines);
+
+    private:
+
+        VRollingFileLogAppender(const VRollingFileLogAppender&); // not copyable
+        VRollingFileLogAppender& operator=(const VRollingFileLogAppender&); // not assignable
+
+        void _init(); // constructor helper
+        void _writeLine(const VString& line);       ///< Writes one line, first starting a new file if a limit would be passed; the caller must hold mMutex and flush afterwards.
+        void _roll();                               ///< Swaps in the next file and hands the current one to the helper thread; the caller must hold mMutex.
+        VRollingLogFile* _openLogFile(int sequence) const;  ///< Creates and opens the file with the specified sequence number. @return the open file
+        static void _removeUnusedLogFile(VRollingLogFile* file); ///< Closes and deletes a prepared file that was never written to.
+        void _deleteOldFiles() const;               ///< Deletes the earlier files beyond mMaxNumArchives.
+        bool _parseSequence(const VString& fileName, int& sequence) const;  ///< Recognizes one of our file names. @return true if it is one, with its sequence number
+        void _runWorker();                          ///< The helper thread's main loop.
+
+        VFSNode                         mDirectory;         ///< The directory the files are written in.
+        VString                         mFileNamePrefix;    ///< The first part of each file name.
+        Vs64                            mMaxFileSize;       ///< The size limit, or 0 for none.
+        VDuration                       mRollInterval;      ///< The time limit, or positive infinity for none.
+        int                             mMaxNumArchives;    ///< The number of earlier files to keep, or -1 for all.
+        int                             mLineEndingLength;  ///< The number of bytes each line ending adds to a file.
+        VRollingLogFile*                mCurrentFile;       ///< The file being written; guarded by mMutex.
+        Vs64                            mCurrentFileSize;   ///< The bytes written to mCurrentFile; guarded by mMutex.
+        VInstant                        mRollTime;          ///< When mCurrentFile reaches the time limit; guarded by mMutex.
+        std::atomic<int>                mCurrentSequence;   ///< mCurrentFile's sequence number, for the helper thread.
+        VMutex                          mHousekeepingMutex; ///< Guards the state shared with the helper thread, below.
+        VRollingLogFile*                mNextFile;          ///< The file prepared to be written next, or NULL.
+        int                             mNextSequence;      ///< The sequence number for the next file opened.
+        std::vector<VRollingLogFile*>   mRetiredFiles;      ///< Files moved on from, for the helper thread to close.
+        std::atomic<bool>               mIsStopped;         ///< Set by the destructor to end the helper thread.
+        VLogAppenderWorkerThread<VRollingFileLogAppender>* mWorkerThread; ///< The helper thread.
+
+        template <class APPENDER> friend class VLogAppenderWorkerThread; // its run() calls our _runWorker()
+};
+
+/**
+An appender for high-volume output that writes into a memory-mapped file, so that writing a line is
+a copy into memory rather than a write call on the file. The file is mapped in fixed-size segments.
+When the current segment fills, writing continues in the next one, which a helper thread owned by
+the appender has already added to the end of the file and mapped. The helper thread also starts
+writing the data out to disk on a schedule, and syncs and unmaps each segment that has been filled.
+
+Like VFileLogAppender, it appends to any existing file. The part of the current segment not yet
+written reads as zero bytes; the destructor truncates the file to the data written. If the process
+ends without that, for example in a crash, the zero tail remains until the next appender for the
+file finds the end of the data and truncates the tail, so appended output follows on without a gap.
+
+Each segment's disk blocks are reserved when it is added to the file (see VMemoryMappedFile::setSize()),
+so a full disk is reported as a VException from the logging call that needs the segment. A write to
+a mapped segment can still raise SIGBUS if something else truncates the file while it is mapped.
+
+It defines the following additional properties:
+- "path" (string)
+  Defaults to "<appendername>.log" in the base log directory. Specifies the file path for the log file.
+- "segment-size" (int)
+  Defaults to 16777216 (16 MB). The size of each mapped segment, rounded up to a multiple of
+  VMemoryMappedFile::getGranularity().
+- "sync-interval" (duration string such as "1s")
+  Defaults to 1 second. How often the helper thread starts writing the current segment out to disk.
+*/
+class VMappedFileLogAppender : public VLogAppender {
+    public:
+
+        static const Vs64 kDefaultSegmentSize = CONST_S64(16777216);   ///< The default "segment-size".
+
+        VMappedFileLogAppender(const VString& name, bool formatOutput, const VString& formatSpec, const VString& timeFormat, const VString& filePath, Vs64 segmentSize = kDefaultSegmentSize, const VDuration& syncInterval = VDuration::SECOND());
+        VMappedFileLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults);
+        virtual ~VMappedFileLogAppender();
+        virtual void addInfo(VBentoNode& infoNode) const;
+
+        /**
+        Writes everything emitted so far out to disk, and waits until it is done.
+        */
+        void sync();
+        /**
+        Returns the number of bytes of log data in the file, which is where the next line will be written.
+        @return obvious
+        */
+        Vs64 getDataLength() const;
+
     protected:
         virtual void _emitRawLine(const VString& line);
+        virtual void _emitRawLines(const VStringVector& lines);
+
+    private:
+
+        VMappedFileLogAppender(const VMappedFileLogAppender&); // not copyable
+        VMappedFileLogAppender& operator=(const VMappedFileLogAppender&); // not assignable
+
+        void _init(); // constructor helper
+        Vs64 _findDataLength(); // constructor helper: finds the end of any data already in the file, before its zero tail
+        void _writeLine(const VString& line);               ///< Copies a line and line ending into the mapping; the caller must hold mMutex.
+        void _write(const Vu8* data, Vs64 length);          ///< Copies bytes into the mapping, moving to the next segment as each fills; the caller must hold mMutex.
+        void _advanceSegment();                             ///< Swaps in the next segment and hands the current one to the helper thread; the caller must hold mMutex.
+        VMappedLogSegment* _mapNextSegment();               ///< Extends the file by a segment and maps it; the caller must hold mHousekeepingMutex. @return the segment
+        void _runWorker();                                  ///< The helper thread's main loop.
+
+        VMemoryMappedFile                   mFile;              ///< The file.
+        Vs64                                mSegmentSize;       ///< The size of each segment.
+        VDuration                           mSyncInterval;      ///< How often the helper thread starts writing out the current segment.
+        const Vu8*                          mLineEnding;        ///< The native line ending bytes.
+        int                                 mLineEndingLength;  ///< The number of bytes in mLineEnding.
+        VMappedLogSegment*                  mCurrentSegment;    ///< The segment being written; guarded by mMutex, and changed only with mHousekeepingMutex also held.
+        Vs64                                mWriteOffset;       ///< The offset in mCurrentSegment where the next byte will be written; guarded by mMutex.
+        VMutex                              mHousekeepingMutex; ///< Guards the state shared with the helper thread, below.
+        VMappedLogSegment*                  mNextSegment;       ///< The segment prepared to be written next, or NULL.
+        Vs64                                mNextSegmentOffset; ///< The file offset at which the next segment will be mapped.
+        std::vector<VMappedLogSegment*>     mRetiredSegments;   ///< Filled segments, for the helper thread to sync and unmap.
+        VMutex                              mRetiringMutex;     ///< Held by the helper thread while it syncs and unmaps filled segments, so that sync() can wait for it.
+        std::atomic<bool>                   mIsStopped;         ///< Set by the destructor to end the helper thread.
+        VLogAppenderWorkerThread<VMappedFileLogAppender>* mWorkerThread; ///< The helper thread.
+
+        template <class APPENDER> friend class VLogAppenderWorkerThread; // its run() calls our _runWorker()
 };
 
 /**
@@ -1087,13 +1550,16 @@ class VStringLogAppender : public VLogAppender {
         virtual void addInfo(VBentoNode& infoNode) const;
 
         VMutex& getMutex() { return mMutex; }
-        const VString& getLines() const { return mLines; }
-        const char* orphanLines() { return mLines.orphanDataBuffer(); }
+        const VString& getLines() const;
+        const char* orphanLines();
 
     protected:
         virtual void _emitRawLine(const VString& line);
     private:
-        VString mLines;
+        void _gatherLines() const; ///< Moves mPendingLines onto the end of mLines; the caller must hold mMutex.
+
+        mutable VStringBuilder  mPendingLines;  ///< Lines emitted since getLines() was last called; appending to a builder keeps a long capture from recopying itself per line.
+        mutable VString         mLines;         ///< The lines gathered by getLines().
 };
 
 /**
@@ -1119,6 +1585,197 @@ class VStringVectorLogAppender : public VLogAppender {
         VStringVector mLines;
 };
 
+/**
+An appender that captures emitted lines in memory, like VStringVectorLogAppender, for tests
+that log from many threads at once. Each thread that emits to it appends to its own buffer, so
+logging threads do not wait for each other as they would on a single shared list. Each line
+is stamped with a sequence number from one counter shared by all threads; getLines() and
+getText() merge the buffers by sequence number, so the lines come back in the order they were
+emitted. A line still being emitted when they are called may be left out.
+
+Like the other capture appenders, it keeps everything until clear(), so it is meant for
+output of limited duration.
+It defines no additional settings properties.
+*/
+class VCaptureLogAppender : public VLogAppender {
+    public:
+        VCaptureLogAppender(const VString& name, bool formatOutput, const VString& formatSpec, const VString& timeFormat);
+        VCaptureLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults);
+        virtual ~VCaptureLogAppender();
+        virtual void addInfo(VBentoNode& infoNode) const;
+
+        virtual void emit(int level, const char* file, int line, bool emitMessage, const VString& message, const VString& specifiedLoggerName, const VString& actualLoggerName, bool emitRawLine, const VString& rawLine);
+
+        /**
+        Returns the captured lines in the order they were emitted.
+        @param  lines   the vector to which the lines are appended
+        */
+        void getLines(VStringVector& lines) const;
+        /**
+        Returns the captured lines in the order they were emitted, each followed by a native
+        line ending, as VStringLogAppender::getLines() does.
+        @return the text
+        */
+        VString getText() const;
+        /**
+        Returns the number of lines captured.
+        @return obvious
+        */
+        int getNumLines() const;
+        /**
+        Discards the captured lines.
+        */
+        void clear();
+
+    protected:
+
+        virtual void _emitRawLine(const VString& line); ///< Appends the line to the calling thread's buffer; emit() and the inherited _emitRawLines() (used by VAsyncLogAppender) come here.
+
+    private:
+
+        VCaptureLogAppender(const VCaptureLogAppender&); // not copyable
+        VCaptureLogAppender& operator=(const VCaptureLogAppender&); // not assignable
+
+        VCaptureLogBuffer* _getThreadBuffer(); ///< Returns the calling thread's buffer, creating it on the thread's first emit.
+
+        const Vu64                          mID;            ///< Identifies this appender in the threads' buffer caches; never reused.
+        std::atomic<Vs64>                   mNextSequence;  ///< The sequence number for the next line emitted by any thread.
+        mutable VMutex                      mBuffersMutex;  ///< Guards mBuffers; taken only when a thread creates its buffer, and to read or clear.
+        std::vector<VCaptureLogBuffer*>     mBuffers;       ///< The threads' buffers, which we own.
+};
+
+/**
+An appender that decorates another appender (the "target") so that logging threads do not wait
+for its output medium. A logging thread formats the message using the target's format settings,
+which captures the time stamp and thread name where the message was logged, and places the
+result in a fixed-size queue. A writer thread owned by this appender takes the queued lines in
+order and hands them to the target in batches, so a file target is flushed once per batch
+rather than once per line.
+
+Adding to the queue takes no lock; each slot carries a sequence number that tells a logging
+thread whether the slot is free and tells the writer whether it has been filled. The writer
+wakes when a batch's worth of lines is waiting or when the flush interval has passed, whichever
+comes first.
+
+When the queue is full, the overflow policy decides what happens to a new message: the logging
+thread can wait for room, or the message can be dropped. Dropped messages are counted, and the
+writer notes the count in the output the next time it writes.
+
+stop() writes out everything queued and ends the writer thread; after that, messages are written
+to the target directly. A message whose emit() was already under way when stop() ran is written
+by that emit() call itself once it sees the appender has stopped. stop() is called by the destructor,
+and for every async appender still alive when the VShutdownRegistry shuts down, so queued output
+is not lost at exit.
+
+It defines the following additional properties:
+- "target" (string)
+  Required. The name of a previously configured appender to write to. Configure the target
+  before the async appender, and do not also route loggers to the target directly if the
+  order of lines in its output matters.
+- "capacity" (int)
+  Defaults to 8192. The number of messages the queue can hold; it is rounded up to a power of two.
+- "batch-size" (int)
+  Defaults to 256. The writer is woken as soon as this many messages are waiting, and writes at
+  most this many to the target at a time.
+- "flush-interval" (duration string such as "100ms")
+  Defaults to 100 milliseconds. The longest a message waits in the queue when fewer than
+  "batch-size" messages are waiting.
+- "overflow" (string)
+  Defaults to "block". What to do with a message when the queue is full: "block" waits for room;
+  "drop" drops the message; "drop-below" drops it if it is less severe than "overflow-level" and
+  otherwise waits for room.
+- "overflow-level" (level name or int)
+  Defaults to WARN. For the "drop-below" policy, the least severe level that still waits for room.
+*/
+class VAsyncLogAppender : public VLogAppender {
+    public:
+
+        /** What emit() does when the queue is full. */
+        enum OverflowPolicy {
+            kBlockWhenFull,         ///< Wait for the writer to make room.
+            kDropWhenFull,          ///< Drop the message and count it.
+            kDropBelowLevelWhenFull ///< Drop and count the message if its level is less severe than the overflow level; otherwise wait.
+        };
+
+        static const int kDefaultCapacity = 8192;   ///< The default number of queue slots.
+        static const int kDefaultBatchSize = 256;   ///< The default number of lines handed to the target at a time.
+
+        /**
+        Constructs the appender and starts its writer thread.
+        @param  name            the name of this appender
+        @param  target          the appender to write to
+        @param  capacity        the number of messages the queue can hold; rounded up to a power of two
+        @param  batchSize       the number of waiting messages that wakes the writer, and the most it writes at a time
+        @param  flushInterval   the longest a message waits in the queue when fewer than batchSize are waiting
+        @param  overflowPolicy  what to do with a message when the queue is full
+        @param  overflowLevel   for kDropBelowLevelWhenFull, the least severe level that still waits for room
+        */
+        VAsyncLogAppender(const VString& name, VLogAppenderPtr target, int capacity = kDefaultCapacity, int batchSize = kDefaultBatchSize, const VDuration& flushInterval = 100 * VDuration::MILLISECOND(), OverflowPolicy overflowPolicy = kBlockWhenFull, int overflowLevel = VLoggerLevel::WARN);
+        VAsyncLogAppender(const VSettingsNode& settings, const VSettingsNode& defaults);
+        virtual ~VAsyncLogAppender();
+        virtual void addInfo(VBentoNode& infoNode) const;
+
+        /**
+        Formats the message and raw line on the calling thread and queues them for the writer.
+        The two are queued as one entry, so that no other thread's output comes between them.
+        */
+        virtual void emit(int level, const char* file, int line, bool emitMessage, const VString& message, const VString& specifiedLoggerName, const VString& actualLoggerName, bool emitRawLine, const VString& rawLine);
+
+        /**
+        Writes everything queued so far to the target before returning.
+        */
+        void flush();
+        /**
+        Writes everything queued so far to the target and ends the writer thread. Messages emitted
+        afterwards are written to the target directly. Calling it again does nothing.
+        */
+        void stop();
+
+        VLogAppenderPtr getTarget() const { return mTarget; }           ///< Returns the appender this one writes to. @return obvious
+        Vs64 getNumDropped() const { return mNumDropped.load(); }       ///< Returns the number of messages dropped because the queue was full. @return obvious
+
+    private:
+
+        VAsyncLogAppender(const VAsyncLogAppender&); // not copyable
+        VAsyncLogAppender& operator=(const VAsyncLogAppender&); // not assignable
+
+        /** One queue slot, holding the lines from one call to emit(). */
+        struct Slot {
+            std::atomic<Vu64>   mSequence;          ///< Equals the enqueue position that may fill the slot when it is free, and that position plus one once it is filled.
+            VString             mMessageLine;       ///< The formatted message, if mHasMessageLine.
+            VString             mRawLine;           ///< The raw line, if mHasRawLine.
+            bool                mHasMessageLine;    ///< True if the entry includes a message.
+            bool                mHasRawLine;        ///< True if the entry includes a raw line.
+        };
+
+        void _init(); // constructor helper
+        bool _tryEnqueue(bool hasMessageLine, VString& messageLine, bool hasRawLine, VString& rawLine);    ///< Moves the lines into a free slot. @return false if the queue is full
+        bool _shouldDropWhenFull(int level) const;  ///< Applies the overflow policy. @return true to drop, false to wait
+        void _emitDirectly(bool hasMessageLine, const VString& messageLine, bool hasRawLine, const VString& rawLine);  ///< Writes to the target after the writer has stopped.
+        void _drain();          ///< Writes all filled slots to the target, in batches; the caller must hold mDrainMutex.
+        void _writeBatch(VStringVector& batch);    ///< Hands a batch to the target with the target's mutex locked, then empties it.
+        void _runWorker();      ///< The writer thread's main loop.
+
+        static OverflowPolicy _overflowPolicyFromString(const VString& s);
+
+        VLogAppenderPtr     mTarget;            ///< The appender we write to.
+        Slot*               mSlots;             ///< The queue, mCapacity slots.
+        int                 mCapacity;          ///< The number of slots; a power of two.
+        int                 mBatchSize;         ///< The number of waiting entries that wakes the writer, and the most written per batch.
+        VDuration           mFlushInterval;     ///< The writer's longest sleep.
+        OverflowPolicy      mOverflowPolicy;    ///< What emit() does when the queue is full.
+        int                 mOverflowLevel;     ///< For kDropBelowLevelWhenFull, the least severe level that waits.
+        std::atomic<Vu64>   mEnqueuePosition;   ///< The position the next entry will be queued at.
+        Vu64                mDequeuePosition;   ///< The position of the next entry to write; guarded by mDrainMutex.
+        std::atomic<Vs64>   mNumDropped;        ///< The number of entries dropped because the queue was full.
+        Vs64                mNumDroppedReported;///< The drop count the writer last noted in the output; guarded by mDrainMutex.
+        std::atomic<bool>   mIsStopped;         ///< True once stop() has ended the writer.
+        VMutex              mDrainMutex;        ///< Held by whichever thread is taking entries from the queue.
+        VLogAppenderWorkerThread<VAsyncLogAppender>* mWriterThread; ///< The writer thread; it stays allocated after stop(), until we are destructed.
+
+        template <class APPENDER> friend class VLogAppenderWorkerThread; // its run() calls our _runWorker()
+};
+
 /**
 A special logger subclass meant to be declared on the stack (not "registered") and explicitly logged
 to, which uses an embedded VStringLogAppender to capture the emitted messages to a multi-line string.
@@ -0,0 +1,108 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+/** @file */
+
+/*
+vbinarylogdecoder prints the contents of files written by VBinaryLogAppender as text log lines.
+
+    vbinarylogdecoder [-utc] file...
+
+Time stamps are shown in local time unless -utc is given.
+*/
+
+#include "vbinarylog.h"
+#include "vexception.h"
+#include "vthread.h"
+#include "vshutdownregistry.h"
+
+class App {
+    public:
+
+        App(int argc, char** argv);
+        ~App();
+        void run();
+
+        int getResult() { return mResult; }
+
+    private:
+
+        App(const App&); // not copyable
+        App& operator=(const App&); // not assignable
+
+        void _decodeFile(const VString& path);
+
+        VStringVector mPaths;
+        bool          mUseUTC;
+        int           mResult;
+};
+
+App::App(int argc, char** argv) :
+    mPaths(),
+    mUseUTC(false),
+    mResult(0) {
+    for (int i = 1; i < argc; ++i) { // Omit argc[0] which is just the application name, not really an arg to be processed.
+        VString arg(argv[i]);
+        if (arg == "-utc") {
+            mUseUTC = true;
+        } else {
+            mPaths.push_back(arg);
+        }
+    }
+}
+
+App::~App() {
+}
+
+void App::run() {
+    if (mPaths.empty()) {
+        std::cerr << "usage: vbinarylogdecoder [-utc] file..." << std::endl;
+        mResult = -1;
+        return;
+    }
+
+    for (VStringVector::const_iterator i = mPaths.begin(); i != mPaths.end(); ++i) {
+        this->_decodeFile(*i);
+    }
+}
+
+void App::_decodeFile(const VString& path) {
+    VBufferedFileStream file((VFSNode(path)));
+    file.openReadOnly();
+
+    VBinaryLogReader reader(file);
+    VBinaryLogEvent event;
+    while (reader.readEvent(event)) {
+        std::cout << reader.formatEvent(event, mUseUTC).chars() << "\n";
+    }
+
+    std::cout.flush();
+}
+
+// static
+int VThread::userMain(int argc, char** argv) {
+    int    result = -1;
+    App    app(argc, argv);
+
+    try {
+        app.run();
+        result = app.getResult();
+    } catch (const VException& ex) {
+        std::cerr << "ERROR: Caught VException (" << ex.getError() << "): '" << ex.what() << "'\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "ERROR: Caught STL exception: '" << ex.what() << "'\n";
+    }
+
+    VShutdownRegistry::shutdown();
+
+    return result;
+}
+
+int main(int argc, char** argv) {
+    VMainThread mainThread;
+    return mainThread.execute(argc, argv);
+}
@@ -0,0 +1,213 @@
+/*
+Copyright c1997-2014 Trygve Isaacson. All rights reserved.
+This file is part of the Code Vault version 4.1
+http://www.bombaydigital.com/
+License: MIT. See LICENSE.md in the Vault top level directory.
+*/
+
+/** @file */
+
+/*
+vlogbenchmark measures the cost of emitting a log line to each of the file-based appenders.
+
+    vlogbenchmark [-lines n] [-threads n] [-dir path]
+
+Each appender writes the same lines to a new file in the directory (default "vlogbenchmark"),
+from the given number of threads at once, in two passes: first messages that the appender
+formats with a time stamp and level, then raw lines that it writes as is, which shows the cost
+of the write itself. The result is the elapsed time divided by the total number of lines. The
+files are removed afterward. For comparison, a VBinaryLogAppender is given the same messages
+through VLOGGER_BINARY, which leaves the formatting to whoever decodes the file.
+*/
+
+#include "vlogger.h"
+#include "vbinarylog.h"
+#include "vexception.h"
+#include "vthread.h"
+#include "vshutdownregistry.h"
+
+class App {
+    public:
+
+        App(int argc, char** argv);
+        ~App();
+        void run();
+
+        int getResult() { return mResult; }
+
+    private:
+
+        App(const App&); // not copyable
+        App& operator=(const App&); // not assignable
+
+        void _runBenchmarks(const VString& label, VLogAppender& appender);
+        void _runBenchmark(const VString& label, VLogAppender& appender, int mode);
+
+        int     mNumLines;
+        int     mNumThreads;
+        VFSNode mDirectory;
+        int     mResult;
+};
+
+/**
+Emits its share of the benchmark's lines to an appender.
+*/
+class BenchmarkThread : public VThread {
+    public:
+
+        /** How each line is emitted. */
+        enum Mode {
+            kFormatted, ///< A message, formatted by the appender.
+            kRaw,       ///< A raw line.
+            kBinary     ///< The message's arguments, through VLOGGER_BINARY; the appender must be a VBinaryLogAppender.
+        };
+
+        BenchmarkThread(const VString& name, VLogAppender& appender, int numLines, int mode)
+            : VThread(name, "vlogbenchmark.BenchmarkThread", kDontDeleteSelfAtEnd, kCreateThreadJoinable, NULL)
+            , mAppender(appender)
+            , mNumLines(numLines)
+            , mMode(mode)
+            {}
+        virtual ~BenchmarkThread() {}
+
+        virtual void run() {
+            if (mMode == kBinary) {
+                VBinaryLogAppender& binaryAppender = static_cast<VBinaryLogAppender&>(mAppender);
+                for (int i = 0; i < mNumLines; ++i) {
+                    VLOGGER_BINARY(binaryAppender, VLoggerLevel::INFO, "Request {} completed: status=OK bytes={} client=10.0.0.{}", i, i * 7, i % 256);
+                }
+
+                return;
+            }
+
+            if (mMode == kRaw) {
+                VString line("2014-01-01 12:00:00.000 INFO | Request 12345 completed: status=OK bytes=86415 client=10.0.0.57");
+                for (int i = 0; i < mNumLines; ++i) {
+                    mAppender.emitRaw(line);
+                }
+
+                return;
+            }
+
+            VString message;
+            for (int i = 0; i < mNumLines; ++i) {
+                message.format("Request %d completed: status=OK bytes=%d client=10.0.0.%d", i, i * 7, i % 256);
+                VLOGGER_APPENDER_EMIT(mAppender, VLoggerLevel::INFO, message);
+            }
+        }
+
+    private:
+        BenchmarkThread(const BenchmarkThread&); // not copyable
+        BenchmarkThread& operator=(const BenchmarkThread&); // not assignable
+
+        VLogAppender&   mAppender;
+        int             mNumLines;
+        int             mMode;
+};
+
+App::App(int argc, char** argv) :
+    mNumLines(1000000),
+    mNumThreads(1),
+    mDirectory("vlogbenchmark"),
+    mResult(0) {
+    for (int i = 1; i < argc; ++i) { // Omit argc[0] which is just the application name, not really an arg to be processed.
+        VString arg(argv[i]);
+        if ((arg == "-lines") && (i + 1 < argc)) {
+            mNumLines = VString(argv[++i]).parseInt();
+        } else if ((arg == "-threads") && (i + 1 < argc)) {
+            mNumThreads = VString(argv[++i]).parseInt();
+        } else if ((arg == "-dir") && (i + 1 < argc)) {
+            mDirectory.setPath(argv[++i]);
+        } else {
+            mNumLines = 0; // show usage
+        }
+    }
+}
+
+App::~App() {
+}
+
+void App::run() {
+    if ((mNumLines <= 0) || (mNumThreads <= 0)) {
+        std::cerr << "usage: vlogbenchmark [-lines n] [-threads n] [-dir path]" << std::endl;
+        mResult = -1;
+        return;
+    }
+
+    (void) mDirectory.rm();
+    mDirectory.mkdirs();
+
+    std::cout << mNumLines << " lines from " << mNumThreads << " thread(s)" << std::endl;
+
+    /* appender scope */ {
+        VFileLogAppender appender("file", VLogAppender::DO_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY(), VFSNode(mDirectory, "file.log").getPath());
+        this->_runBenchmarks("VFileLogAppender", appender);
+    }
+
+    /* appender scope */ {
+        VRollingFileLogAppender appender("rolling", VLogAppender::DO_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY(), mDirectory.getPath(), "rolling", CONST_S64(1073741824), VDuration::POSITIVE_INFINITY(), 1);
+        this->_runBenchmarks("VRollingFileLogAppender", appender);
+    }
+
+    /* appender scope */ {
+        VMappedFileLogAppender appender("mapped", VLogAppender::DO_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY(), VFSNode(mDirectory, "mapped.log").getPath());
+        this->_runBenchmarks("VMappedFileLogAppender", appender);
+    }
+
+    /* appender scope */ {
+        VBinaryLogAppender appender("binary", VFSNode(mDirectory, "binary.vblog").getPath());
+        this->_runBenchmark("VBinaryLogAppender binary", appender, BenchmarkThread::kBinary);
+    }
+
+    (void) mDirectory.rm();
+}
+
+void App::_runBenchmarks(const VString& label, VLogAppender& appender) {
+    this->_runBenchmark(label + " formatted", appender, BenchmarkThread::kFormatted);
+    this->_runBenchmark(label + " raw", appender, BenchmarkThread::kRaw);
+}
+
+void App::_runBenchmark(const VString& label, VLogAppender& appender, int mode) {
+    std::vector<BenchmarkThread*> threads;
+    for (int i = 0; i < mNumThreads; ++i) {
+        threads.push_back(new BenchmarkThread(VSTRING_FORMAT("benchmark.%d", i), appender, mNumLines / mNumThreads, mode));
+    }
+
+    Vs64 start = VInstant::snapshot();
+    for (std::vector<BenchmarkThread*>::const_iterator i = threads.begin(); i != threads.end(); ++i) {
+        (*i)->start();
+    }
+
+    for (std::vector<BenchmarkThread*>::const_iterator i = threads.begin(); i != threads.end(); ++i) {
+        (void) (*i)->join();
+        delete *i;
+    }
+
+    VDuration elapsed = VInstant::snapshotDelta(start);
+    Vs64 numLines = (mNumLines / mNumThreads) * mNumThreads;
+    std::cout << VSTRING_FORMAT("%-34s " VSTRING_FORMATTER_S64 " ms %8.1f ns/line", label.chars(), elapsed.getDurationMilliseconds(), (elapsed.getDurationMilliseconds() * 1000000.0) / numLines).chars() << std::endl;
+}
+
+// static
+int VThread::userMain(int argc, char** argv) {
+    int    result = -1;
+    App    app(argc, argv);
+
+    try {
+        app.run();
+        result = app.getResult();
+    } catch (const VException& ex) {
+        std::cerr << "ERROR: Caught VException (" << ex.getError() << "): '" << ex.what() << "'\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "ERROR: Caught STL exception: '" << ex.what() << "'\n";
+    }
+
+    VShutdownRegistry::shutdown();
+
+    return result;
+}
+
+int main(int argc, char** argv) {
+    VMainThread mainThread;
+    return mainThread.execute(argc, argv);
+}
@@ -11,6 +11,8 @@ License: MIT. See LICENSE.md in the Vault top level directory.
 #include "vbento.h"
 #include "vexception.h"
 #include "vchar.h"
+#include "vwritebufferedstream.h"
+#include "vbufferedfilestream.h"
 
 VBentoUnit::VBentoUnit(bool logOnSuccess, bool throwOnError) :
     VUnit("VBentoUnit", logOnSuccess, throwOnError) {
@@ -71,7 +73,7 @@ VBentoUnit::VBentoUnit(bool logOnSuccess, bool throwOnError) :
 #define ATTRIBUTE_NAME_INSTANT_ARRAY "instant-array-attribute"
 
 static const VFloat kTestFloatValue = 3.14f;
-static const VDouble kTestDoubleValue = 3.14159; // note: use of more than 6 decimal places here will cause the text i/o conversion test to fail because only 6 decimal places are written out
+static const VDouble kTestDoubleValue = 3.14159;
 static const VDuration kTestDurationValue = VDuration::MILLISECOND() * 42;
 static const VDateAndTime kTestDateAndTimeValue = VDateAndTime(2007, 04, 20, 7, 56, 23, 986);
 static VInstant gTestInstantValue;
@@ -129,6 +131,52 @@ static VInstant gInstantNoon2005June1UTC;
 #define NODE_NAME_ASSIGNED_ARRAYS "assigned_arrays"
 #define NODE_NAME_APPENDED_ARRAYS "appended_arrays"
 
+// Writes an existing tree through a VBentoStreamWriter, one node and attribute at a time.
+static void _writeWithStreamWriter(VBentoStreamWriter& writer, const VBentoNode& node) {
+    writer.beginNode(node.getName());
+
+    const VBentoAttributePtrVector& attributes = node.getAttributes();
+    for (VBentoAttributePtrVector::const_iterator i = attributes.begin(); i != attributes.end(); ++i) {
+        writer.addAttribute(**i);
+    }
+
+    const VBentoNodePtrVector& children = node.getNodes();
+    for (VBentoNodePtrVector::const_iterator i = children.begin(); i != children.end(); ++i) {
+        _writeWithStreamWriter(writer, **i);
+    }
+
+    writer.endNode();
+}
+
+// Builds one of two versions of a state tree, for diff and patch tests. The updated version changes, adds,
+// and removes attributes and child nodes at several levels, and leaves the shared subtree untouched.
+static void _buildPatchTestState(VBentoNode& state, const VBentoNode& sharedSubtree, bool updated) {
+    state.addS32("version", updated ? 2 : 1);
+    if (!updated) {
+        state.addString("obsolete", "gone in the update");
+    }
+
+    state.addChildNode(new VBentoNode(sharedSubtree));
+
+    for (int i = 0; i < 100; ++i) {
+        if (updated && (i == 50)) {
+            continue;
+        }
+
+        VBentoNode* item = state.addNewChildNode("item");
+        item->addS32("id", i);
+        item->addString("label", (updated && (i == 7)) ? VString("item seven") : VSTRING_FORMAT("item %d", i));
+        if (updated && (i == 3)) {
+            item->addNewChildNode("detail")->addBool("flagged", true);
+        }
+    }
+
+    if (updated) {
+        state.addBool("added", true);
+        state.addNewChildNode("item")->addS32("id", 100);
+    }
+}
+
 void VBentoUnit::run() {
     this->_verifyDynamicLengths();
 
@@ -216,6 +264,342 @@ void VBentoUnit::run() {
         nodeWithEscapeCharsInName.writeToBentoTextString(escapedNodeText);
         // The node name should have escaped each of the special values. Verify that we got what we should:
         VUNIT_ASSERT_EQUAL(escapedNodeText, "{ \"1:\\\\\\\\ 2:\\{ 3:\\} 4:\\\\ 5:\\'\" }"); // Note: all those excess backslashes evaluate to this: { "1:\\\\ 2:\{ 3:\} 4:\\ 5:\'" }
+
+        // And the escaped text must parse back to the original name.
+        VBentoNode parsedNode;
+        parsedNode.readFromBentoTextString(escapedNodeText);
+        VUNIT_ASSERT_EQUAL(parsedNode.getName(), nodeWithEscapeCharsInName.getName());
+    }
+
+    /* subtest scope */ {
+        // The stream writer must produce exactly the bytes that writeToStream produces, whether it back-patches
+        // a memory stream in place or spools for a stream it cannot seek. Add a child big enough to need a
+        // multi-byte length indicator at several levels.
+        VBentoNode bigRoot(root);
+        VBentoNode* bigChild = new VBentoNode("big-child");
+        bigChild->addString("big-string", VString(VSTRING_FORMAT("%070000d", 42)));
+        bigChild->addChildNode(new VBentoNode("big-grandchild"));
+        bigRoot.addChildNode(bigChild);
+
+        VMemoryStream expectedBuffer;
+        VBinaryIOStream expectedStream(expectedBuffer);
+        bigRoot.writeToStream(expectedStream);
+
+        VMemoryStream inPlaceBuffer;
+        VBinaryIOStream inPlaceStream(inPlaceBuffer);
+        VBentoStreamWriter inPlaceWriter(inPlaceStream);
+        _writeWithStreamWriter(inPlaceWriter, bigRoot);
+        VUNIT_ASSERT_EQUAL(inPlaceWriter.getDepth(), 0);
+        VUNIT_ASSERT_TRUE(inPlaceBuffer == expectedBuffer);
+
+        VMemoryStream spooledBuffer;
+        VWriteBufferedStream unseekableStream(spooledBuffer);
+        VBinaryIOStream spooledStream(unseekableStream);
+        VBentoStreamWriter spoolingWriter(spooledStream);
+        _writeWithStreamWriter(spoolingWriter, bigRoot);
+        spooledStream.flush();
+        VUNIT_ASSERT_TRUE(spooledBuffer == expectedBuffer);
+
+        // A seekable file stream is back-patched by copying the tail back to front in chunks; the big
+        // string makes that tail several chunks long.
+        VFSNode seekableFile("vbentounit-stream-writer.vbn");
+        (void) seekableFile.rm();
+        /* file scope */ {
+            VBufferedFileStream seekableFileStream(seekableFile);
+            seekableFileStream.openReadWrite();
+            VBinaryIOStream seekableStream(seekableFileStream);
+            VBentoStreamWriter seekableWriter(seekableStream, true);
+            _writeWithStreamWriter(seekableWriter, bigRoot);
+            VUNIT_ASSERT_EQUAL(seekableWriter.getDepth(), 0);
+            seekableStream.flush();
+        }
+
+        VMemoryStream seekableBuffer;
+        /* file scope */ {
+            VBufferedFileStream seekableFileStream(seekableFile);
+            seekableFileStream.openReadOnly();
+            (void) VStream::streamCopy(seekableFileStream, seekableBuffer, seekableFile.size());
+        }
+
+        (void) seekableFile.rm();
+        VUNIT_ASSERT_TRUE(seekableBuffer == expectedBuffer);
+
+        (void) inPlaceStream.seek0();
+        VBentoNode readBack(inPlaceStream);
+        VUNIT_ASSERT_EQUAL(readBack.getName(), bigRoot.getName());
+        VUNIT_ASSERT_NOT_NULL(readBack.findNode("big-child"));
+
+        // Typed adders and addNode match the equivalent tree, and attributes may not follow a child node.
+        VBentoNode small("small");
+        small.addS32("s32", 32);
+        small.addString("string", "value");
+        small.addChildNode(new VBentoNode("child"));
+        VMemoryStream smallExpectedBuffer;
+        VBinaryIOStream smallExpectedStream(smallExpectedBuffer);
+        small.writeToStream(smallExpectedStream);
+
+        VMemoryStream smallBuffer;
+        VBinaryIOStream smallStream(smallBuffer);
+        VBentoStreamWriter smallWriter(smallStream);
+        smallWriter.beginNode("small");
+        smallWriter.addS32("s32", 32);
+        smallWriter.addString("string", "value");
+        smallWriter.addNode(VBentoNode("child"));
+        try {
+            smallWriter.addBool("late", true);
+            VUNIT_ASSERT_FAILURE("addBool after child node");
+        } catch (const VException& /*ex*/) {
+            VUNIT_ASSERT_SUCCESS("addBool after child node");
+        }
+        smallWriter.endNode();
+        VUNIT_ASSERT_TRUE(smallBuffer == smallExpectedBuffer);
+    }
+
+    /* subtest scope */ {
+        // A text stream over a memory buffer is parsed in place; verify it matches the string parse, and that the stream is consumed.
+        VString rootTextAgain;
+        rootFromText.writeToBentoTextString(rootTextAgain);
+        VUNIT_ASSERT_EQUAL(rootTextAgain, rootText);
+
+        VMemoryStream textBuffer;
+        VTextIOStream textStream(textBuffer);
+        textStream.writeString(rootText);
+        (void) textStream.seek0();
+        VBentoNode rootFromTextStream;
+        rootFromTextStream.readFromBentoTextStream(textStream);
+        this->_verifyContents(rootFromTextStream, "text stream");
+        VUNIT_ASSERT_EQUAL(textBuffer.getIOOffset(), textBuffer.getEOFOffset());
+    }
+
+    /* subtest scope */ {
+        // Formatting errors must report the line and column where parsing failed.
+        VBentoNode badNode;
+        VString message;
+        try {
+            badNode.readFromBentoTextString("{ \"bad\"\n  [\"a\"=1]\n  x }");
+        } catch (const VException& ex) {
+            message = ex.what();
+        }
+        VUNIT_ASSERT_TRUE_LABELED(message.contains("line 3, column 3"), message);
+
+        // Content after the top level node is closed is an error rather than being ignored.
+        message = VString::EMPTY();
+        try {
+            badNode.readFromBentoTextString("{ \"one\" } { \"two\" }");
+        } catch (const VException& ex) {
+            message = ex.what();
+        }
+        VUNIT_ASSERT_TRUE_LABELED(message.contains("line 1, column 11"), message);
+    }
+
+    /* subtest scope */ {
+        // Doubles are written to bento text in their shortest exact form, so they survive the round trip.
+        VBentoNode doubles("doubles");
+        doubles.addDouble("sum", 0.1 + 0.2);
+        VDoubleArray values;
+        values.push_back(1.0 / 3.0);
+        values.push_back(-2.5e-300);
+        values.push_back(1500.0);
+        doubles.addDoubleArray("values", values);
+
+        VString doublesText;
+        doubles.writeToBentoTextString(doublesText);
+        VUNIT_ASSERT_TRUE_LABELED(doublesText.contains("0.30000000000000004"), "double text is exact");
+        VUNIT_ASSERT_TRUE_LABELED(doublesText.contains("0.3333333333333333,-2.5e-300,1500"), "double array text is exact");
+
+        VBentoNode doublesFromText;
+        doublesFromText.readFromBentoTextString(doublesText);
+        VUNIT_ASSERT_TRUE_LABELED(doublesFromText.getDouble("sum") == (0.1 + 0.2), "double text round trip");
+        VUNIT_ASSERT_TRUE_LABELED(doublesFromText.getDoubleArray("values") == values, "double array text round trip");
+    }
+
+    /* subtest scope */ {
+        // Large numeric arrays are read and written in bulk; the bytes must match the per-element
+        // encoding, and the values must survive a round trip. Use values whose bytes all differ
+        // so that a missed or doubled byte swap is detected.
+        const int kNumElements = 100000;
+        Vs16Array s16s;
+        Vs32Array s32s;
+        Vs64Array s64s;
+        VDoubleArray doubles;
+        VDurationVector durations;
+        VBoolArray bools;
+        for (int i = 0; i < kNumElements; ++i) {
+            s16s.push_back(static_cast<Vs16>(0x0102 + i));
+            s32s.push_back(static_cast<Vs32>(0x01020304 + i));
+            s64s.push_back(CONST_S64(0x0102030405060708) + i);
+            doubles.push_back(i * 1.25 - 3.0);
+            durations.push_back(VDuration::MILLISECOND() * (CONST_S64(0x010203040506) + i));
+            bools.push_back((i % 3) == 0);
+        }
+
+        VBentoS32Array borrowedS32s("s32s", &s32s[0], kNumElements);
+        VUNIT_ASSERT_TRUE(borrowedS32s.getValue() == s32s);
+
+        VBentoNode arrays("arrays");
+        arrays.addS32Array("s32s", borrowedS32s.getValue());
+        Vs64Array adoptedS64s(s64s);
+        arrays.addS64Array("s64s")->adoptValue(adoptedS64s);
+        VUNIT_ASSERT_TRUE(adoptedS64s.empty());
+        arrays.addS16Array("s16s", s16s);
+        arrays.addDoubleArray("doubles", doubles);
+        arrays.addDurationArray("durations", durations);
+        arrays.addBoolArray("bools", bools);
+
+        VMemoryStream buffer;
+        VBinaryIOStream stream(buffer);
+        arrays.writeToStream(stream);
+
+        VMemoryStream expectedS32Buffer;
+        VBinaryIOStream expectedS32Stream(expectedS32Buffer);
+        expectedS32Stream.writeS32(kNumElements);
+        for (int i = 0; i < kNumElements; ++i) {
+            expectedS32Stream.writeS32(s32s[i]);
+        }
+        VMemoryStream actualS32Buffer;
+        VBinaryIOStream actualS32Stream(actualS32Buffer);
+        actualS32Stream.writeS32(kNumElements);
+        actualS32Stream.writeS32Array(&s32s[0], kNumElements);
+        VUNIT_ASSERT_TRUE(actualS32Buffer == expectedS32Buffer);
+
+        (void) stream.seek0();
+        VBentoNode readBack(stream);
+        VUNIT_ASSERT_TRUE(readBack.getS16Array("s16s") == s16s);
+        VUNIT_ASSERT_TRUE(readBack.getS32Array("s32s") == s32s);
+        VUNIT_ASSERT_TRUE(readBack.getS64Array("s64s") == s64s);
+        VUNIT_ASSERT_TRUE(readBack.getDoubleArray("doubles") == doubles);
+        VUNIT_ASSERT_TRUE(readBack.getDurationArray("durations") == durations);
+        VUNIT_ASSERT_TRUE(readBack.getBoolArray("bools") == bools);
+        VUNIT_ASSERT_EQUAL(buffer.getIOOffset(), buffer.getEOFOffset());
+
+        // A count far beyond the data that follows must fail at the end of the stream, not first
+        // allocate room for billions of elements.
+        VMemoryStream malformedBuffer;
+        VBinaryIOStream malformedStream(malformedBuffer);
+        malformedStream.writeString("malformed");
+        malformedStream.writeS32(0x7FFFFFFF);
+        malformedStream.writeS64Array(&s64s[0], 3);
+        const VString kMalformedTypes[] = { "s64s", "durations" };
+        for (int i = 0; i < 2; ++i) {
+            (void) malformedStream.seek0();
+            try {
+                if (i == 0) {
+                    VBentoS64Array malformed(malformedStream);
+                } else {
+                    VBentoDurationArray malformed(malformedStream);
+                }
+                VUNIT_ASSERT_FAILURE(VSTRING_FORMAT("malformed %s count", kMalformedTypes[i].chars()));
+            } catch (const VEOFException& /*ex*/) {
+                VUNIT_ASSERT_SUCCESS(VSTRING_FORMAT("malformed %s count", kMalformedTypes[i].chars()));
+            }
+        }
+    }
+
+    /* subtest scope */ {
+        // A diff of two versions, sent over a binary stream and applied to the old version, must
+        // reproduce the new version exactly; identical trees produce an empty patch.
+        VBentoNode sharedSubtree;
+        this->_buildTestData(sharedSubtree);
+        VBentoNode oldState("state");
+        _buildPatchTestState(oldState, sharedSubtree, false);
+        VBentoNode newState("state");
+        _buildPatchTestState(newState, sharedSubtree, true);
+
+        VBentoNode emptyPatch;
+        VUNIT_ASSERT_FALSE(VBentoNode::diff(oldState, VBentoNode(oldState), emptyPatch));
+        VUNIT_ASSERT_TRUE(emptyPatch.getAttributes().empty() && emptyPatch.getNodes().empty());
+
+        VBentoNode patch;
+        VUNIT_ASSERT_TRUE(VBentoNode::diff(oldState, newState, patch));
+        VUNIT_ASSERT_NULL(patch.findNode(sharedSubtree.getName()));
+
+        VMemoryStream patchBuffer;
+        VBinaryIOStream patchStream(patchBuffer);
+        patch.writeToStream(patchStream);
+        (void) patchStream.seek0();
+        VBentoNode receivedPatch(patchStream);
+
+        VBentoNode patchedState(oldState);
+        patchedState.applyPatch(receivedPatch);
+
+        VMemoryStream expectedBuffer;
+        VBinaryIOStream expectedStream(expectedBuffer);
+        newState.writeToStream(expectedStream);
+        VMemoryStream patchedBuffer;
+        VBinaryIOStream patchedStream(patchedBuffer);
+        patchedState.writeToStream(patchedStream);
+        VUNIT_ASSERT_TRUE(patchedBuffer == expectedBuffer);
+        VUNIT_ASSERT_TRUE(patchBuffer.getEOFOffset() < expectedBuffer.getEOFOffset());
+
+        // A patch applied to a tree that lacks a child it refers to must fail rather than guess.
+        VBentoNode divergedState("state");
+        try {
+            divergedState.applyPatch(receivedPatch);
+            VUNIT_ASSERT_FAILURE("apply patch to diverged tree");
+        } catch (const VException& /*ex*/) {
+            VUNIT_ASSERT_SUCCESS("apply patch to diverged tree");
+        }
+
+        // A rename is applied even when the new name is empty.
+        VBentoNode unnamedState(newState);
+        unnamedState.setName(VString::EMPTY());
+        VBentoNode renamePatch;
+        VUNIT_ASSERT_TRUE(VBentoNode::diff(newState, unnamedState, renamePatch));
+        VBentoNode renamedState(newState);
+        renamedState.applyPatch(renamePatch);
+        VUNIT_ASSERT_EQUAL(renamedState.getName(), VString::EMPTY());
+    }
+
+    /* subtest scope */ {
+        // Text rendering must keep line breaks inside values, append to an existing string, and
+        // honor the depth and length limits by eliding and truncating rather than failing.
+        VBentoNode multiLine("multi-line");
+        multiLine.addString("lines", "one\ntwo");
+        VString multiLineText;
+        multiLine.writeToBentoTextString(multiLineText);
+        VBentoNode multiLineFromText;
+        multiLineFromText.readFromBentoTextString(multiLineText);
+        VUNIT_ASSERT_EQUAL(multiLineFromText.getString("lines"), "one\ntwo");
+
+        VString rootTextAppended("prefix:");
+        root.appendToBentoTextString(rootTextAppended);
+        VUNIT_ASSERT_EQUAL(rootTextAppended, VSTRING_FORMAT("prefix:%s", rootText.chars()));
+
+        VBentoNode deep("deep");
+        deep.addInt("level", 0);
+        deep.addNewChildNode("child")->addNewChildNode("grandchild")->addInt("level", 2);
+        VString deepText;
+        deep.appendToBentoTextString(deepText, false, 1);
+        VUNIT_ASSERT_EQUAL(deepText.length(), static_cast<int>(::strlen(deepText.chars())));
+        VUNIT_ASSERT_TRUE(deepText.contains("child"));
+        VUNIT_ASSERT_TRUE(deepText.contains("..."));
+        VUNIT_ASSERT_FALSE(deepText.contains("grandchild"));
+        deepText.truncateLength(0);
+        deep.appendToXMLTextString(deepText, false, 1);
+        VUNIT_ASSERT_TRUE(deepText.contains("<!-- ... -->"));
+        VUNIT_ASSERT_FALSE(deepText.contains("grandchild"));
+
+        VBentoNode wide("wide");
+        for (int i = 0; i < 1000; ++i) {
+            wide.addS32(VSTRING_FORMAT("attribute-%d", i), i);
+        }
+
+        // Truncated output is the 200-byte budget, clipped from the attribute that crossed it, plus "...".
+        VString wideText;
+        wide.appendToBentoTextString(wideText, false, -1, 200);
+        VUNIT_ASSERT_EQUAL(wideText.length(), 203);
+        VUNIT_ASSERT_TRUE(wideText.endsWith("..."));
+        VUNIT_ASSERT_FALSE(wideText.contains("attribute-999"));
+        VString wideTextFirst(wideText);
+        wideText.truncateLength(0);
+        wide.appendToBentoTextString(wideText, false, -1, 200);
+        VUNIT_ASSERT_EQUAL(wideText, wideTextFirst);
+        wideText.truncateLength(0);
+        wide.appendToXMLTextString(wideText, true, -1, 200);
+        VUNIT_ASSERT_EQUAL(wideText.length(), 203);
+        VUNIT_ASSERT_TRUE(wideText.startsWith("<wide attribute-0=\"0\""));
+        VUNIT_ASSERT_TRUE(wideText.endsWith("..."));
+        VUNIT_ASSERT_FALSE(wideText.contains("attribute-999"));
     }
 
 }
@@ -490,7 +874,7 @@ void VBentoUnit::_verifyContents(const VBentoNode& node, const VString& labelPre
 
         VString encodedString = node.getString(ATTRIBUTE_NAME_STRING_WITH_ENCODING);
         VUNIT_ASSERT_EQUAL_LABELED(encodedString, ATTRIBUTE_VALUE_ENCODED_STRING, labelPrefix);
-        const VBentoAttribute* encodedStringAttribute = node._findAttribute(ATTRIBUTE_NAME_STRING_WITH_ENCODING, VBentoString::DATA_TYPE_ID());
+        const VBentoAttribute* encodedStringAttribute = node._findAttribute(ATTRIBUTE_NAME_STRING_WITH_ENCODING, VBentoString::DATA_TYPE_ATOM());
         this->testAssertion(encodedStringAttribute != NULL, __FILE__, __LINE__, labelPrefix, "Find attribute with encoding");
         if (encodedStringAttribute != NULL) // line above will have failed unit test
             VUNIT_ASSERT_EQUAL_LABELED(static_cast<const VBentoString*>(encodedStringAttribute)->getEncoding(), ATTRIBUTE_VALUE_STRING_ENCODING, labelPrefix);
@@ -73,5 +73,31 @@ void VHexUnit::run() {
     VHex::readHexDump(dumpStream, reconstructedStream);
 
     VUNIT_ASSERT_TRUE_LABELED(memoryStream == reconstructedBuffer, "VHex::readHexDump reconstructs data");
+
+    // The raw buffer conversions: lowercase digits decode too, and an odd digit count has an implied leading zero.
+    char hexChars[512];
+    VHex::bytesToHexChars(memoryStream.getBuffer(), 256, hexChars);
+    VUNIT_ASSERT_TRUE_LABELED(::memcmp(hexChars, hexString.chars(), 512) == 0, "bytesToHexChars");
+    Vu8 decodedBytes[256];
+    VUNIT_ASSERT_EQUAL_LABELED(VHex::hexCharsToBytes(hexChars, 512, decodedBytes), CONST_S64(256), "hexCharsToBytes length");
+    VUNIT_ASSERT_TRUE_LABELED(::memcmp(decodedBytes, memoryStream.getBuffer(), 256) == 0, "hexCharsToBytes");
+    VUNIT_ASSERT_EQUAL_LABELED(VHex::hexCharsToBytes("aBc", 3, decodedBytes), CONST_S64(2), "odd hexCharsToBytes length");
+    VUNIT_ASSERT_TRUE_LABELED((decodedBytes[0] == 0x0A) && (decodedBytes[1] == 0xBC), "odd hexCharsToBytes");
+    VUNIT_ASSERT_EQUAL_LABELED(VHex::hexCharToNibble('g'), static_cast<Vu8>(0), "non-hex digit");
+
+    // The dump layout, including a row continued from a previous printHex() call, written to a raw stream.
+    const Vu8 dumpBytes[] = { 0x41, 0x00, 0x7E, 0x20, 0x42 };
+    VMemoryStream rawDumpBuffer;
+    VHex rawHexDump(rawDumpBuffer, 4, 1, true, true);
+    rawHexDump.printHex(dumpBytes, 1);
+    rawHexDump.printHex(dumpBytes, 4, 1);
+    VString rawDumpText;
+    rawDumpText.copyFromBuffer(reinterpret_cast<const char*>(rawDumpBuffer.getBuffer()), 0, static_cast<int>(rawDumpBuffer.getEOFOffset()));
+    VString expectedDumpText(VSTRING_ARGS(
+        " 0x00000000: 41             A%s"
+        " 0x00000001:    00 7E 20     .~.%s"
+        " 0x00000004: 42             B%s",
+        VString::NATIVE_LINE_ENDING().chars(), VString::NATIVE_LINE_ENDING().chars(), VString::NATIVE_LINE_ENDING().chars()));
+    VUNIT_ASSERT_EQUAL_LABELED(rawDumpText, expectedDumpText, "hex dump layout");
 }
 
@@ -9,9 +9,13 @@ License: MIT. See LICENSE.md in the Vault top level directory.
 
 #include "vloggerunit.h"
 #include "vlogger.h"
+#include "vbinarylog.h"
 #include "vmessage.h"
 #include "vbento.h"
 #include "vsettings.h"
+#include "vmutexlocker.h"
+#include "vsemaphore.h"
+#include "vthread.h"
 
 typedef std::vector<VNamedLogger*> VLoggerUnitLoggerList;
 
@@ -34,9 +38,18 @@ void VLoggerUnit::run() {
     */
     this->_testMacros();
     this->_testStringLoggers();
+    this->_testFormatSpecs();
+    this->_testTimeStampFormatter();
     this->_testMaxActiveLogLevel();
     this->_testLoggerPathNames();
+    this->_testNamedLoggerCache();
     this->_testSmartPtrLifecycle();
+    this->_testAsyncAppender();
+    this->_testRollingFileAppender();
+    this->_testMappedFileAppender();
+    this->_testBinaryAppender();
+    this->_testRateLimiting();
+    this->_testCaptureAppender();
 //    this->_testOptimizationPerformance();
 }
 
@@ -153,6 +166,78 @@ void VLoggerUnit::_testStringLoggers() {
     VInstant::unfreezeTime();
 }
 
+// Formats a line the way VLogAppender::_formatMessage() did before format specs were compiled, by
+// replacing each variable in turn, so the test can check that the output has not changed.
+static VString _formatByReplacing(const VString& formatSpec, int level, const char* file, int line, const VString& message, const VString& specifiedLoggerName, const VString& actualLoggerName) {
+    VString formattedMessage = formatSpec;
+    formattedMessage.replace("$level", VLoggerLevel::getName(level));
+    formattedMessage.replace("$location", (file == NULL) ? VString::EMPTY() : VSTRING_FORMAT("@ %s:%d: ", file, line));
+    formattedMessage.replace("$thread", VThread::getCurrentThreadName());
+    formattedMessage.replace("$specifiedlogger", specifiedLoggerName);
+    formattedMessage.replace("$actuallogger", actualLoggerName);
+    formattedMessage.replace("$message", message);
+    return formattedMessage;
+}
+
+void VLoggerUnit::_testFormatSpecs() {
+    VStringVector formatSpecs;
+    formatSpecs.push_back("$level | $thread | $location$message");
+    formatSpecs.push_back("[$level] $$level $levels $unknown $specifiedlogger=>$actuallogger $message$message$");
+    formatSpecs.push_back("$message");
+    formatSpecs.push_back("no variables at all");
+    formatSpecs.push_back("$locationx$level$");
+
+    for (VStringVector::const_iterator i = formatSpecs.begin(); i != formatSpecs.end(); ++i) {
+        VStringVectorLogAppender appender("format-spec", VLogAppender::DO_FORMAT_OUTPUT, *i, VString::EMPTY(), NULL);
+        appender.emit(VLoggerLevel::WARN, "file.cpp", 42, true, "the message", "specified", "actual", false, VString::EMPTY());
+        appender.emit(75, NULL, 0, true, VString::EMPTY(), VString::EMPTY(), "actual", false, VString::EMPTY());
+
+        VUNIT_ASSERT_EQUAL_LABELED(appender.getLines()[0], _formatByReplacing(*i, VLoggerLevel::WARN, "file.cpp", 42, "the message", "specified", "actual"), VSTRING_FORMAT("format spec '%s' with location", i->chars()));
+        VUNIT_ASSERT_EQUAL_LABELED(appender.getLines()[1], _formatByReplacing(*i, 75, NULL, 0, VString::EMPTY(), VString::EMPTY(), "actual"), VSTRING_FORMAT("format spec '%s' without location", i->chars()));
+    }
+
+    VStringVectorLogAppender timeAppender("format-spec-time", VLogAppender::DO_FORMAT_OUTPUT, "$localtime|$utctime|$message", "y", NULL);
+    timeAppender.emit(VLoggerLevel::INFO, NULL, 0, true, "m", VString::EMPTY(), VString::EMPTY(), false, VString::EMPTY());
+    VInstant now;
+    VInstantFormatter yearFormatter("y");
+    VUNIT_ASSERT_EQUAL_LABELED(timeAppender.getLines()[0], VSTRING_FORMAT("%s|%s|m", now.getLocalString(yearFormatter).chars(), now.getUTCString(yearFormatter).chars()), "format spec with time stamps");
+}
+
+void VLoggerUnit::_testTimeStampFormatter() {
+    VStringVector specifiers;
+    specifiers.push_back("y-MM-dd HH:mm:ss.SSS");       // the default
+    specifiers.push_back("SSSS ss SSS");                // several millisecond fields, one wider than needed
+    specifiers.push_back("EEEE MMMM d h:mm:ss.SSS a Z"); // variable-width text before the milliseconds
+    specifiers.push_back("HH:mm:ss.S");                 // too narrow to patch
+    specifiers.push_back("y-MM-dd'T'HH:mm:ss.SSS");     // quoted text
+    specifiers.push_back("HH:mm:ss");                   // no milliseconds
+
+    // Several lines in one second, then the next second, then times before 1970 (which are not cached), then around a daylight saving change.
+    std::vector<Vs64> values;
+    const Vs64 base = CONST_S64(1700000000000);
+    values.push_back(base);
+    values.push_back(base + 7);
+    values.push_back(base + 45);
+    values.push_back(base + 999);
+    values.push_back(base + 1000);
+    values.push_back(base + 1234);
+    values.push_back(CONST_S64(-1500));
+    values.push_back(CONST_S64(-1));
+    values.push_back(CONST_S64(1710054000000) - 1);     // 2024-03-10 07:00 UTC, when US time zones moved to daylight time
+    values.push_back(CONST_S64(1710054000000));
+
+    for (VStringVector::const_iterator specifier = specifiers.begin(); specifier != specifiers.end(); ++specifier) {
+        VLogTimeStampFormatter timeStampFormatter(*specifier);
+        VInstantFormatter formatter(*specifier);
+        for (std::vector<Vs64>::const_iterator value = values.begin(); value != values.end(); ++value) {
+            VInstant when;
+            when.setValue(*value);
+            VUNIT_ASSERT_EQUAL_LABELED(timeStampFormatter.formatLocalString(when), when.getLocalString(formatter), VSTRING_FORMAT("time stamp '%s' local " VSTRING_FORMATTER_S64, specifier->chars(), *value));
+            VUNIT_ASSERT_EQUAL_LABELED(timeStampFormatter.formatUTCString(when), when.getUTCString(formatter), VSTRING_FORMAT("time stamp '%s' UTC " VSTRING_FORMATTER_S64, specifier->chars(), *value));
+        }
+    }
+}
+
 void VLoggerUnit::_testMaxActiveLogLevel() {
     // We assume the existing max logger level is less than 90.
     // We need to special case the use of the "VUnit" logger which may be present for routing
@@ -169,22 +254,22 @@ void VLoggerUnit::_testMaxActiveLogLevel() {
     try {
         _printLoggerInfo("BEFORE INSTALLING LOGGERS");
 
-        int oldMaxActiveLevel = VLogger::gMaxActiveLevel;
+        int oldMaxActiveLevel = VLogger::gMaxActiveLevel.load();
 
         VLogger::installNewNamedLogger("90", 90, VStringVector());
-        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel, 90, "max active level");
+        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel.load(), 90, "max active level");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(89), "level -1 is active");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(90), "level == is active");
         VUNIT_ASSERT_FALSE_LABELED(VLogger::isLogLevelActive(91), "level +1 is not active");
 
         VLogger::installNewNamedLogger("94", 94, VStringVector());
-        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel, 94, "max active level");
+        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel.load(), 94, "max active level");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(93), "level -1 is active");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(94), "level == is active");
         VUNIT_ASSERT_FALSE_LABELED(VLogger::isLogLevelActive(95), "level +1 is not active");
 
         VLogger::installNewNamedLogger("92", 92, VStringVector());
-        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel, 94, "max active level");
+        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel.load(), 94, "max active level");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(93), "level -1 is active");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(94), "level == is active");
         VUNIT_ASSERT_FALSE_LABELED(VLogger::isLogLevelActive(95), "level +1 is not active");
@@ -193,14 +278,14 @@ void VLoggerUnit::_testMaxActiveLogLevel() {
 
         VLogger::deregisterLogger("90");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::findNamedLogger("90") == NULL, "level 90 logger deleted");
-        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel, 94, "max active level");
+        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel.load(), 94, "max active level");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(93), "level -1 is active");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(94), "level == is active");
         VUNIT_ASSERT_FALSE_LABELED(VLogger::isLogLevelActive(95), "level +1 is not active");
 
         VLogger::deregisterLogger("94");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::findNamedLogger("94") == NULL, "level 94 logger deleted");
-        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel, 92, "max active level");
+        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel.load(), 92, "max active level");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(91), "level -1 is active");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(92), "level == is active");
         VUNIT_ASSERT_FALSE_LABELED(VLogger::isLogLevelActive(93), "level +1 is not active");
@@ -209,10 +294,27 @@ void VLoggerUnit::_testMaxActiveLogLevel() {
         _printLoggerInfo("AFTER DEREGISTERING LOGGERS");
 
         VUNIT_ASSERT_TRUE_LABELED(VLogger::findNamedLogger("92") == NULL, "level 92 logger deleted");
-        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel, oldMaxActiveLevel, "max active level");
+        VUNIT_ASSERT_EQUAL_LABELED(VLogger::gMaxActiveLevel.load(), oldMaxActiveLevel, "max active level");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(oldMaxActiveLevel - 1), "level -1 is active");
         VUNIT_ASSERT_TRUE_LABELED(VLogger::isLogLevelActive(oldMaxActiveLevel), "level == is active");
         VUNIT_ASSERT_FALSE_LABELED(VLogger::isLogLevelActive(oldMaxActiveLevel + 1), "level +1 is not active");
+
+        // The default logger's level is checked by the VLOGGER macros without locking; a filtered call must not evaluate its message.
+        VNamedLoggerPtr defaultLogger = VLogger::getDefaultLogger();
+        int oldDefaultLevel = defaultLogger->getLevel();
+        int numEvaluations = 0;
+        defaultLogger->setLevel(VLoggerLevel::WARN);
+        VUNIT_ASSERT_TRUE_LABELED(VLogger::isDefaultLogLevelActive(VLoggerLevel::WARN), "default level == is active");
+        VUNIT_ASSERT_FALSE_LABELED(VLogger::isDefaultLogLevelActive(VLoggerLevel::INFO), "default level +1 is not active");
+        VLOGGER_INFO(VSTRING_FORMAT("evaluation %d", ++numEvaluations));
+        VUNIT_ASSERT_EQUAL_LABELED(numEvaluations, 0, "filtered message not evaluated");
+        defaultLogger->setLevel(VLoggerLevel::DEBUG);
+        VUNIT_ASSERT_TRUE_LABELED(VLogger::isDefaultLogLevelActive(VLoggerLevel::DEBUG), "raised default level == is active");
+        VUNIT_ASSERT_FALSE_LABELED(VLogger::isDefaultLogLevelActive(VLoggerLevel::TRACE), "raised default level +1 is not active");
+        VUNIT_ASSERT_TRUE_LABELED(VLOGGER_WOULD_LOG(VLoggerLevel::DEBUG), "VLOGGER_WOULD_LOG follows default level");
+        defaultLogger->setLevel(oldDefaultLevel);
+        VUNIT_ASSERT_EQUAL_LABELED(VLogger::isDefaultLogLevelActive(VLoggerLevel::DEBUG), (oldDefaultLevel >= VLoggerLevel::DEBUG), "restored default level");
+        VUNIT_ASSERT_TRUE_LABELED(VLOGGER_LEVEL_COMPILED_IN(VLoggerLevel::TRACE), "all levels compiled in by default");
     } catch (...) {
         if (vunitLogger != NULL)
             vunitLogger->setLevel(oldVUnitLevel);
@@ -406,12 +508,66 @@ void VLoggerUnit::_testLoggerPathNames() {
 
     for (VLoggerUnitLoggerList::const_iterator i = loggers.begin(); i != loggers.end(); ++i) {
         VString loggerName = (*i)->getName();
-        VLogger::deregisterLogger(loggerName); // destroys the VLogger object with that name
+        VLogger::deregisterLogger(loggerName); // the call sites above cached it, so VLogger keeps the object until shutdown
         VUNIT_ASSERT_TRUE_LABELED(VLogger::findNamedLogger(loggerName) == NULL, VSTRING_FORMAT("logger '%s' deleted", loggerName.chars()));
     }
 
-    // Note: We just deleted the loggers in the loop above. The VLoggerUnitLoggerList (loggers) now contains garbage pointers.
-    // Do not reference them after the loop. Destructing the list is OK.
+    // Note: We just deregistered the loggers in the loop above. The VLoggerUnitLoggerList (loggers) must not be used to
+    // reference them after the loop. Destructing the list is OK.
+}
+
+// One call site, so that the tests below exercise a single VNamedLoggerCache with different names.
+static void _logInfoToNamedLogger(const VString& loggerName, const VString& message) {
+    VLOGGER_NAMED_INFO(loggerName, message);
+}
+
+void VLoggerUnit::_testNamedLoggerCache() {
+    VStringVectorLogger* parentLogger = new VStringVectorLogger("cache-test", VLoggerLevel::INFO, NULL, VLogAppender::DONT_FORMAT_OUTPUT);
+    VLogger::registerLogger(VNamedLoggerPtr(parentLogger));
+
+    _logInfoToNamedLogger("cache-test.child", "one");
+    VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(parentLogger->getLines().size()), 1, "cached call site resolves to parent path");
+
+    // Registering a logger with a more specific name must be seen by the call site that already resolved the name.
+    VStringVectorLogger* childLogger = new VStringVectorLogger("cache-test.child", VLoggerLevel::INFO, NULL, VLogAppender::DONT_FORMAT_OUTPUT);
+    VNamedLoggerPtr childLoggerPtr(childLogger);
+    VLogger::registerLogger(childLoggerPtr);
+    _logInfoToNamedLogger("cache-test.child", "two");
+    VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(childLogger->getLines().size()), 1, "cached call site sees newly registered logger");
+    VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(parentLogger->getLines().size()), 1, "cached call site stops using parent logger");
+
+    // The same call site with a different name.
+    _logInfoToNamedLogger("cache-test", "three");
+    VUNIT_ASSERT_EQUAL_LABELED(parentLogger->getLines().back(), "three", "cached call site follows a changed name");
+
+    // A level change is seen without re-resolving.
+    childLogger->setLevel(VLoggerLevel::WARN);
+    _logInfoToNamedLogger("cache-test.child", "four");
+    VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(childLogger->getLines().size()), 1, "cached call site honors a lowered level");
+    VUNIT_ASSERT_EQUAL_LABELED(parentLogger->getLines().back(), "three", "cached call site does not fall back to parent for a filtered level");
+    VUNIT_ASSERT_FALSE_LABELED(VLOGGER_NAMED_WOULD_LOG("cache-test.child", VLoggerLevel::INFO), "would-log honors a lowered level");
+    VUNIT_ASSERT_TRUE_LABELED(VLOGGER_NAMED_WOULD_LOG("cache-test.child", VLoggerLevel::WARN), "would-log at the logger's level");
+
+    // Deregistering the logger sends its names back to the parent.
+    VLogger::deregisterLogger(childLoggerPtr);
+    _logInfoToNamedLogger("cache-test.child", "five");
+    VUNIT_ASSERT_EQUAL_LABELED(parentLogger->getLines().back(), "five", "cached call site sees deregistered logger");
+    VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(childLogger->getLines().size()), 1, "cached call site stops using deregistered logger");
+
+    // A logger that a call site resolved to is kept by VLogger after deregistration, because caches point to it
+    // without a reference; one that no call site resolved to is destroyed with its last reference.
+    VWeakPtr<VNamedLogger> cachedLogger(childLoggerPtr);
+    childLoggerPtr.reset();
+    VUNIT_ASSERT_FALSE_LABELED(cachedLogger.expired(), "deregistered logger kept for call sites that cached it");
+
+    VNamedLoggerPtr uncachedLoggerPtr(new VStringVectorLogger("cache-test-uncached", VLoggerLevel::INFO, NULL, VLogAppender::DONT_FORMAT_OUTPUT));
+    VWeakPtr<VNamedLogger> uncachedLogger(uncachedLoggerPtr);
+    VLogger::registerLogger(uncachedLoggerPtr);
+    uncachedLoggerPtr.reset();
+    VLogger::deregisterLogger("cache-test-uncached");
+    VUNIT_ASSERT_TRUE_LABELED(uncachedLogger.expired(), "deregistered logger destroyed when no call site cached it");
+
+    VLogger::deregisterLogger("cache-test");
 }
 
 void VLoggerUnit::_testSmartPtrLifecycle() {
@@ -423,6 +579,641 @@ void VLoggerUnit::_testSmartPtrLifecycle() {
 
 }
 
+void VLoggerUnit::_testAsyncAppender() {
+    // Everything emitted arrives at the target, in order, once flushed.
+    VStringVectorLogAppender* target = new VStringVectorLogAppender("async-target", VLogAppender::DONT_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY(), NULL);
+    VLogAppenderPtr targetPtr(target);
+    /* appender scope */ {
+        VAsyncLogAppender appender("async", targetPtr, 16, 4);
+        for (int i = 0; i < 100; ++i) {
+            VLOGGER_APPENDER_EMIT(appender, VLoggerLevel::INFO, VSTRING_FORMAT("message %d", i));
+        }
+
+        appender.emit(VLoggerLevel::INFO, NULL, 0, true, "header", VString::EMPTY(), VString::EMPTY(), true, "raw line");
+        appender.flush();
+
+        VMutexLocker locker(&target->getMutex(), "VLoggerUnit::_testAsyncAppender");
+        const VStringVector& lines = target->getLines();
+        VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(lines.size()), 102, "async appender line count");
+        bool inOrder = true;
+        for (int i = 0; i < 100; ++i) {
+            inOrder = inOrder && (lines.at(i) == VSTRING_FORMAT("message %d", i));
+        }
+
+        VUNIT_ASSERT_TRUE_LABELED(inOrder, "async appender lines in order");
+        VUNIT_ASSERT_EQUAL_LABELED(lines.at(100), "header", "async appender message line");
+        VUNIT_ASSERT_EQUAL_LABELED(lines.at(101), "raw line", "async appender raw line follows its message");
+        VUNIT_ASSERT_EQUAL_LABELED(appender.getNumDropped(), CONST_S64(0), "async appender blocking policy drops nothing");
+    }
+
+    // With the drop policy, messages that do not fit while the writer is stuck are counted, and the count is noted in the output.
+    VStringVectorLogAppender* slowTarget = new VStringVectorLogAppender("async-slow-target", VLogAppender::DONT_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY(), NULL);
+    VLogAppenderPtr slowTargetPtr(slowTarget);
+    /* appender scope */ {
+        VAsyncLogAppender appender("async-drop", slowTargetPtr, 4, 4, 10 * VDuration::MILLISECOND(), VAsyncLogAppender::kDropWhenFull);
+        /* locker scope */ {
+            VMutexLocker locker(&slowTarget->getMutex(), "VLoggerUnit::_testAsyncAppender"); // the writer cannot write until we unlock
+            for (int i = 0; i < 20; ++i) {
+                VLOGGER_APPENDER_EMIT(appender, VLoggerLevel::INFO, VSTRING_FORMAT("message %d", i));
+            }
+        }
+
+        appender.flush();
+
+        // The writer can hold one batch while it waits for the target, and the queue another.
+        Vs64 numDropped = appender.getNumDropped();
+        VUNIT_ASSERT_TRUE_LABELED(numDropped >= 12, "async appender drop policy drops when full");
+
+        VMutexLocker locker(&slowTarget->getMutex(), "VLoggerUnit::_testAsyncAppender");
+        const VStringVector& lines = slowTarget->getLines();
+        VUNIT_ASSERT_EQUAL_LABELED(static_cast<Vs64>(lines.size()), 20 - numDropped + 1, "async appender kept lines plus drop note");
+        VUNIT_ASSERT_TRUE_LABELED(lines.back().contains(VSTRING_FORMAT("dropped " VSTRING_FORMATTER_S64 " messages", numDropped)), "async appender drop note");
+    }
+
+    // Once stopped, output is written directly. The appender is configured from settings naming a registered target.
+    VLogger::registerLogAppender(targetPtr);
+    /* appender scope */ {
+        VString settingsText("<appender name=\"async-settings\" kind=\"async\" target=\"async-target\" capacity=\"100\" batch-size=\"8\" overflow=\"drop-below\" overflow-level=\"ERROR\" />");
+        VMemoryStream buf(settingsText.getDataBuffer(), VMemoryStream::kAllocatedByOperatorNew, false, settingsText.length(), settingsText.length());
+        VTextIOStream in(buf);
+        VSettings settings(in);
+        VAsyncLogAppender appender(*(settings.findNode("appender")), VSettings());
+        VUNIT_ASSERT_TRUE_LABELED(appender.getTarget() == targetPtr, "async appender target from settings");
+
+        VBentoNode info;
+        appender.addInfo(info);
+        VUNIT_ASSERT_EQUAL_LABELED(info.getInt("capacity"), 128, "async appender capacity rounded up");
+        VUNIT_ASSERT_EQUAL_LABELED(info.getString("overflow"), "drop-below", "async appender overflow policy from settings");
+
+        appender.stop();
+        VLOGGER_APPENDER_EMIT(appender, VLoggerLevel::INFO, "after stop");
+        VMutexLocker locker(&target->getMutex(), "VLoggerUnit::_testAsyncAppender");
+        VUNIT_ASSERT_EQUAL_LABELED(target->getLines().back(), "after stop", "async appender writes directly after stop");
+    }
+    VLogger::deregisterLogAppender(targetPtr);
+}
+
+// Returns the sequence number in a rolling log file name such as "roll.000009.log".
+static int _getRollingFileSequence(const VString& fileName) {
+    VString sequence;
+    fileName.getSubstring(sequence, fileName.indexOf('.') + 1, fileName.lastIndexOf('.'));
+    return sequence.parseInt();
+}
+
+void VLoggerUnit::_testRollingFileAppender() {
+    VFSNode dir("vloggerunit-rolling");
+    (void) dir.rm();
+    dir.mkdirs();
+
+    // A file left from an earlier run: numbering continues after it.
+    VBufferedFileStream leftover(VFSNode(dir, "roll.000007.log"));
+    leftover.openWrite();
+    leftover.close();
+
+    /* appender scope */ {
+        VRollingFileLogAppender appender("roll", VLogAppender::DONT_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY(), dir.getPath(), "roll", 100, VDuration::POSITIVE_INFINITY(), 2);
+        VUNIT_ASSERT_EQUAL_LABELED(appender.getCurrentFileNode().getName(), "roll.000008.log", "rolling appender continues numbering");
+
+        // Each line is 10 chars plus a line ending, so 9 lines fit in 100 bytes and the 10th starts a new file.
+        for (int i = 0; i < 10; ++i) {
+            appender.emitRaw("0123456789");
+        }
+
+        // A roll that overtakes the helper thread's next file skips its number, so only the order is certain.
+        const VString secondFileName = appender.getCurrentFileNode().getName();
+        VUNIT_ASSERT_TRUE_LABELED(secondFileName.startsWith("roll.") && (_getRollingFileSequence(secondFileName) > 8), "rolling appender rolls on size");
+        VStringVector firstFileLines;
+        VFSNode(dir, "roll.000008.log").readAll(firstFileLines);
+        VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(firstFileLines.size()), 9, "rolling appender first file line count");
+
+        appender.roll();
+        appender.emitRaw("after roll");
+        const VString thirdFileName = appender.getCurrentFileNode().getName();
+        VUNIT_ASSERT_TRUE_LABELED(_getRollingFileSequence(thirdFileName) > _getRollingFileSequence(secondFileName), "rolling appender rolls on request");
+
+        // Earlier files are 7, 8 and the second file; the helper thread deletes 7 to keep 2.
+        VFSNode oldestFile(dir, "roll.000007.log");
+        for (int i = 0; (i < 200) && oldestFile.exists(); ++i) {
+            VThread::sleep(10 * VDuration::MILLISECOND());
+        }
+
+        VUNIT_ASSERT_FALSE_LABELED(oldestFile.exists(), "rolling appender deletes files beyond max-archives");
+        VUNIT_ASSERT_TRUE_LABELED(VFSNode(dir, "roll.000008.log").exists(), "rolling appender keeps max-archives files");
+    }
+
+    VStringVector fileNames;
+    dir.list(fileNames);
+    VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(fileNames.size()), 3, "rolling appender removes its unused prepared files");
+
+    // Configured from settings, with a time limit.
+    VString settingsText(VSTRING_FORMAT("<appender name=\"timed\" kind=\"rolling-file\" dir=\"%s\" roll-interval=\"20ms\" format-output=\"false\" />", dir.getPath().chars()));
+    VMemoryStream buf(settingsText.getDataBuffer(), VMemoryStream::kAllocatedByOperatorNew, false, settingsText.length(), settingsText.length());
+    VTextIOStream in(buf);
+    VSettings settings(in);
+    VInstant::freezeTime(VInstant()); // The time limit depends on the passage of time, which we control here.
+    /* appender scope */ {
+        VRollingFileLogAppender appender(*(settings.findNode("appender")), VSettings());
+        appender.emitRaw("first");
+        VUNIT_ASSERT_EQUAL_LABELED(appender.getCurrentFileNode().getName(), "timed.000001.log", "rolling appender prefix from name");
+        VInstant::shiftFrozenTime(10 * VDuration::MILLISECOND());
+        appender.emitRaw("still first");
+        VUNIT_ASSERT_EQUAL_LABELED(appender.getCurrentFileNode().getName(), "timed.000001.log", "rolling appender keeps file within time limit");
+        VInstant::shiftFrozenTime(10 * VDuration::MILLISECOND());
+        appender.emitRaw("second");
+        const VString timedFileName = appender.getCurrentFileNode().getName();
+        VUNIT_ASSERT_TRUE_LABELED(timedFileName.startsWith("timed.") && (_getRollingFileSequence(timedFileName) > 1), "rolling appender rolls on time");
+    }
+
+    VInstant::unfreezeTime();
+
+    (void) dir.rm();
+}
+
+void VLoggerUnit::_testMappedFileAppender() {
+    VFSNode dir("vloggerunit-mapped");
+    (void) dir.rm();
+    VFSNode file(dir, "mapped.log");
+
+    // With the smallest segments, a long line spans several of them.
+    const Vs64 segmentSize = VMemoryMappedFile::getGranularity();
+    VString longLine;
+    for (Vs64 i = 0; i < segmentSize * 2; ++i) {
+        longLine += static_cast<char>('a' + (i % 26));
+    }
+
+    int lineEndingLength;
+    (void) vault::VgetNativeLineEnding(lineEndingLength);
+    VString expectedText;
+    /* appender scope */ {
+        VMappedFileLogAppender appender("mapped", VLogAppender::DONT_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY(), file.getPath(), 1, 5 * VDuration::MILLISECOND());
+        for (int i = 0; i < 500; ++i) {
+            VString line(VSTRING_FORMAT("line %d", i));
+            appender.emitRaw(line);
+            expectedText += line;
+            expectedText += '\n';
+        }
+
+        appender.emitRaw(longLine);
+        expectedText += longLine;
+        expectedText += '\n';
+        VUNIT_ASSERT_EQUAL_LABELED(appender.getDataLength(), static_cast<Vs64>(expectedText.length() + (lineEndingLength - 1) * 501), "mapped appender data length");
+
+        appender.sync();
+        VUNIT_ASSERT_TRUE_LABELED(file.size() > appender.getDataLength(), "mapped appender file extended ahead of data");
+    }
+
+    VStringVector lines;
+    file.readAll(lines);
+    VString text;
+    for (VStringVector::const_iterator i = lines.begin(); i != lines.end(); ++i) {
+        text += *i;
+        text += '\n';
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(text, expectedText, "mapped appender file content");
+    VUNIT_ASSERT_EQUAL_LABELED(file.size(), static_cast<Vs64>(expectedText.length() + (lineEndingLength - 1) * 501), "mapped appender truncates unused tail");
+
+    // A file left by a crash has a zero tail: output resumes right after the data.
+    (void) file.rm();
+    /* leftover file scope */ {
+        VMemoryMappedFile leftover(file);
+        leftover.openReadWrite();
+        leftover.setSize(segmentSize * 3);
+        Vu8* region = leftover.map(0, segmentSize * 3);
+        ::memcpy(region + segmentSize, "abc", 3);
+        VMemoryMappedFile::unmap(region, segmentSize * 3);
+    }
+
+    /* appender scope */ {
+        VString settingsText(VSTRING_FORMAT("<appender name=\"mapped\" kind=\"mapped-file\" path=\"%s\" segment-size=\"1\" format-output=\"false\" />", file.getPath().chars()));
+        VMemoryStream buf(settingsText.getDataBuffer(), VMemoryStream::kAllocatedByOperatorNew, false, settingsText.length(), settingsText.length());
+        VTextIOStream in(buf);
+        VSettings settings(in);
+        VMappedFileLogAppender appender(*(settings.findNode("appender")), VSettings());
+        VUNIT_ASSERT_EQUAL_LABELED(appender.getDataLength(), segmentSize + 3, "mapped appender finds end of crashed data");
+        appender.emitRaw("def");
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(file.size(), segmentSize + 6 + lineEndingLength, "mapped appender appends after crashed data");
+    lines.clear();
+    file.readAll(lines);
+    VUNIT_ASSERT_TRUE_LABELED(!lines.empty() && lines[lines.size() - 1].endsWith("abcdef"), "mapped appender appended text");
+
+    (void) dir.rm();
+}
+
+void VLoggerUnit::_testBinaryAppender() {
+    VFSNode dir("vloggerunit-binary");
+    (void) dir.rm();
+    VFSNode file(dir, "binary.vblog");
+    VString longText;
+    for (int i = 0; i < 2000; ++i) {
+        longText += 'a';
+    }
+
+    int argumentsLine = 0;
+    /* appender scope */ {
+        VBinaryLogAppender appender("binary", file.getPath(), VLoggerLevel::DEBUG);
+        argumentsLine = __LINE__ + 1;
+        VLOGGER_BINARY(appender, VLoggerLevel::DEBUG, "i={} u={} b={} c={} d={} s={} v={}", -5, 7u, true, 'x', 1.5, "chars", VString("vstring"));
+        VLOGGER_BINARY(appender, VLoggerLevel::TRACE, "filtered {}", 1);
+        for (int i = 0; i < 2; ++i) {
+            VLOGGER_BINARY(appender, VLoggerLevel::INFO, "loop {}", i);
+        }
+        VLOGGER_BINARY(appender, VLoggerLevel::WARN, "no argument {}");
+        VLOGGER_BINARY(appender, VLoggerLevel::INFO, "long {}", longText);
+        appender.emit(VLoggerLevel::ERROR, "textfile.cpp", 12, true, "text message", VString::EMPTY(), VString::EMPTY(), true, "raw line");
+    }
+
+    /* appender scope */ { // a second run appends to the same file
+        VBinaryLogAppender appender("binary", file.getPath());
+        VLOGGER_BINARY(appender, VLoggerLevel::INFO, "second run {}", 2);
+    }
+
+    std::vector<VBinaryLogEvent> events;
+    VBufferedFileStream in(file);
+    in.openReadOnly();
+    VBinaryLogReader reader(in);
+    VBinaryLogEvent event;
+    while (reader.readEvent(event)) {
+        events.push_back(event);
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(events.size()), 8, "binary log event count");
+    if (events.size() == 8) {
+        VUNIT_ASSERT_EQUAL_LABELED(events[0].mMessage, VString::fmt("i={} u={} b={} c={} d={} s={} v={}", -5, 7u, true, 'x', 1.5, "chars", "vstring"), "binary log arguments");
+        VUNIT_ASSERT_EQUAL_LABELED(events[0].mLevel, VLoggerLevel::DEBUG, "binary log level");
+        VUNIT_ASSERT_EQUAL_LABELED(events[0].mFile, __FILE__, "binary log file");
+        VUNIT_ASSERT_EQUAL_LABELED(events[0].mLine, argumentsLine, "binary log line");
+        VUNIT_ASSERT_EQUAL_LABELED(events[0].mThreadName, VThread::getCurrentThreadName(), "binary log thread name");
+        VUNIT_ASSERT_TRUE_LABELED(reader.formatEvent(events[0]).endsWith(VString::fmt(" DEBUG | {} | @ {}:{}: {}", events[0].mThreadName, __FILE__, argumentsLine, events[0].mMessage)), "binary log formatted event");
+        VUNIT_ASSERT_EQUAL_LABELED(events[1].mMessage, "loop 0", "binary log site reused 0");
+        VUNIT_ASSERT_EQUAL_LABELED(events[2].mMessage, "loop 1", "binary log site reused 1");
+        VUNIT_ASSERT_EQUAL_LABELED(events[3].mMessage, "no argument {}", "binary log missing argument");
+        VUNIT_ASSERT_TRUE_LABELED(events[4].mMessage.startsWith("long aaaa") && (events[4].mMessage.length() < VBinaryLogRecord::kMaxLength), "binary log long string truncated");
+        VUNIT_ASSERT_EQUAL_LABELED(events[5].mMessage, "@ textfile.cpp:12: text message", "binary log text message");
+        VUNIT_ASSERT_EQUAL_LABELED(events[5].mLevel, VLoggerLevel::ERROR, "binary log text message level");
+        VUNIT_ASSERT_TRUE_LABELED(events[6].mIsRawLine, "binary log raw line");
+        VUNIT_ASSERT_EQUAL_LABELED(reader.formatEvent(events[6]), "raw line", "binary log raw line text");
+        VUNIT_ASSERT_EQUAL_LABELED(events[7].mMessage, "second run 2", "binary log appended run");
+    }
+
+    // A run that crashed in the middle of a record, followed by a run that appended after it:
+    // the cut-short record is skipped. Here the file is cut short and then repeated, twice.
+    VMemoryStream wholeLog;
+    in.seek0();
+    (void) VStream::streamCopy(in, wholeLog, in.available());
+    const Vs64 cutLength = wholeLog.getEOFOffset() - 3;
+    VMemoryStream crashedLog;
+    for (int i = 0; i < 2; ++i) {
+        (void) crashedLog.write(wholeLog.getBuffer(), cutLength);
+    }
+    crashedLog.seek0();
+    VBinaryLogReader crashedReader(crashedLog);
+    std::vector<VBinaryLogEvent> crashedEvents;
+    while (crashedReader.readEvent(event)) {
+        crashedEvents.push_back(event);
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(crashedEvents.size()), 14, "binary log crashed run event count");
+    if (crashedEvents.size() == 14) {
+        VUNIT_ASSERT_EQUAL_LABELED(crashedEvents[6].mMessage, "raw line", "binary log crashed run last event");
+        VUNIT_ASSERT_EQUAL_LABELED(crashedEvents[7].mMessage, events[0].mMessage, "binary log run after crash");
+        VUNIT_ASSERT_EQUAL_LABELED(crashedEvents[13].mMessage, "raw line", "binary log crashed run at end");
+    }
+
+    // Anything else is rejected.
+    VString notBinary("plain text");
+    VMemoryStream buf(notBinary.getDataBuffer(), VMemoryStream::kAllocatedByOperatorNew, false, notBinary.length(), notBinary.length());
+    VBinaryLogReader textReader(buf);
+    try {
+        (void) textReader.readEvent(event);
+        VUNIT_ASSERT_FAILURE("binary log reader rejects text");
+    } catch (const VException& /*ex*/) {
+        VUNIT_ASSERT_SUCCESS("binary log reader rejects text");
+    }
+
+    in.close();
+    (void) dir.rm();
+}
+
+/**
+Emits numbered lines to an appender, for _testCaptureAppender().
+*/
+class VLoggerUnitEmitterThread : public VThread {
+    public:
+        VLoggerUnitEmitterThread(const VString& name, VLogAppender& appender, int numLines)
+            : VThread(name, "vloggerunit.VLoggerUnitEmitterThread", kDontDeleteSelfAtEnd, kCreateThreadJoinable, NULL)
+            , mAppender(appender)
+            , mNumLines(numLines)
+            {}
+        virtual ~VLoggerUnitEmitterThread() {}
+
+        virtual void run() {
+            for (int i = 0; i < mNumLines; ++i) {
+                mAppender.emitRaw(VSTRING_FORMAT("%s %d", mName.chars(), i));
+            }
+        }
+
+    private:
+        VLoggerUnitEmitterThread(const VLoggerUnitEmitterThread&); // not copyable
+        VLoggerUnitEmitterThread& operator=(const VLoggerUnitEmitterThread&); // not assignable
+
+        VLogAppender&   mAppender;
+        int             mNumLines;
+};
+
+/**
+Lets threads take turns in a fixed order, for _testCaptureAppender().
+*/
+class VLoggerUnitTurns {
+    public:
+        VLoggerUnitTurns() : mMutex("VLoggerUnitTurns", true), mSemaphore(), mTurn(0) {}
+        ~VLoggerUnitTurns() {}
+
+        void waitForTurn(int turn) {
+            VMutexLocker locker(&mMutex, "VLoggerUnitTurns::waitForTurn");
+            while (mTurn != turn) {
+                mSemaphore.wait(&mMutex, VDuration::ZERO());
+            }
+        }
+
+        void passTurn(int nextTurn) {
+            VMutexLocker locker(&mMutex, "VLoggerUnitTurns::passTurn");
+            mTurn = nextTurn;
+            mSemaphore.signal();
+        }
+
+    private:
+        VLoggerUnitTurns(const VLoggerUnitTurns&); // not copyable
+        VLoggerUnitTurns& operator=(const VLoggerUnitTurns&); // not assignable
+
+        VMutex      mMutex;
+        VSemaphore  mSemaphore;
+        int         mTurn;
+};
+
+/**
+Emits numbered lines to an appender, alternating with another thread, for _testCaptureAppender().
+*/
+class VLoggerUnitAlternatingThread : public VThread {
+    public:
+        VLoggerUnitAlternatingThread(const VString& name, VLogAppender& appender, int numLines, VLoggerUnitTurns& turns, int turn)
+            : VThread(name, "vloggerunit.VLoggerUnitAlternatingThread", kDontDeleteSelfAtEnd, kCreateThreadJoinable, NULL)
+            , mAppender(appender)
+            , mNumLines(numLines)
+            , mTurns(turns)
+            , mTurn(turn)
+            {}
+        virtual ~VLoggerUnitAlternatingThread() {}
+
+        virtual void run() {
+            for (int i = 0; i < mNumLines; ++i) {
+                mTurns.waitForTurn(mTurn);
+                mAppender.emitRaw(VSTRING_FORMAT("%s %d", mName.chars(), i));
+                mTurns.passTurn(1 - mTurn);
+            }
+        }
+
+    private:
+        VLoggerUnitAlternatingThread(const VLoggerUnitAlternatingThread&); // not copyable
+        VLoggerUnitAlternatingThread& operator=(const VLoggerUnitAlternatingThread&); // not assignable
+
+        VLogAppender&       mAppender;
+        int                 mNumLines;
+        VLoggerUnitTurns&   mTurns;
+        int                 mTurn;
+};
+
+void VLoggerUnit::_testCaptureAppender() {
+    VCaptureLogAppender appender("capture", VLogAppender::DONT_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY());
+    appender.emitRaw("first");
+
+    const int kNumThreads = 4;
+    const int kNumLinesPerThread = 500;
+    std::vector<VLoggerUnitEmitterThread*> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.push_back(new VLoggerUnitEmitterThread(VSTRING_FORMAT("t%d", i), appender, kNumLinesPerThread));
+    }
+
+    for (std::vector<VLoggerUnitEmitterThread*>::const_iterator i = threads.begin(); i != threads.end(); ++i) {
+        (*i)->start();
+    }
+
+    for (std::vector<VLoggerUnitEmitterThread*>::const_iterator i = threads.begin(); i != threads.end(); ++i) {
+        (void) (*i)->join();
+    }
+
+    vault::vectorDeleteAll(threads);
+    appender.emitRaw("last");
+
+    VStringVector lines;
+    appender.getLines(lines);
+    VUNIT_ASSERT_EQUAL_LABELED(appender.getNumLines(), kNumThreads * kNumLinesPerThread + 2, "capture appender line count");
+    VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(lines.size()), kNumThreads * kNumLinesPerThread + 2, "capture appender merged line count");
+    if (lines.size() == static_cast<size_t>(kNumThreads * kNumLinesPerThread + 2)) {
+        VUNIT_ASSERT_EQUAL_LABELED(lines[0], "first", "capture appender first line");
+        VUNIT_ASSERT_EQUAL_LABELED(lines[lines.size() - 1], "last", "capture appender last line");
+
+        // Each thread's lines are in the order it emitted them.
+        std::vector<int> nextLineNumbers(kNumThreads, 0);
+        bool inOrder = true;
+        for (size_t i = 1; i < lines.size() - 1; ++i) {
+            int threadIndex = lines[i].charAt(1) - '0';
+            if ((threadIndex < 0) || (threadIndex >= kNumThreads) || (lines[i] != VSTRING_FORMAT("t%d %d", threadIndex, nextLineNumbers[threadIndex]))) {
+                inOrder = false;
+                break;
+            }
+
+            ++nextLineNumbers[threadIndex];
+        }
+
+        VUNIT_ASSERT_TRUE_LABELED(inOrder, "capture appender keeps each thread's order");
+    }
+
+    VString expectedText;
+    for (VStringVector::const_iterator i = lines.begin(); i != lines.end(); ++i) {
+        expectedText += *i;
+        expectedText += VString::NATIVE_LINE_ENDING();
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(appender.getText(), expectedText, "capture appender text");
+
+    // Two threads that hand off to each other after every line produce one known interleaving.
+    VCaptureLogAppender alternatingAppender("capture-alternating", VLogAppender::DONT_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY());
+    const int kNumAlternatingLines = 100;
+    VLoggerUnitTurns turns;
+    VLoggerUnitAlternatingThread threadA("a", alternatingAppender, kNumAlternatingLines, turns, 0);
+    VLoggerUnitAlternatingThread threadB("b", alternatingAppender, kNumAlternatingLines, turns, 1);
+    threadB.start();
+    threadA.start();
+    (void) threadA.join();
+    (void) threadB.join();
+
+    VString expectedAlternatingText;
+    for (int i = 0; i < kNumAlternatingLines; ++i) {
+        expectedAlternatingText += VSTRING_FORMAT("a %d", i);
+        expectedAlternatingText += VString::NATIVE_LINE_ENDING();
+        expectedAlternatingText += VSTRING_FORMAT("b %d", i);
+        expectedAlternatingText += VString::NATIVE_LINE_ENDING();
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(alternatingAppender.getText(), expectedAlternatingText, "capture appender merges a known interleaving in order");
+
+    appender.clear();
+    VUNIT_ASSERT_EQUAL_LABELED(appender.getNumLines(), 0, "capture appender cleared");
+    appender.emitRaw("after clear");
+    VUNIT_ASSERT_EQUAL_LABELED(appender.getText(), VString("after clear") + VString::NATIVE_LINE_ENDING(), "capture appender after clear");
+
+    // A formatted message and a raw line from one emit, and a thread whose cached buffer was replaced by other appenders'.
+    VCaptureLogAppender formattedAppender("capture-formatted", VLogAppender::DO_FORMAT_OUTPUT, "$level|$message", VString::EMPTY());
+    formattedAppender.emit(VLoggerLevel::INFO, NULL, 0, true, "message", VString::EMPTY(), VString::EMPTY(), true, "raw");
+    std::vector<VCaptureLogAppender*> others;
+    for (int i = 0; i < 4; ++i) {
+        others.push_back(new VCaptureLogAppender(VSTRING_FORMAT("capture-other-%d", i), VLogAppender::DONT_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY()));
+        others.back()->emitRaw("other");
+    }
+
+    vault::vectorDeleteAll(others);
+    formattedAppender.emitRaw("after others");
+
+    lines.clear();
+    formattedAppender.getLines(lines);
+    VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(lines.size()), 3, "capture appender formatted line count");
+    if (lines.size() == 3) {
+        VUNIT_ASSERT_EQUAL_LABELED(lines[0], "INFO |message", "capture appender formatted message");
+        VUNIT_ASSERT_EQUAL_LABELED(lines[1], "raw", "capture appender raw line after message");
+        VUNIT_ASSERT_EQUAL_LABELED(lines[2], "after others", "capture appender line after buffer replaced");
+    }
+
+    // Behind an async appender, which hands lines to its target in batches from the writer thread.
+    VCaptureLogAppender* asyncTarget = new VCaptureLogAppender("capture-async-target", VLogAppender::DO_FORMAT_OUTPUT, "$level|$message", VString::EMPTY());
+    VLogAppenderPtr asyncTargetPtr(asyncTarget);
+    /* async appender scope */ {
+        VAsyncLogAppender asyncAppender("capture-async", asyncTargetPtr, 16, 4);
+        for (int i = 0; i < 10; ++i) {
+            asyncAppender.emit(VLoggerLevel::INFO, NULL, 0, true, VSTRING_FORMAT("async %d", i), VString::EMPTY(), VString::EMPTY(), false, VString::EMPTY());
+        }
+        asyncAppender.emitRaw("async raw");
+    }
+
+    lines.clear();
+    asyncTarget->getLines(lines);
+    VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(lines.size()), 11, "capture appender behind async appender line count");
+    if (lines.size() == 11) {
+        VUNIT_ASSERT_EQUAL_LABELED(lines[0], "INFO |async 0", "capture appender behind async appender first line");
+        VUNIT_ASSERT_EQUAL_LABELED(lines[9], "INFO |async 9", "capture appender behind async appender last message");
+        VUNIT_ASSERT_EQUAL_LABELED(lines[10], "async raw", "capture appender behind async appender raw line");
+    }
+}
+
+void VLoggerUnit::_testRateLimiting() {
+    VInstant::freezeTime(VInstant()); // Limits depend on the passage of time, which we control here.
+
+    VLoggerRateLimiter limiter(10, 3, 1, VLoggerLevel::OFF, VDuration::SECOND());
+    int numSuppressed = -1;
+    int numAdmitted = 0;
+    for (int i = 0; i < 5; ++i) {
+        numAdmitted += limiter.admit(numSuppressed) ? 1 : 0;
+    }
+    VUNIT_ASSERT_EQUAL_LABELED(numAdmitted, 3, "rate limiter burst");
+    VInstant::shiftFrozenTime(VDuration::MILLISECOND() * 100);
+    VUNIT_ASSERT_TRUE_LABELED(limiter.admit(numSuppressed), "rate limiter refills one message per interval");
+    VUNIT_ASSERT_EQUAL_LABELED(numSuppressed, 0, "rate limiter summary not yet due");
+    VUNIT_ASSERT_FALSE_LABELED(limiter.admit(numSuppressed), "rate limiter empty again");
+    VInstant::shiftFrozenTime(VDuration::SECOND());
+    VUNIT_ASSERT_TRUE_LABELED(limiter.admit(numSuppressed), "rate limiter refilled");
+    VUNIT_ASSERT_EQUAL_LABELED(numSuppressed, 3, "rate limiter summary count");
+
+    VLoggerRateLimiter sampler(0, 1, 3);
+    numAdmitted = 0;
+    for (int i = 0; i < 9; ++i) {
+        numAdmitted += sampler.admit(numSuppressed) ? 1 : 0;
+    }
+    VUNIT_ASSERT_EQUAL_LABELED(numAdmitted, 3, "sampling 1 in 3");
+    VUNIT_ASSERT_EQUAL_LABELED(sampler.takeSuppressed(false), 0, "sampler summary not yet due");
+    VUNIT_ASSERT_TRUE_LABELED(sampler.admit(numSuppressed), "sampler admits 1 in 3");
+    VInstant::shiftFrozenTime(VDuration::SECOND() * 10);
+    VUNIT_ASSERT_FALSE_LABELED(sampler.admit(numSuppressed), "sampler suppresses");
+    VUNIT_ASSERT_EQUAL_LABELED(numSuppressed, 7, "summary reported with a suppressed message");
+    VUNIT_ASSERT_FALSE_LABELED(sampler.admit(numSuppressed), "sampler suppresses again");
+    VUNIT_ASSERT_EQUAL_LABELED(numSuppressed, 0, "summary reported once per interval");
+    VUNIT_ASSERT_EQUAL_LABELED(sampler.takeSuppressed(true), 1, "summary taken when not due");
+
+    // A logger configured from settings; ERROR messages are not limited by default.
+    VStringVectorLogAppender* target = new VStringVectorLogAppender("rate-limit-target", VLogAppender::DONT_FORMAT_OUTPUT, VString::EMPTY(), VString::EMPTY(), NULL);
+    VLogAppenderPtr targetPtr(target);
+    VLogger::registerLogAppender(targetPtr);
+    VString settingsText("<logger name=\"vloggerunit-rate-limited\" level=\"80\" appender=\"rate-limit-target\" rate-limit=\"2\" rate-limit-summary-interval=\"1s\" />");
+    VMemoryStream buf(settingsText.getDataBuffer(), VMemoryStream::kAllocatedByOperatorNew, false, settingsText.length(), settingsText.length());
+    VTextIOStream in(buf);
+    VSettings settings(in);
+    VLogger::installNewNamedLogger(*(settings.findNode("logger")));
+
+    VBentoNode info;
+    VLogger::findNamedLogger("vloggerunit-rate-limited")->addInfo(info);
+    VUNIT_ASSERT_EQUAL_LABELED(info.getInt("rate-limit"), 2, "rate limit from settings");
+    VUNIT_ASSERT_EQUAL_LABELED(info.getInt("rate-limit-burst"), 2, "rate limit burst defaults to rate");
+
+    for (int i = 0; i < 5; ++i) {
+        VLOGGER_NAMED_INFO("vloggerunit-rate-limited", VSTRING_FORMAT("storm %d", i));
+    }
+    VLOGGER_NAMED_ERROR("vloggerunit-rate-limited", "error");
+    VInstant::shiftFrozenTime(VDuration::SECOND());
+    VLOGGER_NAMED_INFO("vloggerunit-rate-limited", "after storm");
+
+    // A call site that samples is not evaluated for the messages it skips.
+    int numEvaluations = 0;
+    for (int i = 0; i < 8; ++i) {
+        VLOGGER_NAMED_SAMPLED("vloggerunit-rate-limited", VLoggerLevel::ERROR, 4, VSTRING_FORMAT("sampled %d", ++numEvaluations));
+    }
+    VUNIT_ASSERT_EQUAL_LABELED(numEvaluations, 2, "sampled call site evaluates only sampled messages");
+
+    /* locker scope */ {
+        VMutexLocker locker(&target->getMutex(), "VLoggerUnit::_testRateLimiting");
+        const VStringVector& lines = target->getLines();
+        VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(lines.size()), 7, "rate limited line count");
+        if (lines.size() == 7) {
+            VUNIT_ASSERT_EQUAL_LABELED(lines[1], "storm 1", "rate limited burst");
+            VUNIT_ASSERT_EQUAL_LABELED(lines[2], "error", "rate limit does not apply to errors");
+            VUNIT_ASSERT_EQUAL_LABELED(lines[3], VLoggerRateLimiter::formatSummary(3), "rate limit summary");
+            VUNIT_ASSERT_EQUAL_LABELED(lines[4], "after storm", "rate limited after summary");
+            VUNIT_ASSERT_EQUAL_LABELED(lines[6], "sampled 2", "sampled call site");
+        }
+    }
+
+    // The interval has passed since the last summary, so the first message held back reports itself.
+    // The rest of a storm that ends is reported by the next message at any level once the interval
+    // has passed again, and what is still held back is reported when the logger is deregistered.
+    VInstant::shiftFrozenTime(VDuration::SECOND());
+    for (int i = 0; i < 4; ++i) {
+        VLOGGER_NAMED_INFO("vloggerunit-rate-limited", VSTRING_FORMAT("second storm %d", i));
+    }
+    VInstant::shiftFrozenTime(VDuration::SECOND());
+    VLOGGER_NAMED_ERROR("vloggerunit-rate-limited", "error after storm");
+    for (int i = 0; i < 3; ++i) {
+        VLOGGER_NAMED_INFO("vloggerunit-rate-limited", VSTRING_FORMAT("third storm %d", i));
+    }
+    VLogger::deregisterLogger("vloggerunit-rate-limited");
+
+    /* locker scope */ {
+        VMutexLocker locker(&target->getMutex(), "VLoggerUnit::_testRateLimiting");
+        const VStringVector& lines = target->getLines();
+        VUNIT_ASSERT_EQUAL_LABELED(static_cast<int>(lines.size()), 15, "rate limited line count after storms");
+        if (lines.size() == 15) {
+            VUNIT_ASSERT_EQUAL_LABELED(lines[8], "second storm 1", "second storm burst");
+            VUNIT_ASSERT_EQUAL_LABELED(lines[9], VLoggerRateLimiter::formatSummary(1), "held back message reports a due summary");
+            VUNIT_ASSERT_EQUAL_LABELED(lines[10], VLoggerRateLimiter::formatSummary(1), "ended storm reported by unlimited message");
+            VUNIT_ASSERT_EQUAL_LABELED(lines[11], "error after storm", "unlimited message after summary");
+            VUNIT_ASSERT_EQUAL_LABELED(lines[13], "third storm 1", "third storm burst");
+            VUNIT_ASSERT_EQUAL_LABELED(lines[14], VLoggerRateLimiter::formatSummary(1), "held back messages reported on deregistration");
+        }
+    }
+
+    VLogger::deregisterLogAppender(targetPtr);
+    VInstant::unfreezeTime();
+}
+
 #define OLDEST_VLOGGER_NAMED_DEBUG(loggername, message) VLogger::getLogger(loggername)->log(VLoggerLevel::DEBUG, message)
 #define OLD_VLOGGER_NAMED_DEBUG(loggername, message) do { VNamedLoggerPtr vlcond = VLogger::findNamedLoggerForLevel(loggername, VLoggerLevel::DEBUG); if (vlcond != NULL) vlcond->log(VLoggerLevel::DEBUG, NULL, 0, message); } while (false)
 // for reference, as of this writing, the new one basically expands to:
@@ -39,9 +39,18 @@ class VLoggerUnit : public VUnit {
         void _testNewInfrastructure();
         void _testMacros();
         void _testStringLoggers();
+        void _testFormatSpecs();
+        void _testTimeStampFormatter();
         void _testMaxActiveLogLevel();
         void _testLoggerPathNames();
+        void _testNamedLoggerCache();
         void _testSmartPtrLifecycle();
+        void _testAsyncAppender();
+        void _testRollingFileAppender();
+        void _testMappedFileAppender();
+        void _testBinaryAppender();
+        void _testRateLimiting();
+        void _testCaptureAppender();
         void _testOptimizationPerformance();
 
 };
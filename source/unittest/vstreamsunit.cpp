@@ -38,6 +38,7 @@ void VStreamsUnit::run() {
     this->_testReadOnlyStream();
     this->_testOverloadedStreamCopyAPIs();
     this->_testStreamTailer();
+    this->_testTextLineReading();
 }
 
 void VStreamsUnit::_testWriteBufferedStream() {
@@ -433,3 +434,98 @@ void VStreamsUnit::_testStreamTailer() {
     }
 
 }
+
+// Reads lines until EOF and returns them separated by '|', with line endings shown as \r and \n.
+static VString _readLinesForTest(VTextIOStream& stream, bool includeLineEndings) {
+    VString result;
+    VString line;
+    try {
+        for (;;) {
+            stream.readLine(line, includeLineEndings);
+            line.replace("\r", "\\r");
+            line.replace("\n", "\\n");
+            result += line;
+            result += '|';
+        }
+    } catch (const VEOFException&) {}
+
+    return result;
+}
+
+void VStreamsUnit::_testTextLineReading() {
+    // readLine() scans a memory stream's buffer in place, reads a file stream one code point
+    // at a time, or reads it in blocks if told to. All three must split lines the same way,
+    // including when a 0x0D and the 0x0A that follows it land in different blocks.
+    const VString text("one\ntwo\r\nthree\rfour\r\r\nfive\n\nsix");
+    const VString expectedLines("one|two|three|four||five||six|");
+    const VString expectedLinesWithEndings("one\\n|two\\r\\n|three\\r|four\\r|\\r\\n|five\\n|\\n|six|");
+
+    VMemoryStream memoryStream;
+    VTextIOStream memoryTextStream(memoryStream);
+    memoryTextStream.writeString(text);
+    memoryStream.seek0();
+    VUNIT_ASSERT_EQUAL_LABELED(_readLinesForTest(memoryTextStream, false), expectedLines, "memory stream lines");
+    VUNIT_ASSERT_EQUAL_LABELED(memoryTextStream.getLineEndingsReadKind(), static_cast<int>(VTextIOStream::kLineEndingsMixed), "memory stream line endings");
+    memoryStream.seek0();
+    VUNIT_ASSERT_EQUAL_LABELED(_readLinesForTest(memoryTextStream, true), expectedLinesWithEndings, "memory stream lines with endings");
+
+    // A line read from a memory stream with readLineChars() is not copied.
+    memoryStream.seek0();
+    int length;
+    const char* chars = memoryTextStream.readLineChars(length);
+    VUNIT_ASSERT_TRUE_LABELED(chars == reinterpret_cast<const char*>(memoryStream.getBuffer()), "readLineChars in place");
+    VUNIT_ASSERT_EQUAL_LABELED(length, 3, "readLineChars length");
+
+    VFSNode tempDir = VFSNode::getKnownDirectoryNode(VFSNode::CACHED_DATA_DIRECTORY, "vault", "unittest");
+    VFSNode testDirRoot(tempDir, "vstreamsunit_temp");
+    testDirRoot.mkdirs();
+    VFSNode testFileNode(testDirRoot, "line_reading.txt");
+    {
+        VBufferedFileStream outputFileStream(testFileNode);
+        outputFileStream.openWrite();
+        (void) outputFileStream.write(text.getDataBufferConst(), text.length());
+        outputFileStream.flush();
+    }
+
+    const int kNumReadBufferSizes = 11;
+    const int readBufferSizes[kNumReadBufferSizes] = { 0, 1, 2, 3, 4, 5, 6, 7, 11, 16, VTextIOStream::kDefaultReadBufferSize };
+    for (int i = 0; i < kNumReadBufferSizes; ++i) {
+        VBufferedFileStream inputFileStream(testFileNode);
+        inputFileStream.openReadOnly();
+        VTextIOStream inputStream(inputFileStream);
+        inputStream.setReadBufferSize(readBufferSizes[i]);
+        VUNIT_ASSERT_EQUAL_LABELED(_readLinesForTest(inputStream, false), expectedLines, VSTRING_FORMAT("file lines with read buffer size %d", readBufferSizes[i]));
+        VUNIT_ASSERT_EQUAL_LABELED(inputStream.getLineEndingsReadKind(), static_cast<int>(VTextIOStream::kLineEndingsMixed), VSTRING_FORMAT("file line endings with read buffer size %d", readBufferSizes[i]));
+        (void) inputFileStream.seek0();
+        VUNIT_ASSERT_EQUAL_LABELED(_readLinesForTest(inputStream, true), expectedLinesWithEndings, VSTRING_FORMAT("file lines with endings with read buffer size %d", readBufferSizes[i]));
+    }
+
+    // Reading code points after a buffered readLine() takes the bytes the buffer read ahead.
+    {
+        VBufferedFileStream inputFileStream(testFileNode);
+        inputFileStream.openReadOnly();
+        VTextIOStream inputStream(inputFileStream);
+        inputStream.setReadBufferSize(64);
+        VString line;
+        inputStream.readLine(line);
+        VUNIT_ASSERT_EQUAL_LABELED(line, "one", "buffered first line");
+        VUNIT_ASSERT_TRUE_LABELED(inputStream.hasPendingCharacter(), "buffered bytes are pending");
+        VUNIT_ASSERT_EQUAL_LABELED(inputStream.readUTF8CodePoint(), VCodePoint('t'), "code point after buffered line");
+        VUNIT_ASSERT_EQUAL_LABELED(inputStream.readCharacterByte(), VChar('w'), "byte after buffered line");
+        inputStream.readLine(line);
+        VUNIT_ASSERT_EQUAL_LABELED(line, "o", "rest of buffered second line");
+    }
+
+    // readAll() reproduces the text exactly.
+    {
+        VBufferedFileStream inputFileStream(testFileNode);
+        inputFileStream.openReadOnly();
+        VTextIOStream inputStream(inputFileStream);
+        VString all;
+        inputStream.readAll(all);
+        VUNIT_ASSERT_EQUAL_LABELED(all, text, "readAll");
+        VUNIT_ASSERT_EQUAL_LABELED(inputStream.getReadBufferSize(), 0, "readAll restores read buffer size");
+    }
+
+    (void) testDirRoot.rm();
+}
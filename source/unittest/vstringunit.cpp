@@ -11,6 +11,12 @@ License: MIT. See LICENSE.md in the Vault top level directory.
 #include "vchar.h"
 #include "vexception.h"
 #include "vhex.h"
+#include "vinstant.h"
+#include "vmemorystream.h"
+#include "vnumberformat.h"
+#include "vstringatom.h"
+#include "vstringbuilder.h"
+#include "vtextiostream.h"
 
 static int _getOffset(void* objectPtr, void* fieldPtr) {
     Vs64 objAddr = (Vs64) objectPtr;
@@ -25,6 +31,8 @@ VStringUnit::VStringUnit(bool logOnSuccess, bool throwOnError) :
 }
 
 void VStringUnit::run() {
+//    this->_testFormattingPerformance();
+
     // Start by testing assignment and concatenation.
     VString    s("(A)");
 
@@ -93,6 +101,53 @@ void VStringUnit::run() {
     VUNIT_ASSERT_TRUE_LABELED(s.compareIgnoreCase(VString("Cherry")) < 0, "compareIgnoreCase <");
     VUNIT_ASSERT_TRUE_LABELED(s.compareIgnoreCase("Cherry") < 0, "compareIgnoreCase <");
 
+    // Longer than one 8-byte word, with differences before, at, and after the word boundary, and non-ASCII bytes.
+    VString longName("Config.Server.ListenPort");
+    VUNIT_ASSERT_TRUE_LABELED(longName.equalsIgnoreCase("CONFIG.SERVER.LISTENPORT"), "equalsIgnoreCase long");
+    VUNIT_ASSERT_TRUE_LABELED(longName.equalsIgnoreCase(VString("config.server.listenport")), "equalsIgnoreCase long VString");
+    VUNIT_ASSERT_FALSE_LABELED(longName.equalsIgnoreCase("Config.Server.ListenPorts"), "! equalsIgnoreCase long prefix");
+    VUNIT_ASSERT_FALSE_LABELED(longName.equalsIgnoreCase(VString("Config.Server.ListenPor")), "! equalsIgnoreCase long truncated");
+    VUNIT_ASSERT_FALSE_LABELED(longName.equalsIgnoreCase("Config[Server.ListenPort"), "! equalsIgnoreCase long non-letter"); // '[' is 'Z' + 1
+    VUNIT_ASSERT_TRUE_LABELED(longName.compareIgnoreCase("config.server.listenpart") > 0, "compareIgnoreCase long >");
+    VUNIT_ASSERT_TRUE_LABELED(longName.compareIgnoreCase(VString("CONFIG.SERVER.LISTENPORTS")) < 0, "compareIgnoreCase long <");
+    VUNIT_ASSERT_TRUE_LABELED(longName.compareIgnoreCase("CONFIG.SERVER.LISTEN@ORT") > 0, "compareIgnoreCase long @"); // '@' is 'A' - 1
+    VString accentedName("Caf\xC3\xA9-Cr\xC3\xA8me-Br\xC3\xBBl\xC3\xA9" "e"); // "Café-Crème-Brûlée"
+    VUNIT_ASSERT_TRUE_LABELED(accentedName.equalsIgnoreCase("CAF\xC3\xA9-CR\xC3\xA8ME-BR\xC3\xBBL\xC3\xA9" "E"), "equalsIgnoreCase non-ASCII");
+    VUNIT_ASSERT_FALSE_LABELED(accentedName.equalsIgnoreCase("CAF\xC3\xA8-CR\xC3\xA8ME-BR\xC3\xBBL\xC3\xA9" "E"), "! equalsIgnoreCase non-ASCII");
+    VUNIT_ASSERT_TRUE_LABELED(accentedName.compareIgnoreCase("CAF\xC3\xA8-CR\xC3\xA8ME") > 0, "compareIgnoreCase non-ASCII");
+
+    VUNIT_ASSERT_EQUAL_LABELED(longName.hashValue(), VString("Config.Server.ListenPort").hashValue(), "hashValue equal");
+    VUNIT_ASSERT_NOT_EQUAL_LABELED(longName.hashValue(), VString("config.server.listenport").hashValue(), "hashValue case-sensitive");
+    VUNIT_ASSERT_EQUAL_LABELED(longName.hashValueIgnoreCase(), VString("CONFIG.SERVER.LISTENPORT").hashValueIgnoreCase(), "hashValueIgnoreCase equal");
+    VUNIT_ASSERT_EQUAL_LABELED(VString("Short").hashValueIgnoreCase(), VString("sHORT").hashValueIgnoreCase(), "hashValueIgnoreCase short");
+    VUNIT_ASSERT_EQUAL_LABELED(accentedName.hashValueIgnoreCase(), VString("CAF\xC3\xA9-CR\xC3\xA8ME-BR\xC3\xBBL\xC3\xA9" "E").hashValueIgnoreCase(), "hashValueIgnoreCase non-ASCII");
+    VUNIT_ASSERT_EQUAL_LABELED(std::hash<VString>()(longName), longName.hashValue(), "std::hash");
+    std::unordered_map<VString, int, VStringHashIgnoreCase, VStringEqualIgnoreCase> namesIgnoringCase;
+    namesIgnoringCase["Config.Server.ListenPort"] = 1;
+    namesIgnoringCase["config.server.LISTENPORT"] = 2;
+    VUNIT_ASSERT_EQUAL_LABELED((int) namesIgnoringCase.size(), 1, "unordered_map ignore case size");
+    VUNIT_ASSERT_EQUAL_LABELED(namesIgnoringCase["CONFIG.SERVER.LISTENPORT"], 2, "unordered_map ignore case lookup");
+
+    VStringAtom atom("Config.Server.ListenPort");
+    VUNIT_ASSERT_TRUE_LABELED(atom == VStringAtom(longName), "atom equal");
+    VUNIT_ASSERT_TRUE_LABELED(atom.chars() == VStringAtom(longName).chars(), "atom interned once");
+    VUNIT_ASSERT_TRUE_LABELED(atom != VStringAtom("config.server.listenport"), "atom case-sensitive");
+    VUNIT_ASSERT_EQUAL_LABELED(atom.getString(), longName, "atom getString");
+    VUNIT_ASSERT_EQUAL_LABELED(atom.getHash(), longName.hashValue(), "atom getHash");
+    VUNIT_ASSERT_EQUAL_LABELED(atom.getHashIgnoreCase(), longName.hashValueIgnoreCase(), "atom getHashIgnoreCase");
+    VUNIT_ASSERT_TRUE_LABELED(atom.equalsIgnoreCase(VStringAtom("CONFIG.SERVER.LISTENPORT")), "atom equalsIgnoreCase");
+    VUNIT_ASSERT_FALSE_LABELED(atom.equalsIgnoreCase(VStringAtom("CONFIG.SERVER.LISTENPORTS")), "! atom equalsIgnoreCase");
+    VUNIT_ASSERT_TRUE_LABELED(atom.getFolded() == VStringAtom("config.server.listenport"), "atom getFolded");
+    VUNIT_ASSERT_TRUE_LABELED(atom.getFolded().getFolded() == atom.getFolded(), "atom getFolded folded");
+    VUNIT_ASSERT_TRUE_LABELED(atom.hasPathParent(), "atom hasPathParent");
+    VUNIT_ASSERT_TRUE_LABELED(atom.getPathParent() == VStringAtom("Config.Server"), "atom getPathParent");
+    VUNIT_ASSERT_FALSE_LABELED(atom.getPathParent().getPathParent().hasPathParent(), "atom root has no parent");
+    VUNIT_ASSERT_TRUE_LABELED(VStringAtom().isEmpty() && (VStringAtom() == VStringAtom(VString::EMPTY())), "atom default empty");
+    VStringAtom foundAtom;
+    VUNIT_ASSERT_TRUE_LABELED(VStringAtom::find("Config.Server", foundAtom) && (foundAtom == atom.getPathParent()), "atom find interned");
+    VUNIT_ASSERT_FALSE_LABELED(VStringAtom::find("VStringUnit.never.interned", foundAtom), "atom find not interned");
+    VUNIT_ASSERT_FALSE_LABELED(VStringAtom::find("VStringUnit.never.interned", foundAtom), "atom find does not intern");
+
     VUNIT_ASSERT_TRUE_LABELED(s.startsWith("Ban"), "startsWith literal");
     VUNIT_ASSERT_TRUE_LABELED(s.startsWithIgnoreCase("bAN"), "startsWithIgnoreCase literal");
     VUNIT_ASSERT_TRUE_LABELED(s.startsWith('B'), "startsWith char");
@@ -158,8 +213,40 @@ void VStringUnit::run() {
 
     formatted.format(nullPointer);
     VUNIT_ASSERT_EQUAL_LABELED(formatted, VString::EMPTY(), "null formatting");
+
+    // A result too long for the first formatting attempt's stack buffer must be formatted in full.
+    VString longValue;
+    for (int i = 0; i < 3000; ++i) {
+        longValue += 'x';
+    }
+
+    formatted.format("<%s|%d>", longValue.chars(), 42);
+    VUNIT_ASSERT_EQUAL_LABELED(formatted.length(), 3000 + 5, "long formatting length");
+    VUNIT_ASSERT_TRUE_LABELED(formatted.startsWith("<xxx") && formatted.endsWith("x|42>"), "long formatting");
+
+    // Formatting a string from its own contents must work because both attempts use a separate buffer,
+    // including a long result for which our buffer is reallocated.
+    formatted.format("%s and %s", "Spot", "Rover");
+    formatted.format("[%s]", formatted.chars());
+    VUNIT_ASSERT_EQUAL_LABELED(formatted, "[Spot and Rover]", "self formatting");
+    formatted = longValue;
+    formatted.format("%s|%s", formatted.chars(), formatted.chars());
+    VUNIT_ASSERT_EQUAL_LABELED(formatted, longValue + "|" + longValue, "long self formatting");
 #endif
 
+    // Type-safe formatting.
+    VUNIT_ASSERT_EQUAL_LABELED(VString::fmt("{} is {} years old", "Spot", 5), "Spot is 5 years old", "fmt");
+    VUNIT_ASSERT_EQUAL_LABELED(VString::fmt("no placeholders"), "no placeholders", "fmt no args");
+    VUNIT_ASSERT_EQUAL_LABELED(VString::fmt("{}|{}|{}|{}", V_MIN_S64, CONST_U64(0xFFFFFFFFFFFFFFFF), static_cast<Vs8>(-128), static_cast<Vu16>(65535)),
+        "-9223372036854775808|18446744073709551615|-128|65535", "fmt integers");
+    VUNIT_ASSERT_EQUAL_LABELED(VString::fmt("{} {} {} {}", true, false, 'c', 0), "true false c 0", "fmt bool char zero");
+    VUNIT_ASSERT_EQUAL_LABELED(VString::fmt("{}", 3.5), VSTRING_DOUBLE(3.5), "fmt double");
+    VUNIT_ASSERT_EQUAL_LABELED(VString::fmt("{{{}}} {} {}", VString("name"), "%s%d"), "{name} %s%d {}", "fmt braces and missing arg");
+    VUNIT_ASSERT_EQUAL_LABELED(VString::fmt("{}", 1, 2), "1", "fmt extra arg");
+    VString appended("name: ");
+    appended.appendFmt("{}", appended);
+    VUNIT_ASSERT_EQUAL_LABELED(appended, "name: name: ", "appendFmt self");
+
     VString preflightFail("d'oh!");
     try {
         this->logStatus("VStringUnit will now intentionally invoke a memory allocation failure in VString::preflight.");
@@ -854,6 +941,42 @@ void VStringUnit::run() {
     VStringVector returnResult4 = splitInput.split(VCodePoint('e'), 0, false);
     VUNIT_ASSERT_TRUE_LABELED(returnResult4 == splitResult, "split return 4");
 
+    // Split on a multi-byte code point; items keep their own multi-byte code points intact.
+    VString splitUTF8Input("a\xC3\xA9" "b\xE2\x86\x92" "c\xE2\x86\x92\xE2\x86\x92"); // "aéb→c→→"
+    splitUTF8Input.split(splitResult, VCodePoint("U+2192"));
+    VUNIT_ASSERT_EQUAL_LABELED((int) splitResult.size(), 2, "split test UTF-8 size");
+    VUNIT_ASSERT_EQUAL_LABELED(splitResult[0], "a\xC3\xA9" "b", "split test UTF-8 [0]");
+    VUNIT_ASSERT_EQUAL_LABELED(splitResult[1], "c", "split test UTF-8 [1]");
+    VString(",,").split(splitResult, VCodePoint(','));
+    VUNIT_ASSERT_TRUE_LABELED(splitResult.empty(), "split of only delimiters");
+    VString::EMPTY().split(splitResult, VCodePoint(','));
+    VUNIT_ASSERT_TRUE_LABELED(splitResult.empty(), "split of empty string");
+
+    // Substring search offsets are byte offsets that stay valid for code point iteration.
+    VString searchUTF8("\xC3\xA9t\xC3\xA9 \xC3\xA9t\xC3\xA9 summer"); // "été été summer"
+    VUNIT_ASSERT_EQUAL_LABELED(searchUTF8.indexOf("\xC3\xA9t\xC3\xA9"), 0, "indexOf UTF-8");
+    VUNIT_ASSERT_EQUAL_LABELED(searchUTF8.indexOf("\xC3\xA9t\xC3\xA9", 1), 6, "indexOf UTF-8 from");
+    VUNIT_ASSERT_EQUAL_LABELED(searchUTF8.lastIndexOf("\xC3\xA9t\xC3\xA9"), 6, "lastIndexOf UTF-8");
+    VUNIT_ASSERT_EQUAL_LABELED(searchUTF8.indexOf("summer"), 12, "indexOf after UTF-8");
+    VUNIT_ASSERT_EQUAL_LABELED(searchUTF8.indexOfIgnoreCase("SUMMER"), 12, "indexOfIgnoreCase after UTF-8");
+    VUNIT_ASSERT_EQUAL_LABELED(searchUTF8.indexOf("summers"), -1, "indexOf past end");
+    VUNIT_ASSERT_EQUAL_LABELED(searchUTF8.indexOf(VString::EMPTY()), -1, "indexOf empty");
+    VUNIT_ASSERT_EQUAL_LABELED(searchUTF8.lastIndexOf("summer", 11), -1, "lastIndexOf before match");
+    VUNIT_ASSERT_EQUAL_LABELED((*(searchUTF8.begin() + 8)).intValue(), 0x73, "iterate to indexOf offset"); // the 's' at byte offset 12
+
+    // Replacement in one pass, growing and shrinking, with the replacement taken from the string itself.
+    VString replaceInput("$level $message ($level)");
+    VUNIT_ASSERT_EQUAL_LABELED(replaceInput.replace("$level", "WARN"), 2, "replace shrink count");
+    VUNIT_ASSERT_EQUAL_LABELED(replaceInput, "WARN $message (WARN)", "replace shrink");
+    VUNIT_ASSERT_EQUAL_LABELED(replaceInput.replace("$message", replaceInput), 1, "replace self count");
+    VUNIT_ASSERT_EQUAL_LABELED(replaceInput, "WARN WARN $message (WARN) (WARN)", "replace self");
+    VUNIT_ASSERT_EQUAL_LABELED(replaceInput.replace("aa", "a"), 0, "replace no match");
+    replaceInput = "aaaa";
+    VUNIT_ASSERT_EQUAL_LABELED(replaceInput.replace("aa", "a"), 2, "replace adjacent count");
+    VUNIT_ASSERT_EQUAL_LABELED(replaceInput, "aa", "replace adjacent");
+    VUNIT_ASSERT_EQUAL_LABELED(replaceInput.replace("a", VString::EMPTY()), 2, "replace to empty count");
+    VUNIT_ASSERT_EQUAL_LABELED(replaceInput, VString::EMPTY(), "replace to empty");
+
     // Change to vararg constructor to allow "%" to avoid unwanted formatting.
     VString percentSign("%");
     VUNIT_ASSERT_EQUAL_LABELED(percentSign, VString('%'), "percent sign literal constructor");
@@ -1139,6 +1262,33 @@ void VStringUnit::run() {
     VUNIT_ASSERT_EQUAL_LABELED(stringWithMultibyteCharacters.length(), initialLength, "expected length after replace");
     this->logStatus(stringWithMultibyteCharacters);
 
+    // Test the cached ASCII state, bulk counting, and validation.
+    VUNIT_ASSERT_FALSE_LABELED(stringWithMultibyteCharacters.isASCII(), "multibyte string is not ASCII");
+    VUNIT_ASSERT_TRUE_LABELED(stringWithMultibyteCharacters.isValidUTF8(), "multibyte string is valid UTF-8");
+    VString asciiText("The quick brown fox jumps over the lazy dog.");
+    VUNIT_ASSERT_TRUE_LABELED(asciiText.isASCII() && asciiText.isValidUTF8(), "ASCII string");
+    VUNIT_ASSERT_EQUAL_LABELED(asciiText.getNumCodePoints(), asciiText.length(), "ASCII num code points");
+    VUNIT_ASSERT_EQUAL_LABELED((*(asciiText.begin() + 40)), VCodePoint('d'), "ASCII iterator advance");
+    VUNIT_ASSERT_EQUAL_LABELED((*(asciiText.rbegin() + 3)), VCodePoint('d'), "ASCII reverse iterator advance");
+    VUNIT_ASSERT_TRUE_LABELED(VString::EMPTY().isASCII() && VString::EMPTY().isValidUTF8(), "empty string is ASCII");
+    asciiText += VCodePoint("U+6C34");
+    VUNIT_ASSERT_FALSE_LABELED(asciiText.isASCII(), "ASCII state recalculated after append");
+    VUNIT_ASSERT_EQUAL_LABELED(asciiText.getNumCodePoints(), 45, "num code points after append");
+    VUNIT_ASSERT_EQUAL_LABELED((*(asciiText.begin() + 44)), VCodePoint("U+6C34"), "iterator advance past ASCII run");
+    asciiText.truncateCodePoints(44);
+    VUNIT_ASSERT_TRUE_LABELED(asciiText.isASCII(), "ASCII state recalculated after truncate");
+    VString strayContinuationBytes("ab\x80\x81" "cd"); // same length and code point count, but not ASCII
+    VUNIT_ASSERT_EQUAL_LABELED(strayContinuationBytes.getNumCodePoints(), 6, "stray continuation bytes num code points");
+    VUNIT_ASSERT_FALSE_LABELED(strayContinuationBytes.isASCII(), "stray continuation bytes are not ASCII");
+    VUNIT_ASSERT_FALSE_LABELED(strayContinuationBytes.isValidUTF8(), "stray continuation bytes are not valid UTF-8");
+    VUNIT_ASSERT_FALSE_LABELED(VString("caf\xC3").isValidUTF8(), "truncated sequence is not valid UTF-8");
+    VUNIT_ASSERT_FALSE_LABELED(VString("\xC0\xAF").isValidUTF8(), "overlong 2-byte form is not valid UTF-8");
+    VUNIT_ASSERT_FALSE_LABELED(VString("\xE0\x80\xAF").isValidUTF8(), "overlong 3-byte form is not valid UTF-8");
+    VUNIT_ASSERT_FALSE_LABELED(VString("\xED\xA0\x80").isValidUTF8(), "UTF-16 surrogate is not valid UTF-8");
+    VUNIT_ASSERT_FALSE_LABELED(VString("\xF4\x90\x80\x80").isValidUTF8(), "above U+10FFFF is not valid UTF-8");
+    VUNIT_ASSERT_TRUE_LABELED(VString("\xF4\x8F\xBF\xBF").isValidUTF8(), "U+10FFFF is valid UTF-8");
+    VUNIT_ASSERT_TRUE_LABELED(VString("0123456789abcdef\xE6\xB0\xB4" "0123456789").isValidUTF8(), "mixed ASCII runs are valid UTF-8");
+
     std::wstring ws1 = utf8Test.toUTF16();
     VString roundTrip(ws1);
     std::wstring ws2 = roundTrip.toUTF16();
@@ -1179,5 +1329,396 @@ void VStringUnit::run() {
     VUNIT_ASSERT_EQUAL_LABELED((*(localeExample.begin() + 1)).intValue(), 0xDF, "localeExample[1]");
     VUNIT_ASSERT_EQUAL_LABELED((*(localeExample.begin() + 2)).intValue(), 0x6C34, "localeExample[2]");
     VUNIT_ASSERT_EQUAL_LABELED((*(localeExample.begin() + 3)).intValue(), 0x0001D10B, "localeExample[3]");
+
+    this->_testNumberRoundTrips();
+    this->_testStringBuilder();
+    this->_testCopyOnWrite();
+}
+
+// A small deterministic generator, so that failures are reproducible.
+static Vu64 _nextRandom(Vu64& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
 }
 
+static bool _doubleBitsEqual(VDouble a, VDouble b) {
+    return ::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+void VStringUnit::_testNumberRoundTrips() {
+    VString s;
+
+    // Integers, including the extremes that overflow naive negation.
+    s = V_MIN_S64;
+    VUNIT_ASSERT_EQUAL_LABELED(s, "-9223372036854775808", "format V_MIN_S64");
+    VUNIT_ASSERT_TRUE_LABELED(s.parseS64() == V_MIN_S64, "parse V_MIN_S64");
+    s = static_cast<Vu64>(V_MAX_U64); // V_MAX_U64 is declared as a Vs64
+    VUNIT_ASSERT_EQUAL_LABELED(s, "18446744073709551615", "format V_MAX_U64");
+    VUNIT_ASSERT_TRUE_LABELED(s.parseU64() == static_cast<Vu64>(V_MAX_U64), "parse V_MAX_U64");
+    s = 0;
+    VUNIT_ASSERT_EQUAL_LABELED(s, "0", "format 0");
+    s = "x";
+    s += static_cast<Vs8>(-128);
+    s += static_cast<Vu16>(65535);
+    VUNIT_ASSERT_EQUAL_LABELED(s, "x-12865535", "append small integers");
+    VUNIT_ASSERT_EQUAL_LABELED(VString::fmt("{}/{}", V_MIN_S64, static_cast<Vu64>(V_MAX_U64)), "-9223372036854775808/18446744073709551615", "fmt integer extremes");
+
+    const char* outOfRange[] = { "9223372036854775808", "-9223372036854775809", "99999999999999999999", "-", "+", "1 " };
+    for (int i = 0; i < static_cast<int>(sizeof(outOfRange) / sizeof(outOfRange[0])); ++i) {
+        try {
+            s = outOfRange[i];
+            (void) s.parseS64();
+            VUNIT_ASSERT_FAILURE(VSTRING_FORMAT("parseS64 rejects '%s'", outOfRange[i]));
+        } catch (const VRangeException& /*ex*/) {
+            VUNIT_ASSERT_SUCCESS(VSTRING_FORMAT("parseS64 rejects '%s'", outOfRange[i]));
+        }
+    }
+
+    try {
+        s = "18446744073709551616";
+        (void) s.parseU64();
+        VUNIT_ASSERT_FAILURE("parseU64 rejects overflow");
+    } catch (const VRangeException& /*ex*/) {
+        VUNIT_ASSERT_SUCCESS("parseU64 rejects overflow");
+    }
+
+    Vu64 state = CONST_U64(0x9E3779B97F4A7C15);
+    int numIntegerFailures = 0;
+    for (int i = 0; i < 100000; ++i) {
+        Vs64 value = static_cast<Vs64>(_nextRandom(state)) >> (i % 64); // cover every magnitude
+        s = value;
+        if ((s != VSTRING_S64(value)) || (s.parseS64() != value)) {
+            ++numIntegerFailures;
+        }
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(numIntegerFailures, 0, "random Vs64 round trips");
+
+    // Doubles: shortest forms.
+    s.formatRoundTrip(0.1);
+    VUNIT_ASSERT_EQUAL_LABELED(s, "0.1", "format 0.1");
+    s.formatRoundTrip(0.1 + 0.2);
+    VUNIT_ASSERT_EQUAL_LABELED(s, "0.30000000000000004", "format 0.1 + 0.2");
+    s.formatRoundTrip(-1500.0);
+    VUNIT_ASSERT_EQUAL_LABELED(s, "-1500", "format -1500");
+    s.formatRoundTrip(1.0e-7);
+    VUNIT_ASSERT_EQUAL_LABELED(s, "1e-07", "format 1e-07");
+    s.formatRoundTrip(6.02214076e23);
+    VUNIT_ASSERT_EQUAL_LABELED(s, "6.02214076e+23", "format 6.02214076e+23");
+    s.formatRoundTrip(std::numeric_limits<VDouble>::max());
+    VUNIT_ASSERT_EQUAL_LABELED(s, "1.7976931348623157e+308", "format max");
+    s.formatRoundTrip(std::numeric_limits<VDouble>::denorm_min());
+    VUNIT_ASSERT_EQUAL_LABELED(s, "5e-324", "format denorm_min");
+    s.formatRoundTrip(-0.0);
+    VUNIT_ASSERT_EQUAL_LABELED(s, "-0", "format -0");
+    s.formatRoundTrip(-std::numeric_limits<VDouble>::infinity());
+    VUNIT_ASSERT_EQUAL_LABELED(s, "-inf", "format -inf");
+    s.formatRoundTrip(std::numeric_limits<VDouble>::quiet_NaN());
+    VUNIT_ASSERT_EQUAL_LABELED(s, "nan", "format nan");
+    VUNIT_ASSERT_TRUE_LABELED(s.parseDouble() != s.parseDouble(), "parse nan");
+    s = "x=";
+    s.appendRoundTrip(2.5);
+    VUNIT_ASSERT_EQUAL_LABELED(s, "x=2.5", "appendRoundTrip");
+
+    // Doubles: parsing hard cases, which need more than one rounding step in a naive parser.
+    s = "2.2250738585072011e-308";
+    VUNIT_ASSERT_TRUE_LABELED(_doubleBitsEqual(s.parseDouble(), 2.2250738585072011e-308), "parse near smallest normal");
+    s = "9007199254740993";
+    VUNIT_ASSERT_TRUE_LABELED(_doubleBitsEqual(s.parseDouble(), 9007199254740992.0), "parse halfway rounds to even");
+    s = "0.1000000000000000055511151231257827021181583404541015625";
+    VUNIT_ASSERT_TRUE_LABELED(_doubleBitsEqual(s.parseDouble(), 0.1), "parse exact decimal expansion of 0.1");
+    s = "1e400";
+    VUNIT_ASSERT_TRUE_LABELED(s.parseDouble() == std::numeric_limits<VDouble>::infinity(), "parse overflow");
+    s = " -12.5e-1xyz";
+    VUNIT_ASSERT_EQUAL_LABELED(s.parseDouble(), -1.25, "parse with leading space and trailing text");
+
+    // Doubles: every bit pattern class round trips exactly. Random bit patterns cover the
+    // whole range; consecutive values around 1.0 and every power of 2 cover the boundaries.
+    int numDoubleFailures = 0;
+    VDouble value;
+    for (int i = 0; i < 200000; ++i) {
+        Vu64 bits = _nextRandom(state);
+        ::memcpy(&value, &bits, sizeof(value));
+        if (value != value) {
+            continue; // NaN payloads are not preserved, by design
+        }
+
+        s.formatRoundTrip(value);
+        if (!_doubleBitsEqual(s.parseDouble(), value)) {
+            ++numDoubleFailures;
+        }
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(numDoubleFailures, 0, "random double round trips");
+
+    Vu64 oneBits;
+    value = 1.0;
+    ::memcpy(&oneBits, &value, sizeof(oneBits));
+    for (Vu64 bits = oneBits - 50000; bits < oneBits + 50000; ++bits) {
+        ::memcpy(&value, &bits, sizeof(value));
+        s.formatRoundTrip(value);
+        if (!_doubleBitsEqual(s.parseDouble(), value)) {
+            ++numDoubleFailures;
+        }
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(numDoubleFailures, 0, "consecutive double round trips near 1.0");
+
+    for (int exponent = -1074; exponent <= 1023; ++exponent) {
+        value = ::ldexp(1.0, exponent);
+        s.formatRoundTrip(value);
+        if (!_doubleBitsEqual(s.parseDouble(), value)) {
+            ++numDoubleFailures;
+        }
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(numDoubleFailures, 0, "power of 2 double round trips");
+
+    // Short decimals must come back as written, which is what makes the output readable.
+    for (int i = -100000; i <= 100000; ++i) {
+        value = i / 1000.0;
+        s.formatRoundTrip(value);
+        if ((s.length() > 8) || !_doubleBitsEqual(s.parseDouble(), value)) { // at most "-100.000", less any trailing zeros
+            ++numDoubleFailures;
+        }
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(numDoubleFailures, 0, "short decimal double round trips");
+}
+
+void VStringUnit::_testStringBuilder() {
+    VStringBuilder empty;
+    VUNIT_ASSERT_TRUE_LABELED(empty.isEmpty() && (empty.length() == 0), "builder initially empty");
+    VUNIT_ASSERT_EQUAL_LABELED(empty.toString(), VString::EMPTY(), "empty builder toString");
+
+    VStringBuilder builder;
+    builder += "abc";
+    builder += 'd';
+    builder += VString("ef");
+    builder.append("ghij", 2);
+    builder.appendRepeated('-', 3);
+    builder.appendS64(V_MIN_S64);
+    builder.append(' ');
+    builder.appendU64(static_cast<Vu64>(V_MAX_U64)); // V_MAX_U64 is declared as signed -1.
+    builder.append(' ');
+    builder.appendRoundTrip(0.1);
+    builder.appendFmt(" {} {} {{}}", "x", 42);
+    builder.appendFormat(" %s=%d", "y", -7);
+    VUNIT_ASSERT_EQUAL_LABELED(builder.toString(), VString("abcdefgh----9223372036854775808 18446744073709551615 0.1 x 42 {} y=-7"), "builder appends");
+    VUNIT_ASSERT_EQUAL_LABELED(builder.length(), (Vs64) 69, "builder length");
+    VUNIT_ASSERT_EQUAL_LABELED(builder.charAt(3), 'd', "builder charAt");
+
+    VString target("prefix:");
+    builder.appendToString(target);
+    VUNIT_ASSERT_TRUE_LABELED(target.startsWith("prefix:abcdefgh") && target.endsWith("y=-7"), "builder appendToString");
+    builder.copyToString(target);
+    VUNIT_ASSERT_EQUAL_LABELED(target, builder.toString(), "builder copyToString");
+
+    // With a tiny first chunk, a long text spans many chunks; it must match the same text built with VString.
+    VStringBuilder chunked(16);
+    VString expected;
+    for (int i = 0; i < 5000; ++i) {
+        chunked.appendFmt("line {}: ", i);
+        chunked.appendRepeated('*', i % 40);
+        chunked.append('\n');
+        expected.appendFmt("line {}: ", i);
+        for (int j = 0; j < i % 40; ++j) {
+            expected += '*';
+        }
+        expected += '\n';
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(chunked.length(), (Vs64) expected.length(), "chunked builder length");
+    VUNIT_ASSERT_TRUE_LABELED(chunked.toString() == expected, "chunked builder text");
+    VUNIT_ASSERT_EQUAL_LABELED(chunked.charAt(expected.length() - 1), '\n', "chunked builder charAt last");
+    VUNIT_ASSERT_EQUAL_LABELED(chunked.charAt(expected.length() / 2), expected.charAt(expected.length() / 2), "chunked builder charAt middle");
+
+    VMemoryStream memoryStream;
+    VTextIOStream textStream(memoryStream);
+    chunked.writeToStream(textStream);
+    VUNIT_ASSERT_EQUAL_LABELED(memoryStream.getEOFOffset(), (Vs64) expected.length(), "builder writeToStream length");
+    VUNIT_ASSERT_TRUE_LABELED(::memcmp(memoryStream.getBuffer(), expected.chars(), static_cast<VSizeType>(expected.length())) == 0, "builder writeToStream text");
+
+    // Truncating keeps the chunks, and appending afterwards reuses them.
+    int truncatedLength = expected.length() / 3;
+    chunked.truncateLength(truncatedLength);
+    expected.truncateLength(truncatedLength);
+    VUNIT_ASSERT_TRUE_LABELED(chunked.toString() == expected, "builder truncateLength");
+    for (int i = 0; i < 1000; ++i) {
+        chunked.appendFormat("%d,", i);
+        expected.appendFmt("{},", i);
+    }
+
+    VUNIT_ASSERT_TRUE_LABELED(chunked.toString() == expected, "builder append after truncateLength");
+
+    // A formatted append longer than any chunk so far must still land in one piece.
+    VString longValue;
+    for (int i = 0; i < 5000; ++i) {
+        longValue += 'z';
+    }
+
+    chunked.appendFormat("[%s]", longValue.chars());
+    expected.appendFmt("[{}]", longValue);
+    VUNIT_ASSERT_TRUE_LABELED(chunked.toString() == expected, "builder long formatted append");
+
+    chunked.clear();
+    VUNIT_ASSERT_TRUE_LABELED(chunked.isEmpty() && (chunked.toString() == VString::EMPTY()), "builder clear");
+    chunked += "again";
+    VUNIT_ASSERT_EQUAL_LABELED(chunked.toString(), VString("again"), "builder append after clear");
+
+    try {
+        chunked.truncateLength(6);
+        VUNIT_ASSERT_FAILURE("builder truncateLength beyond length");
+    } catch (const VRangeException& /*ex*/) {
+        VUNIT_ASSERT_SUCCESS("builder truncateLength beyond length");
+    }
+}
+
+void VStringUnit::_testCopyOnWrite() {
+    const VString original("The quick brown fox jumps over the lazy dog.");
+
+    VString copy(original);
+    VUNIT_ASSERT_TRUE_LABELED(copy.chars() == original.chars(), "copy shares heap buffer");
+    VString assigned;
+    assigned = original;
+    VUNIT_ASSERT_TRUE_LABELED(assigned.chars() == original.chars(), "assignment shares heap buffer");
+    VString shortString("short");
+    VString shortCopy(shortString);
+    VUNIT_ASSERT_TRUE_LABELED(shortCopy.chars() != shortString.chars(), "internal buffer is not shared");
+
+    // Every mutating method must give the copy its own buffer and leave the original alone.
+    const VString originalText(original.chars()); // Not shared: compares contents, not buffers.
+    int numMutators = 0;
+    int numFailures = 0;
+    std::function<void(VString&)> mutators[] = {
+        [](VString& s) { s += "!"; },
+        [](VString& s) { s += '!'; },
+        [](VString& s) { s += VString("!"); },
+        [](VString& s) { s += 42; },
+        [](VString& s) { s += VCodePoint(0x00E9); },
+        [](VString& s) { s = "replaced"; },
+        [](VString& s) { s = 42; },
+        [](VString& s) { s[0] = 't'; },
+        [](VString& s) { s.set(1, VChar('H')); },
+        [](VString& s) { s.insert('!'); },
+        [](VString& s) { s.insert(VString("!!"), 4); },
+        [](VString& s) { s.insert(VCodePoint(0x00E9), 2); },
+        [](VString& s) { (void) s.replace("quick", "slow"); },
+        [](VString& s) { (void) s.replace(VCodePoint('o'), VCodePoint('0')); },
+        [](VString& s) { s.toLowerCase(); },
+        [](VString& s) { s.toUpperCase(); },
+        [](VString& s) { s.insert(' '); s.trim(); },
+        [](VString& s) { s.truncateLength(20); },
+        [](VString& s) { s.truncateLength(0); },
+        [](VString& s) { s.truncateCodePoints(20); },
+        [](VString& s) { s.substringInPlace(4, 30); },
+        [](VString& s) { s.copyFromBuffer("abcdefghijklmnopqrstuvwxyz", 0, 26); },
+        [](VString& s) { s.copyFromCString("abcdefghijklmnopqrstuvwxyz"); },
+        [](VString& s) { s.copyFromPascalString("\x03" "abc"); },
+        [](VString& s) { s.format("%s-%d", "formatted", 42); },
+        [](VString& s) { s.formatRoundTrip(0.1); },
+        [](VString& s) { s.appendRoundTrip(0.1); },
+        [](VString& s) { s.appendFmt("{}", 42); },
+        [](VString& s) { s.setFourCharacterCode(0x41424344); },
+        [](VString& s) { s.buffer()[0] = 't'; },
+        [](VString& s) { s.getDataBuffer()[0] = 't'; },
+        [](VString& s) { int length = s.length(); s.preflight(200); s.buffer()[length] = '!'; s.postflight(length + 1); },
+        [](VString& s) { s.preflight(10); s.buffer()[0] = 't'; },
+        [](VString& s) { delete [] s.orphanDataBuffer(); },
+        [](VString& s) { VString other(std::move(s)); },
+        [](VString& s) { s = VString("moved in from a temporary string"); }
+    };
+
+    for (VSizeType i = 0; i < sizeof(mutators) / sizeof(mutators[0]); ++i) {
+        VString mutated(original);
+        mutators[i](mutated);
+        ++numMutators;
+        if ((original != originalText) || (mutated.chars() == original.chars())) {
+            ++numFailures;
+            this->logStatus(VSTRING_FORMAT("copy-on-write failed for mutator %d", (int) i));
+        }
+    }
+
+    VUNIT_ASSERT_EQUAL_LABELED(numFailures, 0, VSTRING_FORMAT("copy-on-write for %d mutators", numMutators));
+
+    // Mutating the original must leave its copies alone, too.
+    VString source(original);
+    VString snapshot(source);
+    source += " And then some.";
+    VUNIT_ASSERT_EQUAL_LABELED(snapshot, originalText, "copy unaffected by mutating its source");
+
+    // Copies outlive their source, and self-assignment keeps the buffer.
+    VString* temporary = new VString(original);
+    VString survivor(*temporary);
+    delete temporary;
+    VUNIT_ASSERT_EQUAL_LABELED(survivor, originalText, "copy outlives its source");
+    survivor = survivor;
+    VUNIT_ASSERT_EQUAL_LABELED(survivor, originalText, "self-assignment of shared string");
+
+    // Moving takes the buffer and leaves the source empty.
+    VString moveSource(original);
+    const char* movedBuffer = moveSource.chars();
+    VString moveTarget(std::move(moveSource));
+    VUNIT_ASSERT_TRUE_LABELED(moveTarget.chars() == movedBuffer, "move constructor takes buffer");
+    VUNIT_ASSERT_TRUE_LABELED(moveSource.isEmpty(), "move constructor leaves source empty");
+    moveSource = std::move(moveTarget);
+    VUNIT_ASSERT_TRUE_LABELED((moveSource.chars() == movedBuffer) && moveTarget.isEmpty(), "move assignment takes buffer");
+    moveSource += '!';
+    VUNIT_ASSERT_EQUAL_LABELED(original, originalText, "moved copy mutation leaves original alone");
+}
+
+#ifdef VAULT_VARARG_STRING_FORMATTING_SUPPORT
+// The way vaFormat() used to work: measure with one vsnprintf pass, preflight, and format with a second pass.
+static void _formatInTwoPasses(VString& s, const char* formatText, ...) {
+    va_list args;
+    va_start(args, formatText);
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    int newStringLength = ::vsnprintf(NULL, 0, formatText, args);
+    s.preflight(newStringLength);
+    (void) ::vsnprintf(s.buffer(), static_cast<VSizeType>(newStringLength + 1), formatText, argsCopy);
+    s.postflight(newStringLength);
+    va_end(argsCopy);
+    va_end(args);
+}
+#endif
+
+void VStringUnit::_testFormattingPerformance() {
+    const int numIterations = 1000000;
+    const VString lockerName("VMessageQueue::postMessage");
+    VString result;
+
+    // A typical hot path message: a name, an integer, and a 64-bit duration.
+    // Mode 1 is the former two-pass vaFormat, mode 2 is the current VSTRING_FORMAT, and mode 3 is VString::fmt.
+    // Note: results of first test run of 1 million iterations (Linux x86-64, -O2): 0.439, 0.308, and 0.288 seconds.
+#ifdef VAULT_VARARG_STRING_FORMATTING_SUPPORT
+    {
+        VInstant start;
+        for (int i = 0; i < numIterations; ++i) {
+            _formatInTwoPasses(result, "Locker %s acquired by thread %d after " VSTRING_FORMATTER_S64 "ms.", lockerName.chars(), i, static_cast<Vs64>(i) * 3);
+        }
+        VDuration d(VInstant() - start);
+        std::cout << "MODE 1 (two-pass format): " << numIterations << " iterations in " << d.getDurationString() << std::endl;
+    }
+
+    {
+        VInstant start;
+        for (int i = 0; i < numIterations; ++i) {
+            result = VSTRING_FORMAT("Locker %s acquired by thread %d after " VSTRING_FORMATTER_S64 "ms.", lockerName.chars(), i, static_cast<Vs64>(i) * 3);
+        }
+        VDuration d(VInstant() - start);
+        std::cout << "MODE 2 (VSTRING_FORMAT): " << numIterations << " iterations in " << d.getDurationString() << std::endl;
+    }
+#endif
+
+    {
+        VInstant start;
+        for (int i = 0; i < numIterations; ++i) {
+            result = VString::fmt("Locker {} acquired by thread {} after {}ms.", lockerName, i, static_cast<Vs64>(i) * 3);
+        }
+        VDuration d(VInstant() - start);
+        std::cout << "MODE 3 (VString::fmt): " << numIterations << " iterations in " << d.getDurationString() << std::endl;
+    }
+}
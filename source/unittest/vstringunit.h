@@ -34,6 +34,13 @@ class VStringUnit : public VUnit {
         */
         virtual void run();
 
+    private:
+
+        void _testNumberRoundTrips();
+        void _testStringBuilder();
+        void _testCopyOnWrite();
+        void _testFormattingPerformance();
+
 };
 
 #endif /* vstringunit_h */
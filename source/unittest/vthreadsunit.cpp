@@ -79,6 +79,59 @@ void TestThreadClass::run() {
     mOwnerUnit->logStatus(info);
 }
 
+/**
+Copies a shared string over and over and modifies the copies, while other threads
+do the same with the same string. Each copy shares the string's heap buffer until
+it is modified, so this exercises the buffer's reference counting from many threads.
+*/
+class StringSharingThread : public VThread {
+    public:
+
+        StringSharingThread(const VString& namePrefix, const VString& sharedString, int numIterations);
+        ~StringSharingThread() {}
+
+        virtual void run();
+
+        int getNumFailures() const { return mNumFailures; }
+
+    private:
+
+        StringSharingThread(const StringSharingThread&); // not copyable
+        StringSharingThread& operator=(const StringSharingThread&); // not assignable
+
+        const VString&  mSharedString;
+        VString         mExpectedText;
+        int             mNumIterations;
+        int             mNumFailures;
+};
+
+StringSharingThread::StringSharingThread(const VString& namePrefix, const VString& sharedString, int numIterations) :
+    VThread(VSTRING_FORMAT("StringSharingThread.%s", namePrefix.chars()), "vault.threads.StringSharingThread", kDontDeleteSelfAtEnd, kCreateThreadJoinable, NULL),
+    mSharedString(sharedString),
+    mExpectedText(sharedString.chars()), // a private copy of the text, not a shared buffer
+    mNumIterations(numIterations),
+    mNumFailures(0) {
+}
+
+void StringSharingThread::run() {
+    for (int i = 0; i < mNumIterations; ++i) {
+        VString copy(mSharedString);
+        VString anotherCopy;
+        anotherCopy = copy;
+
+        if ((copy != mExpectedText) || (anotherCopy.chars() != mSharedString.chars())) {
+            ++mNumFailures;
+        }
+
+        copy += mName;
+        anotherCopy.toUpperCase();
+
+        if ((mSharedString != mExpectedText) || !copy.startsWith(mExpectedText) || (copy.length() != mExpectedText.length() + mName.length())) {
+            ++mNumFailures;
+        }
+    }
+}
+
 VThreadsUnit::VThreadsUnit(bool logOnSuccess, bool throwOnError) :
     VUnit("VThreadsUnit", logOnSuccess, throwOnError) {
 }
@@ -192,5 +245,29 @@ void VThreadsUnit::run() {
         VUNIT_ASSERT_FALSE_LABELED(mutexX.isLockedByCurrentThread(), "9 - local mutex not locked by current thread");
     }
 
+    {
+        // Test that strings sharing a copy-on-write buffer can be copied, modified and destroyed from several threads at once.
+        const int kNumSharingThreads = 4;
+        VString sharedString("This string is long enough to be in a shared heap buffer.");
+        StringSharingThread* sharingThreads[kNumSharingThreads];
+        for (int i = 0; i < kNumSharingThreads; ++i) {
+            sharingThreads[i] = new StringSharingThread(VSTRING_INT(i), sharedString, 100000);
+        }
+
+        for (int i = 0; i < kNumSharingThreads; ++i) {
+            sharingThreads[i]->start();
+        }
+
+        int numFailures = 0;
+        for (int i = 0; i < kNumSharingThreads; ++i) {
+            sharingThreads[i]->join();
+            numFailures += sharingThreads[i]->getNumFailures();
+            delete sharingThreads[i];
+        }
+
+        VUNIT_ASSERT_EQUAL_LABELED(numFailures, 0, "threads sharing string buffers");
+        VUNIT_ASSERT_EQUAL_LABELED(sharedString, VString("This string is long enough to be in a shared heap buffer."), "shared string unchanged by threads");
+    }
+
 }
 
@@ -18,6 +18,7 @@ This set of includes is enough to pull in all vault header files.
 #include "vassert.h"
 #include "vchar.h"
 #include "vlogger.h"
+#include "vbinarylog.h"
 #include "vsettings.h"
 #include "vclassregistry.h"
 #include "vsingleton.h"
@@ -29,6 +30,7 @@ This set of includes is enough to pull in all vault header files.
 #include "vsocketthreadfactory.h"
 #include "vbufferedfilestream.h"
 #include "vdirectiofilestream.h"
+#include "vmemorymappedfile.h"
 #include "vmemorystream.h"
 #include "vbinaryiostream.h"
 #include "vtextiostream.h"
@@ -216,7 +216,10 @@ set up for this platform build.
 #include <iostream>
 #include <deque>
 #include <map>
+#include <unordered_map> // C++11 unordered containers, keyed by VString via std::hash<VString>
+#include <functional> // C++11 std::hash
 #include <limits>
+#include <atomic> // C++11 atomics
 
 /*
 We choose to define just the basic specific-sized data types. Most